@@ -35,6 +35,16 @@ using namespace wwiv::strings;
 
 namespace wwiv::bbs {
 
+static void show_debug_info(const std::vector<std::string>& debug_info, acs_debug_t debug) {
+  for (const auto& l : debug_info) {
+    if (debug == acs_debug_t::local) {
+      LOG(INFO) << l;
+    } else if (debug == acs_debug_t::remote) {
+      bout.pl(l);
+    }
+  }
+}
+
 bool check_acs(const std::string& expression, acs_debug_t debug) {
   if (StringTrim(expression).empty()) {
     // Empty expression is always allowed.
@@ -46,14 +56,20 @@ bool check_acs(const std::string& expression, acs_debug_t debug) {
 
   auto [result, debug_info] =
       sdk::acs::check_acs(*a()->config(), expression, &user_provider, &bbs_provider);
-  for (const auto& l : debug_info) {
-    if (debug == acs_debug_t::local) {
-      LOG(INFO) << l;
-    } else if (debug == acs_debug_t::remote) {
-      bout.pl(l);
-    }
+  show_debug_info(debug_info, debug);
+  return result;
+}
+
+bool check_acs(const CompiledAcs& acs, acs_debug_t debug) {
+  if (acs.empty()) {
+    return true;
   }
 
+  const UserValueProvider user_provider(a()->context());
+  const BbsValueProvider bbs_provider(*a()->config(), a()->sess());
+
+  auto [result, debug_info] = acs.check({&user_provider, &bbs_provider});
+  show_debug_info(debug_info, debug);
   return result;
 }
 
@@ -52,6 +52,7 @@
 #include "common/output.h"
 #include "common/pipe_expr.h"
 #include "common/remote_io.h"
+#include "common/remote_socket_io.h"
 #include "common/workspace.h"
 #include "core/command_line.h"
 #include "core/eventbus.h"
@@ -71,6 +72,7 @@
 #include "local_io/wconstants.h"
 #include "sdk/chains.h"
 #include "sdk/gfiles.h"
+#include "sdk/latency_histograms.h"
 // ReSharper disable once CppUnusedIncludeDirective
 #include "sdk/names.h"
 // ReSharper disable once CppUnusedIncludeDirective
@@ -94,8 +96,6 @@
 #if defined(_WIN32)
 #include <crtdbg.h>
 // Needed for isatty
-// ReSharper disable once CppUnusedIncludeDirective
-#include "common/remote_socket_io.h"
 #include "local_io/local_io_win32.h"
 #include <io.h>
 #else
@@ -105,6 +105,10 @@
 #include <unistd.h>
 #endif // _WIN32
 
+#if !defined(_WIN32) && !defined(__OS2__)
+#include "core/fork_server.h"
+#endif
+
 #if defined(__OS2__) && defined (_WWIV_USE_TAKE_HANDLES)
 #include "libcx/handles.h"
 #endif
@@ -832,6 +836,8 @@ int Application::ExitBBSImpl(int exit_level, bool perform_shutdown) {
 
 int Application::Run(int argc, char* argv[]) {
   VLOG(4) << "Application::Run(): ";
+  // Used to log how long it takes before the caller sees the remote session.
+  auto start_time = steady_clock::now();
   auto bps = 0;
   auto ooneuser = false;
   auto type = CommunicationType::NONE;
@@ -850,6 +856,9 @@ int Application::Run(int argc, char* argv[]) {
   cmdline.add_argument({"fsed", 'f', "Opens file in the FSED", ""});
   cmdline.add_argument({"bps", 'b', "Modem speed of logged on user", "38400"});
   cmdline.add_argument({"sysop_cmd", 'c', "Executes a sysop command (b/c/d)", ""});
+  cmdline.add_argument(BooleanCommandLineArgument{
+      "trace", "Record latency histograms for wwivd's /metrics and a trace of each session",
+      false});
   cmdline.add_argument(BooleanCommandLineArgument{"debug", 'd', "Debug WWIVbasic Scripts", false});
   cmdline.add_argument({"debug_port", "Debug WWIVbasic Script Port Number", "9948"});
   cmdline.add_argument(
@@ -874,6 +883,12 @@ int Application::Run(int argc, char* argv[]) {
   cmdline.add_argument({"x", 'x', xhelp.str(), ""});
   cmdline.add_argument(BooleanCommandLineArgument{"no_hangup", 'z',
                                                   "Do not hang up on user when at log off", false});
+#if !defined(_WIN32) && !defined(__OS2__)
+  cmdline.add_argument({"fork_server",
+                        "Run as a pre-initialized template, forking a node for each caller "
+                        "when requested by wwivd over this UNIX domain socket.",
+                        ""});
+#endif
   VLOG(4) << "Application::Run(): 3";
   VLOG(1) << "Before Parse";
   if (!cmdline.Parse()) {
@@ -909,7 +924,7 @@ int Application::Run(int argc, char* argv[]) {
   
   oklevel_ = cmdline.iarg("ok_exit");
   errorlevel_ = cmdline.iarg("error_exit");
-  const unsigned int hSockOrComm = cmdline.iarg("handle");
+  unsigned int hSockOrComm = cmdline.iarg("handle");
   const unsigned int parent_pid = 0; //cmdline.iarg("parent_pid");
   no_hangup_ = cmdline.barg("no_hangup");
   sess().ok_modem_stuff(!cmdline.barg("no_modem"));
@@ -921,6 +936,32 @@ int Application::Run(int argc, char* argv[]) {
   }
 
   auto this_usernum_from_commandline = static_cast<uint16_t>(cmdline.iarg("user_num"));
+  auto set_remote_type = [&](char xarg) {
+    // Setting a max of 57600 for the BPS value, by default we use 38400
+    // as the default value.
+    bps = std::min<int>(cmdline.iarg("bps"), 57600);
+    switch (xarg) { 
+    case 'S':
+      SetCurrentSpeed("SSH");
+      type = CommunicationType::SSH; 
+      break;
+    case 'P':
+      SetCurrentSpeed("TELNET/PIPE");
+      type = CommunicationType::PIPE;
+      break;
+    case 'T':
+    default:
+      SetCurrentSpeed("TELNET");
+      type = CommunicationType::TELNET;
+      break;
+    }
+    // Set it false until we call liLo
+    user_already_on_ = true;
+    ooneuser = true;
+    sess().using_modem(false);
+    sess().incom(true);
+    sess().outcom(false);
+  };
   if (const auto x = cmdline.sarg("x"); !x.empty()) {
     const auto xarg = to_upper_case_char(x.at(0));
     if (cmdline.arg("handle").is_default() && (xarg == 'T' || xarg == 'S')) {
@@ -929,30 +970,7 @@ int Application::Run(int argc, char* argv[]) {
       return errorlevel_;
     }
     if (xarg == 'T' || xarg == 'S' || xarg == 'P') {
-      // Setting a max of 57600 for the BPS value, by default we use 38400
-      // as the default value.
-      bps = std::min<int>(cmdline.iarg("bps"), 57600);
-      switch (xarg) { 
-      case 'S':
-        SetCurrentSpeed("SSH");
-        type = CommunicationType::SSH; 
-        break;
-      case 'P':
-        SetCurrentSpeed("TELNET/PIPE");
-        type = CommunicationType::PIPE;
-        break;
-      case 'T':
-      default:
-        SetCurrentSpeed("TELNET");
-        type = CommunicationType::TELNET;
-        break;
-      }
-      // Set it false until we call liLo
-      user_already_on_ = true;
-      ooneuser = true;
-      sess().using_modem(false);
-      sess().incom(true);
-      sess().outcom(false);
+      set_remote_type(xarg);
     } else {
       std::clog << "Invalid Command line argument given '" << "-x" << x << "'" << std::endl;
       return errorlevel_;
@@ -978,7 +996,10 @@ int Application::Run(int argc, char* argv[]) {
 				     wwiv::local::ui::curses_out->GetMaxX()));
 
 #else
-    if (type == CommunicationType::NONE) {
+    if (!cmdline.sarg("fork_server").empty()) {
+      // The fork server template and the nodes forked from it never use curses.
+      reset_local_io(new NullLocalIO());
+    } else if (type == CommunicationType::NONE) {
       // We only want the localIO if we ran this locally at a terminal
       // and also not passed in from the telnet handler, etc.  On Windows
       // We always have a local console, so this is *NIX specific.
@@ -1004,6 +1025,29 @@ int Application::Run(int argc, char* argv[]) {
     return Application::exitLevelNotOK;
   }
 
+#if !defined(_WIN32) && !defined(__OS2__)
+  if (const auto fork_server = cmdline.sarg("fork_server"); !fork_server.empty()) {
+    const auto r = RunForkServer(fork_server);
+    if (!r) {
+      // This is the template exiting.
+      return oklevel_;
+    }
+    // This is now the forked node, handling a single caller.
+    start_time = steady_clock::now();
+    hSockOrComm = r->client_socket;
+    sess().instance_number(r->request.node_number);
+    set_environment_variable("WWIV_INSTANCE", std::to_string(sess().instance_number()));
+    set_remote_type(r->request.connection_type == 'S' ? 'S' : 'T');
+    if (!ReadInstanceConfig()) {
+      return Application::exitLevelNotOK;
+    }
+  }
+#endif
+
+  if (cmdline.barg("trace")) {
+    EnableTracing(config()->datadir(), StrCat("node", sess().instance_number()));
+  }
+
   const auto sysop_cmd = cmdline.sarg("sysop_cmd");
   const auto fsed = cmdline.sarg("fsed");
   const auto run_basic = cmdline.sarg("run_basic");
@@ -1032,6 +1076,10 @@ int Application::Run(int argc, char* argv[]) {
     std::clog << "Remote side disconnected." << std::endl;
     return oklevel_;
   }
+  if (type != CommunicationType::NONE) {
+    LOG(INFO) << "Node " << sess().instance_number() << " ready for caller after "
+              << duration_cast<milliseconds>(steady_clock::now() - start_time).count() << "ms";
+  }
 
   if (cmdline.barg("beginday")) {
     if (const auto status = status_manager()->get_status(); date() != status->last_date()) {
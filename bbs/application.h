@@ -27,6 +27,7 @@
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -64,6 +65,7 @@ class RemoteIO;
 }
 namespace core {
 class IniFile;
+struct accepted_fork_request_t;
 }
 namespace sdk {
 struct conference_t;
@@ -332,6 +334,19 @@ public:
   void ReadINIFile(wwiv::core::IniFile& ini); // from xinit.cpp
   bool ReadInstanceSettings(int instance_number);
   bool ReadConfig();
+  /** Re-reads the WWIV.INI settings and directories for the current instance number. */
+  bool ReadInstanceConfig();
+  /**
+   * Loads the read-only system configuration (networks, gfiles, names, subs, dirs,
+   * chains, protocols, archivers, editors and conferences).
+   */
+  bool LoadConfigData();
+  /**
+   * Runs as a pre-initialized template process that forks a child per node when
+   * asked by wwivd over the UNIX domain socket socket_path.  Returns the request
+   * in the forked child, or std::nullopt in the template when it is time to exit.
+   */
+  std::optional<wwiv::core::accepted_fork_request_t> RunForkServer(const std::string& socket_path);
 
   // Data from system_operation_rec, make it public for now, and add
   // accessors later on.
@@ -448,6 +463,9 @@ private:
   std::string network_extension_;
   bool user_already_on_{false};
   bool at_wfc_{false};
+  // True once LoadConfigData has run, either in this process or in the
+  // fork server template this node was forked from.
+  bool config_data_loaded_{false};
   // If true, then we are allowed to perform a shutdown on exit, if false it means the BBS
   // hasn't yet been started.
   bool shutdown_on_exit_allowed_{false};
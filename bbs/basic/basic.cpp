@@ -39,6 +39,9 @@
 
 #include <chrono>
 #include <cstdarg>
+#include <filesystem>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -79,6 +82,83 @@ static bool RegisterMyBasicGlobals() {
   return true;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Script cache
+
+namespace {
+
+// A parsed script.  Each run uses a fork of bas, which shares the parsed
+// program but gets its own variables, so bas itself is never run.
+struct cached_script_t {
+  cached_script_t(mb_interpreter_t* b, std::filesystem::file_time_type t) : bas(b), mtime(t) {}
+  ~cached_script_t() {
+    if (bas) {
+      mb_close(&bas);
+    }
+  }
+  cached_script_t(const cached_script_t&) = delete;
+  cached_script_t& operator=(const cached_script_t&) = delete;
+
+  mb_interpreter_t* bas;
+  const std::filesystem::file_time_type mtime;
+  // Held while a fork of bas is running.
+  std::mutex mu;
+};
+
+struct script_cache_t {
+  std::mutex mu;
+  std::map<std::filesystem::path, std::shared_ptr<cached_script_t>> scripts;
+  std::map<std::string, basic_script_stats_t> stats;
+};
+
+script_cache_t& script_cache() {
+  static script_cache_t cache;
+  return cache;
+}
+
+std::chrono::microseconds elapsed_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                               start);
+}
+
+void record_load(const std::string& module, std::chrono::microseconds t) {
+  VLOG(1) << "WWIVbasic: loaded '" << module << "' in " << t.count() << "us";
+  auto& cache = script_cache();
+  std::lock_guard lock(cache.mu);
+  auto& s = cache.stats[module];
+  ++s.loads;
+  s.load_time += t;
+}
+
+void record_run(const std::string& module, std::chrono::microseconds t, bool cache_hit) {
+  VLOG(1) << "WWIVbasic: ran '" << module << "' in " << t.count() << "us"
+          << (cache_hit ? " (cached)" : "");
+  auto& cache = script_cache();
+  std::lock_guard lock(cache.mu);
+  auto& s = cache.stats[module];
+  ++s.runs;
+  if (cache_hit) {
+    ++s.cache_hits;
+  }
+  s.run_time += t;
+  s.last_run_time = t;
+}
+
+} // namespace
+
+std::map<std::string, basic_script_stats_t> BasicScriptStats() {
+  auto& cache = script_cache();
+  std::lock_guard lock(cache.mu);
+  return cache.stats;
+}
+
+void ClearBasicScriptCache() {
+  auto& cache = script_cache();
+  std::lock_guard lock(cache.mu);
+  // Scripts that are running keep their entry alive until they finish.
+  cache.scripts.clear();
+}
+
 static std::optional<std::string> ReadBasicFile(wwiv::common::Output& out,
                                                 const std::filesystem::path& path,
                                                 const std::string& script_name) {
@@ -162,10 +242,15 @@ Basic::Basic(common::Input& i, common::Output& o, const sdk::Config& config, com
   [[maybe_unused]] static auto once = RegisterMyBasicGlobals();
 
   bas_ = SetupBasicInterpreter();
-  RegisterDefaultNamespaces();
+  RegisterDefaultNamespaces(bas_);
 }
 
 Basic::~Basic() {
+  if (bas_) {
+    // Only RunScript(module, text) closes bas_, scripts run from the cache
+    // do not use it.
+    mb_close(&bas_);
+  }
 }
 
 static std::string ScriptBaseName(const std::string& script_name) {
@@ -198,17 +283,17 @@ mb_interpreter_t* Basic::SetupBasicInterpreter() {
 }
 
 // ReSharper disable once CppMemberFunctionMayBeConst
-bool Basic::RegisterDefaultNamespaces() {
-  RegisterNamespaceWWIV(bas_);
-  RegisterNamespaceWWIVIO(bas_);
-  RegisterNamespaceData(bas_);
+bool Basic::RegisterDefaultNamespaces(mb_interpreter_t* bas) {
+  RegisterNamespaceWWIV(bas);
+  RegisterNamespaceWWIVIO(bas);
+  RegisterNamespaceData(bas);
   if (config_.script_package_file_enabled()) {
-    RegisterNamespaceWWIVFILE(bas_);
+    RegisterNamespaceWWIVFILE(bas);
   }
   if (config_.script_package_os_enabled()) {
-    RegisterNamespaceWWIVOS(bas_);
+    RegisterNamespaceWWIVOS(bas);
   }
-  RegisterNamespaceWWIVTIME(bas_);
+  RegisterNamespaceWWIVTIME(bas);
 
   return true;
 }
@@ -228,10 +313,12 @@ bool Basic::RunScript(const std::string& module, const std::string& text) {
   }
   mb_set_userdata(bas_, script_userdata_.get());
 
+  const auto load_start = std::chrono::steady_clock::now();
   if (mb_load_string(bas_, text.c_str(), true) != MB_FUNC_OK) {
     LOG(ERROR) << "Unable to load text: '" << text << "'";
     return false;
   }
+  record_load(m, elapsed_since(load_start));
 
   if (a()->sess().debug_wwivbasic()) {
     bout.pl("Waiting for debugger to attach...");
@@ -240,10 +327,12 @@ bool Basic::RunScript(const std::string& module, const std::string& text) {
     debugger()->WaitForDebuggerToAttach();
   }
 
-  static std::mutex script_mutex;
-  std::lock_guard<std::mutex> guard(script_mutex);
+  // bas_ belongs to this instance and runs on the caller's thread, so unlike
+  // the cached interpreters it needs no lock.
+  const auto run_start = std::chrono::steady_clock::now();
   const auto ret = mb_run(bas_, false);
   mb_close(&bas_);
+  record_run(m, elapsed_since(run_start), false);
 
   // We don't call mb_dispose since we only call mb_init once per execution.
   if (ret != MB_FUNC_OK) {
@@ -274,12 +363,92 @@ Debugger* Basic::debugger() {
   return debugger_.get();
 }
 
+std::optional<bool> Basic::RunCachedScript(const std::string& script_name,
+                                           const std::filesystem::path& path) {
+#ifdef MB_ENABLE_FORK
+  std::error_code ec;
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  const auto module = ToStringUpperCase(ScriptBaseName(script_name));
+  {
+    std::lock_guard lock(mu_);
+    script_userdata_->module = module;
+  }
+
+  auto& cache = script_cache();
+  std::shared_ptr<cached_script_t> script;
+  {
+    std::lock_guard lock(cache.mu);
+    if (const auto it = cache.scripts.find(path);
+        it != std::end(cache.scripts) && it->second->mtime == mtime) {
+      script = it->second;
+    }
+  }
+  const auto cache_hit = script != nullptr;
+  if (!cache_hit) {
+    const auto load_start = std::chrono::steady_clock::now();
+    const auto text = ReadBasicFile(bout_, path, script_name);
+    if (!text) {
+      return false;
+    }
+    auto* bas = SetupBasicInterpreter();
+    RegisterDefaultNamespaces(bas);
+    // Imports are loaded while parsing and need the script state.
+    mb_set_userdata(bas, script_userdata_.get());
+    script = std::make_shared<cached_script_t>(bas, mtime);
+    if (mb_load_string(bas, text->c_str(), true) != MB_FUNC_OK) {
+      LOG(ERROR) << "Unable to load script: " << path;
+      return false;
+    }
+    record_load(module, elapsed_since(load_start));
+    std::lock_guard lock(cache.mu);
+    cache.scripts[path] = script;
+  }
+
+  std::unique_lock run_lock(script->mu, std::try_to_lock);
+  if (!run_lock.owns_lock()) {
+    // This script is already running further up the stack, so give this
+    // run an interpreter of its own.
+    return std::nullopt;
+  }
+  mb_interpreter_t* forked = nullptr;
+  if (mb_fork(&forked, script->bas, true) != MB_FUNC_OK) {
+    return std::nullopt;
+  }
+  mb_set_userdata(forked, script_userdata_.get());
+  const auto run_start = std::chrono::steady_clock::now();
+  const auto ret = mb_run(forked, false);
+  mb_join(&forked);
+  record_run(module, elapsed_since(run_start), cache_hit);
+
+  if (ret != MB_FUNC_OK) {
+    LOG(INFO) << "Failure exiting script: '" << module << "' error code (MB_FUNC_XXXX) : " << ret;
+    return false;
+  }
+  return true;
+#else
+  return std::nullopt;
+#endif
+}
+
 bool Basic::RunScript(const std::string& script_name) {
   const auto path = FilePath(config_.scriptdir(), script_name);
   if (!File::Exists(path)) {
     bout_.print("|#6Unable to locate script: {}", script_name);
     return false;
   }
+  if (!config_.scripting_enabled()) {
+    bout_.outstr("WWIVbasic scripting is not enabled on this system.");
+    return false;
+  }
+  // The debugger needs the source of each module, so it always parses.
+  if (!a()->sess().debug_wwivbasic()) {
+    if (const auto r = RunCachedScript(script_name, path)) {
+      return r.value();
+    }
+  }
 
   const auto o = ReadBasicFile(bout_, path, script_name);
   if (!o) {
@@ -21,6 +21,9 @@
 #include "bbs/basic/util.h"
 #include "bbs/basic/debug_state.h"
 #include "bbs/basic/debugger.h"
+#include <chrono>
+#include <filesystem>
+#include <map>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -62,8 +65,12 @@ public:
   Debugger* debugger();
 
 private:
-  bool RegisterDefaultNamespaces();
+  bool RegisterDefaultNamespaces(mb_interpreter_t* bas);
   mb_interpreter_t* SetupBasicInterpreter();
+  // Runs script_name from the per-process cache of parsed scripts.  Returns
+  // std::nullopt if the cache can not be used for this run.
+  std::optional<bool> RunCachedScript(const std::string& script_name,
+                                      const std::filesystem::path& path);
   static bool LoadBasicFile(mb_interpreter_t* bas, const std::string& script_name);
 
   common::Input& bin_;
@@ -84,6 +91,28 @@ private:
 
 bool RunBasicScript(const std::string& script_name);
 
+/**
+ * Load (read and parse) and run timings for a script, accumulated over the
+ * life of this process.
+ */
+struct basic_script_stats_t {
+  // Number of times the script was read and parsed.
+  int loads{0};
+  // Number of times the script was run.
+  int runs{0};
+  // Number of runs that reused an already parsed copy of the script.
+  int cache_hits{0};
+  std::chrono::microseconds load_time{0};
+  std::chrono::microseconds run_time{0};
+  std::chrono::microseconds last_run_time{0};
+};
+
+/** Returns the timings of every script run by this process, keyed by module name. */
+std::map<std::string, basic_script_stats_t> BasicScriptStats();
+
+/** Closes every cached interpreter, forcing scripts to be parsed again. */
+void ClearBasicScriptCache();
+
 } // namespace wwiv::bbs
 
 #endif
@@ -23,15 +23,21 @@
 #include "bbs/basic/basic.h"
 #include "bbs/basic/util.h"
 #include "bbs/bbs_helper.h"
+#include "core/file.h"
 #include "core/log.h"
 #include "core/strings.h"
+#include "core/textfile.h"
 #include "core/version.h"
 #include "deps/my_basic/core/my_basic.h"
 #include "fmt/format.h"
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <string>
 
+using namespace std::chrono_literals;
 using namespace wwiv::bbs;
+using namespace wwiv::core;
 using namespace wwiv::common;
 using namespace wwiv::bbs::basic;
 using namespace wwiv::strings;
@@ -316,3 +322,34 @@ PrintList (lines)
   const auto actual = SplitString(helper.io()->captured(), "\r\n", true);
   EXPECT_THAT(actual, testing::ElementsAre("1", "2", "3"));
 }
+
+TEST_F(BasicTest, RunScript_Cached) {
+  ClearBasicScriptCache();
+  const auto dir = a()->config()->scriptdir();
+  ASSERT_TRUE(File::mkdirs(dir));
+  const auto path = FilePath(dir, "cached.bas");
+  {
+    TextFile f(path, "wt");
+    ASSERT_TRUE(f.IsOpen());
+    f.Write("wwiv.io.puts(\"Hello\")\n");
+  }
+
+  const auto before = BasicScriptStats()["CACHED"];
+  for (auto i = 0; i < 2; i++) {
+    Basic b(bin, bout, *a()->config(), &helper.context());
+    EXPECT_TRUE(b.RunScript("cached.bas"));
+  }
+  EXPECT_EQ("HelloHello", helper.io()->captured());
+  auto s = BasicScriptStats()["CACHED"];
+  EXPECT_EQ(before.loads + 1, s.loads);
+  EXPECT_EQ(before.runs + 2, s.runs);
+  EXPECT_EQ(before.cache_hits + 1, s.cache_hits);
+
+  // Changing the script forces it to be parsed again.
+  std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + 1s);
+  Basic b(bin, bout, *a()->config(), &helper.context());
+  EXPECT_TRUE(b.RunScript("cached.bas"));
+  s = BasicScriptStats()["CACHED"];
+  EXPECT_EQ(before.loads + 2, s.loads);
+  EXPECT_EQ(before.runs + 3, s.runs);
+}
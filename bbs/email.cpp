@@ -45,6 +45,7 @@
 #include "sdk/usermanager.h"
 #include "sdk/fido/fido_util.h"
 #include "sdk/fido/nodelist.h"
+#include "sdk/msgapi/email_index.h"
 #include "sdk/net/net.h"
 #include "sdk/net/networks.h"
 
@@ -61,6 +62,7 @@ using namespace wwiv::core;
 using namespace wwiv::os;
 using namespace wwiv::sdk;
 using namespace wwiv::sdk::net;
+using wwiv::sdk::msgapi::EmailIndex;
 using namespace wwiv::strings;
 
 // returns true on success (i.e. the message gets forwarded)
@@ -225,11 +227,15 @@ void sendout_email(EmailData& data) {
       }
     }
 
+    auto index = EmailIndex::LoadOrRebuild(file_email->path());
     file_email->Seek(i * sizeof(mailrec), File::Whence::begin);
     auto bytes_written = file_email->Write(&m, sizeof(mailrec));
     file_email->Close();
     if (bytes_written == -1) {
       bout.outstr("|#6DIDN'T SAVE RIGHT!\r\n");
+    } else {
+      index.Add(static_cast<int>(i), m);
+      index.Save(file_email->path());
     }
   } else {
     auto o = readfile(&m.msg, "email"); 
@@ -752,13 +758,17 @@ void delmail(File& f, size_t loc) {
       a()->users()->writeuser(&user, m.touser);
     }
   }
+  auto index = EmailIndex::LoadOrRebuild(f.path());
+  index.Remove(static_cast<int>(loc), m);
   f.Seek(loc * sizeof(mailrec), File::Whence::begin);
   m.touser = 0;
   m.tosys = 0;
   m.daten = 0xffffffff;
   m.msg.storage_type = 0;
   m.msg.stored_as = 0xffffffff;
-  f.Write(&m, sizeof(mailrec));
+  if (f.Write(&m, sizeof(mailrec)) == sizeof(mailrec)) {
+    index.Save(f.path());
+  }
 }
 
 std::string fixup_user_entered_email(const std::string& user_input) {
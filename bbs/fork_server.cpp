@@ -0,0 +1,120 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "bbs/fork_server.h"
+
+#include "bbs/application.h"
+#include "core/file.h"
+#include "core/fork_server.h"
+#include "core/log.h"
+#include "sdk/config.h"
+#include "sdk/filenames.h"
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <signal.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+
+namespace wwiv::bbs {
+
+ConfigFileWatcher::ConfigFileWatcher(std::vector<std::filesystem::path> files)
+    : files_(std::move(files)), times_(snapshot()) {}
+
+bool ConfigFileWatcher::changed() {
+  auto now = snapshot();
+  if (now == times_) {
+    return false;
+  }
+  times_ = std::move(now);
+  return true;
+}
+
+std::vector<std::filesystem::file_time_type> ConfigFileWatcher::snapshot() const {
+  std::vector<std::filesystem::file_time_type> times;
+  times.reserve(files_.size());
+  for (const auto& f : files_) {
+    std::error_code ec;
+    const auto t = std::filesystem::last_write_time(f, ec);
+    times.push_back(ec ? std::filesystem::file_time_type::min() : t);
+  }
+  return times;
+}
+
+} // namespace wwiv::bbs
+
+std::optional<accepted_fork_request_t> Application::RunForkServer(const std::string& socket_path) {
+  LOG(INFO) << "Starting fork server on: " << socket_path;
+  if (!LoadConfigData()) {
+    LOG(ERROR) << "Unable to load the BBS configuration.";
+    return std::nullopt;
+  }
+
+  const auto& datadir = config()->datadir();
+  wwiv::bbs::ConfigFileWatcher watcher({
+      config()->config_filename(), FilePath(bbspath(), WWIV_INI),
+      FilePath(datadir, NETWORKS_JSON), FilePath(datadir, "gfiles.json"),
+      FilePath(datadir, NAMES_LST), FilePath(datadir, SUBS_JSON), FilePath(datadir, DIRS_JSON),
+      FilePath(datadir, CHAINS_JSON), FilePath(datadir, NEXTERN_DAT),
+      FilePath(datadir, NINTERN_DAT), FilePath(datadir, ARCHIVER_DAT),
+      FilePath(datadir, EDITORS_DAT), FilePath(datadir, "conference.json")});
+
+  ForkServer server(socket_path);
+  if (!server.Listen()) {
+    return std::nullopt;
+  }
+  // Let the kernel reap the nodes, wwivd waits on them through the control connection.
+  signal(SIGCHLD, SIG_IGN);
+
+  for (;;) {
+    if (watcher.changed()) {
+      // Check between requests so callers don't pay for the reload.
+      LOG(INFO) << "Configuration changed; reloading.";
+      if (!ReadConfig() || !LoadConfigData()) {
+        LOG(ERROR) << "Unable to reload the BBS configuration; fork server exiting.";
+        server.Close(true);
+        return std::nullopt;
+      }
+      // Loading chains may have rewritten chains.json.
+      watcher.changed();
+    }
+    auto r = server.Accept(1s);
+    if (!r) {
+      continue;
+    }
+    VLOG(1) << "Fork request for node: " << r->request.node_number;
+    const auto pid = fork();
+    if (pid == 0) {
+      // Child, this is now the node handling the caller.
+      server.Close(false);
+      signal(SIGCHLD, SIG_DFL);
+      return r;
+    }
+    if (pid < 0) {
+      LOG(ERROR) << "Unable to fork node: " << r->request.node_number << "; errno: " << errno;
+    } else if (!SendForkResponse(r->control_fd, pid)) {
+      LOG(ERROR) << "Unable to send fork response for node: " << r->request.node_number;
+    }
+    // The child owns these now.
+    close(r->control_fd);
+    closesocket(r->client_socket);
+  }
+}
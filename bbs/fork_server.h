@@ -1,7 +1,7 @@
 /**************************************************************************/
 /*                                                                        */
 /*                              WWIV Version 5.x                          */
-/*             Copyright (C)1998-2022, WWIV Software Services             */
+/*                Copyright (C)2022, WWIV Software Services               */
 /*                                                                        */
 /*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
 /*    you may not use this  file  except in compliance with the License.  */
@@ -16,38 +16,35 @@
 /*    language governing permissions and limitations under the License.   */
 /*                                                                        */
 /**************************************************************************/
-#include "bbs/qwk/qwk_util.h"
+#ifndef INCLUDED_BBS_FORK_SERVER_H
+#define INCLUDED_BBS_FORK_SERVER_H
 
-namespace wwiv::bbs::qwk {
+#include <filesystem>
+#include <vector>
 
-int _fieeetomsbin(float *src4, float *dest4) {
-  auto* ieee = reinterpret_cast<unsigned char*>(src4);
-  auto* msbin = reinterpret_cast<unsigned char*>(dest4);
-  unsigned char msbin_exp = 0x00;
+namespace wwiv::bbs {
 
-  /* See _fmsbintoieee() for details of formats   */
-  const unsigned char sign = ieee[3] & 0x80;
-  msbin_exp |= ieee[3] << 1;
-  msbin_exp |= ieee[2] >> 7;
+/**
+ * Tracks the last write times of the configuration files preloaded by the
+ * fork server template, so that it knows when they need to be reloaded.
+ */
+class ConfigFileWatcher final {
+public:
+  explicit ConfigFileWatcher(std::vector<std::filesystem::path> files);
 
-  /* An ieee exponent of 0xfe overflows in MBF    */
-  if (msbin_exp == 0xfe) {
-    return 1;
-  }
+  /**
+   * Returns true if any of the files have been modified, created or deleted
+   * since the previous call (or construction).
+   */
+  bool changed();
 
-  msbin_exp += 2;     /* actually, -127 + 128 + 1 */
+private:
+  [[nodiscard]] std::vector<std::filesystem::file_time_type> snapshot() const;
 
-  for (auto i = 0; i < 4; i++) {
-    msbin[i] = 0;
-  }
+  const std::vector<std::filesystem::path> files_;
+  std::vector<std::filesystem::file_time_type> times_;
+};
 
-  msbin[3] = msbin_exp;
-  msbin[2] |= sign;
-  msbin[2] |= ieee[2] & 0x7f;
-  msbin[1] = ieee[1];
-  msbin[0] = ieee[0];
+} // namespace wwiv::bbs
 
-  return 0;
-}
-
-}
\ No newline at end of file
+#endif
@@ -36,6 +36,7 @@
 #include "bbs/readmail.h"
 #include "bbs/shortmsg.h"
 #include "bbs/stuffin.h"
+#include "bbs/subacc.h"
 #include "bbs/sysoplog.h"
 #include "bbs/trashcan.h"
 #include "bbs/utility.h"
@@ -53,6 +54,8 @@
 #include "core/scope_exit.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/textfile.h"
+#include "core/trace.h"
 #include "core/version.h"
 #include "fmt/printf.h"
 #include "local_io/wconstants.h"
@@ -960,6 +963,18 @@ void logoff() {
   const auto min_used = std::chrono::duration_cast<std::chrono::minutes>(used_this_session);
   sysoplog(false, fmt::format("Read: {}   Time on: {} minutes.", a()->GetNumMessagesReadThisLogon(),
                               min_used.count()));
+  if (const auto& w = post_window_stats(); w.hits + w.misses > 0) {
+    VLOG(1) << "Post header window: hits: " << w.hits << "; misses: " << w.misses
+            << "; syscalls saved: " << w.syscalls_saved;
+  }
+  if (tracing_enabled()) {
+    // Keep the spans from this session for loading into chrome://tracing.
+    const auto trace_fn = FilePath(a()->config()->logdir(),
+                                   fmt::format("trace.{}.json", a()->sess().instance_number()));
+    TextFile trace_file(trace_fn, "wt");
+    trace_file.Write(to_chrome_trace_json(trace_spans(), get_pid()));
+    clear_trace_spans();
+  }
   {
     if (auto file_email(OpenEmailFile(true)); file_email->IsOpen()) {
       a()->user()->email_waiting(0);
@@ -993,9 +1008,7 @@ void logoff() {
       }
       file_email->Close();
       file_email->set_length(static_cast<long>(sizeof(mailrec)) * static_cast<long>(w));
-      a()->status_manager()->Run([](Status& s) {
-        s.increment_filechanged(Status::file_change_email);
-      });
+      a()->status_manager()->increment_filechanged(Status::file_change_email);
     }
   }
   if (received_short_message()) {
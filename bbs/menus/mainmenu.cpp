@@ -27,7 +27,6 @@
 #include "bbs/menus/config_menus.h"
 #include "bbs/menus/menucommands.h"
 #include "common/printfile.h"
-#include "common/menus/menu_generator.h"
 #include "common/value/bbsvalueprovider.h"
 #include "common/value/uservalueprovider.h"
 #include "core/strings.h"
@@ -38,7 +37,6 @@
 #include <string>
 
 using namespace wwiv::core;
-using namespace wwiv::common::menus;
 using namespace wwiv::sdk;
 using namespace wwiv::strings;
 using namespace wwiv::sdk::menus;
@@ -147,25 +145,13 @@ void mainmenu() {
 Menu::Menu(const std::filesystem::path& menu_path, const MenuSet56& menu_set,
            const std::string& menu_name)
     : menu_set_name_(menu_set.menu_set.name), menu_name_(menu_name),
-      menu_set_(menu_set),  menu_(menu_path, menu_set, menu_name) {
-
+      menu_set_(menu_set), compiled_(menu_cache().Get(menu_path, menu_set, menu_name)) {
   menu_set_path_ = menu_set_.menuset_dir();
-  prompt_ = "|09Command? ";
-
-  // Load Prompt;
-  const auto prompt_filename = StrCat(menu_name, ".pro");
-  const auto prompt_path = FilePath(menu_set_path_, prompt_filename);
+}
 
-  TextFile prompt_file(prompt_path, "rb");
-  if (prompt_file.IsOpen()) {
-    const auto tmp = prompt_file.ReadFileIntoString();
-    const auto end = tmp.find(".end.");
-    if (end != std::string::npos) {
-      prompt_ = tmp.substr(0, end);
-    } else {
-      prompt_ = tmp;
-    }
-  }
+const menu_56_t& Menu::menu() const noexcept {
+  static const menu_56_t empty_menu{};
+  return compiled_ ? compiled_->menu : empty_menu;
 }
 
 void Menu::DisplayMenu() {
@@ -213,57 +199,43 @@ static bool IsNumber(const std::string& command) {
   return true;
 }
 
-std::optional<menu_item_56_t> Menu::GetMenuItemForCommand(const std::string& cmd) const {
+const compiled_menu_item_t* Menu::GetMenuItemForCommand(const std::string& cmd) {
+  if (!compiled_) {
+    return nullptr;
+  }
   const auto nums = menu().num_action;
   if (IsNumber(cmd) && nums != menu_numflag_t::none) {
-    if (nums == menu_numflag_t::subs) {
-      menu_item_56_t i{};
-      menu_action_56_t a{"SetSubNumber", cmd, ""};
-      i.actions.emplace_back(a);
-      return {i};
-    }
-    if (nums == menu_numflag_t::dirs) {
-      menu_item_56_t i{};
-      menu_action_56_t a{"SetDirNumber", cmd, ""};
-      i.actions.emplace_back(a);
-      return {i};
-    }
-  }
-
-  for (const auto& mi : menu().items) {
-    if (cmd == mi.item_key) {
-      return {mi};
-    }
-  }
-
-  // Check global items.
-  for (const auto& mi : menu_set_.menu_set.items) {
-    if (cmd == mi.item_key) {
-      return {mi};
-    }
+    const auto* command = nums == menu_numflag_t::subs ? "SetSubNumber" : "SetDirNumber";
+    menu_action_56_t a{command, cmd, ""};
+    number_item_ = compiled_menu_item_t{};
+    number_item_.item.actions.emplace_back(a);
+    number_item_.actions.push_back(compiled_menu_action_t{a, find_menu_command(a.cmd)});
+    return &number_item_;
   }
 
-  return std::nullopt;
+  // Includes the global items from the menu set.
+  return compiled_->item_for_key(cmd);
 }
 
-std::tuple<menu_command_action_t, std::string> Menu::ExecuteAction(const menu_action_56_t& a) {
-  if (auto o = interpret_command(this, a.cmd, a.data)) {
-    auto& ctx = o.value();
-    if (ctx.menu_action == menu_command_action_t::return_from_menu) {
-      return std::make_tuple(menu_command_action_t::return_from_menu, "");
-    }
-    if (ctx.menu_action == menu_command_action_t::push_menu) {
-      return std::make_tuple(menu_command_action_t::push_menu, a.data);
-    }
+std::tuple<menu_command_action_t, std::string> Menu::ExecuteAction(const compiled_menu_action_t& a) {
+  if (a.command == nullptr) {
+    return std::make_tuple(menu_command_action_t::none, "");
+  }
+  const auto ctx = run_menu_command(this, *a.command, a.action.data);
+  if (ctx.menu_action == menu_command_action_t::return_from_menu) {
+    return std::make_tuple(menu_command_action_t::return_from_menu, "");
+  }
+  if (ctx.menu_action == menu_command_action_t::push_menu) {
+    return std::make_tuple(menu_command_action_t::push_menu, a.action.data);
   }
   return std::make_tuple(menu_command_action_t::none, "");
 }
 
 std::tuple<menu_command_action_t, std::string>
-Menu::ExecuteActions(const std::vector<menu_action_56_t>& actions) {
+Menu::ExecuteActions(const std::vector<compiled_menu_action_t>& actions) {
   for (const auto& action : actions) {
     auto [a, d] = ExecuteAction(action);
-    VLOG(1) << "Action: " << action.cmd << "; " << action.data;
+    VLOG(1) << "Action: " << action.action.cmd << "; " << action.action.data;
     if (a == menu_command_action_t::push_menu) {
       return std::make_tuple(menu_command_action_t::push_menu, d);
     }
@@ -276,10 +248,10 @@ Menu::ExecuteActions(const std::vector<menu_action_56_t>& actions) {
 
 std::tuple<menu_run_result_t, std::string> Menu::Run() {
   const auto menu_set = a()->user()->menu_set();
-  if (!menu_.initialized()) {
+  if (!compiled_) {
     return std::make_tuple(menu_run_result_t::error, "");
   }
-  if (!check_acs(menu().acs)) {
+  if (!check_acs(compiled_->acs)) {
     sysoplog("Insufficient ACS for menu.");
     bout.print("|#6Insufficient ACS for menu: {}\r\n", menu().title);
     return std::make_tuple(menu_run_result_t::error, "");
@@ -291,7 +263,7 @@ std::tuple<menu_run_result_t, std::string> Menu::Run() {
 
   {
     // Process entrance actions.
-    auto [a, d] = ExecuteActions(menu().enter_actions);
+    auto [a, d] = ExecuteActions(compiled_->enter_actions);
     if (a == menu_command_action_t::push_menu) {
       return std::make_tuple(menu_run_result_t::push_menu, d);
     }
@@ -315,31 +287,31 @@ std::tuple<menu_run_result_t, std::string> Menu::Run() {
     }
     const auto save_mci = bout.mci_enabled();
     bout.enable_mci();
-    bout.outstr(prompt_);
+    bout.outstr(compiled_->prompt);
     bout.set_mci_enabled(save_mci);
     // Do actions on enter.
 
     auto cmd = GetCommandFromUser();
     // Reset menu displayed
     menu_displayed_ = false;
-    if (auto omi = GetMenuItemForCommand(cmd)) {
-      const auto& mi = omi.value();
-      if (!check_acs(mi.acs)) {
+    if (const auto* cmi = GetMenuItemForCommand(cmd)) {
+      const auto& mi = cmi->item;
+      if (!check_acs(cmi->acs)) {
         sysoplog(fmt::format("Insufficient ACS for menu item: {}", mi.item_key));
         bout.print("|#6Insufficient ACS for menu item: {}\r\n", mi.item_key);
         continue;
       }
       VLOG(1) << "Command is: " << cmd << "; " << mi.item_key;
       log_command(menu().logging_action, mi);
-      auto [action, d] = ExecuteActions(mi.actions);
+      auto [action, d] = ExecuteActions(cmi->actions);
       if (action == menu_command_action_t::push_menu) {
         // No push or pop allowed in exit actions
-        (void) ExecuteActions(menu().exit_actions);
+        (void) ExecuteActions(compiled_->exit_actions);
         return std::make_tuple(menu_run_result_t::push_menu, d);
       }
       if (action == menu_command_action_t::return_from_menu) {
         // No push or pop allowed in exit actions
-        (void) ExecuteActions(menu().exit_actions);
+        (void) ExecuteActions(compiled_->exit_actions);
         return std::make_tuple(menu_run_result_t::return_from_menu, "");
       }
       if (reload || !iequals(menu_set, a()->user()->menu_set())) {
@@ -369,11 +341,19 @@ void Menu::GenerateMenu(menu_type_t typ) {
 
 
 std::vector<std::string> Menu::GenerateMenuAsLines(menu_type_t typ) {
+  if (!compiled_) {
+    return {};
+  }
   const common::value::UserValueProvider up(a()->context());
   const common::value::BbsValueProvider bp(*a()->config(), a()->sess());
   const std::vector<const wwiv::sdk::value::ValueProvider*> providers{&up, &bp};
-  return GenerateMenuLines(*a()->config(), menu_set_, menu(), *a()->user(),
-                           providers, typ);
+  // Only the ACS depends on the user, the rest of the menu is generated once.
+  std::vector<bool> visible;
+  for (const auto i : compiled_->generated_items) {
+    auto [result, debug_lines] = compiled_->items.at(i).acs.check(providers);
+    visible.push_back(result);
+  }
+  return compiled_->GenerateMenuLines(a()->user()->screen_width(), typ, visible);
 }
 
 
@@ -20,10 +20,12 @@
 #define INCLUDED_MENUS_MAINMENU_H
 
 #include "menucommands.h"
+#include "bbs/menus/menu_cache.h"
 #include "sdk/menus/menu.h"
 #include "sdk/menus/menu_set.h"
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -55,21 +57,21 @@ public:
   Menu(const std::filesystem::path& menu_path, const wwiv::sdk::menus::MenuSet56& menu_set,
                const std::string& menu_name);
   ~Menu() = default;
-  [[nodiscard]] bool initalized() const { return menu_.initialized(); }
+  [[nodiscard]] bool initalized() const { return compiled_ != nullptr; }
   // Gets the command string from the user for this menu.
   [[nodiscard]] std::string GetCommandFromUser() const;
-  [[nodiscard]] std::optional<wwiv::sdk::menus::menu_item_56_t>
-  GetMenuItemForCommand(const std::string& cmd) const;
+  // Returns the menu item for cmd, or nullptr if there is none.
+  [[nodiscard]] const compiled_menu_item_t* GetMenuItemForCommand(const std::string& cmd);
   void DisplayMenu();
   // Generates the short form (multi-column) or long form (single col, help text) menu.
   [[nodiscard]] std::vector<std::string> GenerateMenuAsLines(sdk::menus::menu_type_t typ);
   // Generates the short form (multi-column) or long form (single col, help text) menu.
   void GenerateMenu(sdk::menus::menu_type_t typ);
-  [[nodiscard]] const sdk::menus::menu_56_t& menu() const noexcept { return menu_.menu; }
+  [[nodiscard]] const sdk::menus::menu_56_t& menu() const noexcept;
   [[nodiscard]] std::tuple<menu_command_action_t, std::string>
-  ExecuteAction(const sdk::menus::menu_action_56_t& a);
+  ExecuteAction(const compiled_menu_action_t& a);
   [[nodiscard]] std::tuple<menu_command_action_t, std::string>
-  ExecuteActions(const std::vector<wwiv::sdk::menus::menu_action_56_t>& actions);
+  ExecuteActions(const std::vector<compiled_menu_action_t>& actions);
   [[nodiscard]] std::tuple<menu_run_result_t, std::string> Run();
 
   bool reload{false}; /* true if we are going to reload the menus */
@@ -79,9 +81,11 @@ private:
   const std::string menu_set_name_;
   const std::string menu_name_;
   const wwiv::sdk::menus::MenuSet56 menu_set_;
-  sdk::menus::Menu56 menu_;
+  // Shared with every other Menu for the same menu, see MenuCache.
+  std::shared_ptr<const CompiledMenu> compiled_;
   std::filesystem::path menu_set_path_;
-  std::string prompt_;
+  // Item for a sub or dir number typed at the menu.
+  compiled_menu_item_t number_item_;
 };
 
 class MainMenu {
@@ -0,0 +1,169 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "bbs/menus/menu_cache.h"
+
+#include "common/menus/menu_generator.h"
+#include "core/file.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "core/textfile.h"
+
+#include <system_error>
+#include <utility>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk::menus;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+
+namespace wwiv::bbs::menus {
+
+// Generated menus kept per CompiledMenu, one for each screen width, menu type
+// and set of visible items seen.
+static constexpr int kMaxGeneratedMenus = 32;
+
+static std::vector<compiled_menu_action_t> compile_actions(const std::vector<menu_action_56_t>& actions) {
+  std::vector<compiled_menu_action_t> out;
+  out.reserve(actions.size());
+  for (const auto& a : actions) {
+    out.push_back(compiled_menu_action_t{a, find_menu_command(a.cmd)});
+  }
+  return out;
+}
+
+static compiled_menu_item_t compile_item(const menu_item_56_t& mi) {
+  return compiled_menu_item_t{mi, sdk::acs::CompiledAcs(mi.acs), compile_actions(mi.actions)};
+}
+
+CompiledMenu::CompiledMenu(menu_56_t m, const MenuSet56& menu_set, std::string p)
+    : menu(std::move(m)), prompt(std::move(p)), acs(menu.acs),
+      enter_actions(compile_actions(menu.enter_actions)),
+      exit_actions(compile_actions(menu.exit_actions)) {
+  std::map<const menu_item_56_t*, int> index;
+  for (const auto& mi : menu.items) {
+    index.emplace(&mi, size_int(items));
+    items.push_back(compile_item(mi));
+  }
+  for (const auto& mi : menu_set.menu_set.items) {
+    index.emplace(&mi, size_int(items));
+    items.push_back(compile_item(mi));
+  }
+  for (auto i = 0; i < size_int(items); i++) {
+    // The menu's own items are first, so they win over global ones.
+    keys_.emplace(items.at(i).item.item_key, i);
+  }
+  for (const auto* mi : common::menus::GeneratedMenuItems(menu_set, menu)) {
+    generated_items.push_back(index.at(mi));
+  }
+}
+
+const compiled_menu_item_t* CompiledMenu::item_for_key(const std::string& key) const {
+  if (const auto it = keys_.find(key); it != keys_.end()) {
+    return &items.at(it->second);
+  }
+  return nullptr;
+}
+
+std::vector<std::string> CompiledMenu::GenerateMenuLines(int screen_width, menu_type_t typ,
+                                                         const std::vector<bool>& visible) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto key = std::make_tuple(screen_width, typ, visible);
+  if (const auto it = lines_.find(key); it != lines_.end()) {
+    return it->second;
+  }
+  std::vector<const menu_item_56_t*> shown;
+  for (auto i = 0; i < size_int(generated_items) && i < size_int(visible); i++) {
+    if (visible[i]) {
+      shown.push_back(&items.at(generated_items[i]).item);
+    }
+  }
+  auto lines = common::menus::GenerateMenuLines(menu, shown, screen_width, typ);
+  if (size_int(lines_) >= kMaxGeneratedMenus) {
+    lines_.clear();
+  }
+  lines_.emplace(std::move(key), lines);
+  return lines;
+}
+
+static std::string load_prompt(const std::filesystem::path& path) {
+  TextFile prompt_file(path, "rb");
+  if (!prompt_file.IsOpen()) {
+    return "|09Command? ";
+  }
+  const auto tmp = prompt_file.ReadFileIntoString();
+  if (const auto end = tmp.find(".end."); end != std::string::npos) {
+    return tmp.substr(0, end);
+  }
+  return tmp;
+}
+
+MenuCache::file_stamp_t MenuCache::stamp(const std::filesystem::path& path) {
+  std::error_code ec;
+  file_stamp_t s{};
+  s.mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return {};
+  }
+  s.size = std::filesystem::file_size(path, ec);
+  return s;
+}
+
+std::shared_ptr<const CompiledMenu> MenuCache::Get(const std::filesystem::path& menu_dir,
+                                                   const MenuSet56& menu_set,
+                                                   const std::string& menu_name) {
+  const auto menu_path =
+      FilePath(FilePath(menu_dir, menu_set.menu_set.name), StrCat(menu_name, ".mnu.json"));
+  const auto prompt_path = FilePath(menu_set.menuset_dir(), StrCat(menu_name, ".pro"));
+  // Stamp before loading, so an edit made while loading is seen next time.
+  const std::vector<file_stamp_t> stamps{
+      stamp(menu_path), stamp(prompt_path), stamp(FilePath(menu_set.menuset_dir(), "menuset.json"))};
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (const auto it = entries_.find(menu_path); it != entries_.end() && it->second.stamps == stamps) {
+      return it->second.menu;
+    }
+  }
+
+  Menu56 m(menu_dir, menu_set, menu_name);
+  std::lock_guard<std::mutex> lock(mu_);
+  if (!m.initialized()) {
+    entries_.erase(menu_path);
+    return nullptr;
+  }
+  auto compiled = std::make_shared<const CompiledMenu>(std::move(m.menu), menu_set, load_prompt(prompt_path));
+  entries_.insert_or_assign(menu_path, entry_t{stamps, compiled});
+  return compiled;
+}
+
+void MenuCache::clear() {
+  std::lock_guard<std::mutex> lock(mu_);
+  entries_.clear();
+}
+
+int MenuCache::size() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return size_int(entries_);
+}
+
+MenuCache& menu_cache() {
+  static MenuCache cache;
+  return cache;
+}
+
+} // namespace wwiv::bbs::menus
@@ -0,0 +1,125 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_BBS_MENUS_MENU_CACHE_H
+#define INCLUDED_BBS_MENUS_MENU_CACHE_H
+
+#include "bbs/menus/menucommands.h"
+#include "sdk/acs/acs.h"
+#include "sdk/menus/menu.h"
+#include "sdk/menus/menu_set.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace wwiv::bbs::menus {
+
+/** A menu action with its command already looked up. */
+struct compiled_menu_action_t {
+  sdk::menus::menu_action_56_t action;
+  /** Null if action.cmd is not a menu command. */
+  const MenuItem* command{nullptr};
+};
+
+struct compiled_menu_item_t {
+  sdk::menus::menu_item_56_t item;
+  sdk::acs::CompiledAcs acs;
+  std::vector<compiled_menu_action_t> actions;
+};
+
+/**
+ * Everything about a menu that doesn't depend on the user: the menu and
+ * prompt as loaded from disk, the command for each action, the parsed ACS
+ * expressions and the generated menu text.  Shared by every Menu using it.
+ */
+class CompiledMenu final {
+public:
+  CompiledMenu(sdk::menus::menu_56_t m, const sdk::menus::MenuSet56& menu_set, std::string p);
+
+  /** Returns the menu or menu set item for key, or nullptr if there is none. */
+  [[nodiscard]] const compiled_menu_item_t* item_for_key(const std::string& key) const;
+
+  /**
+   * Returns the generated menu for a screen width, where visible says which
+   * of generated_items are allowed by the user's ACS.
+   */
+  [[nodiscard]] std::vector<std::string> GenerateMenuLines(int screen_width,
+                                                           sdk::menus::menu_type_t typ,
+                                                           const std::vector<bool>& visible) const;
+
+  const sdk::menus::menu_56_t menu;
+  const std::string prompt;
+  const sdk::acs::CompiledAcs acs;
+  std::vector<compiled_menu_action_t> enter_actions;
+  std::vector<compiled_menu_action_t> exit_actions;
+  /** Menu items followed by the menu set's global items. */
+  std::vector<compiled_menu_item_t> items;
+  /** Indexes into items that may be shown in the generated menu, in order. */
+  std::vector<int> generated_items;
+
+private:
+  std::map<std::string, int> keys_;
+  mutable std::mutex mu_;
+  mutable std::map<std::tuple<int, sdk::menus::menu_type_t, std::vector<bool>>,
+                   std::vector<std::string>>
+      lines_;
+};
+
+/**
+ * Process wide cache of CompiledMenus by path.  An entry is reused for as long
+ * as the menu, its prompt and the menu set are unchanged on disk.
+ */
+class MenuCache final {
+public:
+  MenuCache() = default;
+
+  /** Returns the menu, or nullptr if it can not be loaded. */
+  [[nodiscard]] std::shared_ptr<const CompiledMenu> Get(const std::filesystem::path& menu_dir,
+                                                        const sdk::menus::MenuSet56& menu_set,
+                                                        const std::string& menu_name);
+  void clear();
+  [[nodiscard]] int size() const;
+
+private:
+  struct file_stamp_t {
+    std::filesystem::file_time_type mtime{};
+    uintmax_t size{0};
+    bool operator==(const file_stamp_t& o) const { return mtime == o.mtime && size == o.size; }
+  };
+  struct entry_t {
+    std::vector<file_stamp_t> stamps;
+    std::shared_ptr<const CompiledMenu> menu;
+  };
+  static file_stamp_t stamp(const std::filesystem::path& path);
+
+  mutable std::mutex mu_;
+  std::map<std::filesystem::path, entry_t> entries_;
+};
+
+/** The MenuCache shared by every Menu in this process. */
+MenuCache& menu_cache();
+
+} // namespace wwiv::bbs::menus
+
+#endif
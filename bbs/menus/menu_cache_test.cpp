@@ -0,0 +1,156 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "bbs/menus/menu_cache.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "core/test/file_helper.h"
+#include "core/textfile.h"
+#include "sdk/menus/menu.h"
+#include "sdk/menus/menu_set.h"
+
+#include <string>
+
+using namespace wwiv::bbs::menus;
+using namespace wwiv::core;
+using namespace wwiv::sdk::menus;
+using namespace wwiv::strings;
+
+class MenuCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(helper.Mkdir("menus"));
+    ASSERT_TRUE(helper.Mkdir("menus/wwiv"));
+    menu_dir = helper.Dir("menus");
+    menu_set = MenuSet56(FilePath(menu_dir, "wwiv"));
+    menu_set.menu_set.items.push_back(item("G", "Global", "Goodbye"));
+    menu_set.menu_set.items.push_back(item("Q", "Global Quit", "Goodbye"));
+    ASSERT_TRUE(menu_set.Save());
+    WriteMenu("First");
+  }
+
+  static menu_item_56_t item(const std::string& key, const std::string& text,
+                             const std::string& cmd) {
+    menu_item_56_t mi{};
+    mi.item_key = key;
+    mi.item_text = text;
+    mi.actions.push_back(menu_action_56_t{cmd, "", ""});
+    return mi;
+  }
+
+  void WriteMenu(const std::string& title) const {
+    Menu56 m(menu_dir, menu_set, "main");
+    m.menu = {};
+    m.menu.title = title;
+    m.menu.items.push_back(item("Q", "Quit", "ReturnFromMenu"));
+    m.menu.items.push_back(item("X", "Unknown", "NoSuchMenuCommand"));
+    auto hidden = item("H", "Hidden", "ReturnFromMenu");
+    hidden.visible = false;
+    m.menu.items.push_back(hidden);
+    ASSERT_TRUE(m.Save());
+  }
+
+  wwiv::core::test::FileHelper helper;
+  std::filesystem::path menu_dir;
+  MenuSet56 menu_set;
+  MenuCache cache;
+};
+
+TEST_F(MenuCacheTest, NotFound) {
+  EXPECT_EQ(nullptr, cache.Get(menu_dir, menu_set, "nosuchmenu"));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(MenuCacheTest, Cached) {
+  const auto m = cache.Get(menu_dir, menu_set, "main");
+  ASSERT_NE(nullptr, m);
+  EXPECT_EQ("First", m->menu.title);
+  EXPECT_EQ(m, cache.Get(menu_dir, menu_set, "main"));
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(MenuCacheTest, MenuEdited) {
+  const auto m = cache.Get(menu_dir, menu_set, "main");
+  ASSERT_NE(nullptr, m);
+
+  WriteMenu("Second");
+  const auto m2 = cache.Get(menu_dir, menu_set, "main");
+  ASSERT_NE(nullptr, m2);
+  EXPECT_NE(m, m2);
+  EXPECT_EQ("Second", m2->menu.title);
+  // Menus already in use keep the old one.
+  EXPECT_EQ("First", m->menu.title);
+}
+
+TEST_F(MenuCacheTest, MenuDeleted) {
+  ASSERT_NE(nullptr, cache.Get(menu_dir, menu_set, "main"));
+  ASSERT_TRUE(File::Remove(FilePath(FilePath(menu_dir, "wwiv"), "main.mnu.json")));
+  EXPECT_EQ(nullptr, cache.Get(menu_dir, menu_set, "main"));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(MenuCacheTest, Prompt) {
+  EXPECT_EQ("|09Command? ", cache.Get(menu_dir, menu_set, "main")->prompt);
+
+  helper.CreateTempFile("menus/wwiv/main.pro", "Go ahead: .end.\r\nignored");
+  EXPECT_EQ("Go ahead: ", cache.Get(menu_dir, menu_set, "main")->prompt);
+
+  helper.CreateTempFile("menus/wwiv/main.pro", "Next? ");
+  EXPECT_EQ("Next? ", cache.Get(menu_dir, menu_set, "main")->prompt);
+}
+
+TEST_F(MenuCacheTest, Commands) {
+  const auto m = cache.Get(menu_dir, menu_set, "main");
+  ASSERT_NE(nullptr, m);
+
+  const auto* q = m->item_for_key("Q");
+  ASSERT_NE(nullptr, q);
+  // The menu's own item wins over the global one.
+  EXPECT_EQ("Quit", q->item.item_text);
+  ASSERT_EQ(1u, q->actions.size());
+  ASSERT_NE(nullptr, q->actions.front().command);
+  EXPECT_EQ("ReturnFromMenu", q->actions.front().command->cmd_);
+
+  const auto* x = m->item_for_key("X");
+  ASSERT_NE(nullptr, x);
+  EXPECT_EQ(nullptr, x->actions.front().command);
+
+  const auto* g = m->item_for_key("G");
+  ASSERT_NE(nullptr, g);
+  EXPECT_EQ("Global", g->item.item_text);
+
+  EXPECT_EQ(nullptr, m->item_for_key("Z"));
+}
+
+TEST_F(MenuCacheTest, GenerateMenuLines) {
+  const auto m = cache.Get(menu_dir, menu_set, "main");
+  ASSERT_NE(nullptr, m);
+  // Q, X and G; H is hidden and the global Q is replaced by the menu's.
+  ASSERT_EQ(3u, m->generated_items.size());
+
+  const auto all = JoinStrings(m->GenerateMenuLines(80, menu_type_t::short_menu, {true, true, true}), "\n");
+  EXPECT_NE(std::string::npos, all.find("Unknown"));
+  EXPECT_NE(std::string::npos, all.find("Global"));
+  EXPECT_EQ(std::string::npos, all.find("Hidden"));
+
+  const auto some = JoinStrings(m->GenerateMenuLines(80, menu_type_t::short_menu, {true, false, true}), "\n");
+  EXPECT_EQ(std::string::npos, some.find("Unknown"));
+  EXPECT_NE(std::string::npos, some.find("Global"));
+}
@@ -39,12 +39,14 @@
 #include "common/output.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/trace.h"
 #include <functional>
 #include <map>
 #include <string>
 #include <utility>
 
 using wwiv::core::IniFile;
+using wwiv::core::TraceSpan;
 
 using namespace wwiv::sdk;
 using namespace wwiv::strings;
@@ -71,19 +73,32 @@ static const std::string MENU_CAT_USER = "User";
 
 std::optional<MenuContext> interpret_command(Menu* menu, const std::string& cmd,
                                             const std::string& data) {
+  if (const auto* command = find_menu_command(cmd)) {
+    return {run_menu_command(menu, *command, data)};
+  }
+  return std::nullopt;
+}
+
+const MenuItem* find_menu_command(const std::string& cmd) {
   if (cmd.empty()) {
-    return std::nullopt;
+    return nullptr;
   }
+  static const auto functions = CreateCommandMap();
+  if (const auto it = functions.find(cmd); it != functions.end()) {
+    return &it->second;
+  }
+  return nullptr;
+}
 
-  if (static auto functions = CreateCommandMap(); contains(functions, cmd)) {
-    MenuContext context(menu, data);
-    at(functions, cmd).f_(context);
-    if (menu) {
-      menu->reload = context.need_reload;
-    }
-    return {context};
+MenuContext run_menu_command(Menu* menu, const MenuItem& command, const std::string& data) {
+  // Named by cmd_, since the command in the menu may be in any case.
+  TraceSpan span("menu", command.cmd_);
+  MenuContext context(menu, data);
+  command.f_(context);
+  if (menu) {
+    menu->reload = context.need_reload;
   }
-  return std::nullopt;
+  return context;
 }
 
 std::map<std::string, MenuItem, ci_less> CreateCommandMap() {
@@ -691,6 +706,18 @@ This command does not attempt to display a .msg/.ans file.
 )",
                                    MENU_CAT_MSGS, [](MenuContext&) { ResetQscan(); }));
   m.emplace("MemStat", MenuItem(R"()", MENU_CAT_SYSOP, [](MenuContext&) { MemoryStatus(); }));
+  m.emplace("basic:stats", MenuItem(R"(
+  Sysop command to display how long each WWIVbasic script has taken to load and run
+)",
+                                     MENU_CAT_SYSOP, [](MenuContext&) {
+                                       for (const auto& [name, s] : basic::BasicScriptStats()) {
+                                         bout.print("|#2{:<20} |#1loads: {} runs: {} cached: {} "
+                                                    "load: {}us run: {}us last: {}us\r\n",
+                                                    name, s.loads, s.runs, s.cache_hits,
+                                                    s.load_time.count(), s.run_time.count(),
+                                                    s.last_run_time.count());
+                                       }
+                                     }));
   m.emplace("VoteEdit", MenuItem(R"(
   Sysop command to edit the voting both
 )",
@@ -52,6 +52,12 @@ std::map<std::string, MenuItem, wwiv::stl::ci_less> CreateCommandMap();
  */
 std::optional<MenuContext> interpret_command(Menu* menu, const std::string& cmd, const std::string& data);
 
+/** Returns the menu command named cmd (in any case), or nullptr if there is none. */
+const MenuItem* find_menu_command(const std::string& cmd);
+
+/** Executes a command returned by find_menu_command, see interpret_command. */
+MenuContext run_menu_command(Menu* menu, const MenuItem& command, const std::string& data);
+
 }  // namespace
 
 #endif
@@ -97,9 +97,7 @@ static void save_gat(File& file) {
   const auto section_pos = gat_section * GATSECLEN;
   file.Seek(section_pos, File::Whence::begin);
   file.Write(gat, GAT_SECTION_SIZE);
-  a()->status_manager()->Run([](Status& s) {
-    s.increment_filechanged(Status::file_change_posts);
-  });
+  a()->status_manager()->increment_filechanged(Status::file_change_posts);
 }
 
 /**
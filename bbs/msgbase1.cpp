@@ -46,6 +46,7 @@
 #include "sdk/usermanager.h"
 #include "sdk/fido/fido_address.h"
 #include "sdk/msgapi/parsed_message.h"
+#include "sdk/msgapi/qscan_high_water.h"
 #include "sdk/net/ftn_msgdupe.h"
 #include "sdk/net/networks.h"
 #include "sdk/net/subscribers.h"
@@ -253,7 +254,7 @@ void post(const PostData& post_data) {
   p.msg = m;
   p.ownersys = 0;
   p.owneruser = static_cast<uint16_t>(a()->sess().user_num());
-  a()->status_manager()->Run([&](Status& s) { p.qscan = s.next_qscanptr(); });
+  p.qscan = a()->status_manager()->next_qscanptr();
   p.daten = daten_t_now();
   p.status = 0;
   if (a()->user()->restrict_validate()) {
@@ -382,7 +383,18 @@ std::string grab_user_name(messagerec* m, const std::string& file_name, int netw
   return {};
 }
 
-void qscan(uint16_t start_subnum, bool& nextsub) {
+// Returns true if sub_number may have posts newer than last_read.  When the
+// high water table shows nothing has been posted since, the sub isn't opened.
+static bool has_new_posts(int sub_number, uint32_t last_read, const QScanHighWater* high_water) {
+  if (high_water && high_water->high_water(a()->subs().sub(sub_number).filename) <= last_read) {
+    return false;
+  }
+  iscan1(sub_number);
+  const auto on_disk_last_post = WWIVReadLastRead(sub_number);
+  return !on_disk_last_post || on_disk_last_post > last_read;
+}
+
+static void qscan(uint16_t start_subnum, bool& nextsub, const QScanHighWater* high_water) {
   const int sub_number = a()->usub[start_subnum].subnum;
 
   if (a()->sess().hangup() || sub_number < 0) {
@@ -391,9 +403,8 @@ void qscan(uint16_t start_subnum, bool& nextsub) {
   bout.nl();
   auto memory_last_read = a()->sess().qsc_p[sub_number];
 
-  iscan1(sub_number);
   auto num_lines = 3;
-  if (const auto on_disk_last_post = WWIVReadLastRead(sub_number); !on_disk_last_post || on_disk_last_post > memory_last_read) {
+  if (has_new_posts(sub_number, memory_last_read, high_water)) {
     const auto old_subnum = a()->current_user_sub_num();
     a()->set_current_user_sub_num(start_subnum);
 
@@ -406,11 +417,7 @@ void qscan(uint16_t start_subnum, bool& nextsub) {
     bout.printf("\r\n\n|#1< Q-scan %s %s - %lu msgs >\r\n", a()->current_sub().name,
                  a()->current_user_sub().keys, a()->GetNumMessagesInCurrentMessageArea());
 
-    int i;
-    for (i = a()->GetNumMessagesInCurrentMessageArea();
-         (i > 1) && (get_post(i - 1)->qscan > memory_last_read); i--)
-      ;
-
+    const auto i = first_post_after(memory_last_read);
     if (a()->GetNumMessagesInCurrentMessageArea() > 0 &&
         i <= a()->GetNumMessagesInCurrentMessageArea() &&
         get_post(i)->qscan > a()->sess().qsc_p[a()->sess().GetCurrentReadMessageArea()]) {
@@ -435,14 +442,20 @@ void qscan(uint16_t start_subnum, bool& nextsub) {
   bout.nl();
 }
 
+void qscan(uint16_t start_subnum, bool& nextsub) {
+  qscan(start_subnum, nextsub, nullptr);
+}
+
 void nscan(uint16_t start_subnum) {
   bool nextsub = true;
 
+  // Read once, so that subs with nothing new are skipped without being opened.
+  const auto high_water = QScanHighWater::LoadOrCreate(a()->config()->datadir());
   bout.outstr("\r\n|#3-=< Q-Scan All >=-\r\n");
   for (auto i = start_subnum; i < a()->usub.size() && nextsub && !a()->sess().hangup();
        i++) {
     if (a()->sess().qsc_q[a()->usub[i].subnum / 32] & (1L << (a()->usub[i].subnum % 32))) {
-      qscan(i, nextsub);
+      qscan(i, nextsub, high_water ? &high_water.value() : nullptr);
     }
     bool abort = false;
     bin.checka(&abort);
@@ -678,7 +678,7 @@ void HandleMessageMove(int& msg_num) {
       open_sub(true);
       p2.msg.storage_type = static_cast<unsigned char>(a()->current_sub().storage_type);
       savefile(b, &(p2.msg), (a()->current_sub().filename));
-      a()->status_manager()->Run([&](Status& s) { p2.qscan = s.next_qscanptr(); });
+      p2.qscan = a()->status_manager()->next_qscanptr();
       if (a()->GetNumMessagesInCurrentMessageArea() >= a()->current_sub().maxmsgs) {
         auto temp_msg_num = 1;
         auto msg_to_delete = 0;
@@ -134,17 +134,6 @@ void qwk_gather_email(qwk_state* qwk_info) {
   auto curmail = 0;
   auto done = false;
   qwk_info->in_email = true;
-  const auto index_filemode = File::modeReadWrite | File::modeAppend | File::modeBinary | File::modeCreateFile;
-
-  const auto personal_filename = FilePath(a()->sess().dirs().qwk_directory(), "PERSONAL.NDX");
-  qwk_info->personal =
-      std::make_unique<DataFile<qwk_index>>(personal_filename, index_filemode);
-
-
-  const auto zero_filename = FilePath(a()->sess().dirs().qwk_directory(), "000.NDX");
-  qwk_info->zero = 
-      std::make_unique<DataFile<qwk_index>>(zero_filename, index_filemode);
-
   do {
     read_same_email(mloc, mw, curmail, m, false, 0);
 
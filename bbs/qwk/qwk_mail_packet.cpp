@@ -34,7 +34,6 @@
 #include "bbs/utility.h"
 #include "bbs/qwk/qwk_email.h"
 #include "bbs/qwk/qwk_ui.h"
-#include "bbs/qwk/qwk_util.h"
 #include "common/input.h"
 #include "common/output.h"
 #include "common/pause.h"
@@ -43,7 +42,6 @@
 #include "core/scope_exit.h"
 #include "core/stl.h"
 #include "core/strings.h"
-#include "core/textfile.h"
 #include "fmt/format.h"
 #include "local_io/wconstants.h"
 #include "sdk/filenames.h"
@@ -53,7 +51,7 @@
 #include "sdk/status.h"
 #include "sdk/subxtr.h"
 #include "sdk/vardec.h"
-#include "sdk/ansi/makeansi.h"
+#include "sdk/qwk/qwk_packet.h"
 
 using namespace wwiv::core;
 using namespace wwiv::sdk;
@@ -80,52 +78,29 @@ static bool replacefile(const std::string& src, const std::string& dst) {
 }
 
 bool build_control_dat(const sdk::qwk_config& qwk_cfg, Clock* clock, qwk_state *qwk_info) {
-  const auto date_time = clock->Now().to_string("%m-%d-%Y,%H:%M:%S"); // 'mm-dd-yyyy,hh:mm:ss'
+  sdk::qwk::qwk_control_dat_t c{};
+  c.system_name = sdk::qwk_system_name(qwk_cfg, a()->config()->system_name());
+  c.system_phone = a()->config()->system_phone();
+  c.sysop_name = a()->config()->sysop_name();
+  c.date_time = clock->Now().to_string("%m-%d-%Y,%H:%M:%S"); // 'mm-dd-yyyy,hh:mm:ss'
+  c.user_name = a()->user()->name();
+  c.num_messages = qwk_info->writer->next_logical_num();
 
-  TextFile fp(FilePath(a()->sess().dirs().qwk_directory(), "CONTROL.DAT"), "wd");
-  if (!fp) {
-    return false;
-  }
-
-  const auto system_name = sdk::qwk_system_name(qwk_cfg, a()->config()->system_name());
-  fp.WriteLine(fmt::format("{}.qwk", system_name));
-  fp.WriteLine();  // System City and State
-  fp.WriteLine(a()->config()->system_phone());
-  fp.WriteLine(a()->config()->sysop_name());
-  fp.WriteLine(fmt::format("00000,{}", system_name));
-  fp.WriteLine(date_time);
-  fp.WriteLine(a()->user()->name());
-  fp.WriteLine("");
-  fp.WriteLine("0");
-  fp.WriteLine(qwk_info->qwk_rec_num);
-  
   const auto max_size = a()->subs().subs().size();
   const sdk::qscan_bitset qb(a()->sess().qsc_q, max_size);
-  std::vector<std::pair<int, std::string>> subs_list;
   for (auto cur = 0; cur < size_int(a()->usub); cur++) {
     const auto subnum = a()->usub[cur].subnum;
     if (qb.test(subnum)) {
       // QWK support says this should be truncated to 10 or 13 characters however QWKE allows for
       // 255 characters. This works fine in multimail which is the only still maintained QWK
       //  reader that I'm aware of at this time, so we'll allow it to be the full length.
-      subs_list.emplace_back(subnum + 1, stripcolors(a()->subs().sub(subnum).name));
+      c.subs.emplace_back(subnum + 1, stripcolors(a()->subs().sub(subnum).name));
     }
   }
-  fp.WriteLine(subs_list.size());
-  
-  fp.WriteLine("0");
-  fp.WriteLine("E-Mail");
-
-  for (const auto& [sub_num, sub_name] : subs_list) {
-    // Write the subs in the format of "Sub Number\r\nSub Name\r\n"
-    fp.WriteLine(sub_num);
-    fp.WriteLine(sub_name);
-  }
-
-  fp.WriteLine(qwk_cfg.hello);
-  fp.WriteLine(qwk_cfg.news);
-  fp.WriteLine(qwk_cfg.bye);
-  return fp.Close();
+  c.hello = qwk_cfg.hello;
+  c.news = qwk_cfg.news;
+  c.bye = qwk_cfg.bye;
+  return sdk::qwk::write_control_dat(FilePath(a()->sess().dirs().qwk_directory(), "CONTROL.DAT"), c);
 }
 
 void build_qwk_packet() {
@@ -158,25 +133,17 @@ void build_qwk_packet() {
   write_inst(INST_LOC_QWK, a()->current_user_sub().subnum, INST_FLAGS_ONLINE);
 
   const auto filename = FilePath(a()->sess().dirs().batch_directory(), MESSAGES_DAT);
-  const auto filemode = File::modeReadWrite | File::modeBinary | File::modeCreateFile;
   qwk_state qwk_info{};
-  qwk_info.file = std::make_unique<DataFile<qwk_record>>(filename, filemode);
+  qwk_info.writer =
+      std::make_unique<sdk::qwk::QwkPacketWriter>(filename, a()->sess().dirs().qwk_directory());
 
-  if (!qwk_info.file->ok()) {
+  // Also writes the required header at the start of MESSAGES.DAT
+  if (!qwk_info.writer->Open()) {
     bout.outstr("Open error");
     sysoplog("Couldn't open MESSAGES.DAT");
     return;
   }
 
-  // Required header at the start of MESSAGES.DAT
-  qwk_record header{};
-  memcpy(&header, "Produced by Qmail...Copyright (c) 1987 by Sparkware.  All Rights Reserved (For Compatibility with Qmail)                        ", 128);
-  qwk_info.file->Write(&header);
-
-  // Logical record number
-  qwk_info.qwk_rec_num = 1;
-  qwk_info.qwk_rec_pos = 2;
-
   qwk_info.abort = false;
 
   if (!a()->user()->data.qwk_dont_scan_mail && !qwk_info.abort) {
@@ -206,7 +173,7 @@ void build_qwk_packet() {
 
   bool msgs_ok = true;
   for (uint16_t i = 0; i < a()->usub.size() && !a()->sess().hangup() && !qwk_info.abort && msgs_ok; i++) {
-    msgs_ok = max_msgs ? qwk_info.qwk_rec_num <= max_msgs : true;
+    msgs_ok = max_msgs ? qwk_info.writer->next_logical_num() <= max_msgs : true;
     if (a()->sess().qsc_q[a()->usub[i].subnum / 32] & (1L << (a()->usub[i].subnum % 32))) {
       qwk_gather_sub(i, &qwk_info);
     }
@@ -224,10 +191,12 @@ void build_qwk_packet() {
     }
   }
 
-  qwk_info.file.reset(nullptr);
-  qwk_info.index.reset(nullptr);
-  qwk_info.personal.reset(nullptr);
-  qwk_info.zero.reset(nullptr);
+  if (!qwk_info.writer->Close()) {
+    // Must be out of disk space
+    qwk_info.abort = true;
+    bout.outstr("Write error");
+    bout.pausescr();
+  }
 
   if (!qwk_info.abort) {
     SystemClock clock{};
@@ -353,7 +322,7 @@ void qwk_start_read(int msgnum, qwk_state *qwk_info) {
         a()->user()->data.qwk_max_msgs_per_sub : 0) {
       done = true;
     }
-    if (max_msgs ? qwk_info->qwk_rec_num > max_msgs : 0) {
+    if (max_msgs ? qwk_info->writer->next_logical_num() > max_msgs : 0) {
       done = true;
     }
     ++amount;
@@ -392,101 +361,12 @@ void make_pre_qwk(int msgnum, qwk_state *qwk_info) {
 }
 
 
-static void insert_after_routing(std::string& text, const std::string& text2insert) {
-  const auto text_to_insert_nc = StrCat(stripcolors(text2insert), "\xE3\xE3");
-
-  size_t pos = 0;
-  const auto len = text.size();
-  while (pos < len && text[pos] != 0) {
-    if (text[pos] == 4 && text[pos + 1] == '0') {
-      while (pos < len && text[pos] != '\xE3') {
-        ++pos;
-      }
-
-      if (text[pos] == '\xE3') {
-        ++pos;
-      }
-    } else if (pos < len) {
-      text.insert(pos, text_to_insert_nc);
-      return;
-    }
-  }
-}
-
-// Give us 3000 extra bytes to play with in the message text
-static constexpr int PAD_SPACE = 3000;
-
-// Takes text, deletes all ascii '10' and converts '13' to '227' ()
-// And does other conversions as specified
-// TODO(rushfan): This whole thing needs to be redone.
-static std::string make_qwk_ready(const std::string& text, const std::string& address) {
-  std::string::size_type pos = 0;
-
-  std::string temp;
-  temp.reserve(text.size() + PAD_SPACE + 1);
-
-  while (pos < text.size()) {
-    const auto x = static_cast<unsigned char>(text[pos]);
-    const auto xo = text[pos];
-    if (x == 0) {
-      break;
-    }
-    if (x == 13) {
-      temp.push_back('\xE3');
-      ++pos;
-    } else if (x == 10 || x < 3) {
-      // Strip out Newlines, NULLS, 1's and 2's
-      ++pos;
-    } else if (a()->user()->data.qwk_remove_color && x == 3) {
-      pos += 2;
-    } else if (a()->user()->data.qwk_convert_color && x == 3) {
-      const auto save_curatr = bout.curatr();
-      bout.curatr(255);
-
-      const auto ansi_string = wwiv::sdk::ansi::makeansi(text[pos + 1] - '0', bout.curatr());
-      temp.append(ansi_string);
-
-      pos += 2;
-      bout.setc(save_curatr);
-    } else if (a()->user()->data.qwk_keep_routing == false && x == 4 && text[pos + 1] == '0') {
-      if (text[pos + 1] == 0) {
-        ++pos;
-      } else { 
-        while (text[pos] != '\xE3' && text[pos] != '\r' && pos < text.size() && text[pos] != 0) {
-          ++pos;
-        }
-      }
-      ++pos;
-      if (pos < text.size() && text[pos] == '\n') {
-        ++pos;
-      }
-    } else if (x == 4 && text[pos + 1] != '0') {
-      pos += 2;
-    } else {
-      temp.push_back(xo);
-      ++pos;
-    }
-  }
-
-  // Only add address if it does not yet exist
-  if (temp.find("QWKFrom:") != std::string::npos) {
-    // Don't search for diamond or number, just text after that
-    insert_after_routing(temp, address);
-  }
-
-  temp.shrink_to_fit();
-  return temp;
-}
-
-static void qwk_remove_null(char *memory, int size) {
-  auto pos = 0;
-
-  while (pos < size) {
-    if (memory[pos] == 0) {
-      memory[pos] = ' ';
-    }
-    ++pos;
-  }
+static sdk::qwk::qwk_text_options qwk_text_options_for_user() {
+  sdk::qwk::qwk_text_options o{};
+  o.remove_color = a()->user()->data.qwk_remove_color;
+  o.convert_color = a()->user()->data.qwk_convert_color;
+  o.keep_routing = a()->user()->data.qwk_keep_routing;
+  return o;
 }
 
 void put_in_qwk(postrec *m1, const char *fn, int msgnum, qwk_state *qwk_info) {
@@ -495,7 +375,6 @@ void put_in_qwk(postrec *m1, const char *fn, int msgnum, qwk_state *qwk_info) {
       return;
     }
   }
-  memset(&qwk_info->qwk_rec, ' ', sizeof(qwk_info->qwk_rec));
 
   auto o = read_type2_message(&m1->msg, m1->anony & 0x0f, true, fn, m1->ownersys, m1->owneruser);
   if (!o) {
@@ -503,117 +382,43 @@ void put_in_qwk(postrec *m1, const char *fn, int msgnum, qwk_state *qwk_info) {
     bout.nl();
     return;
   }
-  auto& m = o.value();
-  int cur = 0;
-  auto len = m.message_text.length();
-  if (len <= 0) {
+  const auto& m = o.value();
+  if (m.message_text.empty()) {
     std::cout << "we have no text for this message." << std::endl;
     return;
   }
-  auto ss = m.message_text;
-  auto n = m.from_user_name;
-  auto d = m.date;
+  const auto& n = m.from_user_name;
 
   auto qwk_address = StrCat(QWKFrom, n);  // Copy wwivnet address to qwk_address
   if (qwk_address.find('@') != std::string::npos) {
     qwk_address.append(fmt::format("@{}", m1->ownersys));
   }
 
+  sdk::qwk::qwk_message_t q{};
+  q.msgnum = msgnum;
+  q.daten = m1->daten;
+  q.from = ToStringUpperCase(stripcolors(n));
   // Took the annonomouse stuff out right here
   if (!qwk_info->in_email) {
     // Maybe m.to_user_name is valid here?
-    if (!m.to_user_name.empty()) {
-    strncpy(qwk_info->qwk_rec.to, m.to_user_name.c_str(), 25);
-    } else {
-      memcpy(qwk_info->qwk_rec.to, "ALL", 3);
-    }
-  } else {
-    auto temp = ToStringUpperCase(a()->user()->name());
-    strncpy(qwk_info->qwk_rec.to, temp.c_str(), 25);
-  }
-  auto temp_from = ToStringUpperCase(stripcolors(n));
-  strncpy(qwk_info->qwk_rec.from, temp_from.c_str(), 25);
-
-  auto dt = DateTime::from_daten(m1->daten);
-  auto date = dt.to_string("%m-%d-%y");
-  // to_char_array uses strncpy_safe which expects buffer to be big enough for
-  // a trailing 0.  Use memcpy instead.
-  memcpy(qwk_info->qwk_rec.date, date.c_str(), sizeof(qwk_info->qwk_rec.date));
-
-  ss = make_qwk_ready(ss, qwk_address);
-  // Update length since we don't do it in make_qwk_ready anymore.
-  len = ss.length();
-  auto amount_blocks = static_cast<int>(len / sizeof(qwk_info->qwk_rec) + 2);
-
-  // Save Qwk Record
-  sprintf(qwk_info->qwk_rec.amount_blocks, "%d", amount_blocks);
-  sprintf(qwk_info->qwk_rec.msgnum, "%d", msgnum);
-
-  if (!qwk_info->in_email) {
-    strncpy(qwk_info->qwk_rec.subject, stripcolors(m1->title), 25);
-  } else {
-    strncpy(qwk_info->qwk_rec.subject,qwk_info->email_title, 25);
-  }
-
-  qwk_remove_null(reinterpret_cast<char*>(&qwk_info->qwk_rec), 123);
-  if (qwk_info->in_email) {
-    // email conference is always zero.
-    qwk_info->qwk_rec.conf_num = 0;
+    q.to = m.to_user_name.empty() ? "ALL" : m.to_user_name;
+    q.subject = stripcolors(m1->title);
+    q.conf_num = static_cast<uint16_t>(a()->current_user_sub().subnum + 1);
   } else {
-    qwk_info->qwk_rec.conf_num = a()->current_user_sub().subnum + 1;
+    q.to = ToStringUpperCase(a()->user()->name());
+    q.subject = std::string(qwk_info->email_title,
+                            strnlen(qwk_info->email_title, sizeof(qwk_info->email_title)));
+    // email conference is always zero, and goes in PERSONAL.NDX too.
+    q.conf_num = 0;
+    q.personal = true;
   }
-  qwk_info->qwk_rec.logical_num = qwk_info->qwk_rec_num;
+  q.text = sdk::qwk::make_qwk_ready(m.message_text, qwk_address, qwk_text_options_for_user());
 
-  if (!qwk_info->file->Write(&qwk_info->qwk_rec)) {
+  if (!qwk_info->writer->Write(sdk::qwk::format_qwk_message(q))) {
     qwk_info->abort = true; // Must be out of disk space
     bout.outstr("Write error");
     bout.pausescr();
   }
-
-  // Save Qwk NDX
-  qwk_info->qwk_ndx.pos = static_cast<float>(qwk_info->qwk_rec_pos);
-  float msbin = 0.0f;
-  _fieeetomsbin(&qwk_info->qwk_ndx.pos, &msbin);
-  qwk_info->qwk_ndx.pos = msbin;
-  qwk_info->qwk_ndx.nouse = 0;
-
-  if (!qwk_info->in_email) { // Only if currently doing messages...
-    // Create new index if it hasn't been already
-    if (a()->current_user_sub_num() != static_cast<uint16_t>(qwk_info->cursub) || !qwk_info->index) {
-      qwk_info->cursub = a()->current_user_sub_num();
-      const auto filename =
-          fmt::sprintf("%s%03d.NDX", a()->sess().dirs().qwk_directory().string(), a()->current_user_sub().subnum + 1);
-      const auto index_filemode = File::modeReadWrite | File::modeAppend | File::modeBinary | File::modeCreateFile;
-      qwk_info->index = std::make_unique<DataFile<qwk_index>>(filename, index_filemode);
-    }
-
-    qwk_info->index->Write(&qwk_info->qwk_ndx);
-  } else { // Write to email indexes
-    qwk_info->zero->Write(&qwk_info->qwk_ndx);
-    qwk_info->personal->Write(&qwk_info->qwk_ndx);
-  }
-
-  // Setup next NDX position
-  qwk_info->qwk_rec_pos += static_cast<uint16_t>(amount_blocks);
-
-  int cur_block = 2;
-  while (cur_block <= amount_blocks && !a()->sess().hangup()) {
-    size_t this_pos;
-    memset(&qwk_info->qwk_rec, ' ', sizeof(qwk_info->qwk_rec));
-    this_pos = (cur_block - 2) * sizeof(qwk_info->qwk_rec);
-
-    if (this_pos < len) {
-      size_t size = (this_pos + sizeof(qwk_info->qwk_rec) > static_cast<size_t>(len)) ? (len - this_pos - 1) : sizeof(qwk_info->qwk_rec);
-      memmove(&qwk_info->qwk_rec, ss.data() + cur + this_pos, size);
-    }
-    // Save this block
-    qwk_info->file->Write(&qwk_info->qwk_rec);
-
-    this_pos += sizeof(qwk_info->qwk_rec);
-    ++cur_block;
-  }
-  // Global variable on total amount of records saved
-  ++qwk_info->qwk_rec_num;
 }
 
 static void qwk_send_file(const std::string& fn, bool *sent, bool *abort) {
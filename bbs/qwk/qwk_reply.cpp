@@ -40,6 +40,7 @@
 #include "bbs/qwk/qwk_ui.h"
 #include "common/com.h"
 #include "common/input.h"
+#include "core/datafile.h"
 #include "core/datetime.h"
 #include "core/file.h"
 #include "core/findfiles.h"
@@ -284,9 +285,7 @@ static void qwk_post_text(std::string text, const std::string& to, const std::st
     p.msg = m;
     p.ownersys = 0;
     p.owneruser = static_cast<uint16_t>(a()->sess().user_num());
-    {
-      a()->status_manager()->Run([&](Status& s) { p.qscan = s.next_qscanptr(); });
-    }
+    p.qscan = a()->status_manager()->next_qscanptr();
     p.daten = daten_t_now();
     if (a()->user()->restrict_validate()) {
       p.status = status_unvalidated;
@@ -20,53 +20,18 @@
 #define INCLUDED_BBS_QWK_QWK_STRUCT_H
 
 #include "core/file.h"
-#include "core/datafile.h"
+#include "sdk/qwk/qwk_packet.h"
 #include <cstdint>
+#include <memory>
 
 
 namespace wwiv::bbs::qwk {
-#pragma pack(push, 1)
-struct qwk_record {
-  char status;   // ' ' for public
-
-  char msgnum[7]; // all strings are space padded
-  char date[8];
-  char time[5];
-
-  char to[25]; // Uppercase, left justified
-  char from[25]; // Uppercase left justified
-  char subject[25];
-  char password[12];
-  char reference[8];
-
-  char amount_blocks[6];
-  char flag;
-
-  uint16_t conf_num;
-  uint16_t logical_num;
-  char tagline;
-};
-
-struct qwk_index {
-  float pos;
-  char nouse;
-};
+using sdk::qwk::qwk_index;
+using sdk::qwk::qwk_record;
 
 struct qwk_state {
-  uint16_t qwk_rec_num{0};
-  uint16_t qwk_rec_pos{0};
-  int cursub{0};
-
-  // File number for the MESSAGES.DAT file
-  std::unique_ptr<wwiv::core::DataFile<qwk_record>> file;
-
-  // File number for the *.NDX files
-  std::unique_ptr<wwiv::core::DataFile<qwk_index>> index;
-  std::unique_ptr<wwiv::core::DataFile<qwk_index>> personal;  // personal.ndx
-  std::unique_ptr<wwiv::core::DataFile<qwk_index>> zero;      // 000.ndx for email
-
-  qwk_record qwk_rec{};
-  qwk_index qwk_ndx{};
+  // Writes MESSAGES.DAT and the *.NDX files
+  std::unique_ptr<sdk::qwk::QwkPacketWriter> writer;
 
   bool abort{false};
   bool in_email{false};
@@ -75,6 +40,7 @@ struct qwk_state {
 };
 
 
+#pragma pack(push, 1)
 struct qwk_sub_conf {
   int import_num;
   char import_name[14];
@@ -56,6 +56,7 @@
 #include "sdk/filenames.h"
 #include "sdk/names.h"
 #include "sdk/status.h"
+#include "sdk/msgapi/email_index.h"
 #include "sdk/msgapi/message_utils_wwiv.h"
 #include "sdk/net/networks.h"
 
@@ -208,10 +209,14 @@ bool read_same_email(std::vector<tmpmailrec>& mloc, int mw, int rec, mailrec& m,
       mloc[rec].index = -1;
     }
   } else {
-    if (stat && !del && mloc[rec].index >= 0) {
+    if (stat && !del && mloc[rec].index >= 0 && (m.status & stat) != stat) {
+      auto index = EmailIndex::LoadOrRebuild(file->path());
+      index.Remove(mloc[rec].index, m);
       m.status |= stat;
       file->Seek(mloc[rec].index * sizeof(mailrec), File::Whence::begin);
       file->Write(&m, sizeof(mailrec));
+      index.Add(mloc[rec].index, m);
+      index.Save(file->path());
     }
     if (del) {
       delmail(*file, mloc[rec].index);
@@ -378,10 +383,13 @@ void readmail(bool newmail_only) {
       bout.outstr("\r\n\nNo mail file exists!\r\n\n");
       return;
     }
-    auto mfl = static_cast<File::size_type>(file->length() / sizeof(mailrec));
-    for (int i = 0; i < mfl && mw < MAXMAIL; i++) {
-      file->Seek(i * sizeof(mailrec), File::Whence::begin);
-      file->Read(&m, sizeof(mailrec));
+    const auto records = email_records_to_user(file->path(), a()->sess().user_num());
+    for (const auto& [i, h] : read_email_headers(*file, records)) {
+      if (mw >= MAXMAIL) {
+        break;
+      }
+      m = h;
+      // The index may be behind a write made by another node.
       if (m.tosys == 0 && m.touser == a()->sess().user_num()) {
         tmpmailrec r = {};
         r.index = static_cast<int16_t>(i);
@@ -784,9 +792,7 @@ void readmail(bool newmail_only) {
             }
             p.msg.storage_type = static_cast<uint8_t>(a()->current_sub().storage_type);
             savefile(b, &(p.msg), a()->current_sub().filename);
-            a()->status_manager()->Run([&](Status& status) {
-              p.qscan = status.next_qscanptr();
-            });
+            p.qscan = a()->status_manager()->next_qscanptr();
             if (a()->GetNumMessagesInCurrentMessageArea() >= a()->current_sub().maxmsgs) {
               int i2;
               i1 = 1;
@@ -1153,21 +1159,9 @@ void readmail(bool newmail_only) {
 }
 
 int check_new_mail(int user_number) {
-  auto new_messages = 0; // number of new mail
-
-  if (auto file(OpenEmailFile(false)); file->Exists() && file->IsOpen()) {
-    const auto mfLength = static_cast<int>(file->length() / sizeof(mailrec));
-    for (auto i = 0; i < mfLength; i++) {
-      mailrec m{};
-      file->Seek(i * sizeof(mailrec), File::Whence::begin);
-      file->Read(&m, sizeof(mailrec));
-      if (m.tosys == 0 && m.touser == user_number) {
-        if (!(m.status & status_seen)) {
-          ++new_messages;
-        }
-      }
-    }
-    file->Close();
+  const auto fn = FilePath(a()->config()->datadir(), EMAIL_DAT);
+  if (!File::Exists(fn)) {
+    return 0;
   }
-  return new_messages;
+  return email_unread_count(fn, user_number);
 }
@@ -36,6 +36,7 @@
 #include "core/scope_exit.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/trace.h"
 #include "fmt/printf.h"
 #include "local_io/keycodes.h"
 #include "local_io/local_io.h"
@@ -93,6 +94,7 @@ char gettimeout(long ds, bool *abort) {
 
 
 int extern_prot(int num, const std::filesystem::path& path, bool bSending) {
+  TraceSpan span("xfer", bSending ? "external_send" : "external_receive");
   char s1[81];
 
   if (bSending) {
@@ -362,6 +364,7 @@ int get_protocol(xfertype xt) {
 }
 
 void ascii_send(const std::filesystem::path& path, bool* sent, double* percent) {
+  TraceSpan span("xfer", "ascii_send");
 
   if (File file(path); file.Open(File::modeBinary | File::modeReadOnly)) {
     auto file_size = file.length();
@@ -399,6 +402,7 @@ void ascii_send(const std::filesystem::path& path, bool* sent, double* percent)
 
 void maybe_internal(const std::filesystem::path& path, bool* xferred, double* percent, bool bSend,
                     int prot) {
+  TraceSpan span("xfer", bSend ? "internal_send" : "internal_receive");
   if (!a()->over_intern.empty() 
       && a()->over_intern[prot - 2].othr & othr_override_internal
       && ((bSend && a()->over_intern[prot - 2].sendfn[0]) ||
@@ -26,6 +26,8 @@
 #else
 
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/select.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -33,24 +35,29 @@
 #endif  // _WIN32
 
 #include "cryptlib.h"
+#include "common/remote_socket_io.h"
 #include "core/log.h"
 #include "core/net.h"
+#include <algorithm>
 #include <cstring>
-#include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <thread>
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#ifndef MSG_DONTWAIT
+#define MSG_DONTWAIT 0
+#endif
+
 using wwiv::common::RemoteInfo;
 using wwiv::common::RemoteSocketIO;
 using wwiv::common::RemoteIO;
 
 namespace wwiv::bbs{
 
-struct socket_error: public std::runtime_error {
-  socket_error(const std::string& message): std::runtime_error(message) {}
-};
-
 static constexpr char WWIV_SSH_KEY_NAME[] = "wwiv_ssh_server";
 #define RETURN_IF_ERROR(s) { if (!cryptStatusOK(s)) return false; }
 #define OK(s) cryptStatusOK(s)
@@ -194,6 +201,13 @@ SSHSession::SSHSession(int socket_handle, const Key& key) : socket_handle_(socke
 
     GetSSHUserNameAndPassword(session_, remote_username_, remote_password_);
     VLOG(1) << "Got Username and Password!";
+
+    // IOSSH only pops data once the socket is readable, so never block
+    // waiting for the rest of a packet.
+    status = cryptSetAttribute(session_, CRYPT_OPTION_NET_READTIMEOUT, 0);
+    if (!OK(status)) {
+      VLOG(1) << "ERROR setting CRYPT_OPTION_NET_READTIMEOUT. status: " << status;
+    }
   }
   initialized_ = success;
 }
@@ -213,6 +227,7 @@ int SSHSession::PopData(char* data, size_t buffer_size) {
   int bytes_copied = 0;
   std::lock_guard<std::mutex> lock(mu_);
   int status = cryptPopData(session_, data, buffer_size, &bytes_copied);
+  if (status == CRYPT_ERROR_TIMEOUT) return bytes_copied;
   if (!OK(status)) return -1;
   return bytes_copied;
 }
@@ -239,230 +254,350 @@ std::string SSHSession::GetAndClearRemotePassword() {
   return temp;
 }
 
-static bool socket_avail(SOCKET sock, int seconds) {
+// Waits up to timeout_ms for sock to become readable.
+static bool socket_readable(SOCKET sock, int timeout_ms) {
   fd_set fds;
   FD_ZERO(&fds);
   FD_SET(sock, &fds);
 
-  timeval tv;
-  tv.tv_sec = seconds;
-  tv.tv_usec = 0;
+  timeval tv{};
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = (timeout_ms % 1000) * 1000;
+  return select(static_cast<int>(sock) + 1, &fds, nullptr, nullptr, &tv) > 0;
+}
 
-  int result = select(sock + 1, &fds, 0, 0, &tv);
-  if (result == SOCKET_ERROR) {
-    throw socket_error("Error on select for socket.");
-  }
-  return result == 1;
+static bool socket_writable(SOCKET sock, int timeout_ms) {
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(sock, &fds);
+
+  timeval tv{};
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = (timeout_ms % 1000) * 1000;
+  return select(static_cast<int>(sock) + 1, nullptr, &fds, nullptr, &tv) > 0;
 }
 
-// Reads from remote socket using session, writes to socket
-static void reader_thread(SSHSession& session, SOCKET socket) {
-  constexpr size_t size = 16 * 1024;
-  std::unique_ptr<char[]> data = std::make_unique<char[]>(size);
-  try {
-    while (true) {
-      if (session.closed()) {
-        break;
-      }
-      if (!socket_avail(session.socket_handle(), 1)) {
+// Sends all of data to sock, giving up if stop is set while the door
+// isn't reading.
+static bool send_all(SOCKET sock, const char* data, int size, const std::atomic<bool>& stop) {
+  while (size > 0) {
+    if (stop.load()) {
+      return false;
+    }
+    if (!socket_writable(sock, 100)) {
+      continue;
+    }
+    const auto num_sent = send(sock, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (num_sent == SOCKET_ERROR) {
+#ifdef _WIN32
+      return false;
+#else
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
         continue;
       }
-      memset(data.get(), 0, size);
-      int num_read = session.PopData(data.get(), size);
-      if (num_read == -1) {
-        // error.
-        break;
-      }
-      int num_sent = send(socket, data.get(), num_read, 0);
-      VLOG(1) << "reader_thread: sent " << num_sent;
+      return false;
+#endif
     }
-  } catch (const socket_error& e) {
-    VLOG(1) << e.what();
+    data += num_sent;
+    size -= static_cast<int>(num_sent);
   }
-  closesocket(socket);
+  return true;
 }
 
-// Reads from local socket socket, writes to remote socket using session.
-static void writer_thread(SSHSession& session, SOCKET socket) {
-  constexpr size_t size = 16 * 1024;
-  std::unique_ptr<char[]> data = std::make_unique<char[]>(size);
-  try {
-    while (true) {
-        if (session.closed()) {
-          break;
-        }
-      if (!socket_avail(socket, 1)) {
-        continue;
-      }
-      memset(data.get(), 0, size);
-      int num_read = recv(socket, data.get(), size, 0);
-      if (num_read > 0) {
-        int num_sent = session.PushData(data.get(), num_read);
-        VLOG(1) << "writer_thread: pushed_data: " << num_sent;
-      }
-    }
-  } catch (const socket_error& e) {
-    VLOG(1) << e.what();
+// Creates a connected pair of local stream sockets.
+static bool create_socket_pair(SOCKET (&sockets)[2]) {
+#ifdef _WIN32
+  sockaddr_in a{};
+
+  SOCKET listener = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (listener == INVALID_SOCKET) {
+    VLOG(1) << "WSAGetLastError: " << WSAGetLastError();
+    return false;
   }
-  closesocket(socket);
+
+  // IP, localhost, any port.
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  a.sin_port = 0;
+
+  socklen_t addr_len = sizeof(a);
+  if (bind(listener, reinterpret_cast<struct sockaddr*>(&a), sizeof(a)) == SOCKET_ERROR ||
+      listen(listener, 1) == SOCKET_ERROR ||
+      getsockname(listener, reinterpret_cast<struct sockaddr*>(&a), &addr_len) == SOCKET_ERROR) {
+    closesocket(listener);
+    return false;
+  }
+
+  SOCKET client = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (connect(client, reinterpret_cast<struct sockaddr*>(&a), addr_len) == SOCKET_ERROR) {
+    closesocket(client);
+    closesocket(listener);
+    return false;
+  }
+
+  SOCKET server = accept(listener, reinterpret_cast<struct sockaddr*>(&a), &addr_len);
+  // Since we'll only ever accept one connection, we can close
+  // the listener socket.
+  closesocket(listener);
+  if (server == INVALID_SOCKET) {
+    closesocket(client);
+    return false;
+  }
+  sockets[0] = server;
+  sockets[1] = client;
+  return true;
+#else
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    VLOG(1) << "socketpair failed; errno: " << errno;
+    return false;
+  }
+  sockets[0] = fds[0];
+  sockets[1] = fds[1];
+  return true;
+#endif
 }
 
-IOSSH::IOSSH(SOCKET ssh_socket, Key& key) 
+IOSSH::IOSSH(SOCKET ssh_socket, Key& key)
   : ssh_socket_(ssh_socket), session_(ssh_socket, key) {
   static bool initialized = RemoteSocketIO::Initialize();
-  if (!ssh_initalize()) {
-    VLOG(1) << "ERROR INITIALIZING SSH (ssh_initalize)";
-    closesocket(ssh_socket_);
-    ssh_socket_ = INVALID_SOCKET;
-    return;
-  }
   if (!session_.initialized()) {
     //LOG(ERROR) << "ERROR INITIALIZING SSH (SSHSession::initialized)";
     closesocket(ssh_socket_);
     ssh_socket_ = INVALID_SOCKET;
     return;
   }
-  io_.reset(new RemoteSocketIO(plain_socket_, false));
   RemoteInfo& info = remote_info();
   info.username = session_.GetAndClearRemoteUserName();
   info.password = session_.GetAndClearRemotePassword();
 
   initialized_ = true;
+  connected_.store(true);
 }
 
 IOSSH::~IOSSH() {
-  if (ssh_receive_thread_.joinable()) {
-    ssh_receive_thread_.join();
-  }
-  if (ssh_send_thread_.joinable()) {
-    ssh_send_thread_.join();
-  }
-
-  // Release the remote before it happens automatically.
-  io_.reset(nullptr);
-
-  std::cerr << "~IOSSH";
+  stop_door_bridge();
+  session_.close();
 }
 
-bool IOSSH::ssh_initalize() {
-  sockaddr_in a{};
+void IOSSH::fill_queue() {
+  char buffer[16 * 1024];
+  // cryptlib already keeps reading packets until no more are waiting, and
+  // each extra call costs a short select, so only call again if the
+  // buffer filled up.
+  int num_read;
+  do {
+    num_read = session_.PopData(buffer, sizeof(buffer));
+    if (num_read < 0) {
+      VLOG(1) << "IOSSH: error reading from SSH session.";
+      connected_.store(false);
+      return;
+    }
+    if (binary_mode()) {
+      queue_.insert(queue_.end(), buffer, buffer + num_read);
+    } else {
+      std::copy_if(buffer, buffer + num_read, std::back_inserter(queue_),
+                   [](char c) { return c != '\0'; });
+    }
+  } while (num_read == static_cast<int>(sizeof(buffer)));
+}
 
-  SOCKET listener = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-  if (listener == INVALID_SOCKET) {
-#ifdef _WIN32    
-    int last_error = WSAGetLastError();
-#else
-    int last_error = errno;
-#endif
-    VLOG(1) << "WSAGetLastError: " << last_error;
-    return false;
+bool IOSSH::create_door_sockets() const {
+  if (door_socket_ != INVALID_SOCKET) {
+    return true;
   }
-
-  // IP, localhost, any port.
-  a.sin_family = AF_INET;
-  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-  a.sin_port = 0;
-
-  int result = bind(listener, reinterpret_cast<struct sockaddr*>(&a), sizeof(a));
-  if (result == SOCKET_ERROR) {
-    closesocket(listener);
+  SOCKET sockets[2];
+  if (!create_socket_pair(sockets)) {
+    LOG(ERROR) << "Unable to create the door socket for SSH.";
     return false;
   }
-
-  result = listen(listener, 1);
-  if (result == SOCKET_ERROR) {
-    closesocket(listener);
-    return false;
+  door_socket_ = sockets[0];
+  bridge_socket_ = sockets[1];
+#ifndef _WIN32
+  // Only the door's end should be inherited by the door.
+  if (const auto flags = fcntl(bridge_socket_, F_GETFD); flags != -1) {
+    fcntl(bridge_socket_, F_SETFD, flags | FD_CLOEXEC);
   }
+#endif
+  return true;
+}
 
-  socklen_t addr_len = sizeof(a);
-  result = getsockname(listener, reinterpret_cast<struct sockaddr*>(&a), &addr_len);
-  if (result == SOCKET_ERROR) {
-    closesocket(listener);
-    return false;
+void IOSSH::start_door_bridge() {
+  if (bridge_thread_.joinable() || !create_door_sockets()) {
+    return;
   }
+  stop_bridge_.store(false);
+  bridge_thread_ = std::thread(&IOSSH::door_bridge, this);
+}
 
-  SOCKET pipe_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-  result = connect(pipe_socket, reinterpret_cast<struct sockaddr*>(&a), addr_len);
-  if (result == SOCKET_ERROR) {
-    closesocket(listener);
-    return false;
+void IOSSH::stop_door_bridge() {
+  if (bridge_thread_.joinable()) {
+    stop_bridge_.store(true);
+    bridge_thread_.join();
   }
-
-  plain_socket_ = accept(listener, reinterpret_cast<struct sockaddr*>(&a), &addr_len);
-  if (plain_socket_ == INVALID_SOCKET) {
-    closesocket(listener);
-    closesocket(pipe_socket);
-    return false;
+  if (door_socket_ != INVALID_SOCKET) {
+    closesocket(door_socket_);
+    door_socket_ = INVALID_SOCKET;
   }
+  if (bridge_socket_ != INVALID_SOCKET) {
+    closesocket(bridge_socket_);
+    bridge_socket_ = INVALID_SOCKET;
+  }
+}
 
-  // Since we'll only ever accept one connection, we can close
-  // the listener socket.
-  closesocket(listener);
-
-  // assign and start the threads.
-  ssh_receive_thread_ = std::thread(reader_thread, std::ref(session_), pipe_socket);
-  ssh_send_thread_ = std::thread(writer_thread, std::ref(session_), pipe_socket);
-  return true;
+// Relays between the SSH session and the door's socket until the remote IO
+// is reopened.
+void IOSSH::door_bridge() {
+  constexpr int size = 16 * 1024;
+  auto data = std::make_unique<char[]>(size);
+  while (!stop_bridge_.load() && connected_.load()) {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(ssh_socket_, &fds);
+    FD_SET(bridge_socket_, &fds);
+    // The timeout only bounds how long open() waits for this thread.
+    timeval tv{0, 100 * 1000};
+    const auto max_socket = std::max(ssh_socket_, bridge_socket_);
+    const auto result = select(static_cast<int>(max_socket) + 1, &fds, nullptr, nullptr, &tv);
+    if (result == SOCKET_ERROR) {
+      VLOG(1) << "IOSSH::door_bridge: select failed.";
+      break;
+    }
+    if (result == 0) {
+      continue;
+    }
+    if (FD_ISSET(ssh_socket_, &fds)) {
+      int num_read;
+      do {
+        num_read = session_.PopData(data.get(), size);
+        if (num_read < 0) {
+          connected_.store(false);
+          break;
+        }
+        if (!send_all(bridge_socket_, data.get(), num_read, stop_bridge_)) {
+          break;
+        }
+      } while (num_read == size);
+    }
+    if (FD_ISSET(bridge_socket_, &fds)) {
+      const auto num_read = recv(bridge_socket_, data.get(), size, 0);
+      if (num_read <= 0) {
+        // The door closed its end.
+        break;
+      }
+      if (session_.PushData(data.get(), num_read) != num_read) {
+        connected_.store(false);
+        break;
+      }
+    }
+  }
 }
 
-bool IOSSH::open() { 
-  if (!initialized_) return false;  
-  
+bool IOSSH::open() {
+  if (!initialized_) return false;
+
+  stop_door_bridge();
   remote_info().address = wwiv::core::GetRemotePeerAddress(ssh_socket_).value_or("");
-  return io_->open(); 
+  return connected_.load();
 }
 
-void IOSSH::close(bool temporary) { 
+void IOSSH::close(bool temporary) {
   if (!initialized_) return;
-  if (!temporary) {
-    session_.close();
+  if (temporary) {
+    // A door is about to use GetDoorHandle.
+    start_door_bridge();
+    return;
   }
-  io_->close(temporary);
+  stop_door_bridge();
+  session_.close();
+  connected_.store(false);
 }
 
-unsigned char IOSSH::getW() { 
+unsigned char IOSSH::getW() {
   if (!initialized_) return 0;
-  return io_->getW();
+  std::lock_guard<std::mutex> lock(mu_);
+  if (queue_.empty() && socket_readable(ssh_socket_, 0)) {
+    fill_queue();
+  }
+  if (queue_.empty()) {
+    return 0;
+  }
+  const auto ch = queue_.front();
+  queue_.pop_front();
+  return static_cast<unsigned char>(ch);
 }
+
 bool IOSSH::disconnect() {
   if (!initialized_) return false;
-  return io_->disconnect();
+  stop_door_bridge();
+  session_.close();
+  connected_.store(false);
+  closesocket(ssh_socket_);
+  ssh_socket_ = INVALID_SOCKET;
+  return true;
 }
-void IOSSH::purgeIn() { 
+
+void IOSSH::purgeIn() {
   if (!initialized_) return;
-  io_->purgeIn();
+  std::lock_guard<std::mutex> lock(mu_);
+  queue_.clear();
 }
-unsigned int IOSSH::put(unsigned char ch) { 
-  if (!initialized_) return 0;
-  return io_->put(ch);
+
+unsigned int IOSSH::put(unsigned char ch) {
+  const auto c = static_cast<char>(ch);
+  return write(&c, 1, true);
 }
+
 unsigned int IOSSH::read(char *buffer, unsigned int count) {
   if (!initialized_) return 0;
-  return io_->read(buffer, count);
+  std::lock_guard<std::mutex> lock(mu_);
+  if (queue_.size() < count && socket_readable(ssh_socket_, 0)) {
+    fill_queue();
+  }
+  const auto num_read = std::min<size_t>(count, queue_.size());
+  std::copy_n(queue_.begin(), num_read, buffer);
+  queue_.erase(queue_.begin(), queue_.begin() + num_read);
+  return static_cast<unsigned int>(num_read);
 }
-unsigned int IOSSH::write(const char *buffer, unsigned int count, bool bNoTranslation) {
-  if (!initialized_) return 0;
-  return io_->write(buffer, count, bNoTranslation);
+
+unsigned int IOSSH::write(const char *buffer, unsigned int count, bool) {
+  if (!initialized_ || !connected_.load()) return 0;
+  // SSH is 8-bit clean, so unlike telnet nothing needs to be escaped.
+  unsigned int num_written = 0;
+  while (num_written < count) {
+    const auto num_sent = session_.PushData(buffer + num_written, count - num_written);
+    if (num_sent <= 0) {
+      VLOG(1) << "IOSSH: error writing to SSH session.";
+      connected_.store(false);
+      break;
+    }
+    num_written += num_sent;
+  }
+  return num_written;
 }
-bool IOSSH::connected() { 
+
+bool IOSSH::connected() {
   if (!initialized_) return false;
-  return io_->connected(); 
+  return connected_.load() && !session_.closed();
 }
 
 bool IOSSH::incoming() {
-  if (!initialized_) return false;
-  return io_->incoming();
+  if (!initialized_ || bridge_thread_.joinable()) return false;
+  std::lock_guard<std::mutex> lock(mu_);
+  if (queue_.empty() && socket_readable(ssh_socket_, 0)) {
+    fill_queue();
+  }
+  return !queue_.empty();
 }
 
-unsigned int IOSSH::GetHandle() const { 
-  if (!initialized_) return false;
-  return io_->GetHandle();
+unsigned int IOSSH::GetHandle() const {
+  if (!initialized_) return 0;
+  return static_cast<unsigned int>(ssh_socket_);
 }
 
 unsigned int IOSSH::GetDoorHandle() const {
-  if (!initialized_) return false;
-  return io_->GetDoorHandle();
+  if (!initialized_ || !create_door_sockets()) return 0;
+  return static_cast<unsigned int>(door_socket_);
 }
 
 } // namespace wwiv::bbs
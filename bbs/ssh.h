@@ -19,12 +19,14 @@
 #define __INCLUDED_BBS_SSH_H__
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "common/remote_io.h"
-#include "common/remote_socket_io.h"
+#include "core/net.h"
 
 namespace wwiv {
 namespace bbs {
@@ -68,12 +70,21 @@ private:
   std::string remote_password_;
 };
 
+/**
+ * RemoteIO for SSH connections.
+ *
+ * Talks to the cryptlib session directly: input is popped from the session
+ * only when the SSH socket is readable and output is pushed straight through
+ * it, so no extra threads or sockets are used while the caller is in the BBS.
+ *
+ * Doors that need a plain socket (GetDoorHandle) are given one end of a
+ * local socket pair, which is only relayed to the session while the remote
+ * IO is temporarily closed for the door.
+ */
 class IOSSH: public wwiv::common::RemoteIO {
 public:
   IOSSH(SOCKET socket, Key& key);
-  virtual ~IOSSH();
-
-  bool ssh_initalize();
+  ~IOSSH() override;
 
   bool open() override;
   void close(bool temporary) override;
@@ -89,15 +100,26 @@ public:
   unsigned int GetDoorHandle() const override;
 
 private:
-  std::thread ssh_receive_thread_;
-  std::thread ssh_send_thread_;
+  // Pops any data waiting on the session into queue_.  mu_ must be held.
+  void fill_queue();
+  bool create_door_sockets() const;
+  void start_door_bridge();
+  void stop_door_bridge();
+  void door_bridge();
+
   bool initialized_{false};
-  std::unique_ptr<wwiv::common::RemoteSocketIO> io_;
   SOCKET ssh_socket_;
-  SOCKET plain_socket_;
   SSHSession session_;
-};
+  std::mutex mu_;
+  std::deque<char> queue_;
+  std::atomic<bool> connected_{false};
 
+  // Local socket pair handed to doors, created on demand.
+  mutable SOCKET door_socket_{INVALID_SOCKET};
+  mutable SOCKET bridge_socket_{INVALID_SOCKET};
+  std::thread bridge_thread_;
+  std::atomic<bool> stop_bridge_{false};
+};
 
 }
 }
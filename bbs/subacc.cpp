@@ -30,10 +30,12 @@
 #include "core/version.h"
 #include "core/wwivport.h"
 #include "sdk/config.h"
+#include "sdk/msgapi/qscan_high_water.h"
 #include "sdk/status.h"
 #include "sdk/subxtr.h"
 #include "sdk/vardec.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -50,6 +52,69 @@ using namespace wwiv::strings;
 static std::unique_ptr<File> fileSub; // File object for '.sub' file
 static char subdat_fn[MAX_PATH];      // filename of .sub file
 
+// Number of post headers read at once by get_post.
+static constexpr int POST_WINDOW_SIZE = 32;
+
+// Post headers read ahead from the current sub by get_post.  The storage
+// never moves, so pointers returned by get_post stay valid like they did
+// when it returned a single static postrec, although what they point to
+// changes once the window is read again.
+struct post_window_t {
+  std::string filename;
+  int first{0};
+  int count{0};
+  // Number of messages in the sub and the posts file change counter from
+  // STATUS.DAT when the window was read.
+  int num_messages{0};
+  uint8_t posts_changed{0};
+  // Whether subchg was already set when the window was read.
+  bool subchg{false};
+  postrec posts[POST_WINDOW_SIZE]{};
+};
+
+static post_window_t post_window;
+static post_window_stats_t post_window_stats_;
+
+static void invalidate_post_window() { post_window.count = 0; }
+
+static bool post_window_current() {
+  return post_window.count > 0 && post_window.filename == subdat_fn &&
+         post_window.num_messages == a()->GetNumMessagesInCurrentMessageArea() &&
+         post_window.posts_changed ==
+             a()->status_manager()->filechanged(Status::file_change_posts) &&
+         (!a()->subchg || post_window.subchg);
+}
+
+// Reads the window of post headers around message number mn from fileSub.
+static bool read_post_window(int mn) {
+  const auto num_messages = a()->GetNumMessagesInCurrentMessageArea();
+  if (mn < 1 || num_messages < 1) {
+    return false;
+  }
+  // Readers mostly move forward, but resynch and the title listings walk
+  // backwards, so keep a few posts before mn too.
+  auto first = std::max(1, mn - POST_WINDOW_SIZE / 4);
+  first = std::max(1, std::min(first, num_messages - POST_WINDOW_SIZE + 1));
+  const auto wanted = std::min(POST_WINDOW_SIZE, num_messages - first + 1);
+
+  invalidate_post_window();
+  fileSub->Seek(first * sizeof(postrec), File::Whence::begin);
+  const auto num_read = fileSub->Read(post_window.posts, wanted * sizeof(postrec));
+  const auto count = num_read > 0 ? static_cast<int>(num_read / sizeof(postrec)) : 0;
+  if (mn >= first + count) {
+    return false;
+  }
+  post_window.filename = subdat_fn;
+  post_window.first = first;
+  post_window.count = count;
+  post_window.num_messages = num_messages;
+  post_window.posts_changed = a()->status_manager()->filechanged(Status::file_change_posts);
+  post_window.subchg = a()->subchg != 0;
+  return true;
+}
+
+const post_window_stats_t& post_window_stats() { return post_window_stats_; }
+
 using namespace wwiv::core;
 using namespace wwiv::stl;
 using namespace wwiv::strings;
@@ -71,6 +136,8 @@ bool open_sub(bool wr) {
       fileSub->Read(&p, sizeof(postrec));
       a()->SetNumMessagesInCurrentMessageArea(p.owneruser);
     }
+    // Another node may have changed the sub since the window was read.
+    invalidate_post_window();
   } else {
     fileSub->Open(File::modeReadOnly | File::modeBinary);
   }
@@ -148,6 +215,7 @@ bool iscan1(int sub_index) {
   // set sub
   a()->sess().SetCurrentReadMessageArea(sub_index);
   a()->subchg = 0;
+  invalidate_post_window();
 
   // read in first rec, specifying # posts
   fileSub->Seek(0L, File::Whence::begin);
@@ -175,6 +243,13 @@ postrec* get_post(int mn) {
   if (mn > a()->GetNumMessagesInCurrentMessageArea()) {
     mn = a()->GetNumMessagesInCurrentMessageArea();
   }
+  if (post_window_current() && mn >= post_window.first &&
+      mn < post_window.first + post_window.count) {
+    ++post_window_stats_.hits;
+    // The seek and read, plus the open and close when the sub isn't open.
+    post_window_stats_.syscalls_saved += fileSub ? 2 : 4;
+    return &post_window.posts[mn - post_window.first];
+  }
   auto need_close = false;
   if (!fileSub) {
     if (!open_sub(false)) {
@@ -182,21 +257,57 @@ postrec* get_post(int mn) {
     }
     need_close = true;
   }
-  // read in post
-  static postrec p;
-  fileSub->Seek(mn * sizeof(postrec), File::Whence::begin);
-  fileSub->Read(&p, sizeof(postrec));
+  ++post_window_stats_.misses;
+  postrec* result;
+  if (read_post_window(mn)) {
+    result = &post_window.posts[mn - post_window.first];
+  } else {
+    // read in post
+    static postrec p;
+    fileSub->Seek(mn * sizeof(postrec), File::Whence::begin);
+    fileSub->Read(&p, sizeof(postrec));
+    result = &p;
+  }
+
+  if (need_close) {
+    close_sub();
+  }
+  return result;
+}
 
+int first_post_after(uint32_t qscan) {
+  const auto need_close = !fileSub && open_sub(false);
+  // qscan values only increase within a sub, so binary search for the
+  // first one past qscan.
+  auto lo = 1;
+  auto hi = a()->GetNumMessagesInCurrentMessageArea() + 1;
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    const auto* p = get_post(mid);
+    if (!p) {
+      break;
+    }
+    if (p->qscan > qscan) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
   if (need_close) {
     close_sub();
   }
-  return &p;
+  return lo;
 }
 
 void write_post(int mn, postrec* pp) {
   if (!fileSub || !fileSub->IsOpen()) {
+    invalidate_post_window();
     return;
   }
+  if (post_window.count > 0 && mn >= post_window.first &&
+      mn < post_window.first + post_window.count) {
+    post_window.posts[mn - post_window.first] = *pp;
+  }
   fileSub->Seek(mn * sizeof(postrec), File::Whence::begin);
   fileSub->Write(pp, sizeof(postrec));
 }
@@ -239,9 +350,12 @@ void add_post(postrec* pp) {
   // add the new post
   fileSub->Seek(a()->GetNumMessagesInCurrentMessageArea() * sizeof(postrec), File::Whence::begin);
   fileSub->Write(pp, sizeof(postrec));
+  wwiv::sdk::msgapi::QScanHighWater::Update(a()->config()->datadir(), a()->current_sub().filename,
+                                            pp->qscan);
 
   // we've modified the sub
   a()->subchg = 0;
+  invalidate_post_window();
 
   if (need_close) {
     close_sub();
@@ -292,6 +406,7 @@ void delete_message(int mn) {
         fileSub->Seek(0L, File::Whence::begin);
         fileSub->Write(&p, sizeof(postrec));
         free(buffer);
+        invalidate_post_window();
       }
     }
   }
@@ -22,16 +22,27 @@
 
 struct postrec;
 
+// Counts of get_post calls answered from the post header window and the
+// reads it saved, for the sysop log.
+struct post_window_stats_t {
+  int64_t hits{0};
+  int64_t misses{0};
+  int64_t syscalls_saved{0};
+};
+
 void close_sub();
 bool open_sub(bool wr);
 uint32_t WWIVReadLastRead(int sub_number);
 bool iscan1(int si);
 int iscan(int b);
 postrec* get_post(int mn);
+// First post in the current sub newer than qscan, or one past the last post.
+int first_post_after(uint32_t qscan);
 void delete_message(int mn);
 void write_post(int mn, postrec * pp);
 void add_post(postrec * pp);
 void resynch(int *msgnum, postrec * pp);
+const post_window_stats_t& post_window_stats();
 
 namespace wwiv::bbs {
 
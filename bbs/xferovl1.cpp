@@ -53,10 +53,13 @@
 #include "local_io/wconstants.h"
 #include "sdk/config.h"
 #include "sdk/filenames.h"
+#include "sdk/files/arc.h"
 #include "sdk/files/diz.h"
 #include "sdk/files/files.h"
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 // How far to indent extended descriptions
@@ -227,6 +230,27 @@ static std::optional<std::filesystem::path> PathToTempdDiz(const std::filesystem
   return std::nullopt;
 }
 
+/**
+ * Returns the name of the DIZ file and the parsed DIZ from the archive at p.
+ * ZIP files are read directly, other archives are extracted to the temp
+ * directory using the archiver's extract command.
+ */
+static std::optional<std::pair<std::string, std::optional<Diz>>>
+ReadDiz(const DizParser& dp, const std::filesystem::path& p) {
+  if (can_extract_archive_member(p)) {
+    for (const auto* name : {FILE_ID_DIZ, DESC_SDI}) {
+      if (auto o = extract_archive_member(p, name)) {
+        return std::make_pair(std::string(name), dp.parse_text(o.value()));
+      }
+    }
+    return std::nullopt;
+  }
+  if (auto o = PathToTempdDiz(p)) {
+    return std::make_pair(o->filename().string(), dp.parse(o.value()));
+  }
+  return std::nullopt;
+}
+
 bool get_file_idz(FileRecord& fr, const directory_t& dir) {
   auto at_exit = finally([] {
     File::Remove(FilePath(a()->sess().dirs().temp_directory(), FILE_ID_DIZ));
@@ -239,19 +263,19 @@ bool get_file_idz(FileRecord& fr, const directory_t& dir) {
 
   const auto dir_path = File::absolute(a()->bbspath(), dir.path);
   fr.set_date(DateTime::from_time_t(File::last_write_time(FilePath(dir_path, fr))));
-  auto o = PathToTempdDiz(FilePath(dir_path, fr));
+  const DizParser dp(a()->HasConfigFlag(OP_FLAGS_IDZ_DESC));
+  auto o = ReadDiz(dp, FilePath(dir_path, fr));
   if (!o) {
     LOG(INFO) << "File had no DIZ: " << fr;
     return true;
   }
-  const auto& diz_fn = o.value();
+  const auto& [diz_fn, odiz] = o.value();
   bout.nl();
-  bout.print("|#9Reading in |#2{}|#9 as extended description...", diz_fn.filename().string());
+  bout.print("|#9Reading in |#2{}|#9 as extended description...", diz_fn);
   const auto old_ext = a()->current_file_area()->ReadExtendedDescriptionAsString(fr).value_or("");
 
-  const DizParser dp(a()->HasConfigFlag(OP_FLAGS_IDZ_DESC));
-  if (auto odiz = dp.parse(diz_fn)) {
-    auto& diz = odiz.value();
+  if (odiz) {
+    const auto& diz = odiz.value();
     fr.set_description(diz.description());
     const auto ext_desc = diz.extended_description();
 
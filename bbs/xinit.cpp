@@ -394,13 +394,7 @@ bool Application::ReadConfig() {
   user_manager_ = std::make_unique<UserManager>(*config_);
   statusMgr = std::make_unique<StatusMgr>(config_->datadir(), StatusManagerCallback);
 
-  IniFile ini(FilePath(bbspath(), WWIV_INI), StrCat("WWIV-", sess().instance_number()), INI_TAG);
-  if (!ini.IsOpen()) {
-    LOG(ERROR) << "Unable to read WWIV.INI.";
-    return false;
-  }
-  ReadINIFile(ini);
-  if (!ReadInstanceSettings(sess().instance_number())) {
+  if (!ReadInstanceConfig()) {
     return false;
   }
 
@@ -409,6 +403,16 @@ bool Application::ReadConfig() {
   return true;
 }
 
+bool Application::ReadInstanceConfig() {
+  IniFile ini(FilePath(bbspath(), WWIV_INI), StrCat("WWIV-", sess().instance_number()), INI_TAG);
+  if (!ini.IsOpen()) {
+    LOG(ERROR) << "Unable to read WWIV.INI.";
+    return false;
+  }
+  ReadINIFile(ini);
+  return ReadInstanceSettings(sess().instance_number());
+}
+
 void Application::read_nextern() {
   externs.clear();
   if (auto externalFile = DataFile<newexternalrec>(FilePath(config()->datadir(), NEXTERN_DAT))) {
@@ -532,6 +536,54 @@ static bool mkdir_or_warn(const std::filesystem::path& dir, const std::string& n
   return true;
 }
 
+bool Application::LoadConfigData() {
+  read_networks();
+  if (!create_message_api()) {
+    return false;
+  }
+
+  VLOG(1) << "Reading Gfiles.";
+  read_gfile();
+
+  VLOG(1) << "Reading user names.";
+  if (!read_names()) {
+    return false;
+  }
+
+  VLOG(1) << "Reading Message Areas.";
+  if (!read_subs()) {
+    return false;
+  }
+
+  VLOG(1) << "Reading File Areas.";
+  if (!read_dirs()) {
+    return false;
+  }
+
+  VLOG(1) << "Reading Chains.";
+  read_chains();
+
+  VLOG(1) << "Reading File Transfer Protocols.";
+  read_nextern();
+  read_nintern();
+
+  VLOG(1) << "Reading File Archivers.";
+  read_arcs();
+
+  VLOG(1) << "Reading Full Screen Message Editors.";
+  read_editors();
+
+  VLOG(1) << "Reading Conferences.";
+  all_confs_ = std::make_unique<Conferences>(
+    config()->datadir(), *subs_, *dirs_, config()->max_backups());
+  if (!all_confs_->Load()) {
+    LOG(ERROR) << "Error Loading Conferences";
+  }
+
+  config_data_loaded_ = true;
+  return true;
+}
+
 bool Application::InitializeBBS(bool cleanup_network) {
   Cls();
   std::clog << std::endl
@@ -564,8 +616,8 @@ bool Application::InitializeBBS(bool cleanup_network) {
     return false;
   }
 
-  read_networks();
-  if (!create_message_api()) {
+  // When forked from a fork server template, this has already been loaded.
+  if (!config_data_loaded_ && !LoadConfigData()) {
     return false;
   }
 
@@ -575,37 +627,6 @@ bool Application::InitializeBBS(bool cleanup_network) {
     status.ensure_callernum_valid();
   });
 
-  VLOG(1) << "Reading Gfiles.";
-  read_gfile();
-
-  VLOG(1) << "Reading user names.";
-  if (!read_names()) {
-    return false;
-  }
-
-  VLOG(1) << "Reading Message Areas.";
-  if (!read_subs()) {
-    return false;
-  }
-
-  VLOG(1) << "Reading File Areas.";
-  if (!read_dirs()) {
-    return false;
-  }
-
-  VLOG(1) << "Reading Chains.";
-  read_chains();
-
-  VLOG(1) << "Reading File Transfer Protocols.";
-  read_nextern();
-  read_nintern();
-
-  VLOG(1) << "Reading File Archivers.";
-  read_arcs();
-
-  VLOG(1) << "Reading Full Screen Message Editors.";
-  read_editors();
-
   if (!File::mkdirs(attach_dir_)) {
     LOG(ERROR) << "Your file attachment directory is invalid.";
     LOG(ERROR) << "It is now set to: " << attach_dir_ << "'";
@@ -642,12 +663,6 @@ bool Application::InitializeBBS(bool cleanup_network) {
   }
 
   frequent_init();
-  VLOG(1) << "Reading Conferences.";
-  all_confs_ = std::make_unique<Conferences>(
-    config()->datadir(), *subs_, *dirs_, config()->max_backups());
-  if (!all_confs_->Load()) {
-    LOG(ERROR) << "Error Loading Conferences";
-  }
 
   TempDisablePause disable_pause(bout);
   const auto t = sess().dirs().temp_directory();
@@ -0,0 +1,218 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "bench/bench_helper.h"
+
+#include "core/datetime.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "sdk/fido/fido_packets.h"
+#include "sdk/files/files.h"
+#include "sdk/files/filesapi_helper.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/msgapi.h"
+#include "sdk/user.h"
+#include "sdk/usermanager.h"
+#include "fmt/format.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Counts every allocation made by wwiv_bench.
+static std::atomic<int64_t> num_allocations{0};
+
+void* operator new(std::size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int64_t allocation_count() { return num_allocations.load(std::memory_order_relaxed); }
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::fido;
+using namespace wwiv::sdk::files;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::sdk::net;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+
+bool BenchBbs::CreateUsers(int num_users) {
+  UserManager um(config());
+  um.set_user_writes_allowed(true);
+  for (auto i = 1; i <= num_users; i++) {
+    User u{};
+    User::CreateNewUserRecord(&u, 10, 10, 0, 0.0f, {7, 11, 14, 13, 31, 10, 12, 9, 5, 3},
+                              {7, 15, 15, 15, 112, 15, 15, 7, 7, 7});
+    u.set_name(StrCat("USER ", i));
+    u.real_name(StrCat("User ", i));
+    if (!um.writeuser(&u, i)) {
+      LOG(ERROR) << "Unable to write user: " << i;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<subboard_t> BenchBbs::CreateSubs(int num_subs, int num_posts, int post_size) {
+  MessageApiOptions options;
+  options.overflow_strategy = OverflowStrategy::delete_none;
+  WWIVMessageApi api(options, config(), {}, new NullLastReadImpl());
+
+  const auto text = CreateText(post_size);
+  std::vector<subboard_t> subs;
+  for (auto s = 0; s < num_subs; s++) {
+    subboard_t sub{};
+    sub.filename = StrCat("sub", s);
+    sub.name = StrCat("Sub #", s);
+    if (!api.Create(sub, -1)) {
+      LOG(ERROR) << "Unable to create sub: " << sub.filename;
+      return {};
+    }
+    auto area = api.Open(sub, -1);
+    if (!area) {
+      LOG(ERROR) << "Unable to open sub: " << sub.filename;
+      return {};
+    }
+    auto daten = DateTime::now().to_daten_t() - num_posts;
+    for (auto i = 0; i < num_posts; i++) {
+      auto msg = area->CreateMessage();
+      auto& h = msg.header();
+      h.set_from_system(0);
+      h.set_from_usernum(1);
+      h.set_title(StrCat("Post #", i));
+      h.set_from("USER 1");
+      h.set_to("All");
+      h.set_daten(daten++);
+      msg.set_text(text);
+      if (!area->AddMessage(msg, {})) {
+        LOG(ERROR) << "Unable to add post #" << i << " to: " << sub.filename;
+        return {};
+      }
+    }
+    subs.push_back(sub);
+  }
+  return subs;
+}
+
+std::vector<std::string> BenchBbs::CreateDirs(int num_dirs, int num_files) {
+  FileApi api(datadir());
+  std::vector<std::string> dirs;
+  for (auto d = 0; d < num_dirs; d++) {
+    const auto name = StrCat("dir", d);
+    if (!api.Create(name)) {
+      LOG(ERROR) << "Unable to create file area: " << name;
+      return {};
+    }
+    auto area = api.Open(name);
+    if (!area) {
+      LOG(ERROR) << "Unable to open file area: " << name;
+      return {};
+    }
+    for (auto i = 0; i < num_files; i++) {
+      area->AddFile(FileRecord(ul(fmt::format("F{:07}.ZIP", i), StrCat("File #", i), 1024 * i)));
+    }
+    area->Save();
+    dirs.push_back(name);
+  }
+  return dirs;
+}
+
+std::filesystem::path BenchBbs::CreateWWIVnetPacket(const std::string& name, int num_packets,
+                                                    int text_size) {
+  const auto path = FilePath(scratch(), name);
+  const auto packet = CreatePostPacket("BENCH", text_size);
+  for (auto i = 0; i < num_packets; i++) {
+    if (!write_wwivnet_packet(path, packet)) {
+      LOG(ERROR) << "Unable to write packet #" << i << " to: " << path;
+      return {};
+    }
+  }
+  return path;
+}
+
+std::filesystem::path BenchBbs::CreateFtnPacket(const std::string& name, int num_messages,
+                                                int text_size) {
+  const auto path = FilePath(scratch(), name);
+  const auto header =
+      CreateType2PlusPacketHeader(FidoAddress("1:2/3"), FidoAddress("1:2/4"), DateTime::now(), "");
+  auto o = FidoPacket::Create(path, header);
+  if (!o) {
+    LOG(ERROR) << "Unable to create FTN packet: " << path;
+    return {};
+  }
+  fido_variable_length_header_t vh{};
+  vh.date_time = "01 Jan 20  00:00:00";
+  vh.to_user_name = "All";
+  vh.from_user_name = "Sysop";
+  vh.text = StrCat("AREA:BENCH\r\001MSGID: 1:2/3 00000001\r", CreateText(text_size));
+  fido_packed_message_t nh{};
+  nh.message_type = 2;
+  for (auto i = 0; i < num_messages; i++) {
+    vh.subject = std::to_string(i);
+    if (!o->Write(FidoPackedMessage(nh, vh))) {
+      LOG(ERROR) << "Unable to write message #" << i << " to: " << path;
+      return {};
+    }
+  }
+  return path;
+}
+
+std::string BenchBbs::CreateText(int size) {
+  static const std::string kLine =
+      "The quick brown fox jumps over the lazy dog while the BBS keeps on ringing.\r\n";
+  std::string text;
+  text.reserve(size);
+  while (ssize(text) < size) {
+    text.append(kLine);
+  }
+  text.resize(size);
+  return text;
+}
+
+NetPacket BenchBbs::CreatePostPacket(const std::string& subtype, int text_size) {
+  std::string text;
+  text.append(subtype);
+  text.push_back(0);
+  text.append("Benchmark Post");
+  text.push_back(0);
+  text.append("USER 1 #1 @1\r\n");
+  text.append(daten_to_wwivnet_time(daten_t_now())).append("\r\n");
+  text.append(CreateText(text_size));
+
+  net_header_rec nh{};
+  nh.daten = daten_t_now();
+  nh.fromsys = 1;
+  nh.tosys = 2;
+  nh.fromuser = 1;
+  nh.touser = 0;
+  nh.main_type = main_type_new_post;
+  nh.length = static_cast<uint32_t>(text.size());
+  return NetPacket(nh, {}, text);
+}
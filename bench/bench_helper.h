@@ -0,0 +1,72 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_BENCH_BENCH_HELPER_H
+#define INCLUDED_BENCH_BENCH_HELPER_H
+
+#include "sdk/sdk_helper.h"
+#include "sdk/net/packets.h"
+#include "sdk/subxtr.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * Synthetic BBS data directory for wwiv_bench.
+ *
+ * Builds on SdkHelper, so each instance gets its own temporary BBS with a
+ * config.json, and then fills it with users, subs, file areas and packets
+ * of the requested sizes.
+ */
+class BenchBbs : public SdkHelper {
+public:
+  BenchBbs() = default;
+  ~BenchBbs() = default;
+
+  // Writes users 1 through num_users to user.lst.
+  bool CreateUsers(int num_users);
+
+  // Creates subs named "sub0".."subN" each containing num_posts posts whose
+  // text is post_size bytes long.
+  std::vector<wwiv::sdk::subboard_t> CreateSubs(int num_subs, int num_posts, int post_size);
+
+  // Creates file areas named "dir0".."dirN" each containing num_files files.
+  std::vector<std::string> CreateDirs(int num_dirs, int num_files);
+
+  // Creates a WWIVnet packet in the scratch directory containing num_packets
+  // posts whose text is text_size bytes long.
+  std::filesystem::path CreateWWIVnetPacket(const std::string& name, int num_packets,
+                                            int text_size);
+
+  // Creates a FTN type 2+ packet in the scratch directory containing
+  // num_messages messages whose text is text_size bytes long.
+  std::filesystem::path CreateFtnPacket(const std::string& name, int num_messages, int text_size);
+
+  // Returns size bytes of message text broken into lines.
+  static std::string CreateText(int size);
+
+  // Returns a WWIVnet post packet with a text of text_size bytes.
+  static wwiv::sdk::net::NetPacket CreatePostPacket(const std::string& subtype, int text_size);
+};
+
+// Returns how many times operator new has been called in this process, so
+// benchmarks can report heap allocations per item.
+int64_t allocation_count();
+
+#endif // INCLUDED_BENCH_BENCH_HELPER_H
@@ -0,0 +1,53 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/cp437.h"
+#include "core/log.h"
+#include "core/test/file_helper.h"
+#include "core/version.h"
+#include "benchmark/benchmark.h"
+#include <ctime>
+
+using namespace wwiv::core;
+
+/**
+ * Runs the WWIV benchmarks.
+ *
+ * All of the usual Google Benchmark flags work, i.e.:
+ *   --benchmark_filter=Packet     only run the packet benchmarks.
+ *   --benchmark_out=bench.json    also write the results as JSON.
+ *
+ * Like the tests, --wwiv_test_tempdir may be used to choose where the
+ * synthetic BBS directories are created.
+ */
+int main(int argc, char* argv[]) {
+  set_wwiv_codepage(wwiv_codepage_t::utf8);
+  tzset();
+  benchmark::Initialize(&argc, argv);
+
+  LoggerConfig logger_config{};
+  logger_config.register_file_destinations = false;
+  logger_config.log_startup = false;
+  Logger::Init(argc, argv, logger_config);
+  test::FileHelper::set_wwiv_test_tempdir_from_commandline(argc, argv);
+
+  benchmark::AddCustomContext("wwiv_version", full_version());
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,248 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "bench/bench_helper.h"
+
+#include "binkp/frame_compression.h"
+#include "core/file.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "sdk/fido/fido_packets.h"
+#include "sdk/fido/fido_util.h"
+#include "sdk/fido/nodelist.h"
+#include "sdk/net/packets.h"
+#include "benchmark/benchmark.h"
+#include <algorithm>
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk::fido;
+using namespace wwiv::sdk::net;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+
+// FTN message text as networkf sees it on import.
+static std::string CreateFtnText(int size) {
+  auto text = StrCat("AREA:BENCH\r\001MSGID: 1:2/3 00000001\r", BenchBbs::CreateText(size));
+  StringReplace(&text, "\r\n", "\r");
+  return text;
+}
+
+static void SetAllocationsPerItem(benchmark::State& state, int64_t start) {
+  state.counters["allocs_per_item"] =
+      static_cast<double>(allocation_count() - start) / static_cast<double>(state.iterations());
+}
+
+// Reads every packet from a WWIVnet packet file, as network2 does.
+static void BM_ReadPacket(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_packets = static_cast<int>(state.range(0));
+  const auto path =
+      bbs.CreateWWIVnetPacket("p1.net", num_packets, static_cast<int>(state.range(1)));
+  if (path.empty()) {
+    state.SkipWithError("Unable to create packet");
+    return;
+  }
+  for (auto _ : state) {
+    File f(path);
+    if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+      state.SkipWithError("Unable to open packet");
+      break;
+    }
+    for (;;) {
+      auto [packet, response] = read_packet(f, false);
+      if (response != ReadNetPacketResponse::OK) {
+        break;
+      }
+      benchmark::DoNotOptimize(packet);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_packets);
+  state.SetBytesProcessed(state.iterations() * File(path).length());
+}
+BENCHMARK(BM_ReadPacket)->Args({100, 1024})->Args({1000, 1024})->Args({100, 16 * 1024});
+
+// Appends posts to a WWIVnet packet file, as network1 and network3 do.
+static void BM_WriteWWIVnetPacket(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_packets = static_cast<int>(state.range(0));
+  const auto packet = BenchBbs::CreatePostPacket("BENCH", static_cast<int>(state.range(1)));
+  const auto path = FilePath(bbs.scratch(), "p0.net");
+  for (auto _ : state) {
+    for (auto i = 0; i < num_packets; i++) {
+      write_wwivnet_packet(path, packet);
+    }
+    state.PauseTiming();
+    File::Remove(path);
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_packets);
+}
+BENCHMARK(BM_WriteWWIVnetPacket)->Args({100, 1024});
+
+// Reads every message from a FTN packet without copying, as networkt does.
+static void BM_FidoPacket_ReadView(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_messages = static_cast<int>(state.range(0));
+  const auto path =
+      bbs.CreateFtnPacket("00000001.pkt", num_messages, static_cast<int>(state.range(1)));
+  if (path.empty()) {
+    state.SkipWithError("Unable to create packet");
+    return;
+  }
+  for (auto _ : state) {
+    auto o = FidoPacket::Open(path);
+    if (!o) {
+      state.SkipWithError("Unable to open packet");
+      break;
+    }
+    for (;;) {
+      auto [response, msg] = o->ReadView();
+      if (response != ReadNetPacketResponse::OK) {
+        break;
+      }
+      benchmark::DoNotOptimize(msg);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_messages);
+  state.SetBytesProcessed(state.iterations() * File(path).length());
+}
+BENCHMARK(BM_FidoPacket_ReadView)->Args({1000, 1024})->Args({100, 16 * 1024});
+
+// Reads and copies every message from a FTN packet.
+static void BM_FidoPacket_Read(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_messages = static_cast<int>(state.range(0));
+  const auto path =
+      bbs.CreateFtnPacket("00000001.pkt", num_messages, static_cast<int>(state.range(1)));
+  if (path.empty()) {
+    state.SkipWithError("Unable to create packet");
+    return;
+  }
+  for (auto _ : state) {
+    auto o = FidoPacket::Open(path);
+    if (!o) {
+      state.SkipWithError("Unable to open packet");
+      break;
+    }
+    for (;;) {
+      auto [response, msg] = o->Read();
+      if (response != ReadNetPacketResponse::OK) {
+        break;
+      }
+      benchmark::DoNotOptimize(msg);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_messages);
+}
+BENCHMARK(BM_FidoPacket_Read)->Args({1000, 1024});
+
+// Writes a FTN packet, as networkc does when exporting.
+static void BM_FidoPacket_Write(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_messages = static_cast<int>(state.range(0));
+  const auto text_size = static_cast<int>(state.range(1));
+  for (auto _ : state) {
+    const auto path = bbs.CreateFtnPacket("00000002.pkt", num_messages, text_size);
+    state.PauseTiming();
+    File::Remove(path);
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_messages);
+}
+BENCHMARK(BM_FidoPacket_Write)->Args({1000, 1024});
+
+// Compresses a WWIVnet packet into binkp data frames, as networkb does when
+// the remote supports "OPT PLZ".  Reports how many bytes compression saved.
+static void BM_CompressFrame(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto path = bbs.CreateWWIVnetPacket("p1.net", static_cast<int>(state.range(0)),
+                                            static_cast<int>(state.range(1)));
+  File f(path);
+  if (path.empty() || !f.Open(File::modeBinary | File::modeReadOnly)) {
+    state.SkipWithError("Unable to create packet");
+    return;
+  }
+  std::string contents(f.length(), '\0');
+  f.Read(&contents[0], contents.size());
+  const auto size = size_int(contents);
+  int64_t bytes_saved = 0;
+  for (auto _ : state) {
+    bytes_saved = 0;
+    for (auto start = 0; start < size; start += wwiv::net::kMaxCompressedFrameSize) {
+      const auto len = std::min(wwiv::net::kMaxCompressedFrameSize, size - start);
+      if (const auto c = wwiv::net::compress_frame(contents.data() + start, len)) {
+        bytes_saved += len - size_int(c.value());
+      }
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["bytes_saved"] = static_cast<double>(bytes_saved);
+  state.counters["saved_pct"] = 100.0 * static_cast<double>(bytes_saved) / size;
+}
+BENCHMARK(BM_CompressFrame)->Args({100, 1024})->Args({100, 16 * 1024});
+
+// Splits a message into lines, copying each one.
+static void BM_SplitMessage_SplitString(benchmark::State& state) {
+  const auto text = CreateFtnText(static_cast<int>(state.range(0)));
+  const auto start = allocation_count();
+  for (auto _ : state) {
+    for (const auto& line : SplitString(text, "\r", false)) {
+      benchmark::DoNotOptimize(line.data());
+    }
+  }
+  SetAllocationsPerItem(state, start);
+}
+BENCHMARK(BM_SplitMessage_SplitString)->Arg(1024)->Arg(16 * 1024);
+
+// Splits a message into lines as views into it.
+static void BM_SplitMessage_SplitView(benchmark::State& state) {
+  const auto text = CreateFtnText(static_cast<int>(state.range(0)));
+  const auto start = allocation_count();
+  for (auto _ : state) {
+    for (const auto line : SplitView(text, "\r", false)) {
+      benchmark::DoNotOptimize(line.data());
+    }
+  }
+  SetAllocationsPerItem(state, start);
+}
+BENCHMARK(BM_SplitMessage_SplitView)->Arg(1024)->Arg(16 * 1024);
+
+// Converts a FTN message to WWIV text, as networkf does on import.
+static void BM_FidoToWWIVText(benchmark::State& state) {
+  const auto text = CreateFtnText(static_cast<int>(state.range(0)));
+  const auto start = allocation_count();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FidoToWWIVText(text));
+  }
+  SetAllocationsPerItem(state, start);
+  state.SetBytesProcessed(state.iterations() * ssize(text));
+}
+BENCHMARK(BM_FidoToWWIVText)->Arg(1024)->Arg(16 * 1024);
+
+// Parses one nodelist line, as loading a nodelist does for every node.
+static void BM_ParseNodelistLine(benchmark::State& state) {
+  static const std::string kLine = "Hub,100,Bench_BBS,Somewhere_USA,Jane_Sysop,1-555-555-1212,"
+                                   "33600,CM,XA,V34,INA:bbs.example.com,IBN,ITN:2323";
+  const auto start = allocation_count();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(NodelistEntry::ParseDataLine(kLine));
+  }
+  SetAllocationsPerItem(state, start);
+}
+BENCHMARK(BM_ParseNodelistLine);
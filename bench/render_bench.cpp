@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "bbs/bbs_helper.h"
+#include "common/common_helper.h"
+#include "common/output.h"
+#include "common/pipe_expr.h"
+#include "common/value/uservalueprovider.h"
+#include "core/strings.h"
+#include "sdk/acs/eval.h"
+#include "sdk/ansi/ansi.h"
+#include "sdk/ansi/framebuffer.h"
+#include "sdk/config.h"
+#include "sdk/user.h"
+#include "benchmark/benchmark.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wwiv::common;
+using namespace wwiv::common::value;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::acs;
+using namespace wwiv::sdk::ansi;
+using namespace wwiv::strings;
+
+static const std::vector<uint8_t> kColors{7, 11, 14, 13, 31, 10, 12, 9, 5, 3};
+
+// A screen full of text with a mix of ANSI sequences, heart codes and pipe
+// codes, which is what menus and message text typically look like.
+static std::string CreateScreen() {
+  std::string s;
+  for (auto i = 0; i < 24; i++) {
+    s.append("\x1b[1;33m").append(StrCat(i)).append(". \x1b[0;36m");
+    s.append("|#2Message base |#1").append(std::string(20, 'x'));
+    s.append("\x03" "5 heart |15 pipe |09 codes\x1b[K\r\n");
+  }
+  return s;
+}
+
+// Evaluates an ACS expression from scratch, as each menu item and
+// conference check does.
+static void BM_AcsEval(benchmark::State& state, const std::string& expr) {
+  Config config("", config_t{});
+  config.set_initialized_for_test(true);
+  User user{};
+  user.sl(100);
+  user.dsl(100);
+  slrec sl{};
+  for (auto _ : state) {
+    Eval eval(expr);
+    eval.add(std::make_unique<UserValueProvider>(config, user, user.sl(), sl));
+    benchmark::DoNotOptimize(eval.eval());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_AcsEval, simple, std::string("user.sl>=50"));
+BENCHMARK_CAPTURE(BM_AcsEval, compound,
+                  std::string("user.sl>=50 && (user.dsl>20 || user.ar == 'A') && user.age>=18"));
+
+// Expands pipe expressions, as used in menus and prompts.
+static void BM_PipeEval(benchmark::State& state, const std::string& expr) {
+  CommonHelper helper;
+  helper.user()->set_name("USER 1");
+  helper.user()->sl(100);
+  helper.sess().effective_sl(100);
+  PipeEval eval(helper.context());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(eval.eval(expr));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_PipeEval, variable, std::string("{user.name}"));
+BENCHMARK_CAPTURE(BM_PipeEval, if_expr,
+                  std::string(R"({if "user.sl >= 200", "Senior Level", "Junior Level"})"));
+
+// Interprets a screen full of ANSI into a frame buffer, as the full screen
+// editor and message viewer do.
+static void BM_Ansi_Write(benchmark::State& state) {
+  const auto screen = CreateScreen();
+  for (auto _ : state) {
+    FrameBuffer b(80);
+    Ansi ansi(&b, {}, 0x07);
+    HeartAndPipeCodeFilter heart_and_pipe(&ansi, kColors);
+    for (const auto c : screen) {
+      heart_and_pipe.write(c);
+    }
+    heart_and_pipe.close();
+    benchmark::DoNotOptimize(b.rows());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(screen.size()));
+}
+BENCHMARK(BM_Ansi_Write);
+
+// Writes a screen full of text through Output::outstr to the local and
+// remote IO, including the pipe and heart code handling.
+static void BM_Output_Outstr(benchmark::State& state) {
+  BbsHelper helper;
+  helper.SetUp();
+  const auto screen = CreateScreen();
+  for (auto _ : state) {
+    bout.outstr(screen);
+    state.PauseTiming();
+    helper.io()->Clear();
+    state.ResumeTiming();
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(screen.size()));
+}
+BENCHMARK(BM_Output_Outstr);
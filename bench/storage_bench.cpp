@@ -0,0 +1,167 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "bench/bench_helper.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+#include "sdk/files/files.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/msgapi.h"
+#include "sdk/msgapi/type2_text.h"
+#include "sdk/vardec.h"
+#include "benchmark/benchmark.h"
+#include "fmt/format.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::files;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+
+// Loads all of user.lst at once, as the user list and user search do.
+static void BM_DataFile_ReadVector(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_users = static_cast<int>(state.range(0));
+  if (!bbs.CreateUsers(num_users)) {
+    state.SkipWithError("Unable to create users");
+    return;
+  }
+  const auto path = FilePath(bbs.datadir(), USER_LST);
+  for (auto _ : state) {
+    DataFile<userrec> f(path, File::modeBinary | File::modeReadOnly);
+    std::vector<userrec> users;
+    f.ReadVector(users);
+    benchmark::DoNotOptimize(users.data());
+  }
+  state.SetItemsProcessed(state.iterations() * (num_users + 1));
+}
+BENCHMARK(BM_DataFile_ReadVector)->Arg(10)->Arg(100);
+
+// Reads one record at a time from an open file, as readuser does.
+static void BM_DataFile_ReadRecord(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_users = static_cast<int>(state.range(0));
+  if (!bbs.CreateUsers(num_users)) {
+    state.SkipWithError("Unable to create users");
+    return;
+  }
+  DataFile<userrec> f(FilePath(bbs.datadir(), USER_LST), File::modeBinary | File::modeReadOnly);
+  userrec u{};
+  auto user_number = 0;
+  for (auto _ : state) {
+    f.Read(1 + user_number++ % num_users, &u);
+    benchmark::DoNotOptimize(u);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DataFile_ReadRecord)->Arg(100);
+
+// Reads the text of every post on a sub straight from the type 2 message file.
+static void BM_Type2Text_ReadFile(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_posts = static_cast<int>(state.range(0));
+  const auto subs = bbs.CreateSubs(1, num_posts, static_cast<int>(state.range(1)));
+  if (subs.empty()) {
+    state.SkipWithError("Unable to create sub");
+    return;
+  }
+  DataFile<postrec> sub(FilePath(bbs.datadir(), StrCat(subs.front().filename, ".sub")),
+                        File::modeBinary | File::modeReadOnly);
+  std::vector<postrec> posts;
+  sub.ReadVector(posts);
+  // Record 0 is the sub's header, not a post.
+  posts.erase(posts.begin());
+
+  Type2Text t(FilePath(bbs.msgsdir(), StrCat(subs.front().filename, ".dat")));
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    for (const auto& p : posts) {
+      const auto text = t.readfile(p.msg);
+      bytes += text ? ssize(*text) : 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ssize(posts));
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_Type2Text_ReadFile)->Args({100, 1024})->Args({100, 16 * 1024});
+
+// Saves and then removes a message, which walks and rewrites the GAT both times.
+static void BM_Type2Text_SaveAndRemove(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto text = BenchBbs::CreateText(static_cast<int>(state.range(0)));
+  Type2Text t(FilePath(bbs.msgsdir(), "bench.dat"));
+  for (auto _ : state) {
+    const auto m = t.savefile(text);
+    if (!m) {
+      state.SkipWithError("Unable to save message");
+      break;
+    }
+    benchmark::DoNotOptimize(t.remove_link(*m));
+  }
+  state.SetBytesProcessed(state.iterations() * ssize(text));
+}
+BENCHMARK(BM_Type2Text_SaveAndRemove)->Arg(1024)->Arg(16 * 1024);
+
+// Reads every message on a sub through the message API, as the message
+// scan does.
+static void BM_MessageArea_ReadMessage(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_posts = static_cast<int>(state.range(0));
+  const auto subs = bbs.CreateSubs(1, num_posts, 2048);
+  if (subs.empty()) {
+    state.SkipWithError("Unable to create sub");
+    return;
+  }
+  MessageApiOptions options;
+  WWIVMessageApi api(options, bbs.config(), {}, new NullLastReadImpl());
+  auto area = api.Open(subs.front(), -1);
+  for (auto _ : state) {
+    for (auto i = 1; i <= num_posts; i++) {
+      benchmark::DoNotOptimize(area->ReadMessage(i));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_posts);
+}
+BENCHMARK(BM_MessageArea_ReadMessage)->Arg(100);
+
+// Looks up the last file in a file area by name.
+static void BM_FileArea_FindFile(benchmark::State& state) {
+  BenchBbs bbs;
+  const auto num_files = static_cast<int>(state.range(0));
+  const auto dirs = bbs.CreateDirs(1, num_files);
+  if (dirs.empty()) {
+    state.SkipWithError("Unable to create file area");
+    return;
+  }
+  FileApi api(bbs.datadir());
+  auto area = api.Open(dirs.front());
+  const auto name = fmt::format("F{:07}.ZIP", num_files - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(area->FindFile(name));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FileArea_FindFile)->Arg(100)->Arg(1000);
@@ -21,6 +21,7 @@
 #include "binkp/binkp_config.h"
 #include "binkp/cram.h"
 #include "binkp/file_manager.h"
+#include "binkp/frame_compression.h"
 #include "binkp/net_log.h"
 #include "binkp/transfer_file.h"
 #include "core/connection.h"
@@ -114,6 +115,13 @@ bool BinkP::process_opt(const std::string& opt) {
       } else {
         LOG(INFO) << "       Not enabling CRC support (disabled in net.ini).";
       }
+    } else if (s == "PLZ") {
+      if (config_->compress()) {
+        LOG(INFO) << "       Enabling PLZ compression";
+        plz_ = true;
+      } else {
+        LOG(INFO) << "       Not enabling PLZ compression (disabled).";
+      }
     } else {
       LOG(INFO) << "       Unknown OPT: '" << s << "'";
     }
@@ -192,14 +200,23 @@ bool BinkP::process_command(int16_t length, duration<double> d) {
   return true;
 }
 
-bool BinkP::process_data(int16_t length, duration<double> d) {
+bool BinkP::process_data(int16_t length, bool compressed, duration<double> d) {
   if (!conn_->is_open()) {
     return false;
   }
-  const auto s = conn_->receive(length, d);
+  auto s = conn_->receive(length, d);
   LOG_IF(length != static_cast<int16_t>(s.size()), ERROR)
       << "RECV:  DATA PACKET; ** unexpected size** len: " << s.size() << "; expected: " << length
       << " duration:" << wwiv::core::to_string(d);
+  if (compressed) {
+    auto o = decompress_frame(s);
+    if (!o) {
+      LOG(ERROR) << "ERROR: Unable to decompress data frame of length: " << length;
+      return false;
+    }
+    compression_saved_ += size_int(o.value()) - size_int(s);
+    s = std::move(o.value());
+  }
   if (!current_receive_file_) {
     LOG(ERROR) << "ERROR: Received M_DATA with no current file.";
     return false;
@@ -278,7 +295,9 @@ bool BinkP::process_frames(const std::function<bool()>& predicate, duration<doub
         // process data frame.
         // note: always use a timeout of 10s to process data since dropping bytes
         // causes real problems.
-        if (!process_data(header & 0x7fff, seconds(10))) {
+        const auto compressed = plz_ && (header & kCompressedFrameFlag) != 0;
+        const auto length = header & (compressed ? kMaxCompressedFrameSize : 0x7fff);
+        if (!process_data(static_cast<int16_t>(length), compressed, seconds(10))) {
           // false return value mean san error occurred.
           return false;
         }
@@ -319,15 +338,16 @@ bool BinkP::send_command_packet(uint8_t command_id, const std::string& data) {
   return true;
 }
 
-bool BinkP::send_data_packet(const char* data, int packet_length) {
+bool BinkP::send_data_packet(const char* data, int packet_length, bool compressed) {
   if (!conn_->is_open()) {
     return false;
   }
   // for now assume everything fits within a single frame.
   const std::unique_ptr<char[]> packet(new char[packet_length + 2]);
   packet_length &= 0x7fff;
-  uint8_t b0 = ((packet_length & 0xff00) >> 8);
-  uint8_t b1 = packet_length & 0x00ff;
+  const auto header = compressed ? packet_length | kCompressedFrameFlag : packet_length;
+  uint8_t b0 = ((header & 0xff00) >> 8);
+  uint8_t b1 = header & 0x00ff;
   auto* p = packet.get();
   *p++ = b0;
   *p++ = b1;
@@ -370,6 +390,9 @@ BinkState BinkP::WaitConn() {
   if (config_->crc()) {
     send_command_packet(BinkpCommands::M_NUL, "OPT CRC");
   }
+  if (config_->compress()) {
+    send_command_packet(BinkpCommands::M_NUL, "OPT PLZ");
+  }
 
   std::string network_addresses;
   if (side_ == BinkSide::ANSWERING) {
@@ -702,34 +725,80 @@ bool BinkP::SendFilePacket(TransferFile* file) {
   VLOG(1) << "       SendFilePacket: " << filename;
   files_to_send_[filename] = std::unique_ptr<TransferFile>(file);
   send_command_packet(BinkpCommands::M_FILE, file->as_packet_data(0));
+  // The remote may answer with an M_GET to resume a file it already has part of.
+  sending_file_ = true;
   process_frames(seconds(2));
+  sending_file_ = false;
 
   // file* may not be viable anymore if it was already send.
   if (contains(files_to_send_, filename)) {
     // We have the file still to send.
-    SendFileData(file);
+    long offset = 0;
+    if (const auto it = get_requests_.find(filename); it != std::end(get_requests_)) {
+      offset = it->second;
+      get_requests_.erase(it);
+      send_command_packet(BinkpCommands::M_FILE, file->as_packet_data(offset));
+    }
+    SendFileData(file, offset);
   }
+  SendGetRequests();
   return true;
 }
 
-bool BinkP::SendFileData(TransferFile* file) {
-  VLOG(1) << "       SendFileData: " << file->filename();
+bool BinkP::SendFileData(TransferFile* file, long offset) {
+  const auto filename = file->filename();
+  VLOG(1) << "       SendFileData: " << filename << "; offset: " << offset;
   const auto file_length = file->file_size();
-  const auto chunk_size = 16384; // This is 1<<14.  The max per spec is (1 << 15) - 1
+  // This is 1<<14.  The max per spec is (1 << 15) - 1, but with PLZ the
+  // compressed flag takes another bit.
+  const auto chunk_size = plz_ ? kMaxCompressedFrameSize : 16384;
   const auto chunk = std::make_unique<char[]>(chunk_size);
-  for (long start = 0; start < file_length; start += chunk_size) {
+  const auto compress = plz_ && !is_compressed_file_type(filename);
+  sending_file_ = true;
+  for (auto start = offset; start < file_length;) {
     const auto size = std::min<int>(chunk_size, file_length - start);
     if (!file->GetChunk(chunk.get(), start, size)) {
       // Bad chunk. Abort
     }
-    send_data_packet(chunk.get(), size);
+    if (const auto c = compress ? compress_frame(chunk.get(), size) : std::nullopt) {
+      compression_saved_ += size - size_int(c.value());
+      send_data_packet(c->data(), size_int(c.value()), true);
+    } else {
+      send_data_packet(chunk.get(), size);
+    }
+    start += size;
     // sending multi-chunk files was not reliable.  check after each frame if we have
     // an inbound command.
     process_frames(seconds(1));
+    if (!contains(files_to_send_, filename)) {
+      // M_GOT was received, so file* is no longer viable.
+      break;
+    }
+    if (const auto it = get_requests_.find(filename); it != std::end(get_requests_)) {
+      // The remote wants the data from somewhere else, restart there.
+      start = it->second;
+      get_requests_.erase(it);
+      send_command_packet(BinkpCommands::M_FILE, file->as_packet_data(start));
+    }
   }
+  sending_file_ = false;
   return true;
 }
 
+void BinkP::SendGetRequests() {
+  while (!get_requests_.empty()) {
+    const auto [filename, offset] = *std::begin(get_requests_);
+    get_requests_.erase(std::begin(get_requests_));
+    const auto iter = files_to_send_.find(filename);
+    if (iter == std::end(files_to_send_)) {
+      continue;
+    }
+    auto* file = iter->second.get();
+    send_command_packet(BinkpCommands::M_FILE, file->as_packet_data(offset));
+    SendFileData(file, offset);
+  }
+}
+
 bool BinkP::HandlePassword(const std::string& password_line) {
   VLOG(1) << "        HandlePassword: ";
   VLOG(2) << "        password_line: " << password_line;
@@ -756,10 +825,6 @@ bool BinkP::HandlePassword(const std::string& password_line) {
 // M_FILE received.
 bool BinkP::HandleFileRequest(const std::string& request_line) {
   VLOG(1) << "       HandleFileRequest; request_line: " << request_line;
-  auto* old_file = current_receive_file_.release();
-  if (old_file != nullptr) {
-    LOG(ERROR) << "** ERROR: Got HandleFileRequest while still having an open receive file!";
-  }
   std::string filename;
   long expected_length;
   time_t timestamp;
@@ -769,10 +834,42 @@ bool BinkP::HandleFileRequest(const std::string& request_line) {
                             &crc)) {
     return false;
   }
+  auto skip = [&]() {
+    LOG(ERROR) << "Unable to receive: " << filename << " from offset: " << starting_offset;
+    send_command_packet(BinkpCommands::M_SKIP,
+                        fmt::format("{} {} {}", filename, expected_length, timestamp));
+    current_receive_file_.reset();
+    return false;
+  };
+
+  if (current_receive_file_ && current_receive_file_->resume_requested_ &&
+      current_receive_file_->same_file(filename, expected_length, timestamp)) {
+    // This answers our M_GET, the data that follows it starts at starting_offset.
+    return current_receive_file_->Resume(starting_offset) ? true : skip();
+  }
+  if (current_receive_file_) {
+    LOG(ERROR) << "** ERROR: Got HandleFileRequest while still having an open receive file!";
+    // Destroying it keeps what was received so it can be resumed later.
+    current_receive_file_.reset();
+  }
+
   const auto net = remote_.network_name();
-  auto* p = new ReceiveFile(received_transfer_file_factory_(net, filename), filename,
-                            expected_length, timestamp, crc);
-  current_receive_file_.reset(p);
+  auto* file = received_transfer_file_factory_(net, filename);
+  current_receive_file_ =
+      std::make_unique<ReceiveFile>(file, filename, expected_length, timestamp, crc);
+  const auto offset = file->PartialReceiveOffset(expected_length, timestamp);
+  // An offset of -1 means the sender waits for an M_GET before sending anything.
+  if (starting_offset >= 0 && !current_receive_file_->Resume(starting_offset)) {
+    return skip();
+  }
+  if (starting_offset < 0 || offset > starting_offset) {
+    // Ask for the rest of the file.  Until the sender answers, keep writing
+    // whatever it already sent since that is the same data at the same place.
+    LOG(INFO) << "       Requesting " << filename << " from offset: " << offset;
+    current_receive_file_->resume_requested_ = true;
+    send_command_packet(BinkpCommands::M_GET,
+                        fmt::format("{} {} {} {}", filename, expected_length, timestamp, offset));
+  }
   return true;
 }
 
@@ -786,17 +883,22 @@ bool BinkP::HandleFileGetRequest(const std::string& request_line) {
   if (s.size() >= 4) {
     offset = to_number<long>(s.at(3));
   }
-  if (offset != 0) {
-    LOG(WARNING) << "offset specified in FileGetRequest.  We don't support offset != 0";
-  }
 
   const auto iter = files_to_send_.find(filename);
   if (iter == end(files_to_send_)) {
     LOG(ERROR) << "File not found: " << filename;
     return false;
   }
-  return SendFileData(iter->second.get());
+  if (offset < 0 || offset > iter->second->file_size()) {
+    LOG(ERROR) << "Invalid offset: " << offset << " requested for: " << filename;
+    return false;
+  }
+  get_requests_[filename] = offset;
+  if (!sending_file_) {
+    SendGetRequests();
+  }
   // File was sent but wait until we receive M_GOT before we remove it from the list.
+  return true;
 }
 
 bool BinkP::HandleFileGotRequest(const std::string& request_line) {
@@ -901,6 +1003,9 @@ void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
     LOG(ERROR) << "STATE: BinkP::RunOriginatingLoop() socket_error: " << e.what();
   }
 
+  if (plz_) {
+    LOG(INFO) << "       PLZ compression saved: " << compression_saved_ << " bytes.";
+  }
   const auto network_log_side = side_ == BinkSide::ORIGINATING ? NetworkSide::TO : NetworkSide::FROM;
   NetworkLog net_log(config_->gfiles_directory());
   const auto end_time = system_clock::now();
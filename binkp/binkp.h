@@ -86,10 +86,11 @@ private:
  
   bool process_opt(const std::string& opt);
   bool process_command(int16_t length, std::chrono::duration<double> d);
-  bool process_data(int16_t length, std::chrono::duration<double> d);
+  // compressed is true for a data frame sent with the "OPT PLZ" compressed flag.
+  bool process_data(int16_t length, bool compressed, std::chrono::duration<double> d);
 
   bool send_command_packet(uint8_t command_id, const std::string& data);
-  bool send_data_packet(const char* data, int size);
+  bool send_data_packet(const char* data, int size, bool compressed = false);
 
   void process_network_files(const wwiv::core::CommandLine& cmdline) const;
 
@@ -109,7 +110,10 @@ private:
   BinkState Unknown();
   BinkState FatalError();
   bool SendFilePacket(TransferFile* file);
-  bool SendFileData(TransferFile* file);
+  // Sends the data of file starting at offset.
+  bool SendFileData(TransferFile* file, long offset);
+  // Answers any M_GET requests received while another file was being sent.
+  void SendGetRequests();
   bool HandleFileGetRequest(const std::string& request_line);
   bool HandleFileGotRequest(const std::string& request_line);
   bool HandlePassword(const std::string& password_line);
@@ -122,6 +126,11 @@ private:
   bool ok_received_ = false;
   bool eob_received_ = false;
   std::map<std::string, std::unique_ptr<TransferFile>> files_to_send_;
+  // Offsets requested by M_GET, keyed by filename, that have not been sent yet.
+  std::map<std::string, long> get_requests_;
+  // True while a file is being offered or its data sent, M_GET requests
+  // are only queued then so data for two files is never interleaved.
+  bool sending_file_ = false;
   BinkSide side_;
   const std::string expected_remote_node_;
   std::string remote_password_;
@@ -136,6 +145,10 @@ private:
   // Auth type used.
   AuthType auth_type_ = AuthType::PLAIN_TEXT;
   bool crc_ = false;
+  // Both sides sent "OPT PLZ", so data frames may be compressed.
+  bool plz_ = false;
+  // Bytes not sent over the wire in either direction thanks to compression.
+  long compression_saved_ = 0;
 
   std::unique_ptr<FileManager> file_manager_;
   Remote remote_;
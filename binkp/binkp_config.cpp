@@ -96,6 +96,10 @@ std::string BinkConfig::receive_dir(const std::string& network_name) const {
   return dir;
 }
 
+std::filesystem::path BinkConfig::partial_dir(const std::string& network_name) const {
+  return wwiv::core::FilePath(network_dir(network_name), "partial");
+}
+
 static Network test_net(const std::string& network_dir) {
   Network net(network_type_t::wwivnet, "WWIVnet");
   net.sysnum = 1;
@@ -50,6 +50,11 @@ public:
   [[nodiscard]] std::filesystem::path network_dir(const std::string& network_name) const;
   /** Get the directory to receive files into for network named network_name */
   [[nodiscard]] std::string receive_dir(const std::string& network_name) const;
+  /**
+   * Get the directory that keeps partially received files for network named
+   * network_name between sessions so that they may be resumed.
+   */
+  [[nodiscard]] std::filesystem::path partial_dir(const std::string& network_name) const;
 
   [[nodiscard]] const sdk::net::Network& network(const std::string& network_name) const;
   [[nodiscard]] const sdk::net::Network& callout_network() const;
@@ -69,6 +74,9 @@ public:
   [[nodiscard]] int network_version() const { return network_version_; }
   [[nodiscard]] bool crc() const { return crc_; }
   [[nodiscard]] bool cram_md5() const { return cram_md5_; }
+  void set_compress(bool compress) { compress_ = compress; }
+  // Offer "OPT PLZ" to compress data frames when the remote supports it.
+  [[nodiscard]] bool compress() const { return compress_; }
   [[nodiscard]] const sdk::Config& config() const { return config_; }
 
   [[nodiscard]] std::string session_identifier() const { return session_identifier_; }
@@ -94,6 +102,7 @@ private:
   int network_version_{38};
   bool crc_{true};
   bool cram_md5_{true};
+  bool compress_{true};
   std::string session_identifier_;
 };
 
@@ -20,16 +20,25 @@
 #include "binkp/binkp_config.h"
 #include "binkp/transfer_file.h"
 #include "binkp/fake_connection.h"
+#include "binkp/frame_compression.h"
+#include "binkp/wfile_transfer_file.h"
 #include "core/file.h"
+#include "core/stl.h"
 #include "core/strings.h"
 #include "core/test/file_helper.h"
+#include "fmt/format.h"
 #include "sdk/net/callout.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <chrono>
 #include <string>
 #include <thread>
 
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
 using wwiv::sdk::Callout;
+using wwiv::stl::size_int;
 using namespace wwiv::core;
 using namespace wwiv::net;
 using namespace wwiv::sdk::fido;
@@ -87,6 +96,184 @@ TEST_F(BinkTest, ErrorAbortsSession) {
   }
 }
 
+static const std::string REMOTE_ADDRESS = "20000:20000/2@wwivnet";
+
+// Runs answering sessions that complete the handshake, so that files can be
+// transferred over the fake connection.
+class BinkSessionTest : public testing::Test {
+protected:
+  BinkSessionTest() {
+    CHECK(files_.Mkdir("network"));
+    CHECK(files_.Mkdir("gfiles"));
+    CHECK(files_.Mkdir("recv"));
+    wwiv::sdk::config_t c{};
+    c.systemname = "Test System";
+    c.sysopname = "Test Sysop";
+    config_ = std::make_unique<wwiv::sdk::Config>(File::current_directory(), c);
+    config_->gfilesdir(files_.DirName("gfiles"));
+    binkp_config_ =
+        std::make_unique<BinkConfig>(ORIGINATING_ADDRESS, *config_, files_.DirName("network"));
+    binkp_config_->callouts()["wwivnet"] =
+        std::make_unique<Callout>(binkp_config_->callout_network(), 0);
+    binkp_config_->address_pw_map.try_emplace(FidoAddress(REMOTE_ADDRESS), "-");
+    binkp_config_->set_skip_net(true);
+  }
+
+  void Start(FakeConnection& conn) {
+    BinkP::received_transfer_file_factory_t factory = [this](const std::string&,
+                                                             const std::string& filename) {
+      return new WFileTransferFile(filename, std::make_unique<File>(recv_path(filename)),
+                                   partial_dir());
+    };
+    conn.Open();
+    conn.ReplyCommand(BinkpCommands::M_ADR, REMOTE_ADDRESS);
+    conn.ReplyCommand(BinkpCommands::M_PWD, "-");
+    binkp_ = std::make_unique<BinkP>(&conn, binkp_config_.get(), BinkSide::ANSWERING,
+                                     ANSWERING_ADDRESS, factory);
+    thread_ = std::thread([this]() {
+      const CommandLine cmdline({"networkb_tests.exe"}, "");
+      binkp_->Run(cmdline);
+    });
+    WaitForCommand(conn, BinkpCommands::M_OK);
+  }
+
+  void Stop() {
+    thread_.join();
+    binkp_.reset();
+  }
+
+  // Waits for the session to send the next packet.
+  static FakeBinkpPacket WaitForPacket(FakeConnection& conn) {
+    const auto timeout = steady_clock::now() + seconds(10);
+    while (!conn.has_sent_packets()) {
+      if (steady_clock::now() > timeout) {
+        throw std::runtime_error("Timed out waiting for a packet.");
+      }
+      std::this_thread::sleep_for(milliseconds(10));
+    }
+    return conn.GetNextPacket();
+  }
+
+  // Waits for the session to send command_id, returning the data sent with it.
+  static std::string WaitForCommand(FakeConnection& conn, uint8_t command_id) {
+    for (;;) {
+      const auto packet = WaitForPacket(conn);
+      if (packet.is_command() && packet.command() == command_id) {
+        return packet.data().substr(1);
+      }
+    }
+  }
+
+  [[nodiscard]] std::filesystem::path recv_path(const std::string& filename) const {
+    return FilePath(files_.DirName("recv"), filename);
+  }
+
+  [[nodiscard]] std::filesystem::path partial_dir() const {
+    return FilePath(files_.TempDir(), "partial");
+  }
+
+  std::unique_ptr<wwiv::sdk::Config> config_;
+  std::unique_ptr<BinkConfig> binkp_config_;
+  std::unique_ptr<BinkP> binkp_;
+  std::thread thread_;
+  wwiv::core::test::FileHelper files_;
+};
+
+TEST_F(BinkSessionTest, Receive_ResumesAfterDroppedSession) {
+  {
+    FakeConnection conn;
+    Start(conn);
+    conn.ReplyCommand(BinkpCommands::M_FILE, "s2.net 20 1600000000 0");
+    conn.ReplyData("0123456789");
+    // Drop the connection half way through the file.
+    while (conn.has_received_packets()) {
+      std::this_thread::sleep_for(milliseconds(10));
+    }
+    conn.close();
+    Stop();
+  }
+  EXPECT_FALSE(File::Exists(recv_path("s2.net")));
+  EXPECT_TRUE(File::Exists(FilePath(partial_dir(), "s2.net.part")));
+
+  FakeConnection conn;
+  Start(conn);
+  conn.ReplyCommand(BinkpCommands::M_FILE, "s2.net 20 1600000000 0");
+  EXPECT_EQ("s2.net 20 1600000000 10", WaitForCommand(conn, BinkpCommands::M_GET));
+  conn.ReplyCommand(BinkpCommands::M_FILE, "s2.net 20 1600000000 10");
+  conn.ReplyData("ABCDEFGHIJ");
+  EXPECT_EQ("s2.net 20 1600000000", WaitForCommand(conn, BinkpCommands::M_GOT));
+  conn.ReplyCommand(BinkpCommands::M_EOB, "Thank you.");
+  Stop();
+
+  EXPECT_EQ("0123456789ABCDEFGHIJ", files_.ReadFile(recv_path("s2.net")));
+  EXPECT_FALSE(File::Exists(FilePath(partial_dir(), "s2.net.part")));
+  EXPECT_FALSE(File::Exists(FilePath(partial_dir(), "s2.net.resume")));
+}
+
+TEST_F(BinkSessionTest, Send_HonorsGetOffset) {
+  files_.CreateTempFile("network/s2.net", "0123456789ABCDEFGHIJ");
+
+  FakeConnection conn;
+  Start(conn);
+  const auto offer = SplitString(WaitForCommand(conn, BinkpCommands::M_FILE), " ");
+  ASSERT_GE(offer.size(), 4u);
+  EXPECT_EQ("0", offer.at(3));
+  const auto& timestamp = offer.at(2);
+
+  conn.ReplyCommand(BinkpCommands::M_GET, fmt::format("s2.net 20 {} 10", timestamp));
+  const auto resumed = SplitString(WaitForCommand(conn, BinkpCommands::M_FILE), " ");
+  ASSERT_GE(resumed.size(), 4u);
+  EXPECT_EQ("10", resumed.at(3));
+  const auto data = WaitForPacket(conn);
+  EXPECT_FALSE(data.is_command());
+  EXPECT_EQ("ABCDEFGHIJ", data.data());
+
+  conn.ReplyCommand(BinkpCommands::M_GOT, fmt::format("s2.net 20 {}", timestamp));
+  conn.ReplyCommand(BinkpCommands::M_EOB, "Thank you.");
+  Stop();
+  EXPECT_FALSE(File::Exists(FilePath(files_.DirName("network"), "s2.net")));
+}
+
+TEST_F(BinkSessionTest, Receive_CompressedFrames) {
+  const std::string contents(4000, 'x');
+  const auto compressed = compress_frame(contents.data(), size_int(contents));
+  ASSERT_TRUE(compressed.has_value());
+
+  FakeConnection conn;
+  conn.ReplyCommand(BinkpCommands::M_NUL, "OPT PLZ");
+  Start(conn);
+  conn.ReplyCommand(BinkpCommands::M_FILE, "s2.net 4000 1600000000 0");
+  conn.ReplyData(compressed.value(), true);
+  EXPECT_EQ("s2.net 4000 1600000000", WaitForCommand(conn, BinkpCommands::M_GOT));
+  conn.ReplyCommand(BinkpCommands::M_EOB, "Thank you.");
+  Stop();
+
+  EXPECT_EQ(contents, files_.ReadFile(recv_path("s2.net")));
+}
+
+TEST_F(BinkSessionTest, Send_CompressesWhenRemoteOffersPlz) {
+  std::string contents;
+  for (auto i = 0; i < 100; i++) {
+    contents += fmt::format("Line {} of a very compressible message.\r\n", i);
+  }
+  files_.CreateTempFile("network/s2.net", contents);
+
+  FakeConnection conn;
+  conn.ReplyCommand(BinkpCommands::M_NUL, "OPT PLZ");
+  Start(conn);
+  const auto offer = SplitString(WaitForCommand(conn, BinkpCommands::M_FILE), " ");
+  ASSERT_GE(offer.size(), 3u);
+  const auto data = WaitForPacket(conn);
+  ASSERT_FALSE(data.is_command());
+  EXPECT_NE(0, data.header() & kCompressedFrameFlag);
+  EXPECT_LT(data.data().size(), contents.size());
+  EXPECT_EQ(contents, decompress_frame(data.data()).value_or(""));
+
+  conn.ReplyCommand(BinkpCommands::M_GOT, fmt::format("s2.net {} {}", contents.size(), offer.at(2)));
+  conn.ReplyCommand(BinkpCommands::M_EOB, "Thank you.");
+  Stop();
+}
+
 static int node_number_from_address_list(const std::string& addresses,
                                          const std::string& network_name) {
   const auto a = ftn_address_from_address_list(addresses, network_name);
@@ -20,6 +20,7 @@
 #include "core/os.h"
 #include "core/scope_exit.h"
 #include "core/socket_exceptions.h"
+#include "core/stl.h"
 #include "core/strings.h"
 #include "binkp/binkp_commands.h"
 #include <chrono>
@@ -36,17 +37,15 @@ using namespace wwiv::strings;
 using namespace wwiv::net;
 
 FakeBinkpPacket::FakeBinkpPacket(const void* data, int size) {
-  auto p = static_cast<const char*>(data);
-  header_ = *p++ << 8;
+  auto p = static_cast<const uint8_t*>(data);
+  header_ = static_cast<uint16_t>(*p++ << 8);
   header_ = header_ | *p++;
-  is_command_ = (header_ | 0x8000) != 0;
+  is_command_ = (header_ & 0x8000) != 0;
   header_ &= 0x7fff;
 
-  if (is_command_) {
-    command_ = *p;
-  }
+  command_ = is_command_ ? *p : 0;
   // size doesn't include the uint16_t header.
-  data_ = std::string(p, size - 2);  
+  data_ = std::string(reinterpret_cast<const char*>(p), size - 2);
 }
 
 FakeBinkpPacket::~FakeBinkpPacket() = default;
@@ -101,7 +100,12 @@ uint8_t FakeConnection::read_uint8(std::chrono::duration<double> d) {
   if (!front.is_command()) {
     throw std::logic_error("called read_uint8 on a data packet");
   }
-  return front.command();
+  const auto command = front.command();
+  if (front.data().size() <= 1) {
+    // There's no data after the command, so nothing else will be read.
+    receive_queue_.pop();
+  }
+  return command;
 }
 
 int FakeConnection::receive(void* data, int size, duration<double> d) {
@@ -122,7 +126,8 @@ std::string FakeConnection::receive(int, duration<double> d) {
   std::lock_guard<std::mutex> lock(mu_);
   auto on_exit = finally([=] { receive_queue_.pop(); });
   const FakeBinkpPacket& front = receive_queue_.front();
-  return front.data();
+  // The command was already read by read_uint8.
+  return front.is_command() ? front.data().substr(1) : front.data();
 }
 
 int FakeConnection::send(const void* data, int size, std::chrono::duration<double>) {
@@ -136,6 +141,11 @@ int FakeConnection::send(const std::string& s, std::chrono::duration<double> d)
   return send(s.data(), s.length(), d);
 }
 
+bool FakeConnection::has_received_packets() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return !receive_queue_.empty();
+}
+
 bool FakeConnection::has_sent_packets() const {
   std::lock_guard<std::mutex> lock(mu_);
   return !send_queue_.empty();
@@ -171,5 +181,23 @@ void FakeConnection::ReplyCommand(int8_t command_id, const std::string& data) {
   receive_queue_.push(FakeBinkpPacket(packet.get(), size));
 }
 
+void FakeConnection::ReplyData(const std::string& data, bool compressed) {
+  const int size = 2 + wwiv::stl::size_int(data);
+  std::unique_ptr<char[]> packet(new char[size]);
+  auto packet_length = static_cast<uint16_t>(data.size()) & 0x7fff;
+  if (compressed) {
+    packet_length |= 0x4000;
+  }
+
+  auto* p = packet.get();
+  *p++ = static_cast<char>((packet_length & 0xff00) >> 8);
+  *p++ = static_cast<char>(packet_length & 0x00ff);
+  memcpy(p, data.data(), data.size());
+
+  std::lock_guard<std::mutex> lock(mu_);
+  receive_queue_.push(FakeBinkpPacket(packet.get(), size));
+}
+
+void FakeConnection::Open() { open_ = true; }
 bool FakeConnection::is_open() const { return open_; }
 bool FakeConnection::close() { open_ = false; return true; }
\ No newline at end of file
@@ -19,6 +19,7 @@
 #define INCLUDED_BINKP_TEST_FAKE_CONNECTION_H
 
 #include "core/connection.h"
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <mutex>
@@ -62,9 +63,15 @@ public:
   bool is_open() const override;
   bool close() override;
 
+  // Connections start closed, this makes is_open() true.
+  void Open();
+  // True if any replies have not been read yet.
+  bool has_received_packets() const;
   bool has_sent_packets() const;
   FakeBinkpPacket GetNextPacket();
   void ReplyCommand(int8_t command_id, const std::string& data);
+  // Queues a data frame, flagged as compressed for "OPT PLZ" when compressed is true.
+  void ReplyData(const std::string& data, bool compressed = false);
 
   // GUARDED_BY(mu_)
   std::queue<FakeBinkpPacket> receive_queue_;
@@ -72,7 +79,7 @@ public:
   std::queue<FakeBinkpPacket> send_queue_;
 private:
   mutable std::mutex mu_;
-  bool open_{};
+  std::atomic<bool> open_{};
 };
 
 #endif
\ No newline at end of file
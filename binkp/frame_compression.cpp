@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "binkp/frame_compression.h"
+
+#include "core/strings.h"
+#include <cctype>
+#include <set>
+#include <string>
+#include <zlib.h>
+
+using namespace wwiv::strings;
+
+namespace wwiv::net {
+
+std::optional<std::string> compress_frame(const char* data, int size) {
+  auto out_size = compressBound(static_cast<uLong>(size));
+  std::string out(out_size, '\0');
+  if (compress2(reinterpret_cast<Bytef*>(&out[0]), &out_size,
+                reinterpret_cast<const Bytef*>(data), static_cast<uLong>(size),
+                Z_DEFAULT_COMPRESSION) != Z_OK) {
+    return std::nullopt;
+  }
+  if (out_size >= static_cast<uLong>(size) || out_size > kMaxCompressedFrameSize) {
+    return std::nullopt;
+  }
+  out.resize(out_size);
+  return out;
+}
+
+std::optional<std::string> decompress_frame(const std::string& data) {
+  std::string out(kMaxUncompressedFrameSize, '\0');
+  auto out_size = static_cast<uLongf>(out.size());
+  if (uncompress(reinterpret_cast<Bytef*>(&out[0]), &out_size,
+                 reinterpret_cast<const Bytef*>(data.data()),
+                 static_cast<uLong>(data.size())) != Z_OK) {
+    return std::nullopt;
+  }
+  out.resize(out_size);
+  return out;
+}
+
+bool is_compressed_file_type(const std::string& filename) {
+  static const std::set<std::string> extensions{"7Z",  "ARC", "ARJ", "BZ2", "GIF", "GZ",
+                                                "JPG", "LHA", "LZH", "MP3", "PNG", "RAR",
+                                                "TGZ", "XZ",  "ZIP", "ZOO"};
+  const auto idx = filename.rfind('.');
+  if (idx == std::string::npos) {
+    return false;
+  }
+  const auto ext = ToStringUpperCase(filename.substr(idx + 1));
+  if (extensions.count(ext)) {
+    return true;
+  }
+  // FTN mail bundles are archives named for the day of the week they were
+  // created on, such as 0000FFFF.MO0 or 0000FFFF.SU1.
+  static const std::set<std::string> days{"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+  return ext.size() == 3 && days.count(ext.substr(0, 2)) &&
+         std::isalnum(static_cast<unsigned char>(ext.back()));
+}
+
+}  // namespace wwiv::net
@@ -0,0 +1,50 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_BINKP_FRAME_COMPRESSION_H
+#define INCLUDED_BINKP_FRAME_COMPRESSION_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace wwiv::net {
+
+// Set in the header of a data frame holding compressed data when both sides
+// sent "OPT PLZ".
+static constexpr uint16_t kCompressedFrameFlag = 0x4000;
+// Largest data frame that can be sent when "OPT PLZ" is in use, since the
+// compressed flag takes one of the bits otherwise used for the length.
+static constexpr int kMaxCompressedFrameSize = 0x3fff;
+// Largest frame a compressed frame may expand to.
+static constexpr int kMaxUncompressedFrameSize = 0x7fff;
+
+// Compresses one data frame.  Returns std::nullopt when compressing would not
+// make the frame any smaller, in which case it should be sent as is.
+std::optional<std::string> compress_frame(const char* data, int size);
+
+// Decompresses a data frame that was sent with kCompressedFrameFlag.
+std::optional<std::string> decompress_frame(const std::string& data);
+
+// True if filename is an archive or other already compressed file that isn't
+// worth compressing again.
+bool is_compressed_file_type(const std::string& filename);
+
+}  // namespace wwiv::net
+
+#endif
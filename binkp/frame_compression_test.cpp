@@ -0,0 +1,65 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "binkp/frame_compression.h"
+
+#include "core/stl.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <string>
+
+using namespace wwiv::net;
+using wwiv::stl::size_int;
+
+TEST(FrameCompressionTest, RoundTrip) {
+  std::string s;
+  for (auto i = 0; i < 200; i++) {
+    s += fmt::format("Message {} from 1@2 to 1@1.\r\n", i);
+  }
+  const auto c = compress_frame(s.data(), size_int(s));
+  ASSERT_TRUE(c.has_value());
+  EXPECT_LT(c->size(), s.size());
+  EXPECT_EQ(s, decompress_frame(c.value()).value_or(""));
+}
+
+TEST(FrameCompressionTest, Incompressible) {
+  std::mt19937 gen(1);
+  std::string s;
+  for (auto i = 0; i < 4096; i++) {
+    s.push_back(static_cast<char>(gen() & 0xff));
+  }
+  EXPECT_FALSE(compress_frame(s.data(), size_int(s)).has_value());
+}
+
+TEST(FrameCompressionTest, Decompress_Garbage) {
+  EXPECT_FALSE(decompress_frame("not a compressed frame").has_value());
+}
+
+TEST(FrameCompressionTest, IsCompressedFileType) {
+  EXPECT_TRUE(is_compressed_file_type("foo.zip"));
+  EXPECT_TRUE(is_compressed_file_type("FOO.ZIP"));
+  EXPECT_TRUE(is_compressed_file_type("nodelist.7z"));
+  EXPECT_TRUE(is_compressed_file_type("0000ffff.mo0"));
+  EXPECT_TRUE(is_compressed_file_type("0000FFFF.SU9"));
+
+  EXPECT_FALSE(is_compressed_file_type("s1.net"));
+  EXPECT_FALSE(is_compressed_file_type("0000ffff.pkt"));
+  EXPECT_FALSE(is_compressed_file_type("foo.tic"));
+  EXPECT_FALSE(is_compressed_file_type("noext"));
+}
@@ -56,6 +56,23 @@ public:
     return true;
   }
 
+  // Continues receiving at offset, which is where the sender says the data
+  // that follows its M_FILE starts.
+  bool Resume(long offset) {
+    if (!file_->SetReceiveOffset(static_cast<int>(offset))) {
+      return false;
+    }
+    length_ = offset;
+    return true;
+  }
+
+  // True if this is the same file as described by an M_FILE.
+  [[nodiscard]] bool same_file(const std::string& filename, long expected_length,
+                               time_t timestamp) const {
+    return filename_ == filename && expected_length_ == expected_length &&
+           timestamp_ == timestamp;
+  }
+
   [[nodiscard]] std::string filename() const { return filename_; }
   [[nodiscard]] long expected_length() const { return expected_length_; }
   [[nodiscard]] long length() const { return length_; }
@@ -69,6 +86,8 @@ public:
   time_t timestamp_{0};
   long length_{0};
   uint32_t crc_{0};
+  // Set once an M_GET has been sent asking to resume this file.
+  bool resume_requested_{false};
 };
 
 } // namespace
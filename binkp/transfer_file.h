@@ -41,6 +41,14 @@ public:
   virtual bool WriteChunk(const char* chunk, int size) = 0;
   virtual bool Close() = 0;
 
+  // Returns how many bytes of a file of this size and timestamp were already
+  // received by an earlier session, or 0 if it has to be received from the
+  // start.
+  virtual int PartialReceiveOffset(int /* size */, time_t /* timestamp */) { return 0; }
+  // Makes the next WriteChunk write at offset.  Only offsets up to what has
+  // already been received are valid.
+  virtual bool SetReceiveOffset(int offset) { return offset == 0; }
+
  protected:
   [[nodiscard]] std::string as_packet_data(int size, int offset) const;
 
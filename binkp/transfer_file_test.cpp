@@ -139,3 +139,58 @@ TEST_F(TransferFileTest, WFileTest_Write) {
   // Needed wfile_file to go out of scope before the file can be read.
   EXPECT_EQ(contents, file_helper_.ReadFile(empty_file_fullpath));
 }
+
+TEST_F(TransferFileTest, WFileTest_Write_PartUntilClose) {
+  const auto path = file_helper_.CreateTempFilePath("recv");
+  WFileTransferFile wfile_file("recv", std::make_unique<File>(path));
+  ASSERT_TRUE(wfile_file.WriteChunk(contents.c_str(), contents.size()));
+  EXPECT_FALSE(File::Exists(path));
+
+  ASSERT_TRUE(wfile_file.Close());
+  EXPECT_EQ(contents, file_helper_.ReadFile(path));
+  EXPECT_FALSE(File::Exists(wfile_file.part_path()));
+  EXPECT_FALSE(File::Exists(wfile_file.resume_path()));
+}
+
+TEST_F(TransferFileTest, WFileTest_Resume) {
+  const auto partial = FilePath(file_helper_.TempDir(), "partial");
+  const auto path = file_helper_.CreateTempFilePath("recv");
+  {
+    WFileTransferFile wfile_file("recv", std::make_unique<File>(path), partial);
+    EXPECT_EQ(0, wfile_file.PartialReceiveOffset(8, 1234));
+    ASSERT_TRUE(wfile_file.SetReceiveOffset(0));
+    ASSERT_TRUE(wfile_file.WriteChunk(contents.c_str(), contents.size()));
+    // Session ends before the file is complete.
+  }
+  EXPECT_FALSE(File::Exists(path));
+  EXPECT_EQ("8 1234 4\n", file_helper_.ReadFile(FilePath(partial, "recv.resume")));
+
+  WFileTransferFile wfile_file("recv", std::make_unique<File>(path), partial);
+  EXPECT_EQ(4, wfile_file.PartialReceiveOffset(8, 1234));
+  // Can't skip past what was already received.
+  EXPECT_FALSE(wfile_file.SetReceiveOffset(5));
+  ASSERT_TRUE(wfile_file.SetReceiveOffset(4));
+  ASSERT_TRUE(wfile_file.WriteChunk("ZXCV", 4));
+  EXPECT_EQ(8, wfile_file.file_size());
+  ASSERT_TRUE(wfile_file.Close());
+
+  EXPECT_EQ("ASDFZXCV", file_helper_.ReadFile(path));
+  EXPECT_FALSE(File::Exists(FilePath(partial, "recv.part")));
+  EXPECT_FALSE(File::Exists(FilePath(partial, "recv.resume")));
+}
+
+TEST_F(TransferFileTest, WFileTest_Resume_DifferentFile) {
+  const auto partial = FilePath(file_helper_.TempDir(), "partial");
+  const auto path = file_helper_.CreateTempFilePath("recv");
+  {
+    WFileTransferFile wfile_file("recv", std::make_unique<File>(path), partial);
+    EXPECT_EQ(0, wfile_file.PartialReceiveOffset(8, 1234));
+    ASSERT_TRUE(wfile_file.WriteChunk(contents.c_str(), contents.size()));
+  }
+
+  WFileTransferFile wfile_file("recv", std::make_unique<File>(path), partial);
+  // Different timestamp, so start over.
+  EXPECT_EQ(0, wfile_file.PartialReceiveOffset(8, 5678));
+  EXPECT_FALSE(File::Exists(FilePath(partial, "recv.part")));
+  EXPECT_FALSE(File::Exists(FilePath(partial, "recv.resume")));
+}
@@ -20,11 +20,19 @@
 #include "core/crc32.h"
 #include "core/datetime.h"
 #include "core/log.h"
+#include "core/stl.h"
 #include "core/strings.h"
+#include "core/textfile.h"
+#include "fmt/format.h"
 #include "sdk/fido/fido_util.h"
 #include <algorithm>
 #include <chrono>
 #include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#endif
 
 using std::chrono::seconds;
 using std::chrono::system_clock;
@@ -35,6 +43,23 @@ using namespace wwiv::strings;
 
 namespace wwiv::net {
 
+// Received data is written to disk once this much has been buffered.
+static constexpr int kReceiveBufferSize = 256 * 1024;
+
+// Reserves the space for the whole file up front so that it is not
+// fragmented by growing 16K at a time.
+static void preallocate(const File& f, int size) {
+#ifdef __linux__
+  if (const auto r = posix_fallocate(f.handle(), 0, size); r != 0) {
+    VLOG(1) << "Unable to preallocate " << size << " bytes for: " << f << "; error: " << r;
+  }
+#else
+  // Only a hint, so nothing to do where posix_fallocate isn't available.
+  (void)f;
+  (void)size;
+#endif
+}
+
 WFileTransferFile::WFileTransferFile(const std::string& filename, std::unique_ptr<File>&& file)
     : TransferFile(filename, file->Exists() ? file->last_write_time() : time_t_now(),
                    crc32file(file->path())),
@@ -46,10 +71,25 @@ WFileTransferFile::WFileTransferFile(const std::string& filename, std::unique_pt
   }
 }
 
-WFileTransferFile::~WFileTransferFile() = default;
+WFileTransferFile::WFileTransferFile(const std::string& filename, std::unique_ptr<File>&& file,
+                                     std::filesystem::path partial_dir)
+    : WFileTransferFile(filename, std::move(file)) {
+  partial_dir_ = std::move(partial_dir);
+}
+
+WFileTransferFile::~WFileTransferFile() {
+  if (part_file_) {
+    FlushReceiveBuffer();
+  }
+}
 
 // TODO(rushfan): This needs to be fixed to handle >2GB files.
-int WFileTransferFile::file_size() const { return static_cast<int>(file_->length()); }
+int WFileTransferFile::file_size() const {
+  if (part_file_) {
+    return receive_offset_ + stl::size_int(receive_buffer_);
+  }
+  return static_cast<int>(file_->length());
+}
 
 bool WFileTransferFile::Delete() {
   // Since this file may still be open, need to ensure
@@ -95,24 +135,145 @@ bool WFileTransferFile::GetChunk(char* chunk, int start, int size) {
 
 bool WFileTransferFile::WriteChunk(const char* chunk, int size) {
   VLOG(3) << "WFileTransferFile::WriteChunk";
-  if (!file_->IsOpen()) {
-    if (file_->Exists()) {
-      // Don't overwrite an existing file.  Rename it away to: FILENAME.timestamp
-      auto newpath = file_->path();
-      newpath += StrCat(".", system_clock::to_time_t(system_clock::now()));
-      File::Rename(file_->path(), newpath);
-    }
-    if (!file_->Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile)) {
-      return false;
-    }
+  if (!OpenPartFile()) {
+    return false;
   }
-  return file_->Write(chunk, size) == size;
+  receive_buffer_.append(chunk, size);
+  if (stl::size_int(receive_buffer_) >= kReceiveBufferSize) {
+    return FlushReceiveBuffer();
+  }
+  return true;
 }
 
 bool WFileTransferFile::Close() {
   VLOG(1) << "WFileTransferFile::Close " << file_->path().string();
   file_->Close();
+  if (!part_file_) {
+    return true;
+  }
+  const auto flushed = FlushReceiveBuffer();
+  // Trim anything preallocated past what was actually received.
+  part_file_->set_length(receive_offset_);
+  part_file_->Close();
+  part_file_.reset();
+  if (!flushed) {
+    return false;
+  }
+
+  if (file_->Exists()) {
+    // Don't overwrite an existing file.  Rename it away to: FILENAME.timestamp
+    auto newpath = file_->path();
+    newpath += StrCat(".", system_clock::to_time_t(system_clock::now()));
+    File::Rename(file_->path(), newpath);
+  }
+  if (!File::Rename(part_path(), file_->path())) {
+    LOG(ERROR) << "Unable to rename " << part_path() << " to " << file_->path();
+    return false;
+  }
+  File::Remove(resume_path());
   return true;
 }
 
+int WFileTransferFile::PartialReceiveOffset(int size, time_t timestamp) {
+  receive_size_ = size;
+  receive_timestamp_ = timestamp;
+  if (!File::Exists(resume_path())) {
+    return 0;
+  }
+  TextFile tf(resume_path(), "rt");
+  const auto parts = SplitString(tf.ReadFileIntoString(), " \r\n");
+  tf.Close();
+  if (parts.size() == 3) {
+    const auto saved_size = to_number<int>(parts.at(0));
+    const auto saved_timestamp = to_number<time_t>(parts.at(1));
+    const auto offset = to_number<int>(parts.at(2));
+    // A fully received file would have been renamed by Close, so only
+    // resume when something is still missing.
+    if (saved_size == size && saved_timestamp == timestamp && offset > 0 && offset < size &&
+        File(part_path()).length() >= offset) {
+      VLOG(1) << "WFileTransferFile: resuming " << filename() << " at: " << offset;
+      received_ = offset;
+      return offset;
+    }
+  }
+  // This is a different file than the one partially received before.
+  File::Remove(part_path());
+  File::Remove(resume_path());
+  return 0;
+}
+
+bool WFileTransferFile::SetReceiveOffset(int offset) {
+  const auto available = part_file_ ? std::max(received_, file_size()) : received_;
+  if (offset < 0 || offset > available) {
+    LOG(ERROR) << "WFileTransferFile: can not receive " << filename() << " from: " << offset
+               << "; only have: " << available;
+    return false;
+  }
+  if (!OpenPartFile() || !FlushReceiveBuffer()) {
+    return false;
+  }
+  receive_offset_ = offset;
+  return true;
+}
+
+std::filesystem::path WFileTransferFile::part_path() const {
+  if (partial_dir_.empty()) {
+    auto p = file_->path();
+    p += ".part";
+    return p;
+  }
+  return FilePath(partial_dir_, StrCat(filename(), ".part"));
+}
+
+std::filesystem::path WFileTransferFile::resume_path() const {
+  if (partial_dir_.empty()) {
+    auto p = file_->path();
+    p += ".resume";
+    return p;
+  }
+  return FilePath(partial_dir_, StrCat(filename(), ".resume"));
+}
+
+bool WFileTransferFile::OpenPartFile() {
+  if (part_file_) {
+    return true;
+  }
+  if (!partial_dir_.empty() && !File::Exists(partial_dir_)) {
+    File::mkdirs(partial_dir_);
+  }
+  auto f = std::make_unique<File>(part_path());
+  if (!f->Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile)) {
+    LOG(ERROR) << "Unable to open: " << f->path();
+    return false;
+  }
+  if (receive_size_ > 0) {
+    preallocate(*f, receive_size_);
+  }
+  part_file_ = std::move(f);
+  return true;
+}
+
+bool WFileTransferFile::FlushReceiveBuffer() {
+  if (receive_buffer_.empty()) {
+    return true;
+  }
+  const auto size = stl::size_int(receive_buffer_);
+  part_file_->Seek(receive_offset_, File::Whence::begin);
+  const auto written = part_file_->Write(receive_buffer_) == static_cast<File::size_type>(size);
+  receive_buffer_.clear();
+  if (!written) {
+    LOG(ERROR) << "Unable to write to: " << part_file_->path();
+    return false;
+  }
+  receive_offset_ += size;
+  received_ = std::max(received_, receive_offset_);
+  // Only record the new offset once the data it covers has been written.
+  return SaveResumeInfo();
+}
+
+bool WFileTransferFile::SaveResumeInfo() const {
+  TextFile tf(resume_path(), "wt");
+  return tf.Write(fmt::format("{} {} {}\n", receive_size_, receive_timestamp_, received_)) > 0;
+}
+
 } // namespace wwiv
@@ -21,6 +21,7 @@
 #include "binkp/transfer_file.h"
 #include "sdk/fido/fido_util.h"
 #include "sdk/fido/flo_file.h"
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <core/file.h>
@@ -28,9 +29,22 @@
 namespace wwiv {
 namespace net {
   
+// A TransferFile backed by a file on disk.
+//
+// Received data is written into a "FILENAME.part" file and only renamed to
+// the real name by Close, so nothing ever sees a partially received file.
+// Next to it a "FILENAME.resume" file records the size, timestamp and number
+// of bytes safely written so that a later session can resume the transfer.
 class WFileTransferFile : public TransferFile {
 public:
   WFileTransferFile(const std::string& filename, std::unique_ptr<wwiv::core::File>&& file);
+  // Keeps the .part and .resume files in partial_dir instead of next to file,
+  // this lets them outlive a receive directory that is removed after every
+  // session.
+  WFileTransferFile(const std::string& filename, std::unique_ptr<wwiv::core::File>&& file,
+                    std::filesystem::path partial_dir);
+  // Flushes anything received but leaves the .part file in place so that it
+  // may be resumed.
   virtual ~WFileTransferFile();
 
   [[nodiscard]] int file_size() const override final;
@@ -38,11 +52,31 @@ public:
   bool GetChunk(char* chunk, int start, int size) override final;
   bool WriteChunk(const char* chunk, int size) override final;
   bool Close() override final;
+  int PartialReceiveOffset(int size, time_t timestamp) override final;
+  bool SetReceiveOffset(int offset) override final;
   void set_flo_file(std::unique_ptr<wwiv::sdk::fido::FloFile>&& f) { flo_file_ = std::move(f); }
 
+  [[nodiscard]] std::filesystem::path part_path() const;
+  [[nodiscard]] std::filesystem::path resume_path() const;
+
  private:
+  bool OpenPartFile();
+  bool FlushReceiveBuffer();
+  bool SaveResumeInfo() const;
+
   std::unique_ptr<wwiv::core::File> file_; 
   std::unique_ptr<wwiv::sdk::fido::FloFile> flo_file_;
+  std::filesystem::path partial_dir_;
+  // The .part file while receiving.
+  std::unique_ptr<wwiv::core::File> part_file_;
+  // Received data not yet written to part_file_.
+  std::string receive_buffer_;
+  // Position in part_file_ where receive_buffer_ will be written.
+  int receive_offset_{0};
+  // Number of bytes from the start of part_file_ known to be valid.
+  int received_{0};
+  int receive_size_{0};
+  time_t receive_timestamp_{0};
 };
 
 }  // namespace net
@@ -20,6 +20,7 @@
 #include "core/log.h"
 #include "core/strings.h"
 #include "sdk/user.h"
+#include "sdk/acs/acs.h"
 #include "sdk/acs/eval.h"
 
 #include "gtest/gtest.h"
@@ -183,3 +184,29 @@ TEST_F(AcsTest, CoSysop_Fail) {
   createEval("user.cosysop == true");
   EXPECT_FALSE(eval->eval());
 }
+
+TEST_F(AcsTest, Compiled_ManyUsers) {
+  const CompiledAcs acs("user.sl>200");
+
+  wwiv::sdk::User sysop{};
+  sysop.sl(201);
+  const UserValueProvider sysop_provider(config_, sysop, sysop.sl(), sl_);
+  EXPECT_TRUE(std::get<0>(acs.check({&sysop_provider})));
+
+  wwiv::sdk::User newuser{};
+  newuser.sl(10);
+  const UserValueProvider newuser_provider(config_, newuser, newuser.sl(), sl_);
+  EXPECT_FALSE(std::get<0>(acs.check({&newuser_provider})));
+}
+
+TEST_F(AcsTest, Compiled_Empty) {
+  const CompiledAcs acs(" ");
+  EXPECT_TRUE(acs.empty());
+  EXPECT_TRUE(std::get<0>(acs.check({})));
+}
+
+TEST_F(AcsTest, Compiled_BadExpression) {
+  const CompiledAcs acs("foo == ~ foo");
+  EXPECT_FALSE(acs.empty());
+  EXPECT_FALSE(std::get<0>(acs.check({})));
+}
@@ -70,38 +70,36 @@ static std::string generate_menu_item_line(generated_menu_56_t g, const std::str
   return fmt::format("{}{}", line, std::string(max_width - len, ' '));
 }
 
-static bool GenerateMenuLine(const Config& config, const menu_item_56_t& mi,
-                             const generated_menu_56_t& g, bool& just_nled,
-                             const std::vector<const wwiv::sdk::value::ValueProvider*>& providers,
-                             menu_type_t typ, int num_cols, int screen_width,
-                             std::ostringstream& ss) {
-  if (mi.item_key.empty()) {
-    return false;
-  }
-  if (auto [result, debug_lines] = acs::check_acs(config, mi.acs, providers); !result) {
-    return false;
-  }
-  if (!g.show_empty_text && StringTrim(mi.item_text).empty()) {
-    return false;
+std::vector<const menu_item_56_t*> GeneratedMenuItems(const MenuSet56& menu_set,
+                                                      const menu_56_t& menu) {
+  std::vector<const menu_item_56_t*> items;
+  const auto& g = menu.generated_menu;
+  auto add = [&](const menu_item_56_t& mi) {
+    if (mi.item_key.empty() || !mi.visible) {
+      return;
+    }
+    if (!g.show_empty_text && StringTrim(mi.item_text).empty()) {
+      return;
+    }
+    items.push_back(&mi);
+  };
+
+  std::set<std::string> keys;
+  for (const auto& mi : menu.items) {
+    keys.insert(mi.item_key);
+    add(mi);
   }
-  if (!mi.visible) {
-    return false;
+  for (const auto& mi : menu_set.menu_set.items) {
+    if (!wwiv::stl::contains(keys, mi.item_key)) {
+      add(mi);
+    }
   }
-  just_nled = false;
-  const auto col_width =
-      typ == menu_type_t::short_menu ? screen_width / num_cols : screen_width - 1;
-  const auto key = display_key(mi.item_key);
-  const auto& text = typ == menu_type_t::short_menu ? mi.item_text : mi.help_text;
-  ss << generate_menu_item_line(g, key, text, col_width);
-  return true;
+  return items;
 }
 
-
-std::vector<std::string> GenerateMenuLines(
-                  const Config& config, const wwiv::sdk::menus::MenuSet56& menu_set,
-                  const menu_56_t& menu, const sdk::User& user,
-                  const std::vector<const wwiv::sdk::value::ValueProvider*>& providers,
-                  menu_type_t typ) {
+std::vector<std::string> GenerateMenuLines(const menu_56_t& menu,
+                                           const std::vector<const menu_item_56_t*>& items,
+                                           int user_screen_width, menu_type_t typ) {
   std::vector<std::string> out;
   out.emplace_back("|#0");
 
@@ -109,7 +107,7 @@ std::vector<std::string> GenerateMenuLines(
   const auto& g = menu.generated_menu;
   const auto& title = menu.title;
   const auto num_cols = typ == menu_type_t::short_menu ? g.num_cols : 1;
-  const auto screen_width = user.screen_width() - num_cols + 1;
+  const auto screen_width = user_screen_width - num_cols + 1;
   const auto col_width =
       typ == menu_type_t::short_menu ? screen_width / num_cols : screen_width - 1;
   if (!title.empty()) {
@@ -123,28 +121,11 @@ std::vector<std::string> GenerateMenuLines(
     ++lines_displayed;
   }
   auto just_nled = false;
-  for (const auto& mi : menu.items) {
-    if (!GenerateMenuLine(config, mi, g, just_nled, providers, typ, num_cols, screen_width, ss)) {
-      continue;
-    }
-    if (++lines_displayed % num_cols == 0) {
-      out.emplace_back(ss.str());
-      ss.str({});
-      just_nled = true;
-    }
-  }
-
-  std::set<std::string> keys;
-  for (const auto& m : menu.items) {
-    keys.insert(m.item_key);
-  }
-  for (const auto& mi : menu_set.menu_set.items) {
-    if (wwiv::stl::contains(keys, mi.item_key)) {
-      continue;
-    }
-    if (!GenerateMenuLine(config, mi, g, just_nled, providers, typ, num_cols, screen_width, ss)) {
-      continue;
-    }
+  for (const auto* mi : items) {
+    just_nled = false;
+    const auto key = display_key(mi->item_key);
+    const auto& text = typ == menu_type_t::short_menu ? mi->item_text : mi->help_text;
+    ss << generate_menu_item_line(g, key, text, col_width);
     if (++lines_displayed % num_cols == 0) {
       out.emplace_back(ss.str());
       ss.str({});
@@ -162,4 +143,18 @@ std::vector<std::string> GenerateMenuLines(
   return out;
 }
 
+std::vector<std::string> GenerateMenuLines(
+                  const Config& config, const wwiv::sdk::menus::MenuSet56& menu_set,
+                  const menu_56_t& menu, const sdk::User& user,
+                  const std::vector<const wwiv::sdk::value::ValueProvider*>& providers,
+                  menu_type_t typ) {
+  std::vector<const menu_item_56_t*> items;
+  for (const auto* mi : GeneratedMenuItems(menu_set, menu)) {
+    if (auto [result, debug_lines] = acs::check_acs(config, mi->acs, providers); result) {
+      items.push_back(mi);
+    }
+  }
+  return GenerateMenuLines(menu, items, user.screen_width(), typ);
+}
+
 } // namespace wwiv::common::menus
@@ -37,6 +37,22 @@ GenerateMenuLines(const sdk::Config& config,
                   const sdk::User& user, const std::vector<const sdk::value::ValueProvider*>& providers,
                   sdk::menus::menu_type_t typ);
 
+/**
+ * Returns the items that may be shown in a generated menu, the menu's own
+ * items followed by the menu set's global items not replaced by the menu.
+ * This doesn't depend on the user, so ACS is not checked.
+ */
+std::vector<const sdk::menus::menu_item_56_t*>
+GeneratedMenuItems(const wwiv::sdk::menus::MenuSet56& menu_set, const sdk::menus::menu_56_t& menu);
+
+/**
+ * Generates the menu lines for items (from GeneratedMenuItems) which have
+ * already been checked against the user's ACS.
+ */
+std::vector<std::string> GenerateMenuLines(const sdk::menus::menu_56_t& menu,
+                                           const std::vector<const sdk::menus::menu_item_56_t*>& items,
+                                           int user_screen_width, sdk::menus::menu_type_t typ);
+
 }
 
 #endif 
\ No newline at end of file
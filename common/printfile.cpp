@@ -26,6 +26,7 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include "core/textfile.h"
+#include "core/trace.h"
 #include "local_io/keycodes.h"
 #include <chrono>
 #include <regex>
@@ -182,6 +183,7 @@ public:
  */
 // ReSharper disable once CppMemberFunctionMayBeConst
 bool Output::printfile_path(const std::filesystem::path& file_path, bool abortable, bool force_pause) {
+  TraceSpan span("output", "printfile");
   auto at_exit = finally([this]() { sess().set_file_bps(0); });
   if (!File::Exists(file_path)) {
     // No need to print a file that does not exist.
@@ -19,6 +19,7 @@
 #define INCLUDED_CORE_DATAFILE_H
 
 #include "core/file.h"
+#include "core/mapped_region.h"
 #include "core/stl.h"
 #include "core/wwivport.h"
 #include <filesystem>
@@ -37,6 +38,10 @@ namespace wwiv::core {
  *   if (!f) { LOG(FATAL) << "email.dat does not exist!; }
  *   if (!f.ReadVector(emails) { LOG(FATAL) << "unable to load email.dat"; }
  *   // No need to close f since when f goes out of scope it'll close automatically.
+ *
+ * Reads and writes by record number use positional I/O, so they neither use
+ * nor move the file position and may be shared between threads.  The other
+ * reads and writes continue from the file position, like File::Read.
  */
 template <typename RECORD, ssize_t SIZE = sizeof(RECORD)> class DataFile final {
 public:
@@ -81,10 +86,7 @@ public:
   }
 
   bool Read(size_type record_number, RECORD* record) {
-    if (!Seek(record_number)) {
-      return false;
-    }
-    return Read(record);
+    return file_.ReadAt(record_number * SIZE, record, SIZE) == SIZE;
   }
 
   bool WriteVector(const std::vector<RECORD>& records, size_type max_records = 0) {
@@ -112,12 +114,12 @@ public:
   }
 
   bool Write(size_type record_number, const RECORD* record) {
-    if (!Seek(record_number)) {
-      return false;
-    }
-    return Write(record);
+    return file_.WriteAt(record_number * SIZE, record, SIZE) == SIZE;
   }
 
+  /** Maps the records into memory.  See MappedRegion::records. */
+  [[nodiscard]] MappedRegion Map(bool writable = false) { return MappedRegion(file_, writable); }
+
   bool Seek(size_type record_number) {
     return file_.Seek(record_number * SIZE, File::Whence::begin) ==
            static_cast<File::size_type>(record_number * SIZE);
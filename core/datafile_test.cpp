@@ -22,6 +22,8 @@
 #include "core/test/file_helper.h"
 #include "gtest/gtest.h"
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::strings;
@@ -301,6 +303,55 @@ TEST(DataFileTest, WriteVectorAndTruncate) {
   }
 }
 
+TEST(DataFileTest, ReadWriteByRecordNumber_Concurrent) {
+  struct T {
+    int a;
+    int b;
+  };
+  const wwiv::core::test::FileHelper file;
+  const auto path = FilePath(file.TempDir(), "Concurrent");
+  static constexpr int kThreads = 4;
+  static constexpr int kRecords = 400;
+
+  DataFile<T> datafile(path, File::modeCreateFile | File::modeBinary | File::modeReadWrite);
+  ASSERT_TRUE(static_cast<bool>(datafile));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&datafile, t] {
+      for (int i = t; i < kRecords; i += kThreads) {
+        const T rec{i, t};
+        datafile.Write(i, &rec);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(kRecords, datafile.number_of_records());
+
+  // Read them back from several threads through the same handle.
+  std::vector<int> bad(kThreads);
+  threads.clear();
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&datafile, &bad, t] {
+      for (int i = kRecords - 1 - t; i >= 0; i -= kThreads) {
+        T rec{};
+        if (!datafile.Read(i, &rec) || rec.a != i || rec.b != i % kThreads) {
+          ++bad[t];
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(std::vector<int>(kThreads), bad);
+
+  const auto m = datafile.Map();
+  ASSERT_EQ(kRecords, m.records<T>().size());
+  EXPECT_EQ(kRecords - 1, m.records<T>()[kRecords - 1].a);
+}
+
 TEST(DataFileTest, Read_DoesNotExist) {
   struct T {
     int a;
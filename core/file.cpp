@@ -23,6 +23,7 @@
 #include "core/os.h"
 #include "core/strings.h"
 #include "core/wfndfile.h"
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <string>
@@ -47,6 +48,8 @@
 #else
 #include <sys/file.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <climits>
 #include <unistd.h>
 #include <utime.h>
 #endif // _WIN32
@@ -305,6 +308,198 @@ File::size_type File::Seek(size_type offset, Whence whence) {
 
 File::size_type File::current_position() const { return lseek(handle_, 0, SEEK_CUR); }
 
+// Reads once at offset, returning what pread would.
+static File::size_type read_at_once(int handle, void* buffer, File::size_type size,
+                                    File::size_type offset) {
+#if defined(_WIN32)
+  auto* h = reinterpret_cast<HANDLE>(_get_osfhandle(handle));
+  OVERLAPPED o{};
+  o.Offset = static_cast<DWORD>(static_cast<uint64_t>(offset) & 0xffffffff);
+  o.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+  DWORD num_read = 0;
+  if (!ReadFile(h, buffer, static_cast<DWORD>(size), &num_read, &o)) {
+    return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+  }
+  return static_cast<File::size_type>(num_read);
+#elif defined(__OS2__)
+  // No pread here, so this shares the file position with Seek.
+  if (lseek(handle, static_cast<long>(offset), SEEK_SET) == -1) {
+    return -1;
+  }
+  return read(handle, buffer, static_cast<unsigned int>(size));
+#else
+  for (;;) {
+    const auto r = pread(handle, buffer, static_cast<size_t>(size), static_cast<off_t>(offset));
+    if (r != -1 || errno != EINTR) {
+      return r;
+    }
+  }
+#endif
+}
+
+static File::size_type write_at_once(int handle, const void* buffer, File::size_type size,
+                                     File::size_type offset) {
+#if defined(_WIN32)
+  auto* h = reinterpret_cast<HANDLE>(_get_osfhandle(handle));
+  OVERLAPPED o{};
+  o.Offset = static_cast<DWORD>(static_cast<uint64_t>(offset) & 0xffffffff);
+  o.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+  DWORD num_written = 0;
+  if (!WriteFile(h, buffer, static_cast<DWORD>(size), &num_written, &o)) {
+    return -1;
+  }
+  return static_cast<File::size_type>(num_written);
+#elif defined(__OS2__)
+  if (lseek(handle, static_cast<long>(offset), SEEK_SET) == -1) {
+    return -1;
+  }
+  return write(handle, buffer, static_cast<unsigned int>(size));
+#else
+  for (;;) {
+    const auto r = pwrite(handle, buffer, static_cast<size_t>(size), static_cast<off_t>(offset));
+    if (r != -1 || errno != EINTR) {
+      return r;
+    }
+  }
+#endif
+}
+
+// ReSharper disable once CppMemberFunctionMayBeConst
+File::size_type File::ReadAt(size_type offset, void* buffer, size_type size) {
+  auto* p = static_cast<char*>(buffer);
+  size_type total = 0;
+  while (total < size) {
+    const auto r = read_at_once(handle_, p + total, size - total, offset + total);
+    if (r == -1) {
+      LOG(ERROR) << "ReadAt errno: " << errno << " filename: " << full_path_name_
+                 << " offset: " << offset << " size: " << size << "; " << strerror(errno);
+      return -1;
+    }
+    if (r == 0) {
+      // End of file.
+      break;
+    }
+    total += r;
+  }
+  return total;
+}
+
+// ReSharper disable once CppMemberFunctionMayBeConst
+File::size_type File::WriteAt(size_type offset, const void* buffer, size_type size) {
+  const auto* p = static_cast<const char*>(buffer);
+  size_type total = 0;
+  while (total < size) {
+    const auto r = write_at_once(handle_, p + total, size - total, offset + total);
+    if (r <= 0) {
+      LOG(ERROR) << "WriteAt errno: " << errno << " filename: " << full_path_name_
+                 << " offset: " << offset << " size: " << size << "; " << strerror(errno);
+      return -1;
+    }
+    total += r;
+  }
+  return total;
+}
+
+File::size_type File::ReadAt(size_type offset, const std::vector<read_buffer_t>& buffers) {
+  size_type total = 0;
+#if defined(__linux__)
+  std::vector<iovec> iov;
+  iov.reserve(std::min<size_t>(buffers.size(), IOV_MAX));
+  for (const auto& b : buffers) {
+    if (iov.size() == IOV_MAX) {
+      break;
+    }
+    iov.push_back(iovec{b.data, static_cast<size_t>(b.size)});
+  }
+  ssize_t r;
+  do {
+    r = preadv(handle_, iov.data(), static_cast<int>(iov.size()), static_cast<off_t>(offset));
+  } while (r == -1 && errno == EINTR);
+  if (r == -1) {
+    LOG(ERROR) << "ReadAt errno: " << errno << " filename: " << full_path_name_
+               << " offset: " << offset << "; " << strerror(errno);
+    return -1;
+  }
+  total = r;
+#endif
+  // Finish whatever preadv didn't, or everything where there is no preadv,
+  // one buffer at a time.
+  auto skip = total;
+  for (const auto& b : buffers) {
+    if (skip >= b.size) {
+      skip -= b.size;
+      continue;
+    }
+    const auto want = b.size - skip;
+    const auto r = ReadAt(offset + total, static_cast<char*>(b.data) + skip, want);
+    skip = 0;
+    if (r == -1) {
+      return -1;
+    }
+    total += r;
+    if (r < want) {
+      break;
+    }
+  }
+  return total;
+}
+
+File::size_type File::WriteAt(size_type offset, const std::vector<write_buffer_t>& buffers) {
+  size_type total = 0;
+#if defined(__linux__)
+  std::vector<iovec> iov;
+  iov.reserve(std::min<size_t>(buffers.size(), IOV_MAX));
+  for (const auto& b : buffers) {
+    if (iov.size() == IOV_MAX) {
+      break;
+    }
+    iov.push_back(iovec{const_cast<void*>(b.data), static_cast<size_t>(b.size)});
+  }
+  ssize_t r;
+  do {
+    r = pwritev(handle_, iov.data(), static_cast<int>(iov.size()), static_cast<off_t>(offset));
+  } while (r == -1 && errno == EINTR);
+  if (r == -1) {
+    LOG(ERROR) << "WriteAt errno: " << errno << " filename: " << full_path_name_
+               << " offset: " << offset << "; " << strerror(errno);
+    return -1;
+  }
+  total = r;
+#endif
+  auto skip = total;
+  for (const auto& b : buffers) {
+    if (skip >= b.size) {
+      skip -= b.size;
+      continue;
+    }
+    const auto r =
+        WriteAt(offset + total, static_cast<const char*>(b.data) + skip, b.size - skip);
+    skip = 0;
+    if (r == -1) {
+      return -1;
+    }
+    total += r;
+  }
+  return total;
+}
+
+// ReSharper disable once CppMemberFunctionMayBeConst
+bool File::Advise(Advice advice, size_type offset, size_type len) {
+#if defined(POSIX_FADV_NORMAL)
+  int a = POSIX_FADV_NORMAL;
+  switch (advice) {
+  case Advice::normal: a = POSIX_FADV_NORMAL; break;
+  case Advice::sequential: a = POSIX_FADV_SEQUENTIAL; break;
+  case Advice::random: a = POSIX_FADV_RANDOM; break;
+  case Advice::will_need: a = POSIX_FADV_WILLNEED; break;
+  case Advice::dont_need: a = POSIX_FADV_DONTNEED; break;
+  }
+  return posix_fadvise(handle_, static_cast<off_t>(offset), static_cast<off_t>(len), a) == 0;
+#else
+  return false;
+#endif
+}
+
 bool File::Exists() const noexcept {
   std::error_code ec;
   return exists(full_path_name_, ec);
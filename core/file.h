@@ -26,6 +26,7 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <vector>
 
 #ifndef MAX_PATH
 #define MAX_PATH 260
@@ -84,6 +85,9 @@ public:
 
   enum class Whence : int { begin = SEEK_SET, current = SEEK_CUR, end = SEEK_END };
 
+  // Access pattern hints passed to Advise.
+  enum class Advice { normal, sequential, random, will_need, dont_need };
+
   static const int invalid_handle;
 
   static const char pathSeparatorChar;
@@ -92,6 +96,16 @@ public:
   // Large files.   long is what off_t was.
   using size_type = ssize_t;
 
+  // One buffer of a vectored ReadAt or WriteAt.
+  struct read_buffer_t {
+    void* data;
+    size_type size;
+  };
+  struct write_buffer_t {
+    const void* data;
+    size_type size;
+  };
+
   // Constructor/Destructor
 
   /** Constructs a file from a path. */
@@ -120,6 +134,30 @@ public:
 
   size_type Writeln(const std::string& s) { return this->Writeln(s.c_str(), s.length()); }
 
+  /**
+   * Reads size bytes at offset without using the file position, so unlike
+   * Seek and Read it is safe to call from several threads sharing this File.
+   * Returns the number of bytes read, which is only short at the end of the
+   * file, or -1 on error.
+   *
+   * On Windows the file position is left after the data read.
+   */
+  size_type ReadAt(size_type offset, void* buf, size_type size);
+  /** Like ReadAt, but writes count bytes at offset. */
+  size_type WriteAt(size_type offset, const void* buffer, size_type count);
+
+  /** Reads consecutive bytes starting at offset into each of buffers in turn. */
+  size_type ReadAt(size_type offset, const std::vector<read_buffer_t>& buffers);
+  /** Writes each of buffers in turn to consecutive bytes starting at offset. */
+  size_type WriteAt(size_type offset, const std::vector<write_buffer_t>& buffers);
+
+  /**
+   * Tells the OS how the len bytes at offset (0 meaning through the end of the
+   * file) are about to be used.  This is only a hint and returns false on
+   * platforms that don't take one.
+   */
+  bool Advise(Advice advice, size_type offset = 0, size_type len = 0);
+
   [[nodiscard]] size_type length() const noexcept;
   size_type Seek(size_type offset, Whence whence);
   bool set_length(size_type l);
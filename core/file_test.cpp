@@ -23,8 +23,11 @@
 #include "core/test/wwivtest.h"
 #include "fmt/format-inl.h"
 #include "gtest/gtest.h"
+#include <atomic>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::strings;
@@ -382,6 +385,130 @@ TEST(FileTest, CurrentPosition) {
   EXPECT_EQ(static_cast<int>(kContents.size()), file.current_position());
 }
 
+TEST(FileTest, ReadAt_DoesNotMovePosition) {
+  static const std::string kContents = "0123456789";
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), kContents);
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+
+  EXPECT_EQ(2, file.Seek(2, File::Whence::begin));
+  char buf[4]{};
+  EXPECT_EQ(3, file.ReadAt(5, buf, 3));
+  EXPECT_STREQ("567", buf);
+  EXPECT_EQ(2, file.current_position());
+
+  // Short only at the end of the file.
+  EXPECT_EQ(2, file.ReadAt(8, buf, 3));
+  EXPECT_EQ(0, file.ReadAt(10, buf, 3));
+}
+
+TEST(FileTest, WriteAt) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "0123456789");
+  {
+    File file(path);
+    ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadWrite));
+    EXPECT_EQ(2, file.WriteAt(3, "ab", 2));
+    EXPECT_EQ(2, file.WriteAt(10, "cd", 2));
+    EXPECT_EQ(0, file.current_position());
+  }
+  EXPECT_EQ("012ab56789cd", helper.ReadFile(path));
+}
+
+TEST(FileTest, ReadAt_Vector) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "0123456789");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+
+  char a[3]{};
+  char b[5]{};
+  EXPECT_EQ(6, file.ReadAt(1, {{a, 2}, {b, 4}}));
+  EXPECT_STREQ("12", a);
+  EXPECT_STREQ("3456", b);
+
+  // Stops at the end of the file.
+  char c[8]{};
+  EXPECT_EQ(4, file.ReadAt(6, {{a, 2}, {c, 7}}));
+  EXPECT_STREQ("67", a);
+  EXPECT_STREQ("89", c);
+}
+
+TEST(FileTest, WriteAt_Vector) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "0123456789");
+  {
+    File file(path);
+    ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadWrite));
+    EXPECT_EQ(5, file.WriteAt(8, {{"ab", 2}, {"cde", 3}}));
+  }
+  EXPECT_EQ("01234567abcde", helper.ReadFile(path));
+}
+
+TEST(FileTest, Advise) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "0123456789");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+#ifdef __linux__
+  EXPECT_TRUE(file.Advise(File::Advice::sequential));
+  EXPECT_TRUE(file.Advise(File::Advice::will_need, 0, 4));
+#endif
+  // Only a hint, so reads are unaffected either way.
+  char c{};
+  EXPECT_EQ(1, file.ReadAt(9, &c, 1));
+  EXPECT_EQ('9', c);
+}
+
+TEST(FileTest, ReadAtWriteAt_ConcurrentSameHandle) {
+  static constexpr int kThreads = 4;
+  static constexpr int kBlocks = 200;
+  static constexpr int kBlockSize = 64;
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadWrite));
+
+  // Each writer owns every kThreads'th block and fills it with its own byte,
+  // while readers check that no block holds anything but its owner's byte.
+  // With a shared file position, writes would land in the wrong blocks.
+  std::vector<std::thread> threads;
+  std::atomic<int> misplaced{0};
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&file, t] {
+      const std::string block(kBlockSize, static_cast<char>('a' + t));
+      for (int i = t; i < kBlocks; i += kThreads) {
+        file.WriteAt(i * kBlockSize, block.data(), kBlockSize);
+      }
+    });
+    threads.emplace_back([&file, &misplaced] {
+      char block[kBlockSize];
+      for (int i = 0; i < kBlocks; i++) {
+        const auto n = file.ReadAt(i * kBlockSize, block, kBlockSize);
+        for (int j = 0; j < n; j++) {
+          if (block[j] != '\0' && block[j] != static_cast<char>('a' + i % kThreads)) {
+            ++misplaced;
+          }
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(0, misplaced.load());
+  EXPECT_EQ(0, file.current_position());
+
+  for (int i = 0; i < kBlocks; i++) {
+    char block[kBlockSize];
+    ASSERT_EQ(kBlockSize, file.ReadAt(i * kBlockSize, block, kBlockSize));
+    EXPECT_EQ(std::string(kBlockSize, static_cast<char>('a' + i % kThreads)),
+              std::string(block, kBlockSize))
+        << "block: " << i;
+  }
+}
+
 TEST(FileTest, FsCopyFile) {
   wwiv::core::test::FileHelper file;
   auto tmp = file.TempDir();
@@ -0,0 +1,183 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/file_watcher.h"
+
+#include "core/log.h"
+#include "core/os.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace wwiv::core {
+
+FileWatcher::FileWatcher(std::chrono::milliseconds poll_interval, bool allow_native)
+    : poll_interval_(poll_interval) {
+#ifdef __linux__
+  if (allow_native) {
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0) {
+      LOG(WARNING) << "inotify is unavailable, polling for changes instead; errno: " << errno;
+    }
+  }
+#else
+  (void)allow_native;
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+#endif
+}
+
+bool FileWatcher::Add(const std::filesystem::path& dir) {
+  std::error_code ec;
+  if (!std::filesystem::is_directory(dir, ec)) {
+    LOG(WARNING) << "Unable to watch missing directory: " << dir;
+    return false;
+  }
+#ifdef __linux__
+  if (fd_ >= 0) {
+    const auto wd = inotify_add_watch(fd_, dir.string().c_str(),
+                                      IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR);
+    if (wd < 0) {
+      LOG(WARNING) << "Unable to watch directory: " << dir << "; errno: " << errno;
+      return false;
+    }
+    watches_[wd] = dir;
+    return true;
+  }
+#endif
+  // Files already in the directory are not reported.
+  auto& files = polled_[dir];
+  std::vector<file_watch_event_t> ignored;
+  Scan(dir, files, ignored);
+  for (auto& [_, f] : files) {
+    f.reported = true;
+  }
+  return true;
+}
+
+void FileWatcher::Clear() {
+#ifdef __linux__
+  for (const auto& [wd, _] : watches_) {
+    inotify_rm_watch(fd_, wd);
+  }
+#endif
+  watches_.clear();
+  polled_.clear();
+}
+
+int FileWatcher::size() const noexcept {
+  return static_cast<int>(native() ? watches_.size() : polled_.size());
+}
+
+std::vector<file_watch_event_t> FileWatcher::Wait(std::chrono::milliseconds timeout) {
+  return native() ? WaitNative(timeout) : WaitPolling(timeout);
+}
+
+std::vector<file_watch_event_t> FileWatcher::WaitNative(std::chrono::milliseconds timeout) {
+  std::vector<file_watch_event_t> events;
+#ifdef __linux__
+  pollfd pfd{fd_, POLLIN, 0};
+  if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+    return events;
+  }
+  alignas(inotify_event) char buf[16 * 1024];
+  for (;;) {
+    const auto num_read = read(fd_, buf, sizeof(buf));
+    if (num_read <= 0) {
+      // EAGAIN once everything queued has been read.
+      break;
+    }
+    for (auto* p = buf; p < buf + num_read;) {
+      const auto* e = reinterpret_cast<const inotify_event*>(p);
+      p += sizeof(inotify_event) + e->len;
+      if (e->mask & IN_Q_OVERFLOW) {
+        LOG(WARNING) << "inotify queue overflowed; rescanning all watched directories.";
+        for (const auto& [_, dir] : watches_) {
+          events.push_back({dir, {}});
+        }
+        continue;
+      }
+      if ((e->mask & IN_ISDIR) || e->len == 0) {
+        continue;
+      }
+      if (const auto it = watches_.find(e->wd); it != watches_.end()) {
+        events.push_back({it->second, e->name});
+      }
+    }
+  }
+#else
+  (void)timeout;
+#endif
+  return events;
+}
+
+std::vector<file_watch_event_t> FileWatcher::WaitPolling(std::chrono::milliseconds timeout) {
+  std::vector<file_watch_event_t> events;
+  const auto end = std::chrono::steady_clock::now() + timeout;
+  for (;;) {
+    for (auto& [dir, files] : polled_) {
+      Scan(dir, files, events);
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (!events.empty() || now >= end) {
+      return events;
+    }
+    os::sleep_for(std::min<std::chrono::steady_clock::duration>(poll_interval_, end - now));
+  }
+}
+
+void FileWatcher::Scan(const std::filesystem::path& dir, polled_dir_t& files,
+                       std::vector<file_watch_event_t>& events) {
+  polled_dir_t current;
+  std::error_code ec;
+  for (const auto& de : std::filesystem::directory_iterator(dir, ec)) {
+    std::error_code fec;
+    if (!de.is_regular_file(fec)) {
+      continue;
+    }
+    const auto name = de.path().filename().string();
+    polled_file_t f{de.file_size(fec), de.last_write_time(fec), false};
+    if (const auto it = files.find(name); it != files.end()) {
+      const auto& prev = it->second;
+      if (prev.size == f.size && prev.mtime == f.mtime) {
+        // Unchanged since the last scan, so the writer is most likely done.
+        if (!prev.reported) {
+          events.push_back({dir, name});
+        }
+        f.reported = true;
+      }
+    }
+    current.emplace(name, f);
+  }
+  files = std::move(current);
+}
+
+} // namespace wwiv::core
@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_FILE_WATCHER_H
+#define INCLUDED_CORE_FILE_WATCHER_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace wwiv::core {
+
+/** A file that was finished being written in a watched directory. */
+struct file_watch_event_t {
+  std::filesystem::path dir;
+  /**
+   * Filename within dir.  Empty when events were lost (i.e. the kernel's
+   * queue overflowed), in which case the whole directory should be rescanned.
+   */
+  std::string filename;
+};
+
+/**
+ * Watches directories for files that are finished being written: closed
+ * after writing or renamed into the directory.  Subdirectories are not
+ * watched, and files that already exist when a directory is added are
+ * not reported.
+ *
+ * Uses inotify on Linux.  Elsewhere, or if inotify is unavailable, the
+ * directories are rescanned every poll_interval and a file is reported once
+ * its size and modification time have stayed the same across two scans.
+ */
+class FileWatcher final {
+public:
+  explicit FileWatcher(std::chrono::milliseconds poll_interval = std::chrono::seconds(5),
+                       bool allow_native = true);
+  ~FileWatcher();
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  /** Starts watching dir, returns false if it can not be watched. */
+  bool Add(const std::filesystem::path& dir);
+  /** Stops watching every directory. */
+  void Clear();
+
+  /**
+   * Waits up to timeout for files to be finished, returning as soon as any
+   * are.  Returns an empty vector on timeout.
+   */
+  std::vector<file_watch_event_t> Wait(std::chrono::milliseconds timeout);
+
+  /** True if the OS notifies us of changes, false if polling. */
+  [[nodiscard]] bool native() const noexcept { return fd_ >= 0; }
+  [[nodiscard]] int size() const noexcept;
+
+private:
+  struct polled_file_t {
+    std::uintmax_t size{0};
+    std::filesystem::file_time_type mtime{};
+    bool reported{false};
+  };
+  using polled_dir_t = std::map<std::string, polled_file_t>;
+
+  std::vector<file_watch_event_t> WaitNative(std::chrono::milliseconds timeout);
+  std::vector<file_watch_event_t> WaitPolling(std::chrono::milliseconds timeout);
+  /** Rescans dir, adding any files that have settled to events. */
+  static void Scan(const std::filesystem::path& dir, polled_dir_t& files,
+                   std::vector<file_watch_event_t>& events);
+
+  const std::chrono::milliseconds poll_interval_;
+  // inotify descriptor, or -1 when polling.
+  int fd_{-1};
+  // Watch descriptor to directory, when native.
+  std::map<int, std::filesystem::path> watches_;
+  // Directory to the files seen on the last scan, when polling.
+  std::map<std::filesystem::path, polled_dir_t> polled_;
+};
+
+} // namespace wwiv::core
+
+#endif
@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/file_watcher.h"
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+
+static std::vector<std::string> filenames(const std::vector<file_watch_event_t>& events) {
+  std::vector<std::string> names;
+  for (const auto& e : events) {
+    names.push_back(e.filename);
+  }
+  return names;
+}
+
+class FileWatcherTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(helper.Mkdir("in"));
+    dir = helper.Dir("in");
+  }
+
+  // Polling needs two scans to see that a file has settled.
+  static std::vector<file_watch_event_t> WaitForEvents(FileWatcher& watcher) {
+    std::vector<file_watch_event_t> events;
+    for (int i = 0; i < 10 && events.empty(); i++) {
+      events = watcher.Wait(100ms);
+    }
+    return events;
+  }
+
+  void ExpectWritten(FileWatcher& watcher) {
+    ASSERT_TRUE(watcher.Add(dir));
+    helper.CreateTempFile("in/p1.net", "hello");
+
+    const auto events = WaitForEvents(watcher);
+    ASSERT_EQ(std::vector<std::string>{"p1.net"}, filenames(events));
+    EXPECT_EQ(dir, events.front().dir);
+    // Reported only once.
+    EXPECT_TRUE(watcher.Wait(50ms).empty());
+  }
+
+  void ExpectMovedIn(FileWatcher& watcher) {
+    ASSERT_TRUE(helper.Mkdir("receive"));
+    const auto src = helper.CreateTempFile("receive/00010001.su0", "bundle");
+    ASSERT_TRUE(watcher.Add(dir));
+    ASSERT_TRUE(File::Move(src, FilePath(dir, "00010001.su0")));
+
+    EXPECT_EQ(std::vector<std::string>{"00010001.su0"}, filenames(WaitForEvents(watcher)));
+  }
+
+  void ExpectExistingNotReported(FileWatcher& watcher) {
+    helper.CreateTempFile("in/p1.net", "old");
+    ASSERT_TRUE(watcher.Add(dir));
+    EXPECT_TRUE(watcher.Wait(50ms).empty());
+  }
+
+  test::FileHelper helper;
+  std::filesystem::path dir;
+};
+
+TEST_F(FileWatcherTest, MissingDirectory) {
+  FileWatcher watcher(10ms);
+  EXPECT_FALSE(watcher.Add(helper.Dir("missing")));
+  EXPECT_EQ(0, watcher.size());
+}
+
+TEST_F(FileWatcherTest, Timeout) {
+  FileWatcher watcher(10ms);
+  ASSERT_TRUE(watcher.Add(dir));
+  EXPECT_EQ(1, watcher.size());
+  EXPECT_TRUE(watcher.Wait(20ms).empty());
+}
+
+TEST_F(FileWatcherTest, Clear) {
+  FileWatcher watcher(10ms);
+  ASSERT_TRUE(watcher.Add(dir));
+  watcher.Clear();
+  EXPECT_EQ(0, watcher.size());
+  helper.CreateTempFile("in/p1.net", "hello");
+  EXPECT_TRUE(watcher.Wait(50ms).empty());
+}
+
+TEST_F(FileWatcherTest, Written) {
+  FileWatcher watcher(10ms);
+  ExpectWritten(watcher);
+}
+
+TEST_F(FileWatcherTest, Written_Polling) {
+  FileWatcher watcher(10ms, false);
+  ASSERT_FALSE(watcher.native());
+  ExpectWritten(watcher);
+}
+
+TEST_F(FileWatcherTest, MovedIn) {
+  FileWatcher watcher(10ms);
+  ExpectMovedIn(watcher);
+}
+
+TEST_F(FileWatcherTest, MovedIn_Polling) {
+  FileWatcher watcher(10ms, false);
+  ExpectMovedIn(watcher);
+}
+
+TEST_F(FileWatcherTest, ExistingFilesNotReported) {
+  FileWatcher watcher(10ms);
+  ExpectExistingNotReported(watcher);
+}
+
+TEST_F(FileWatcherTest, ExistingFilesNotReported_Polling) {
+  FileWatcher watcher(10ms, false);
+  ExpectExistingNotReported(watcher);
+}
+
+TEST_F(FileWatcherTest, Rewritten_Polling) {
+  FileWatcher watcher(10ms, false);
+  ExpectWritten(watcher);
+  helper.CreateTempFile("in/p1.net", "hello, again");
+  EXPECT_EQ(std::vector<std::string>{"p1.net"}, filenames(WaitForEvents(watcher)));
+}
+
+#ifdef __linux__
+TEST_F(FileWatcherTest, Native) {
+  FileWatcher watcher(10ms);
+  EXPECT_TRUE(watcher.native());
+}
+#endif
@@ -0,0 +1,232 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/fork_server.h"
+
+#include "core/log.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace wwiv::core {
+
+// "WWFK" - Used to make sure we're talking to a fork server.
+static constexpr uint32_t kForkServerMagic = 0x4b465757;
+
+struct fork_request_wire_t {
+  uint32_t magic;
+  int32_t node_number;
+  char connection_type;
+};
+
+static bool make_unix_address(const std::filesystem::path& path, sockaddr_un& addr) {
+  const auto s = path.string();
+  if (s.size() >= sizeof(addr.sun_path)) {
+    LOG(ERROR) << "Fork server socket path is too long: " << s;
+    return false;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, s.c_str(), sizeof(addr.sun_path) - 1);
+  return true;
+}
+
+static void set_close_on_exec(int fd) {
+  if (const auto flags = fcntl(fd, F_GETFD); flags != -1) {
+    fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+  }
+}
+
+ForkServer::ForkServer(std::filesystem::path socket_path) : socket_path_(std::move(socket_path)) {}
+
+ForkServer::~ForkServer() { Close(false); }
+
+bool ForkServer::Listen() {
+  sockaddr_un addr{};
+  if (!make_unix_address(socket_path_, addr)) {
+    return false;
+  }
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    LOG(ERROR) << "Unable to create fork server socket; errno: " << errno;
+    return false;
+  }
+  set_close_on_exec(listen_fd_);
+  // Remove any stale socket left behind by a previous template.
+  unlink(addr.sun_path);
+  if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    LOG(ERROR) << "Unable to bind fork server socket: " << socket_path_ << "; errno: " << errno;
+    Close(false);
+    return false;
+  }
+  if (listen(listen_fd_, 16) != 0) {
+    LOG(ERROR) << "Unable to listen on fork server socket: " << socket_path_ << "; errno: " << errno;
+    Close(true);
+    return false;
+  }
+  return true;
+}
+
+std::optional<accepted_fork_request_t> ForkServer::Accept(std::chrono::milliseconds timeout) {
+  if (listen_fd_ < 0) {
+    return std::nullopt;
+  }
+  pollfd pfd{listen_fd_, POLLIN, 0};
+  if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+    return std::nullopt;
+  }
+  const auto conn = accept(listen_fd_, nullptr, nullptr);
+  if (conn < 0) {
+    return std::nullopt;
+  }
+
+  fork_request_wire_t wire{};
+  iovec iov{&wire, sizeof(wire)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t num_read;
+  do {
+    num_read = recvmsg(conn, &msg, 0);
+  } while (num_read < 0 && errno == EINTR);
+
+  SOCKET client_socket = INVALID_SOCKET;
+  for (auto* c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+      memcpy(&client_socket, CMSG_DATA(c), sizeof(int));
+    }
+  }
+  if (num_read != sizeof(wire) || wire.magic != kForkServerMagic ||
+      client_socket == INVALID_SOCKET) {
+    LOG(ERROR) << "Received malformed fork request; read: " << num_read;
+    if (client_socket != INVALID_SOCKET) {
+      closesocket(client_socket);
+    }
+    close(conn);
+    return std::nullopt;
+  }
+  // Doors launched by the node must not keep wwivd waiting on the control
+  // connection after the node itself exits.
+  set_close_on_exec(conn);
+
+  accepted_fork_request_t r{};
+  r.request.node_number = wire.node_number;
+  r.request.connection_type = wire.connection_type;
+  r.client_socket = client_socket;
+  r.control_fd = conn;
+  return r;
+}
+
+void ForkServer::Close(bool remove_socket_file) {
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+    listen_fd_ = -1;
+  }
+  if (remove_socket_file) {
+    std::error_code ec;
+    std::filesystem::remove(socket_path_, ec);
+  }
+}
+
+bool SendForkResponse(int control_fd, int pid) {
+  const auto p = static_cast<int32_t>(pid);
+  return send(control_fd, &p, sizeof(p), MSG_NOSIGNAL) == sizeof(p);
+}
+
+std::optional<fork_response_t> RequestFork(const std::filesystem::path& socket_path,
+                                           const fork_request_t& request, SOCKET sock) {
+  sockaddr_un addr{};
+  if (!make_unix_address(socket_path, addr)) {
+    return std::nullopt;
+  }
+  const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  set_close_on_exec(fd);
+  if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    VLOG(1) << "Fork server is not running at: " << socket_path << "; errno: " << errno;
+    close(fd);
+    return std::nullopt;
+  }
+
+  fork_request_wire_t wire{};
+  wire.magic = kForkServerMagic;
+  wire.node_number = request.node_number;
+  wire.connection_type = request.connection_type;
+  iovec iov{&wire, sizeof(wire)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  auto* c = CMSG_FIRSTHDR(&msg);
+  c->cmsg_level = SOL_SOCKET;
+  c->cmsg_type = SCM_RIGHTS;
+  c->cmsg_len = CMSG_LEN(sizeof(int));
+  const int passed = sock;
+  memcpy(CMSG_DATA(c), &passed, sizeof(int));
+
+  if (sendmsg(fd, &msg, MSG_NOSIGNAL) != sizeof(wire)) {
+    LOG(ERROR) << "Unable to send fork request to: " << socket_path << "; errno: " << errno;
+    close(fd);
+    return std::nullopt;
+  }
+
+  int32_t pid = 0;
+  ssize_t num_read;
+  do {
+    num_read = recv(fd, &pid, sizeof(pid), MSG_WAITALL);
+  } while (num_read < 0 && errno == EINTR);
+  if (num_read != sizeof(pid) || pid <= 0) {
+    LOG(ERROR) << "Fork server did not fork a node; read: " << num_read;
+    close(fd);
+    return std::nullopt;
+  }
+  return fork_response_t{fd, pid};
+}
+
+void WaitForForkedNode(int control_fd) {
+  char buf[64];
+  for (;;) {
+    const auto num_read = recv(control_fd, buf, sizeof(buf), 0);
+    if (num_read == 0 || (num_read < 0 && errno != EINTR)) {
+      break;
+    }
+  }
+  close(control_fd);
+}
+
+} // namespace wwiv::core
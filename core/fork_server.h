@@ -0,0 +1,115 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_FORK_SERVER_H
+#define INCLUDED_CORE_FORK_SERVER_H
+
+#include "core/net.h"
+#include <chrono>
+#include <filesystem>
+#include <optional>
+
+namespace wwiv::core {
+
+/**
+ * Request sent by wwivd to a pre-initialized bbs template process (the fork
+ * server) asking it to fork a child to handle a caller on node_number.
+ */
+struct fork_request_t {
+  int node_number{0};
+  /** 'T' for telnet or 'S' for SSH, same as the bbs -x commandline option. */
+  char connection_type{'T'};
+};
+
+/**
+ * A request accepted by the fork server.
+ */
+struct accepted_fork_request_t {
+  fork_request_t request;
+  /** The caller's socket, passed from wwivd over the control connection. */
+  SOCKET client_socket{INVALID_SOCKET};
+  /**
+   * Control connection back to wwivd. The forked node keeps this open for
+   * its lifetime, wwivd treats EOF on it as the node having exited.
+   */
+  int control_fd{-1};
+};
+
+/**
+ * Server side of the fork server protocol.  Listens on a UNIX domain socket
+ * and accepts requests, each of which carries the caller's socket.
+ */
+class ForkServer final {
+public:
+  explicit ForkServer(std::filesystem::path socket_path);
+  ~ForkServer();
+  ForkServer(const ForkServer&) = delete;
+  ForkServer& operator=(const ForkServer&) = delete;
+
+  /** Creates the listening socket, removing any stale one first. */
+  bool Listen();
+
+  /**
+   * Waits up to timeout for a request, returning std::nullopt on timeout
+   * or on a malformed request.
+   */
+  std::optional<accepted_fork_request_t> Accept(std::chrono::milliseconds timeout);
+
+  /**
+   * Closes the listening socket. Called by the forked child, which must not
+   * accept requests, or by the template when exiting.  Only the process
+   * that created the socket file removes it.
+   */
+  void Close(bool remove_socket_file);
+
+  [[nodiscard]] const std::filesystem::path& socket_path() const noexcept { return socket_path_; }
+
+private:
+  const std::filesystem::path socket_path_;
+  int listen_fd_{-1};
+};
+
+/** Sends the pid of the forked node back to wwivd over control_fd. */
+bool SendForkResponse(int control_fd, int pid);
+
+/** Reply from the fork server once the node has been forked. */
+struct fork_response_t {
+  int control_fd{-1};
+  int pid{0};
+};
+
+/**
+ * Client side of the fork server protocol, used by wwivd.
+ *
+ * Passes sock to the fork server at socket_path and returns the control
+ * connection and the pid of the forked node, or std::nullopt if the fork
+ * server is not running or refused the request, in which case the caller
+ * should launch the bbs the traditional way.
+ */
+std::optional<fork_response_t> RequestFork(const std::filesystem::path& socket_path,
+                                           const fork_request_t& request, SOCKET sock);
+
+/**
+ * Blocks until the forked node exits (closing its end of control_fd) and then
+ * closes control_fd.
+ */
+void WaitForForkedNode(int control_fd);
+
+} // namespace wwiv::core
+
+#endif
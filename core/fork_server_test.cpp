@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/fork_server.h"
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <optional>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+
+TEST(ForkServerTest, NotRunning) {
+  const test::FileHelper helper;
+  const auto path = FilePath(helper.TempDir(), "fork.sock");
+  EXPECT_FALSE(RequestFork(path, fork_request_t{1, 'T'}, 0).has_value());
+}
+
+TEST(ForkServerTest, PassesSocketAndNode) {
+  const test::FileHelper helper;
+  const auto path = FilePath(helper.TempDir(), "fork.sock");
+  ForkServer server(path);
+  ASSERT_TRUE(server.Listen());
+
+  int caller[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, caller));
+
+  std::optional<fork_response_t> response;
+  std::thread client([&] { response = RequestFork(path, fork_request_t{7, 'S'}, caller[1]); });
+
+  auto r = server.Accept(5s);
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(7, r->request.node_number);
+  EXPECT_EQ('S', r->request.connection_type);
+  ASSERT_NE(INVALID_SOCKET, r->client_socket);
+
+  // The passed descriptor must refer to the caller's socket.
+  ASSERT_EQ(2, write(r->client_socket, "hi", 2));
+  char buf[3]{};
+  ASSERT_EQ(2, read(caller[0], buf, 2));
+  EXPECT_STREQ("hi", buf);
+
+  ASSERT_TRUE(SendForkResponse(r->control_fd, 1234));
+  client.join();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ(1234, response->pid);
+
+  // Closing the node's end of the control connection ends the wait.
+  close(r->control_fd);
+  WaitForForkedNode(response->control_fd);
+
+  closesocket(r->client_socket);
+  close(caller[0]);
+  close(caller[1]);
+  server.Close(true);
+  EXPECT_FALSE(File::Exists(path));
+}
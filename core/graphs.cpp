@@ -2,11 +2,11 @@
 // Also http://stackoverflow.com/a/22566583/1270019
 #include "core/graphs.h"
 
+#include <algorithm>
 #include <cmath>
-#include <iostream>
+#include <functional>
 #include <limits>
 #include <list>
-#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -14,60 +14,221 @@
 
 namespace wwiv::graphs {
 
-static constexpr uint16_t NO_NODE = 0;
 static constexpr float max_cost = std::numeric_limits<float>::infinity();
 
+// Orders the heap by (cost, node), which is the same order nodes were
+// visited in when this used a std::set, so ties resolve the same way.
+using heap_compare_t = std::greater<std::pair<float, uint16_t>>;
+
 Graph::Graph(uint16_t node, uint16_t max_size)
-  : node_(node), adjacency_list_(max_size) {
-  cost_.clear();
+  : node_(node), max_size_(max_size) {
   cost_.resize(max_size, max_cost);
   cost_[node] = 0;
-  previous_.clear();
   previous_.resize(max_size, NO_NODE);
+  hops_.resize(max_size, 0);
+  first_hop_.resize(max_size, NO_NODE);
 }
 
 Graph::~Graph() = default;
 
 bool Graph::add_edge(uint16_t source, uint16_t dest, float cost) {
-  if (computed_) {
+  if (computed_ || source >= max_size_ || dest >= max_size_) {
     return false;
   }
 
   //VLOG(3) << "adding edge: " << source << " " << dest << " " << cost << " " << std::boolalpha << computed_ << std::endl;
-  adjacency_list_[source].emplace_back(dest, cost);
+  edges_.push_back({source, dest, cost});
+  adjacency_dirty_ = true;
+  return true;
+}
+
+bool Graph::update_edge(uint16_t source, uint16_t dest, float cost) {
+  if (source >= max_size_ || dest >= max_size_) {
+    return false;
+  }
+  auto old_cost = max_cost;
+  for (auto& e : edges_) {
+    if (e.source == source && e.dest == dest) {
+      old_cost = std::min(old_cost, e.cost);
+      e.cost = cost;
+    }
+  }
+  if (old_cost == max_cost) {
+    edges_.push_back({source, dest, cost});
+  }
+  if (old_cost == max_cost || adjacency_dirty_) {
+    adjacency_dirty_ = true;
+  } else {
+    // Update the costs in place, the layout doesn't change.
+    for (auto i = offsets_[source]; i < offsets_[source + 1]; i++) {
+      if (targets_[i] == dest) {
+        weights_[i] = cost;
+      }
+    }
+    for (auto i = roffsets_[dest]; i < roffsets_[dest + 1]; i++) {
+      if (rsources_[i] == source) {
+        rweights_[i] = cost;
+      }
+    }
+  }
+
+  if (!computed_) {
+    return true;
+  }
+  BuildAdjacency();
+  if (cost < old_cost) {
+    EdgeCostDecreased(source, dest, cost);
+  } else if (cost > old_cost) {
+    EdgeCostIncreased(source, dest);
+  }
+  return true;
+}
+
+bool Graph::remove_edge(uint16_t source, uint16_t dest) {
+  const auto it = std::remove_if(std::begin(edges_), std::end(edges_), [=](const edge_t& e) {
+    return e.source == source && e.dest == dest;
+  });
+  if (it == std::end(edges_)) {
+    return false;
+  }
+  edges_.erase(it, std::end(edges_));
+  adjacency_dirty_ = true;
+  if (computed_) {
+    BuildAdjacency();
+    EdgeCostIncreased(source, dest);
+  }
   return true;
 }
 
 bool Graph::has_node(uint16_t source) {
-  return !adjacency_list_[source].empty();
+  BuildAdjacency();
+  return source < max_size_ && offsets_[source] != offsets_[source + 1];
 }
 
+void Graph::BuildAdjacency() {
+  if (!adjacency_dirty_) {
+    return;
+  }
+  adjacency_dirty_ = false;
+  // Counting sort of the edges by source and by dest, keeping the order
+  // they were added within each node.
+  offsets_.assign(max_size_ + 1u, 0);
+  roffsets_.assign(max_size_ + 1u, 0);
+  for (const auto& e : edges_) {
+    ++offsets_[e.source + 1];
+    ++roffsets_[e.dest + 1];
+  }
+  for (size_t i = 1; i < offsets_.size(); i++) {
+    offsets_[i] += offsets_[i - 1];
+    roffsets_[i] += roffsets_[i - 1];
+  }
+  targets_.resize(edges_.size());
+  weights_.resize(edges_.size());
+  rsources_.resize(edges_.size());
+  rweights_.resize(edges_.size());
+  std::vector<uint32_t> next(std::begin(offsets_), std::end(offsets_) - 1);
+  std::vector<uint32_t> rnext(std::begin(roffsets_), std::end(roffsets_) - 1);
+  for (const auto& e : edges_) {
+    const auto i = next[e.source]++;
+    targets_[i] = e.dest;
+    weights_[i] = e.cost;
+    const auto r = rnext[e.dest]++;
+    rsources_[r] = e.source;
+    rweights_[r] = e.cost;
+  }
+}
 
-void Graph::Compute() {
-  computed_ = true;
-  std::set<std::pair<float, uint16_t>> queue;
-  queue.insert(std::make_pair(cost_[node_], node_));
+void Graph::Relax(uint16_t u, uint16_t v, float cost) {
+  cost_[v] = cost;
+  previous_[v] = u;
+  hops_[v] = static_cast<uint16_t>(hops_[u] + 1);
+  first_hop_[v] = u == node_ ? v : first_hop_[u];
+  heap_.emplace_back(cost, v);
+  std::push_heap(std::begin(heap_), std::end(heap_), heap_compare_t());
+}
 
-  while (!queue.empty()) {
-    const auto dist = queue.begin()->first;
-    const auto u = queue.begin()->second;
-    queue.erase(queue.begin());
+void Graph::Run() {
+  while (!heap_.empty()) {
+    std::pop_heap(std::begin(heap_), std::end(heap_), heap_compare_t());
+    const auto [dist, u] = heap_.back();
+    heap_.pop_back();
+    if (dist > cost_[u]) {
+      // Stale entry, u was already reached at a lower cost.
+      continue;
+    }
 
     // Visit each edge exiting u
-    const auto& edges = adjacency_list_[u];
-    for (const auto& e : edges) {
-      auto v = e.node_;
-      if (const auto cost_through_u = dist + e.cost_; cost_through_u < cost_[v]) {
-        queue.erase(std::make_pair(cost_[v], v));
-        cost_[v] = cost_through_u;
-        previous_[v] = u;
-        queue.insert(std::make_pair(cost_[v], v));
+    for (auto i = offsets_[u]; i < offsets_[u + 1]; i++) {
+      const auto v = targets_[i];
+      if (const auto cost_through_u = dist + weights_[i]; cost_through_u < cost_[v]) {
+        Relax(u, v, cost_through_u);
       }
     }
   }
+}
+
+void Graph::Compute() {
+  BuildAdjacency();
+  computed_ = true;
+  heap_.clear();
+  heap_.reserve(edges_.size() + 1);
+  heap_.emplace_back(cost_[node_], node_);
+  Run();
   //DumpCosts();
 }
 
+void Graph::EdgeCostDecreased(uint16_t source, uint16_t dest, float cost) {
+  if (const auto c = cost_[source] + cost; c < cost_[dest]) {
+    heap_.clear();
+    Relax(source, dest, c);
+    Run();
+  }
+}
+
+void Graph::EdgeCostIncreased(uint16_t source, uint16_t dest) {
+  if (previous_[dest] != source || dest == node_) {
+    // Not part of the shortest path tree, so no path changes.
+    return;
+  }
+  // Every node whose path goes through dest needs a new path.
+  std::vector<std::vector<uint16_t>> children(max_size_);
+  for (uint16_t v = 0; v < max_size_; v++) {
+    if (previous_[v] != NO_NODE && v != node_) {
+      children[previous_[v]].push_back(v);
+    }
+  }
+  std::vector<bool> affected(max_size_, false);
+  std::vector<uint16_t> subtree{dest};
+  affected[dest] = true;
+  for (size_t i = 0; i < subtree.size(); i++) {
+    for (const auto c : children[subtree[i]]) {
+      affected[c] = true;
+      subtree.push_back(c);
+    }
+  }
+  for (const auto v : subtree) {
+    cost_[v] = max_cost;
+    previous_[v] = NO_NODE;
+    hops_[v] = 0;
+    first_hop_[v] = NO_NODE;
+  }
+  // Seed them from their neighbors outside of the subtree, whose paths
+  // can't have changed, and let Dijkstra's algorithm fix up the rest.
+  heap_.clear();
+  for (const auto v : subtree) {
+    for (auto i = roffsets_[v]; i < roffsets_[v + 1]; i++) {
+      const auto u = rsources_[i];
+      if (affected[u] || !std::isfinite(cost_[u])) {
+        continue;
+      }
+      if (const auto c = cost_[u] + rweights_[i]; c < cost_[v]) {
+        Relax(u, v, c);
+      }
+    }
+  }
+  Run();
+}
+
 float Graph::cost_to(uint16_t destination) {
   if (!computed_) {
     Compute();
@@ -75,11 +236,24 @@ float Graph::cost_to(uint16_t destination) {
   return cost_[destination];
 }
 
+int Graph::num_hops_to(uint16_t destination) {
+  if (!computed_) {
+    Compute();
+  }
+  return hops_[destination];
+}
+
+uint16_t Graph::next_hop_to(uint16_t destination) {
+  if (!computed_) {
+    Compute();
+  }
+  return first_hop_[destination];
+}
 
 std::string Graph::DumpCosts() const {
   std::ostringstream ss;
   ss << "costs_: ";
-  for (auto i = 0; i < std::numeric_limits<uint16_t>::max(); i++) {
+  for (size_t i = 0; i < cost_.size(); i++) {
     if (const auto cost = cost_[i]; std::isfinite(cost)) {
       ss << i << "[" << cost_[i] << "] ";
     }
@@ -87,7 +261,6 @@ std::string Graph::DumpCosts() const {
   return ss.str();
 }
 
-
 std::list<uint16_t> Graph::shortest_path_to(uint16_t destination) {
   if (!computed_) {
     Compute();
@@ -98,4 +271,21 @@ std::list<uint16_t> Graph::shortest_path_to(uint16_t destination) {
   }
   return path;
 }
+
+bool Graph::path_to(uint16_t destination, std::vector<uint16_t>& path) {
+  if (!computed_) {
+    Compute();
+  }
+  path.clear();
+  if (destination != node_ && previous_[destination] == NO_NODE) {
+    return false;
+  }
+  path.resize(hops_[destination] + 1u);
+  for (auto i = path.size(); i > 0; i--) {
+    path[i - 1] = destination;
+    destination = previous_[destination];
+  }
+  return true;
+}
+
 } // namespace wwiv
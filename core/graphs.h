@@ -19,14 +19,16 @@
 #ifndef INCLUDED_WWIV_GRAPHS_OS_H
 #define INCLUDED_WWIV_GRAPHS_OS_H
 
-#include "core/stl.h"
 #include <cstdint>
 #include <list>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace wwiv::graphs {
 
+/** Used in the predecessor and next hop arrays to mean "no node" */
+static constexpr uint16_t NO_NODE = 0;
 
 struct edge {
   uint16_t node_;
@@ -38,8 +40,6 @@ struct edge {
   }
 };
 
-typedef std::vector<std::vector<edge>> adjacency_list_t;
-
 /*
  Use:
  Graph net(1, 200);
@@ -49,34 +49,83 @@ typedef std::vector<std::vector<edge>> adjacency_list_t;
  net.add_edge(3, 2, 0);
 
  list<uint16_t> path = net.shortest_path_to(3);
+
+ Single source shortest paths from node using Dijkstra's algorithm with a
+ binary heap over a compressed (CSR) adjacency layout.  Along with the
+ cost and predecessor of each node, the number of hops and the first hop
+ from node are kept so that routing for every destination can be read in
+ constant time without building paths.
+
+ Once computed, update_edge and remove_edge repair only the part of the
+ shortest path tree affected by the change instead of recomputing it.
  */
 class Graph final {
 public:
   Graph(uint16_t node, uint16_t max_size);
   ~Graph();
 
+  /** Adds an edge, only allowed before the paths have been computed. */
   bool add_edge(uint16_t source, uint16_t dest, float cost);
+  /**
+   * Sets the cost of all edges from source to dest, adding one if needed.
+   * If the paths have already been computed they are updated incrementally.
+   */
+  bool update_edge(uint16_t source, uint16_t dest, float cost);
+  /** Removes all edges from source to dest, updating computed paths. */
+  bool remove_edge(uint16_t source, uint16_t dest);
+
+  /** Does source have any edges leaving it */
   [[nodiscard]] bool has_node(uint16_t source);
   [[nodiscard]] std::list<uint16_t> shortest_path_to(uint16_t destination);
+  /**
+   * Fills path with the nodes from node to destination, reusing the storage
+   * in path.  Returns false and leaves path empty if there is no path.
+   */
+  bool path_to(uint16_t destination, std::vector<uint16_t>& path);
   [[nodiscard]] float cost_to(uint16_t destination);
+  [[nodiscard]] int num_hops_to(uint16_t destination);
+  /**
+   * The first node after node on the path to destination, or NO_NODE if
+   * destination is node or is unreachable.
+   */
+  [[nodiscard]] uint16_t next_hop_to(uint16_t destination);
   [[nodiscard]] std::string DumpCosts() const;
 
-  [[nodiscard]] int num_hops_to(uint16_t destination) {
-    const auto path = shortest_path_to(destination);
-    if (path.empty()) {
-      return 0;
-    }
-    return stl::size_int(path) - 1;
-  }
-
 private:
-  uint16_t node_;
-  adjacency_list_t adjacency_list_;
+  struct edge_t {
+    uint16_t source;
+    uint16_t dest;
+    float cost;
+  };
+
+  void BuildAdjacency();
+  void Compute();
+  void Relax(uint16_t u, uint16_t v, float cost);
+  void Run();
+  void EdgeCostDecreased(uint16_t source, uint16_t dest, float cost);
+  void EdgeCostIncreased(uint16_t source, uint16_t dest);
+
+  const uint16_t node_;
+  const uint16_t max_size_;
+  std::vector<edge_t> edges_;
   bool computed_{false};
+  bool adjacency_dirty_{true};
+
+  // Outgoing edges of node n are targets_/weights_ [offsets_[n], offsets_[n+1]).
+  std::vector<uint32_t> offsets_;
+  std::vector<uint16_t> targets_;
+  std::vector<float> weights_;
+  // Incoming edges, used when repairing paths after a cost increase.
+  std::vector<uint32_t> roffsets_;
+  std::vector<uint16_t> rsources_;
+  std::vector<float> rweights_;
+
   std::vector<float> cost_;
   std::vector<uint16_t> previous_;
-
-  void Compute();
+  std::vector<uint16_t> hops_;
+  std::vector<uint16_t> first_hop_;
+  // Min heap of (cost, node) with lazy deletion, kept to reuse its storage.
+  std::vector<std::pair<float, uint16_t>> heap_;
 };
 
 } // namespace
@@ -1,36 +1,141 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*               Copyright (C)2014-2022, WWIV Software Services           */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+// Benchmark for wwiv::graphs::Graph on a synthetic network the size of the
+// largest possible WWIVnet node list.
+//
+// Usage: graphs_bench [num_nodes] [edges_per_node]
+#include "core/graphs.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono;
 using namespace wwiv::graphs;
 
-int main() {
-  // remember to insert edges both ways for an undirected graph
-  adjacency_list_t adjacency_list(std::numeric_limits<uint16_t>::max());
-  adjacency_list[1].push_back(edge(2, 10));
-  adjacency_list[1].push_back(edge(3, 15));
-
-  adjacency_list[2].push_back(edge(1, 10));
-  adjacency_list[2].push_back(edge(3, 11));
-  adjacency_list[2].push_back(edge(5, 2));
-
-  adjacency_list[3].push_back(edge(1, 15));
-  adjacency_list[3].push_back(edge(2, 11));
-  adjacency_list[3].push_back(edge(4, 6));
-
-  adjacency_list[4].push_back(edge(3, 6));
-  adjacency_list[4].push_back(edge(5, 9));
-
-  adjacency_list[5].push_back(edge(2, 2));
-  adjacency_list[5].push_back(edge(4, 9));
-
-  std::vector<float> cost_;
-  std::vector<uint16_t> previous;
-  all_paths(1, adjacency_list, cost_, previous);
-  std::cout << "Cost from 1 to 5: " << cost_[5] << std::endl;
-  std::copy_if(previous.begin(), previous.end(),
-               std::ostream_iterator<uint16_t>(std::cout, " "),
-               [](uint16_t i) { return i != NO_NODE; });
-  std::list<uint16_t> path = shortest_path(5, previous);
-  std::cout << "Path : ";
-  std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(std::cout, " "));
-  std::cout << std::endl;
-
-  return 0;
+struct bench_edge_t {
+  uint16_t source;
+  uint16_t dest;
+  float cost;
+};
+
+// The std::set based Dijkstra that Graph used to use, for comparison.
+static std::vector<float> set_dijkstra(uint16_t node, uint16_t max_size,
+                                       const std::vector<bench_edge_t>& edges) {
+  std::vector<std::vector<edge>> adjacency_list(max_size);
+  for (const auto& e : edges) {
+    adjacency_list[e.source].emplace_back(e.dest, e.cost);
+  }
+  std::vector<float> cost(max_size, std::numeric_limits<float>::infinity());
+  std::vector<uint16_t> previous(max_size, NO_NODE);
+  cost[node] = 0;
+  std::set<std::pair<float, uint16_t>> queue;
+  queue.insert(std::make_pair(cost[node], node));
+  while (!queue.empty()) {
+    const auto [dist, u] = *queue.begin();
+    queue.erase(queue.begin());
+    for (const auto& e : adjacency_list[u]) {
+      if (const auto c = dist + e.cost_; c < cost[e.node_]) {
+        queue.erase(std::make_pair(cost[e.node_], e.node_));
+        cost[e.node_] = c;
+        previous[e.node_] = u;
+        queue.insert(std::make_pair(c, e.node_));
+      }
+    }
+  }
+  return cost;
+}
+
+template <typename F> static double time_ms(F f) {
+  const auto start = steady_clock::now();
+  f();
+  return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+  const auto num_nodes =
+      static_cast<uint16_t>(argc > 1 ? std::atoi(argv[1]) : std::numeric_limits<uint16_t>::max());
+  const auto edges_per_node = argc > 2 ? std::atoi(argv[2]) : 4;
+
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> node(1, num_nodes - 1);
+  std::uniform_int_distribution<int> cost(1, 100);
+  std::vector<bench_edge_t> edges;
+  for (auto n = 1; n < num_nodes; n++) {
+    // A ring keeps everything reachable, the rest are random links.
+    const auto next = static_cast<uint16_t>(n + 1 < num_nodes ? n + 1 : 1);
+    edges.push_back({static_cast<uint16_t>(n), next, static_cast<float>(cost(rng))});
+    for (auto i = 1; i < edges_per_node; i++) {
+      edges.push_back({static_cast<uint16_t>(n), static_cast<uint16_t>(node(rng)),
+                       static_cast<float>(cost(rng))});
+    }
+  }
+  std::cout << "Nodes: " << num_nodes << " Edges: " << edges.size() << std::endl;
+
+  std::vector<float> reference;
+  std::cout << "std::set Dijkstra:      "
+            << time_ms([&] { reference = set_dijkstra(1, num_nodes, edges); }) << " ms"
+            << std::endl;
+
+  Graph graph(1, num_nodes);
+  std::cout << "Graph build:            " << time_ms([&] {
+    for (const auto& e : edges) {
+      graph.add_edge(e.source, e.dest, e.cost);
+    }
+  }) << " ms" << std::endl;
+  std::cout << "Graph compute:          " << time_ms([&] { (void)graph.cost_to(1); }) << " ms"
+            << std::endl;
+
+  long long total_hops = 0;
+  std::cout << "Export all routes:      " << time_ms([&] {
+    for (uint16_t n = 1; n < num_nodes; n++) {
+      total_hops += graph.num_hops_to(n) + graph.next_hop_to(n);
+    }
+  }) << " ms" << std::endl;
+
+  auto mismatches = 0;
+  for (uint16_t n = 1; n < num_nodes; n++) {
+    if (reference[n] != graph.cost_to(n)) {
+      ++mismatches;
+    }
+  }
+
+  constexpr auto kNumUpdates = 10;
+  std::cout << kNumUpdates << " incremental updates: " << time_ms([&] {
+    for (auto i = 0; i < kNumUpdates; i++) {
+      auto& e = edges.at(static_cast<size_t>(node(rng)));
+      e.cost = static_cast<float>(cost(rng));
+      graph.update_edge(e.source, e.dest, e.cost);
+    }
+  }) << " ms" << std::endl;
+
+  reference = set_dijkstra(1, num_nodes, edges);
+  for (uint16_t n = 1; n < num_nodes; n++) {
+    if (reference[n] != graph.cost_to(n)) {
+      ++mismatches;
+    }
+  }
+  std::cout << "Cost mismatches:        " << mismatches << std::endl;
+  return mismatches == 0 ? 0 : 1;
 }
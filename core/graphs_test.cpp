@@ -0,0 +1,172 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2022, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+#include "core/graphs.h"
+#include <cmath>
+#include <list>
+#include <random>
+#include <vector>
+
+using namespace wwiv::graphs;
+
+class GraphsTest : public testing::Test {
+protected:
+  // remember to insert edges both ways for an undirected graph
+  static void AddEdges(Graph& g) {
+    g.add_edge(1, 2, 10);
+    g.add_edge(1, 3, 15);
+    g.add_edge(2, 1, 10);
+    g.add_edge(2, 3, 11);
+    g.add_edge(2, 5, 2);
+    g.add_edge(3, 1, 15);
+    g.add_edge(3, 2, 11);
+    g.add_edge(3, 4, 6);
+    g.add_edge(4, 3, 6);
+    g.add_edge(4, 5, 9);
+    g.add_edge(5, 2, 2);
+    g.add_edge(5, 4, 9);
+  }
+};
+
+TEST_F(GraphsTest, ShortestPath) {
+  Graph g(1, 10);
+  AddEdges(g);
+  EXPECT_EQ(12, g.cost_to(5));
+  EXPECT_EQ((std::list<uint16_t>{1, 2, 5}), g.shortest_path_to(5));
+  EXPECT_EQ(2, g.num_hops_to(5));
+  EXPECT_EQ(2, g.next_hop_to(5));
+  EXPECT_EQ(3, g.next_hop_to(3));
+  EXPECT_EQ(0, g.num_hops_to(1));
+  EXPECT_EQ(NO_NODE, g.next_hop_to(1));
+
+  std::vector<uint16_t> path;
+  ASSERT_TRUE(g.path_to(5, path));
+  EXPECT_EQ((std::vector<uint16_t>{1, 2, 5}), path);
+}
+
+TEST_F(GraphsTest, Unreachable) {
+  Graph g(1, 10);
+  AddEdges(g);
+  EXPECT_FALSE(std::isfinite(g.cost_to(7)));
+  EXPECT_EQ(NO_NODE, g.next_hop_to(7));
+  std::vector<uint16_t> path;
+  EXPECT_FALSE(g.path_to(7, path));
+  EXPECT_TRUE(path.empty());
+  EXPECT_FALSE(g.has_node(7));
+  EXPECT_TRUE(g.has_node(5));
+}
+
+TEST_F(GraphsTest, AddEdge_AfterCompute) {
+  Graph g(1, 10);
+  AddEdges(g);
+  EXPECT_EQ(12, g.cost_to(5));
+  EXPECT_FALSE(g.add_edge(1, 5, 1));
+}
+
+TEST_F(GraphsTest, UpdateEdge_Decrease) {
+  Graph g(1, 10);
+  AddEdges(g);
+  EXPECT_EQ(21, g.cost_to(4));
+  ASSERT_TRUE(g.update_edge(1, 5, 1));
+  EXPECT_EQ(1, g.cost_to(5));
+  EXPECT_EQ(3, g.cost_to(2));
+  EXPECT_EQ(10, g.cost_to(4));
+  EXPECT_EQ(5, g.next_hop_to(4));
+  EXPECT_EQ(2, g.num_hops_to(4));
+}
+
+TEST_F(GraphsTest, RemoveEdge) {
+  Graph g(1, 10);
+  AddEdges(g);
+  EXPECT_EQ(2, g.next_hop_to(5));
+  ASSERT_TRUE(g.remove_edge(2, 5));
+  EXPECT_EQ(30, g.cost_to(5));
+  EXPECT_EQ((std::list<uint16_t>{1, 3, 4, 5}), g.shortest_path_to(5));
+  EXPECT_EQ(3, g.next_hop_to(5));
+  EXPECT_EQ(3, g.num_hops_to(5));
+  EXPECT_FALSE(g.remove_edge(2, 5));
+}
+
+TEST_F(GraphsTest, RemoveEdge_Disconnects) {
+  Graph g(1, 10);
+  g.add_edge(1, 2, 1);
+  g.add_edge(2, 3, 1);
+  EXPECT_EQ(2, g.cost_to(3));
+  ASSERT_TRUE(g.remove_edge(1, 2));
+  EXPECT_FALSE(std::isfinite(g.cost_to(2)));
+  EXPECT_FALSE(std::isfinite(g.cost_to(3)));
+  EXPECT_EQ(NO_NODE, g.next_hop_to(3));
+  EXPECT_EQ(0, g.num_hops_to(3));
+}
+
+// Incremental updates must give the same costs as computing from scratch.
+TEST_F(GraphsTest, Incremental_MatchesFull) {
+  constexpr uint16_t kNumNodes = 2000;
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> node(1, kNumNodes - 1);
+  std::uniform_int_distribution<int> cost(1, 100);
+
+  struct e_t { uint16_t s; uint16_t d; float c; };
+  std::vector<e_t> edges;
+  for (auto i = 0; i < kNumNodes * 3; i++) {
+    edges.push_back({static_cast<uint16_t>(node(rng)), static_cast<uint16_t>(node(rng)),
+                     static_cast<float>(cost(rng))});
+  }
+  Graph incremental(1, kNumNodes);
+  for (const auto& e : edges) {
+    incremental.add_edge(e.s, e.d, e.c);
+  }
+  ASSERT_TRUE(std::isfinite(incremental.cost_to(1)));
+
+  for (auto round = 0; round < 50; round++) {
+    auto& e = edges.at(static_cast<size_t>(node(rng)) % edges.size());
+    if (round % 5 == 4) {
+      incremental.remove_edge(e.s, e.d);
+      for (auto& o : edges) {
+        if (o.s == e.s && o.d == e.d) {
+          o.c = -1;
+        }
+      }
+    } else {
+      e.c = static_cast<float>(cost(rng));
+      incremental.update_edge(e.s, e.d, e.c);
+      for (auto& o : edges) {
+        if (o.s == e.s && o.d == e.d && o.c >= 0) {
+          o.c = e.c;
+        }
+      }
+    }
+
+    Graph full(1, kNumNodes);
+    for (const auto& o : edges) {
+      if (o.c >= 0) {
+        full.add_edge(o.s, o.d, o.c);
+      }
+    }
+    for (uint16_t n = 1; n < kNumNodes; n++) {
+      ASSERT_EQ(full.cost_to(n), incremental.cost_to(n)) << "round: " << round << " node: " << n;
+      if (std::isfinite(full.cost_to(n))) {
+        std::vector<uint16_t> path;
+        ASSERT_TRUE(incremental.path_to(n, path));
+        ASSERT_EQ(incremental.num_hops_to(n) + 1, static_cast<int>(path.size()));
+        ASSERT_EQ(n == 1 ? NO_NODE : path.at(1), incremental.next_hop_to(n));
+      }
+    }
+  }
+}
@@ -37,6 +37,8 @@ public:
   /** True if this IP Address is an empty address (i.e. 0.0.0.0 or ::) */
   [[nodiscard]] bool empty() const;
   [[nodiscard]] static std::optional<ip_address> from_string(const std::string&);
+  /** The address as 16 bytes in network order, IPv4 addresses are IPv4-mapped IPv6. */
+  [[nodiscard]] const char* data() const noexcept { return data_; }
   friend inline bool operator==(const ip_address& lhs, const ip_address& rhs);
   friend inline bool operator!=(const ip_address& lhs, const ip_address& rhs);
   friend std::ostream& operator<<(std::ostream& os, const ip_address& u);
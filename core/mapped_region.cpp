@@ -0,0 +1,177 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/mapped_region.h"
+
+#include "core/log.h"
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include "core/wwiv_windows.h"
+#include <io.h>
+#elif !defined(__OS2__)
+#include <sys/mman.h>
+#endif
+
+namespace wwiv::core {
+
+MappedRegion::MappedRegion(File& file, bool writable) : writable_(writable) {
+  if (!file.IsOpen()) {
+    LOG(ERROR) << "MappedRegion: file is not open: " << file.path();
+    return;
+  }
+  file_ = &file;
+  if (!Map(file.length())) {
+    file_ = nullptr;
+  }
+}
+
+MappedRegion::MappedRegion(MappedRegion&& other) noexcept
+    : file_(std::exchange(other.file_, nullptr)), writable_(other.writable_),
+      data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {
+#ifdef _WIN32
+  mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+}
+
+MappedRegion& MappedRegion::operator=(MappedRegion&& other) noexcept {
+  if (this != &other) {
+    Unmap();
+    file_ = std::exchange(other.file_, nullptr);
+    writable_ = other.writable_;
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+    mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+  }
+  return *this;
+}
+
+MappedRegion::~MappedRegion() { Unmap(); }
+
+bool MappedRegion::Map(size_type size) {
+  if (size == 0) {
+    // Nothing can map an empty file, so leave the region empty until an Append.
+    return true;
+  }
+#if defined(_WIN32)
+  auto* h = reinterpret_cast<HANDLE>(_get_osfhandle(file_->handle()));
+  mapping_ = CreateFileMapping(h, nullptr, writable_ ? PAGE_READWRITE : PAGE_READONLY, 0, 0,
+                               nullptr);
+  if (mapping_ == nullptr) {
+    LOG(ERROR) << "CreateFileMapping failed for: " << file_->path()
+               << "; error: " << GetLastError();
+    return false;
+  }
+  auto* m = MapViewOfFile(mapping_, writable_ ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0,
+                          static_cast<SIZE_T>(size));
+  if (m == nullptr) {
+    LOG(ERROR) << "MapViewOfFile failed for: " << file_->path() << "; error: " << GetLastError();
+    CloseHandle(mapping_);
+    mapping_ = nullptr;
+    return false;
+  }
+#elif defined(__OS2__)
+  LOG(ERROR) << "MappedRegion is not supported on OS/2: " << file_->path();
+  return false;
+#else
+  const auto prot = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+  auto* m = mmap(nullptr, static_cast<size_t>(size), prot, MAP_SHARED, file_->handle(), 0);
+  if (m == MAP_FAILED) {
+    LOG(ERROR) << "mmap failed for: " << file_->path() << "; " << strerror(errno);
+    return false;
+  }
+#endif
+#if !defined(__OS2__)
+  data_ = static_cast<std::byte*>(m);
+  size_ = size;
+  return true;
+#endif
+}
+
+void MappedRegion::Unmap() noexcept {
+#if defined(_WIN32)
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+    mapping_ = nullptr;
+  }
+#elif !defined(__OS2__)
+  if (data_ != nullptr) {
+    munmap(data_, static_cast<size_t>(size_));
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+bool MappedRegion::Append(const void* data, size_type size) {
+  if (!ok()) {
+    return false;
+  }
+  if (file_->WriteAt(file_->length(), data, size) != size) {
+    return false;
+  }
+  return Remap();
+}
+
+bool MappedRegion::Remap() {
+  if (!ok()) {
+    return false;
+  }
+  const auto new_size = file_->length();
+  if (new_size == size_) {
+    return true;
+  }
+#if defined(__linux__)
+  if (data_ != nullptr && new_size != 0) {
+    // Lets the kernel grow the mapping in place when it can.
+    auto* m = mremap(data_, static_cast<size_t>(size_), static_cast<size_t>(new_size),
+                     MREMAP_MAYMOVE);
+    if (m == MAP_FAILED) {
+      LOG(ERROR) << "mremap failed for: " << file_->path() << "; " << strerror(errno);
+      return false;
+    }
+    data_ = static_cast<std::byte*>(m);
+    size_ = new_size;
+    return true;
+  }
+#endif
+  Unmap();
+  return Map(new_size);
+}
+
+bool MappedRegion::Sync() {
+  if (data_ == nullptr || !writable_) {
+    return true;
+  }
+#if defined(_WIN32)
+  return FlushViewOfFile(data_, 0) != 0;
+#elif defined(__OS2__)
+  return false;
+#else
+  return msync(data_, static_cast<size_t>(size_), MS_SYNC) == 0;
+#endif
+}
+
+} // namespace wwiv::core
@@ -0,0 +1,133 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_MAPPED_REGION_H
+#define INCLUDED_CORE_MAPPED_REGION_H
+
+#include "core/file.h"
+#include <cstddef>
+#include <type_traits>
+
+namespace wwiv::core {
+
+/**
+ * A non-owning view of a contiguous run of records, like C++20's std::span.
+ */
+template <typename T> class RecordSpan final {
+public:
+  using size_type = ssize_t;
+
+  RecordSpan() noexcept = default;
+  RecordSpan(T* data, size_type size) noexcept : data_(data), size_(size) {}
+
+  [[nodiscard]] T* data() const noexcept { return data_; }
+  [[nodiscard]] size_type size() const noexcept { return size_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  [[nodiscard]] T* begin() const noexcept { return data_; }
+  [[nodiscard]] T* end() const noexcept { return data_ + size_; }
+  T& operator[](size_type n) const noexcept { return data_[n]; }
+
+  /** Returns the count records starting at offset. */
+  [[nodiscard]] RecordSpan subspan(size_type offset, size_type count) const noexcept {
+    return RecordSpan(data_ + offset, count);
+  }
+
+private:
+  T* data_{nullptr};
+  size_type size_{0};
+};
+
+/**
+ * MappedRegion: Maps the whole of an open File into memory, unmapping it
+ * when destroyed.  A writable region writes through to the file.
+ *
+ * Pointers and RecordSpans into the region are invalidated by Append and
+ * Remap, which may move the mapping.  Not supported on OS/2.
+ *
+ * Example:
+ *   File f(FilePath(config.datadir(), "names.lst"));
+ *   if (!f.Open(File::modeBinary | File::modeReadOnly)) { return; }
+ *   MappedRegion m(f);
+ *   for (const auto& n : m.records<smalrec>()) { LOG(INFO) << n.name; }
+ */
+class MappedRegion final {
+public:
+  using size_type = File::size_type;
+
+  MappedRegion() noexcept = default;
+  /**
+   * Maps file, which must stay open for the life of this region.  A writable
+   * region needs file to be open for reading and writing.
+   */
+  explicit MappedRegion(File& file, bool writable = false);
+  MappedRegion(MappedRegion&& other) noexcept;
+  MappedRegion& operator=(MappedRegion&& other) noexcept;
+  MappedRegion(const MappedRegion&) = delete;
+  MappedRegion& operator=(const MappedRegion&) = delete;
+  ~MappedRegion();
+
+  /** True if the file is mapped.  An empty file maps to an empty region. */
+  [[nodiscard]] bool ok() const noexcept { return file_ != nullptr; }
+  explicit operator bool() const noexcept { return ok(); }
+
+  [[nodiscard]] const std::byte* data() const noexcept { return data_; }
+  [[nodiscard]] std::byte* data() noexcept { return data_; }
+  [[nodiscard]] size_type size() const noexcept { return size_; }
+
+  /** Returns the whole records of type T in the region, ignoring any partial one at the end. */
+  template <typename T> [[nodiscard]] RecordSpan<const T> records() const noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "records must be trivially copyable");
+    return RecordSpan<const T>(reinterpret_cast<const T*>(data_),
+                               size_ / static_cast<size_type>(sizeof(T)));
+  }
+
+  template <typename T> [[nodiscard]] RecordSpan<T> records() noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "records must be trivially copyable");
+    return RecordSpan<T>(reinterpret_cast<T*>(data_), size_ / static_cast<size_type>(sizeof(T)));
+  }
+
+  /** Writes size bytes at the end of the file and remaps to include them. */
+  bool Append(const void* data, size_type size);
+
+  template <typename T> bool Append(const T& record) {
+    static_assert(std::is_trivially_copyable_v<T>, "records must be trivially copyable");
+    return Append(&record, sizeof(T));
+  }
+
+  /** Remaps the file if its length changed, such as after another writer appended to it. */
+  bool Remap();
+
+  /** Flushes changes made through a writable region to disk. */
+  bool Sync();
+
+private:
+  bool Map(size_type size);
+  void Unmap() noexcept;
+
+  File* file_{nullptr};
+  bool writable_{false};
+  std::byte* data_{nullptr};
+  size_type size_{0};
+#ifdef _WIN32
+  void* mapping_{nullptr};
+#endif
+};
+
+} // namespace wwiv::core
+
+#endif
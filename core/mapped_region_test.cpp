@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/mapped_region.h"
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+
+using namespace wwiv::core;
+
+namespace {
+struct rec_t {
+  int a;
+  int b;
+};
+}
+
+TEST(MappedRegionTest, Bytes) {
+  test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "Hello World");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+
+  const MappedRegion m(file);
+  ASSERT_TRUE(m.ok());
+  ASSERT_EQ(11, m.size());
+  EXPECT_EQ("Hello World", std::string(reinterpret_cast<const char*>(m.data()), m.size()));
+}
+
+TEST(MappedRegionTest, Empty) {
+  test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+
+  const MappedRegion m(file);
+  ASSERT_TRUE(m.ok());
+  EXPECT_EQ(0, m.size());
+  EXPECT_TRUE(m.records<rec_t>().empty());
+}
+
+TEST(MappedRegionTest, NotOpen) {
+  test::FileHelper helper;
+  File file(helper.CreateTempFile(test_info_->name(), "x"));
+  const MappedRegion m(file);
+  EXPECT_FALSE(m.ok());
+}
+
+TEST(MappedRegionTest, Records_IgnoresPartialRecord) {
+  test::FileHelper helper;
+  const auto path = helper.CreateTempFilePath(test_info_->name());
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeCreateFile | File::modeBinary | File::modeReadWrite));
+  const rec_t r[2]{{1, 2}, {3, 4}};
+  file.Write(r, sizeof(r));
+  file.Write("x", 1);
+
+  const MappedRegion m(file);
+  const auto records = m.records<rec_t>();
+  ASSERT_EQ(2, records.size());
+  EXPECT_EQ(1, records[0].a);
+  EXPECT_EQ(4, records[1].b);
+  int sum = 0;
+  for (const auto& rec : records) {
+    sum += rec.a;
+  }
+  EXPECT_EQ(4, sum);
+}
+
+TEST(MappedRegionTest, Writable_WritesThrough) {
+  test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "0123456789");
+  {
+    File file(path);
+    ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadWrite));
+    MappedRegion m(file, true);
+    ASSERT_TRUE(m.ok());
+    std::memcpy(m.data() + 2, "ab", 2);
+    EXPECT_TRUE(m.Sync());
+  }
+  EXPECT_EQ("01ab456789", helper.ReadFile(path));
+}
+
+TEST(MappedRegionTest, Append_GrowsAndRemaps) {
+  test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadWrite));
+
+  MappedRegion m(file, true);
+  ASSERT_TRUE(m.ok());
+  // Enough records to need more than one page.
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(m.Append(rec_t{i, i * 2}));
+  }
+  const auto records = m.records<rec_t>();
+  ASSERT_EQ(1000, records.size());
+  EXPECT_EQ(999, records[999].a);
+  EXPECT_EQ(1998, records[999].b);
+  EXPECT_EQ(static_cast<File::size_type>(1000 * sizeof(rec_t)), file.length());
+}
+
+TEST(MappedRegionTest, Remap_SeesOtherWriters) {
+  test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "abc");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadWrite));
+
+  MappedRegion m(file);
+  ASSERT_EQ(3, m.size());
+  ASSERT_EQ(3, file.WriteAt(3, "def", 3));
+  ASSERT_TRUE(m.Remap());
+  EXPECT_EQ("abcdef", std::string(reinterpret_cast<const char*>(m.data()), m.size()));
+}
+
+TEST(MappedRegionTest, Move) {
+  test::FileHelper helper;
+  const auto path = helper.CreateTempFile(test_info_->name(), "abc");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+
+  MappedRegion m(file);
+  MappedRegion m2(std::move(m));
+  EXPECT_FALSE(m.ok());  // NOLINT(bugprone-use-after-move)
+  ASSERT_TRUE(m2.ok());
+  EXPECT_EQ(3, m2.size());
+
+  MappedRegion m3;
+  m3 = std::move(m2);
+  EXPECT_EQ('a', static_cast<char>(m3.data()[0]));
+}
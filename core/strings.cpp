@@ -120,18 +120,8 @@ void SplitString(const std::string& original_string, const std::string& delims,
 
 void SplitString(const std::string& original_string, const std::string& delims, bool skip_empty,
                  std::vector<std::string>* out) {
-  auto s(original_string);
-  for (auto found = s.find_first_of(delims); found != std::string::npos;
-       s = s.substr(found + 1), found = s.find_first_of(delims)) {
-    if (found > 0) {
-      out->push_back(s.substr(0, found));
-    } else if (!skip_empty && found == 0) {
-      // Add empty lines.
-      out->push_back({});
-    }
-  }
-  if (!s.empty()) {
-    out->push_back(s);
+  for (const auto s : SplitView(original_string, delims, skip_empty)) {
+    out->emplace_back(s);
   }
 }
 
@@ -151,12 +141,19 @@ std::tuple<std::string, std::string> SplitOnceLast(const std::string& original_s
 }
 
 
-bool starts_with(const std::string& input, const std::string& match) {
+void SplitString(std::string_view original_string, std::string_view delims, bool skip_empty,
+                 std::vector<std::string_view>* out) {
+  for (const auto s : SplitView(original_string, delims, skip_empty)) {
+    out->push_back(s);
+  }
+}
+
+bool starts_with(std::string_view input, std::string_view match) noexcept {
   return input.size() >= match.size()
          && std::equal(std::begin(match), std::end(match), std::begin(input));
 }
 
-bool ends_with(const std::string& input, const std::string& match) {
+bool ends_with(std::string_view input, std::string_view match) noexcept {
   return input.size() >= match.size()
          && std::equal(match.rbegin(), match.rend(), input.rbegin());
 }
@@ -250,6 +247,15 @@ std::string StringTrim(const std::string& orig) {
   return s;
 }
 
+std::string_view StringTrimView(std::string_view s) noexcept {
+  const auto first = s.find_first_not_of(DELIMS_WHITE);
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const auto last = s.find_last_not_of(DELIMS_WHITE);
+  return s.substr(first, last - first + 1);
+}
+
 void StringTrimBegin(std::string* s) {
   const auto pos = s->find_first_not_of(DELIMS_WHITE);
   s->erase(0, pos);
@@ -285,6 +291,11 @@ std::string ToStringUpperCase(const std::string& orig) {
   return s;
 }
 
+void ToStringUpperCase(std::string_view s, std::string* out) {
+  out->resize(s.size());
+  std::transform(std::begin(s), std::end(s), std::begin(*out), to_upper_case<char>);
+}
+
 static char tolower_char(int c) {
   return static_cast<char>(tolower(c));
 }
@@ -23,7 +23,9 @@
 #include <cstring> // strncpy
 // ReSharper disable once CppUnusedIncludeDirective
 #include <ctime>   // struct tm
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <sstream>
 #include <string>
@@ -163,6 +165,114 @@ template <typename A, typename... Args> std::string StrCat(const A& a, const Arg
   void SplitString(const std::string& original_string, const std::string& delims, bool skip_empty,
                    std::vector<std::string>* out);
 
+  /**
+   * @brief Splits a string on the boundaries defined by delims without copying
+   * 
+   * Appends the same pieces as the other SplitString overloads to out, but as
+   * views into original_string.  Clearing and reusing out between calls avoids
+   * allocating at all once it has grown.
+   *
+   * @param[in] original_string The string to be split
+   * @param[in] delims          the boundaries at which to split the string
+   * @param[in] skip_empty      Should empty strings be not included in out.
+   * @param[out] out            Views of original_string split at delims
+   */
+  void SplitString(std::string_view original_string, std::string_view delims, bool skip_empty,
+                   std::vector<std::string_view>* out);
+
+  /**
+   * A lazy range of the pieces SplitString would return, as views into the
+   * original string, so splitting doesn't allocate.  Both the string and
+   * delims must outlive the range.
+   *
+   * Example:
+   *   for (const auto line : SplitView(text, "\r", false)) {
+   *     if (starts_with(line, "AREA:")) { ... }
+   *   }
+   */
+  class SplitView final {
+  public:
+    class iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::string_view;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const std::string_view*;
+      using reference = const std::string_view&;
+
+      iterator() noexcept = default;
+
+      reference operator*() const noexcept { return current_; }
+      pointer operator->() const noexcept { return &current_; }
+      iterator& operator++() noexcept {
+        next();
+        return *this;
+      }
+      iterator operator++(int) noexcept {
+        auto it = *this;
+        next();
+        return it;
+      }
+      bool operator==(const iterator& o) const noexcept {
+        if (done_ || o.done_) {
+          return done_ == o.done_;
+        }
+        return current_.data() == o.current_.data() && current_.size() == o.current_.size();
+      }
+      bool operator!=(const iterator& o) const noexcept { return !(*this == o); }
+
+    private:
+      friend class SplitView;
+      iterator(std::string_view s, std::string_view delims, bool skip_empty) noexcept
+          : rest_(s), delims_(delims), skip_empty_(skip_empty), done_(false) {
+        next();
+      }
+
+      void next() noexcept {
+        for (;;) {
+          if (last_) {
+            done_ = true;
+            return;
+          }
+          const auto found = rest_.find_first_of(delims_);
+          if (found == std::string_view::npos) {
+            // Like SplitString, a trailing empty piece is never included.
+            last_ = true;
+            if (rest_.empty()) {
+              done_ = true;
+              return;
+            }
+            current_ = rest_;
+            return;
+          }
+          current_ = rest_.substr(0, found);
+          rest_.remove_prefix(found + 1);
+          if (!current_.empty() || !skip_empty_) {
+            return;
+          }
+        }
+      }
+
+      std::string_view rest_;
+      std::string_view delims_;
+      std::string_view current_;
+      bool skip_empty_{true};
+      bool last_{false};
+      bool done_{true};
+    };
+
+    SplitView(std::string_view s, std::string_view delims, bool skip_empty = true) noexcept
+        : s_(s), delims_(delims), skip_empty_(skip_empty) {}
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator(s_, delims_, skip_empty_); }
+    [[nodiscard]] iterator end() const noexcept { return {}; }
+
+  private:
+    std::string_view s_;
+    std::string_view delims_;
+    bool skip_empty_;
+  };
+
   /**
    * Splits a string once on the first occurrence of any character in delims.
    */
@@ -173,14 +283,16 @@ template <typename A, typename... Args> std::string StrCat(const A& a, const Arg
    */
   std::tuple<std::string, std::string> SplitOnceLast(const std::string& original_string, const std::string& delims);
 
-  [[nodiscard]] bool starts_with(const std::string& input, const std::string& match);
-  [[nodiscard]] bool ends_with(const std::string& input, const std::string& match);
+  [[nodiscard]] bool starts_with(std::string_view input, std::string_view match) noexcept;
+  [[nodiscard]] bool ends_with(std::string_view input, std::string_view match) noexcept;
 
   void StringJustify(std::string* s, int length, char bg,
                      JustificationType just_type);
   void StringTrim(char* str);
   void StringTrim(std::string* s);
   [[nodiscard]] std::string StringTrim(const std::string& orig);
+  /** Returns the part of s that StringTrim would, without copying it. */
+  [[nodiscard]] std::string_view StringTrimView(std::string_view s) noexcept;
 
   void StringTrimCRLF(std::string* s);
 
@@ -195,6 +307,8 @@ template <typename A, typename... Args> std::string StrCat(const A& a, const Arg
   void StringTrimBegin(std::string* s);
   void StringUpperCase(std::string* s);
   [[nodiscard]] std::string ToStringUpperCase(const std::string& s);
+  /** Replaces the contents of out with s in upper case, reusing its buffer. */
+  void ToStringUpperCase(std::string_view s, std::string* out);
   void StringLowerCase(std::string* s);
   [[nodiscard]] std::string ToStringLowerCase(const std::string& s);
 
@@ -151,6 +151,92 @@ TEST(StringsTest, SplitString_TwoDelimsBackToBack) {
   EXPECT_EQ(expected, actual);
 }
 
+// Inputs for checking the string_view helpers give the same results as the
+// std::string ones.
+static const std::vector<std::string> kSplitInputs = {
+    "", " ", "a", "Hello World", "Hello   World", " Hello World ", "\rA\r\rB\r",
+    "Hello\t\tWorld  \t\t  Everyone", "AREA:BENCH\r\001MSGID: 1:2/3 1\r\rtext\r\r"};
+
+static std::vector<std::string> to_strings(const std::vector<std::string_view>& v) {
+  return {v.begin(), v.end()};
+}
+
+// SplitString as it was before it used SplitView, to check the results are
+// unchanged.
+static std::vector<std::string> ReferenceSplitString(const std::string& original_string,
+                                                     const std::string& delims, bool skip_empty) {
+  std::vector<std::string> out;
+  auto s(original_string);
+  for (auto found = s.find_first_of(delims); found != std::string::npos;
+       s = s.substr(found + 1), found = s.find_first_of(delims)) {
+    if (found > 0) {
+      out.push_back(s.substr(0, found));
+    } else if (!skip_empty && found == 0) {
+      out.push_back({});
+    }
+  }
+  if (!s.empty()) {
+    out.push_back(s);
+  }
+  return out;
+}
+
+TEST(StringsTest, SplitString_SameAsReference) {
+  for (const auto& delims : {" ", " \t", "\r", ""}) {
+    for (const auto skip_empty : {true, false}) {
+      for (const auto& s : kSplitInputs) {
+        EXPECT_EQ(ReferenceSplitString(s, delims, skip_empty), SplitString(s, delims, skip_empty))
+            << "s: '" << s << "' delims: '" << delims << "' skip_empty: " << skip_empty;
+      }
+    }
+  }
+}
+
+TEST(StringsTest, SplitString_View_SameAsSplitString) {
+  for (const auto& delims : {" ", " \t", "\r", ""}) {
+    for (const auto skip_empty : {true, false}) {
+      for (const auto& s : kSplitInputs) {
+        std::vector<std::string_view> actual;
+        SplitString(std::string_view(s), delims, skip_empty, &actual);
+        EXPECT_EQ(ReferenceSplitString(s, delims, skip_empty), to_strings(actual))
+            << "s: '" << s << "' delims: '" << delims << "' skip_empty: " << skip_empty;
+      }
+    }
+  }
+}
+
+TEST(StringsTest, SplitString_View_Appends) {
+  std::vector<std::string_view> actual{"x"};
+  SplitString(std::string_view("a b"), " ", true, &actual);
+  EXPECT_EQ(std::vector<std::string>({"x", "a", "b"}), to_strings(actual));
+}
+
+TEST(StringsTest, SplitView_SameAsSplitString) {
+  for (const auto& delims : {" ", " \t", "\r", ""}) {
+    for (const auto skip_empty : {true, false}) {
+      for (const auto& s : kSplitInputs) {
+        std::vector<std::string> actual;
+        for (const auto piece : SplitView(s, delims, skip_empty)) {
+          actual.emplace_back(piece);
+        }
+        EXPECT_EQ(ReferenceSplitString(s, delims, skip_empty), actual)
+            << "s: '" << s << "' delims: '" << delims << "' skip_empty: " << skip_empty;
+      }
+    }
+  }
+}
+
+TEST(StringsTest, SplitView_Iterator) {
+  const SplitView v("a,b,,c", ",");
+  auto it = v.begin();
+  EXPECT_EQ(3, std::distance(v.begin(), v.end()));
+  EXPECT_EQ("a", *it++);
+  EXPECT_EQ(1u, it->size());
+  EXPECT_EQ("b", *it);
+  EXPECT_EQ("c", *++it);
+  EXPECT_TRUE(++it == v.end());
+  EXPECT_TRUE(SplitView("", ",").begin() == SplitView("", ",").end());
+}
 
 TEST(StringsTest, SplitOnce_Smoke) {
   auto [p, s] = SplitOnce("user.name", ".");
@@ -323,6 +409,12 @@ TEST(StringsTest, StringTrim) {
   EXPECT_EQ("b", b);
 }
 
+TEST(StringsTest, StringTrimView_SameAsStringTrim) {
+  for (const std::string s : {"", " ", " \r\n\t", "a", " a ", "\ta b\r\n", "a  "}) {
+    EXPECT_EQ(StringTrim(s), StringTrimView(s)) << "s: '" << s << "'";
+  }
+}
+
 TEST(StringsTest, StringTrimBegin) {
   std::string a = " a ";
   StringTrimBegin(&a);
@@ -363,6 +455,14 @@ TEST(StringsTest, StringUpperCase) {
   EXPECT_EQ("AB", a);
 }
 
+TEST(StringsTest, ToStringUpperCase_Buffer) {
+  std::string out = "a much longer string that's already here";
+  for (const std::string s : {"", "a", "Hello World 123", "MiXeD"}) {
+    ToStringUpperCase(s, &out);
+    EXPECT_EQ(ToStringUpperCase(s), out);
+  }
+}
+
 TEST(StringsTest, StringLowerCase) {
   std::string a = "aB";
   StringLowerCase(&a);
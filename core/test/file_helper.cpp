@@ -42,7 +42,9 @@ std::filesystem::path FileHelper::testdata_;
 
 FileHelper::FileHelper() {
   const auto* const test_info = testing::UnitTest::GetInstance()->current_test_info();
-  const auto dir = fmt::format("{}_{}", test_info->test_suite_name(), test_info->name());
+  // There's no current test when used outside of gtest, i.e. from wwiv_bench.
+  const auto dir = test_info ? fmt::format("{}_{}", test_info->test_suite_name(), test_info->name())
+                             : std::string("wwiv_bench");
   tmp_ = File::canonical(CreateTempDir(dir));
 }
 
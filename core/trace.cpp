@@ -0,0 +1,149 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/trace.h"
+
+#include "fmt/format.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wwiv::core {
+
+std::atomic<bool> internal::tracing_enabled{false};
+static std::atomic<trace_sink_fn> trace_sink{nullptr};
+static std::atomic<uint32_t> next_thread_id{1};
+
+namespace {
+
+struct trace_ring_t {
+  // Allocated on first use so threads that never trace don't pay for it.
+  std::unique_ptr<trace_span_t[]> spans;
+  int next{0};
+  int count{0};
+  uint32_t depth{0};
+  uint32_t thread_id{0};
+};
+
+} // namespace
+
+static thread_local trace_ring_t ring;
+
+static int64_t now_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+template <size_t N> static void copy_truncated(std::string_view s, char (&dest)[N]) {
+  const auto len = std::min(s.size(), N - 1);
+  memcpy(dest, s.data(), len);
+  dest[len] = '\0';
+}
+
+void set_tracing_enabled(bool enabled) { internal::tracing_enabled.store(enabled); }
+
+void set_trace_sink(trace_sink_fn sink) { trace_sink.store(sink); }
+
+void TraceSpan::begin() noexcept {
+  depth_ = ring.depth++;
+  start_ns_ = now_ns();
+}
+
+void TraceSpan::end() noexcept {
+  const auto duration = now_ns() - start_ns_;
+  --ring.depth;
+  if (!ring.spans) {
+    ring.spans.reset(new (std::nothrow) trace_span_t[kTraceRingSize]);
+    if (!ring.spans) {
+      return;
+    }
+    ring.thread_id = next_thread_id.fetch_add(1);
+  }
+  auto& s = ring.spans[ring.next];
+  copy_truncated(category_, s.category);
+  copy_truncated(name_, s.name);
+  s.start_ns = start_ns_;
+  s.duration_ns = duration;
+  s.thread_id = ring.thread_id;
+  s.depth = depth_;
+  ring.next = (ring.next + 1) % kTraceRingSize;
+  ring.count = std::min(ring.count + 1, kTraceRingSize);
+
+  if (const auto sink = trace_sink.load(); sink != nullptr) {
+    sink(s);
+  }
+}
+
+std::vector<trace_span_t> trace_spans() {
+  std::vector<trace_span_t> spans;
+  if (!ring.spans) {
+    return spans;
+  }
+  spans.reserve(ring.count);
+  const auto first = (ring.next - ring.count + kTraceRingSize) % kTraceRingSize;
+  for (auto i = 0; i < ring.count; i++) {
+    spans.push_back(ring.spans[(first + i) % kTraceRingSize]);
+  }
+  return spans;
+}
+
+void clear_trace_spans() {
+  ring.next = 0;
+  ring.count = 0;
+}
+
+static std::string json_escape(const char* s) {
+  std::string out;
+  for (; *s; ++s) {
+    const auto c = static_cast<unsigned char>(*s);
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(static_cast<char>(c));
+    } else if (c < 0x20) {
+      out.append(fmt::format("\\u{:04x}", c));
+    } else {
+      out.push_back(static_cast<char>(c));
+    }
+  }
+  return out;
+}
+
+std::string to_chrome_trace_json(const std::vector<trace_span_t>& spans, int pid) {
+  std::string out = "{\"traceEvents\":[";
+  auto first = true;
+  for (const auto& s : spans) {
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    // Complete ("X") events with the times in microseconds.
+    out.append(fmt::format(
+        "\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},"
+        "\"pid\":{},\"tid\":{}}}",
+        json_escape(s.name), json_escape(s.category), s.start_ns / 1000.0,
+        s.duration_ns / 1000.0, pid, s.thread_id));
+  }
+  out.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+  return out;
+}
+
+} // namespace wwiv::core
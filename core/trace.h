@@ -0,0 +1,117 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_TRACE_H
+#define INCLUDED_CORE_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wwiv::core {
+
+/** A completed span, as kept in the per-thread ring buffer. */
+struct trace_span_t {
+  char category[16];
+  char name[40];
+  // Nanoseconds on the steady clock.
+  int64_t start_ns;
+  int64_t duration_ns;
+  // Small number identifying the thread, starting at 1.
+  uint32_t thread_id;
+  // Number of spans open on this thread when this one started.
+  uint32_t depth;
+};
+
+/** Called with each span as it completes, i.e. to update histograms. */
+typedef void (*trace_sink_fn)(const trace_span_t& span);
+
+/** Number of the most recent spans kept for each thread. */
+static constexpr int kTraceRingSize = 4096;
+
+namespace internal {
+extern std::atomic<bool> tracing_enabled;
+}
+
+/** Turns tracing on or off for the whole process. It's off by default. */
+void set_tracing_enabled(bool enabled);
+
+[[nodiscard]] inline bool tracing_enabled() noexcept {
+  return internal::tracing_enabled.load(std::memory_order_relaxed);
+}
+
+/** Sets the sink called for every completed span, or nullptr for none. */
+void set_trace_sink(trace_sink_fn sink);
+
+/** Returns the spans recorded on the calling thread, oldest first. */
+[[nodiscard]] std::vector<trace_span_t> trace_spans();
+
+/** Forgets the spans recorded on the calling thread. */
+void clear_trace_spans();
+
+/**
+ * Returns spans in the Chrome trace event format, which can be loaded
+ * into chrome://tracing or https://ui.perfetto.dev.
+ */
+[[nodiscard]] std::string to_chrome_trace_json(const std::vector<trace_span_t>& spans, int pid);
+
+/**
+ * Times the enclosing scope when tracing is enabled. When it's disabled the
+ * cost is a single relaxed load.
+ *
+ * Example use:
+ * \code
+ *  TraceSpan span("msgapi", "ReadMessage");
+ * \endcode
+ *
+ * Both category and name are only used before the span is destroyed, and
+ * are truncated to fit in trace_span_t.
+ */
+class TraceSpan final {
+public:
+  TraceSpan(std::string_view category, std::string_view name) noexcept
+      : category_(category), name_(name) {
+    if (tracing_enabled()) {
+      begin();
+    }
+  }
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan(TraceSpan&&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+  TraceSpan& operator=(TraceSpan&&) = delete;
+  ~TraceSpan() {
+    if (start_ns_ >= 0) {
+      end();
+    }
+  }
+
+private:
+  void begin() noexcept;
+  void end() noexcept;
+
+  std::string_view category_;
+  std::string_view name_;
+  int64_t start_ns_{-1};
+  uint32_t depth_{0};
+};
+
+} // namespace wwiv::core
+
+#endif
@@ -0,0 +1,111 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+#include "core/trace.h"
+#include <string>
+#include <thread>
+
+using namespace wwiv::core;
+
+class TraceTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    clear_trace_spans();
+    set_tracing_enabled(true);
+  }
+  void TearDown() override {
+    set_tracing_enabled(false);
+    set_trace_sink(nullptr);
+    clear_trace_spans();
+  }
+};
+
+TEST_F(TraceTest, Disabled) {
+  set_tracing_enabled(false);
+  { TraceSpan span("test", "Disabled"); }
+  EXPECT_TRUE(trace_spans().empty());
+}
+
+TEST_F(TraceTest, Nested) {
+  {
+    TraceSpan outer("menu", "Outer");
+    TraceSpan inner("msgapi", "Inner");
+  }
+  const auto spans = trace_spans();
+  ASSERT_EQ(2u, spans.size());
+  // Spans are recorded as they complete, so the inner one is first.
+  EXPECT_STREQ("msgapi", spans[0].category);
+  EXPECT_STREQ("Inner", spans[0].name);
+  EXPECT_EQ(1u, spans[0].depth);
+  EXPECT_STREQ("Outer", spans[1].name);
+  EXPECT_EQ(0u, spans[1].depth);
+  EXPECT_LE(spans[1].start_ns, spans[0].start_ns);
+  EXPECT_GE(spans[1].duration_ns, spans[0].duration_ns);
+}
+
+TEST_F(TraceTest, Truncated) {
+  const std::string name(100, 'x');
+  { TraceSpan span("test", name); }
+  const auto spans = trace_spans();
+  ASSERT_EQ(1u, spans.size());
+  EXPECT_EQ(std::string(sizeof(spans[0].name) - 1, 'x'), spans[0].name);
+}
+
+TEST_F(TraceTest, RingKeepsNewest) {
+  for (auto i = 0; i < kTraceRingSize + 10; i++) {
+    TraceSpan span("test", std::to_string(i));
+  }
+  const auto spans = trace_spans();
+  ASSERT_EQ(static_cast<size_t>(kTraceRingSize), spans.size());
+  EXPECT_STREQ("10", spans.front().name);
+  EXPECT_EQ(std::to_string(kTraceRingSize + 9), spans.back().name);
+}
+
+TEST_F(TraceTest, PerThread) {
+  { TraceSpan span("test", "Main"); }
+  std::thread t([] {
+    TraceSpan span("test", "Thread");
+  });
+  t.join();
+  const auto spans = trace_spans();
+  ASSERT_EQ(1u, spans.size());
+  EXPECT_STREQ("Main", spans[0].name);
+}
+
+static int sink_calls = 0;
+static void CountingSink(const trace_span_t&) { ++sink_calls; }
+
+TEST_F(TraceTest, Sink) {
+  sink_calls = 0;
+  set_trace_sink(CountingSink);
+  { TraceSpan span("test", "Sink"); }
+  set_tracing_enabled(false);
+  { TraceSpan span("test", "Sink"); }
+  EXPECT_EQ(1, sink_calls);
+}
+
+TEST_F(TraceTest, ChromeJson) {
+  trace_span_t s{"menu", "Say \"hi\"", 1500, 2000, 1, 0};
+  const auto json = to_chrome_trace_json({s}, 42);
+  EXPECT_NE(std::string::npos,
+            json.find(R"({"name":"Say \"hi\"","cat":"menu","ph":"X","ts":1.500,"dur":2.000,)"
+                      R"("pid":42,"tid":1})"))
+      << json;
+  EXPECT_EQ(0u, json.find(R"({"traceEvents":[)"));
+}
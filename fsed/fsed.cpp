@@ -135,7 +135,7 @@ bool fsed(Context& ctx, FsedModel& ed, MessageEditorData& data, bool file) {
 
   // top editor line number in thw viewable area.
   while (!state.done) {
-    view->gotoxy(ed);
+    view->flush_if_idle(ed);
 
     const auto key = view->bgetch(ed);
     if (key < 0xff && key >= 32) {
@@ -148,8 +148,7 @@ bool fsed(Context& ctx, FsedModel& ed, MessageEditorData& data, bool file) {
           continue;
         }
       }
-      view->gotoxy(ed);
-      view->outchr(ed.curline().wwiv_color(), c);
+      view->echo(ed, c);
       ed.add(c);
       continue;
     }
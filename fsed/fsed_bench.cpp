@@ -0,0 +1,285 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+// Measures how many bytes the full screen editor sends to the remote terminal
+// while a large block of text is pasted into the middle of a message.
+//
+// The paste arrives as keystrokes, read from the socket keys_per_read at a
+// time.  The legacy renderer redraws every invalidated line as soon as it is
+// invalidated, like FsedView used to.  The damage renderer does what FsedView
+// does now: it marks rows dirty, waits until no more input is pending, and
+// then only sends the cells that differ from what the remote already shows.
+//
+// Usage: fsed_bench [num_lines] [keys_per_read]
+#include "fsed/line.h"
+#include "fsed/model.h"
+#include "fsed/screen.h"
+
+#include "fmt/format.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+using namespace wwiv::fsed;
+
+// Screen geometry of a 80x25 terminal with the fsed header and bars.
+static constexpr int kScreenWidth = 79;
+static constexpr int kLinesStart = 6;
+static constexpr int kNumRows = 17;
+
+// Counts the bytes Output would send for each call.
+class Terminal {
+public:
+  void goxy(int x, int y) { bytes += static_cast<int64_t>(fmt::format("\x1b[{};{}H", y, x).size()); }
+  void ansic(int c) {
+    // Output::ansic sends nothing when the color does not change, otherwise
+    // something like ESC [ 0 ; 1 ; 3 3 m
+    if (c != color_) {
+      color_ = c;
+      bytes += 10;
+    }
+  }
+  void outchr(char) { ++bytes; }
+  void clreol() { bytes += 3; }
+  void outcells(const std::vector<cell_t>& cells) {
+    for (const auto& c : cells) {
+      ansic(c.wwiv_color);
+      outchr(c.ch);
+    }
+  }
+
+  int64_t bytes{0};
+
+private:
+  int color_{-1};
+};
+
+class BenchView final : public editor_viewport_t {
+public:
+  [[nodiscard]] int max_view_lines() const override { return kNumRows - 1; }
+  [[nodiscard]] int max_view_columns() const override { return kScreenWidth; }
+  [[nodiscard]] int top_line() const override { return top_line_; }
+  void set_top_line(int l) override { top_line_ = l; }
+  void gotoxy(const FsedModel&) override {}
+
+private:
+  int top_line_{0};
+};
+
+class Renderer {
+public:
+  virtual ~Renderer() = default;
+  virtual void invalidate(const FsedModel& ed, int start_line, int end_line) = 0;
+  virtual void echo(const FsedModel& ed, char ch, bool input_pending) = 0;
+  virtual void idle(const FsedModel& ed) = 0;
+  Terminal term;
+};
+
+// Redraws every invalidated line right away, like FsedView used to.
+class LegacyRenderer final : public Renderer {
+public:
+  explicit LegacyRenderer(const BenchView& view) : view_(view) {}
+
+  void invalidate(const FsedModel& ed, int start_line, int end_line) override {
+    const auto top = view_.top_line();
+    for (auto i = std::max(start_line, top); i <= end_line; i++) {
+      const auto row = i - top;
+      if (row >= kNumRows || i >= static_cast<int>(ed.size())) {
+        break;
+      }
+      term.goxy(1, row + kLinesStart);
+      term.outcells(ed.line(i).cells());
+      term.clreol();
+    }
+    if (static_cast<int>(ed.size()) == end_line + 1) {
+      for (auto row = static_cast<int>(ed.size()) - top; row < kNumRows; row++) {
+        term.goxy(1, row + kLinesStart);
+        term.clreol();
+      }
+    }
+  }
+
+  void echo(const FsedModel& ed, char ch, bool) override {
+    term.goxy(ed.cx + 1, ed.cy + kLinesStart);
+    term.ansic(ed.curline().wwiv_color());
+    term.outchr(ch);
+  }
+
+  void idle(const FsedModel&) override {}
+
+private:
+  const BenchView& view_;
+};
+
+// Marks rows dirty and sends only the damage when idle, like FsedView.
+class DamageRenderer final : public Renderer {
+public:
+  explicit DamageRenderer(const BenchView& view) : view_(view) {}
+
+  void invalidate(const FsedModel& ed, int start_line, int end_line) override {
+    const auto top = view_.top_line();
+    const auto end_row =
+        end_line >= static_cast<int>(ed.size()) - 1 ? kNumRows - 1 : end_line - top;
+    screen_.invalidate(start_line - top, end_row);
+  }
+
+  void echo(const FsedModel& ed, char ch, bool input_pending) override {
+    if (input_pending) {
+      screen_.invalidate(ed.cy, ed.cy);
+      return;
+    }
+    term.goxy(ed.cx + 1, ed.cy + kLinesStart);
+    term.ansic(ed.curline().wwiv_color());
+    term.outchr(ch);
+    screen_.put(ed.cy, ed.cx, cell_t{ed.curline().wwiv_color(), ch});
+  }
+
+  void idle(const FsedModel& ed) override {
+    static const std::vector<cell_t> empty_row;
+    for (auto row = 0; row < kNumRows; row++) {
+      if (!screen_.dirty(row)) {
+        continue;
+      }
+      const auto i = row + view_.top_line();
+      const auto& cells = i < static_cast<int>(ed.size()) ? ed.line(i).cells() : empty_row;
+      if (const auto d = screen_.update(row, cells)) {
+        term.goxy(d->x + 1, row + kLinesStart);
+        term.outcells(d->cells);
+        if (d->clear_eol) {
+          term.ansic(0);
+          term.clreol();
+        }
+      }
+    }
+  }
+
+private:
+  const BenchView& view_;
+  ScreenBuffer screen_{kNumRows};
+};
+
+static std::vector<std::string> make_lines(int num_lines, int seed) {
+  static const std::vector<std::string> words{
+      "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "WWIV", "BBS",
+      "network", "message", "sysop", "node", "callers", "> ", "modem", "baud", "FidoNet"};
+  std::mt19937 gen(seed);
+  std::vector<std::string> lines;
+  for (auto i = 0; i < num_lines; i++) {
+    std::string l;
+    const auto len = 20 + static_cast<int>(gen() % 50);
+    while (static_cast<int>(l.size()) < len) {
+      l.append(words[gen() % words.size()]);
+      l.push_back(' ');
+    }
+    lines.push_back(l);
+  }
+  return lines;
+}
+
+// Only runs the model, to time it without any rendering.
+class NullRenderer final : public Renderer {
+public:
+  explicit NullRenderer(const BenchView&) {}
+  void invalidate(const FsedModel&, int, int) override {}
+  void echo(const FsedModel&, char, bool) override {}
+  void idle(const FsedModel&) override {}
+};
+
+struct paste_result_t {
+  double ms{0};
+  int64_t bytes{0};
+};
+
+template <typename R>
+static paste_result_t paste(const std::vector<std::string>& existing,
+                            const std::vector<std::string>& pasted, int keys_per_read) {
+  FsedModel ed(static_cast<int>(existing.size() + pasted.size()) * 2);
+  auto view = std::make_shared<BenchView>();
+  ed.set_view(view);
+  ed.set_max_line_len(kScreenWidth);
+  for (const auto& l : existing) {
+    ed.emplace_back(line_t{l});
+  }
+  R renderer(*view);
+  ed.add_callback([&renderer](FsedModel& e, editor_range_t r) {
+    renderer.invalidate(e, r.start.line, r.end.line);
+  });
+  ed.add_callback([&renderer](FsedModel& e, int previous_line) {
+    renderer.invalidate(e, previous_line, previous_line);
+    renderer.invalidate(e, e.curli, e.curli);
+  });
+
+  // Start in the middle of the message with the screen already drawn.
+  ed.curli = static_cast<int>(existing.size()) / 2;
+  ed.cy = kNumRows / 2;
+  view->set_top_line(ed.curli - ed.cy);
+  renderer.invalidate(ed, view->top_line(), static_cast<int>(ed.size()) - 1);
+  renderer.idle(ed);
+  renderer.term.bytes = 0;
+
+  std::string keys;
+  for (const auto& l : pasted) {
+    keys.append(l);
+    keys.push_back('\r');
+  }
+  const auto start = steady_clock::now();
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    const auto input_pending =
+        (i + 1) % keys_per_read != 0 && i + 1 < keys.size();
+    if (keys[i] == '\r') {
+      ed.enter();
+    } else {
+      renderer.echo(ed, keys[i], input_pending);
+      ed.add(keys[i]);
+    }
+    if (!input_pending) {
+      renderer.idle(ed);
+    }
+  }
+  return {duration<double, std::milli>(steady_clock::now() - start).count(), renderer.term.bytes};
+}
+
+int main(int argc, char** argv) {
+  const auto num_lines = argc > 1 ? std::atoi(argv[1]) : 5000;
+  const auto keys_per_read = std::max(1, argc > 2 ? std::atoi(argv[2]) : 64);
+
+  const auto existing = make_lines(200, 1);
+  const auto pasted = make_lines(num_lines, 2);
+  int64_t num_keys = 0;
+  for (const auto& l : pasted) {
+    num_keys += static_cast<int64_t>(l.size()) + 1;
+  }
+  std::cout << fmt::format("Pasting {} lines ({} keys, {} keys per read) into the middle of a "
+                           "{} line message.\n",
+                           num_lines, num_keys, keys_per_read, existing.size());
+
+  const auto model = paste<NullRenderer>(existing, pasted, keys_per_read);
+  std::cout << fmt::format("Model only:  {:8.1f} ms\n", model.ms);
+  const auto legacy = paste<LegacyRenderer>(existing, pasted, keys_per_read);
+  std::cout << fmt::format("Legacy:      {:8.1f} ms {:12} bytes sent\n", legacy.ms, legacy.bytes);
+  const auto damage = paste<DamageRenderer>(existing, pasted, keys_per_read);
+  std::cout << fmt::format("Damage list: {:8.1f} ms {:12} bytes sent\n", damage.ms, damage.bytes);
+  return 0;
+}
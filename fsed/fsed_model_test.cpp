@@ -137,3 +137,67 @@ TEST_F(FsedModelWithViewTest, BackSpace_Color) {
   // Now 0 since we went to the end.
   EXPECT_EQ(0, ed.curline().wwiv_color());
 }
+
+TEST_F(FsedModelWithViewTest, Insert_Middle_Reflows) {
+  ed.set_max_line_len(20);
+  add("aaaa bbbb cccc dddd eeee");
+  ASSERT_EQ(2, wwiv::stl::ssize(ed));
+  EXPECT_EQ("aaaa bbbb cccc dddd ", ed.line(0).to_colored_text(0));
+  EXPECT_EQ("eeee", ed.line(1).to_colored_text(0));
+
+  // Typing in the middle of the first line pushes a word onto the next.
+  ed.curli = 0;
+  ed.cy = 0;
+  ed.cx = 5;
+  add("xx ");
+  ASSERT_EQ(2, wwiv::stl::ssize(ed));
+  EXPECT_EQ("aaaa xx bbbb cccc ", ed.line(0).to_colored_text(0));
+  EXPECT_EQ("dddd eeee", ed.line(1).to_colored_text(0));
+  EXPECT_TRUE(ed.line(0).wrapped());
+  EXPECT_EQ(0, ed.curli);
+  EXPECT_EQ(8, ed.cx);
+}
+
+TEST_F(FsedModelWithViewTest, DeleteWordLeft_PullsUp) {
+  ed.set_max_line_len(20);
+  add("aaaa bbbb cccc dddd eeee");
+  ed.curli = 0;
+  ed.cy = 0;
+  ed.cx = 9;
+  ed.delete_word_left();
+  ASSERT_EQ(1, wwiv::stl::ssize(ed));
+  EXPECT_EQ("aaaa cccc dddd eeee", ed.line(0).to_colored_text(0));
+  EXPECT_FALSE(ed.line(0).wrapped());
+  EXPECT_EQ(4, ed.cx);
+}
+
+TEST_F(FsedModelWithViewTest, BackSpace_JoinsLines) {
+  ed.set_max_line_len(20);
+  add("Hello \nWorld");
+  ed.cursor_home();
+  ed.bs();
+  ASSERT_EQ(1, wwiv::stl::ssize(ed));
+  EXPECT_EQ("Hello World", ed.line(0).to_colored_text(0));
+  EXPECT_EQ(0, ed.curli);
+  EXPECT_EQ(0, ed.cy);
+  EXPECT_EQ(6, ed.cx);
+}
+
+TEST_F(FsedModelWithViewTest, Reflow_OnlyInvalidatesParagraph) {
+  ed.set_max_line_len(20);
+  add("first\naaaa bbbb cccc dddd eeee\nlast");
+  int start = -1;
+  int end = -1;
+  ed.add_callback([&](wwiv::fsed::FsedModel&, wwiv::fsed::editor_range_t r) {
+    start = r.start.line;
+    end = r.end.line;
+  });
+  ed.curli = 1;
+  ed.cy = 1;
+  ed.cx = 0;
+  ed.del();
+  EXPECT_EQ("aaa bbbb cccc dddd ", ed.line(1).to_colored_text(0));
+  EXPECT_EQ("eeee", ed.line(2).to_colored_text(0));
+  EXPECT_EQ(1, start);
+  EXPECT_EQ(1, end);
+}
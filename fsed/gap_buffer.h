@@ -0,0 +1,154 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_FSED_GAP_BUFFER_H
+#define INCLUDED_FSED_GAP_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace wwiv::fsed {
+
+/**
+ * Sequence container that keeps a gap of unused slots at the last edit
+ * position.  Inserting or erasing next to the previous edit is O(1), which
+ * is the common case in the editor since edits follow the cursor, instead of
+ * shifting every element after it like std::vector does.
+ *
+ * T must be default constructible and move assignable.
+ */
+template <typename T> class GapBuffer {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  GapBuffer() = default;
+  explicit GapBuffer(std::vector<T>&& v) { assign(std::move(v)); }
+
+  [[nodiscard]] size_type size() const noexcept { return buf_.size() - gap_size(); }
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  T& operator[](size_type n) { return buf_[physical(n)]; }
+  const T& operator[](size_type n) const { return buf_[physical(n)]; }
+
+  T& at(size_type n) {
+    if (n >= size()) {
+      throw std::out_of_range("GapBuffer::at");
+    }
+    return buf_[physical(n)];
+  }
+
+  [[nodiscard]] const T& at(size_type n) const {
+    if (n >= size()) {
+      throw std::out_of_range("GapBuffer::at");
+    }
+    return buf_[physical(n)];
+  }
+
+  /** Inserts t before position pos, returns false if pos is out of range. */
+  bool insert(size_type pos, T&& t) {
+    if (pos > size()) {
+      return false;
+    }
+    move_gap(pos);
+    if (gap_start_ == gap_end_) {
+      grow();
+    }
+    buf_[gap_start_++] = std::move(t);
+    return true;
+  }
+
+  /** Erases the element at pos, returns false if pos is out of range. */
+  bool erase(size_type pos) {
+    if (pos >= size()) {
+      return false;
+    }
+    move_gap(pos);
+    // Release whatever the erased element owns now rather than when the
+    // slot is reused.
+    buf_[gap_end_++] = T{};
+    return true;
+  }
+
+  void push_back(T&& t) { insert(size(), std::move(t)); }
+
+  void clear() {
+    buf_.clear();
+    gap_start_ = gap_end_ = 0;
+  }
+
+  void assign(std::vector<T>&& v) {
+    buf_ = std::move(v);
+    gap_start_ = gap_end_ = buf_.size();
+  }
+
+  /** Returns a copy of the elements in order. */
+  [[nodiscard]] std::vector<T> to_vector() const {
+    std::vector<T> out;
+    out.reserve(size());
+    std::copy(buf_.begin(), buf_.begin() + gap_start_, std::back_inserter(out));
+    std::copy(buf_.begin() + gap_end_, buf_.end(), std::back_inserter(out));
+    return out;
+  }
+
+private:
+  [[nodiscard]] size_type gap_size() const noexcept { return gap_end_ - gap_start_; }
+  [[nodiscard]] size_type physical(size_type n) const noexcept {
+    return n < gap_start_ ? n : n + gap_size();
+  }
+
+  void move_gap(size_type pos) {
+    if (gap_start_ == gap_end_) {
+      // Nothing to move, and moving would self-assign elements.
+      gap_start_ = gap_end_ = pos;
+    } else if (pos < gap_start_) {
+      const auto count = gap_start_ - pos;
+      std::move_backward(buf_.begin() + pos, buf_.begin() + gap_start_, buf_.begin() + gap_end_);
+      gap_start_ -= count;
+      gap_end_ -= count;
+    } else if (pos > gap_start_) {
+      const auto count = pos - gap_start_;
+      std::move(buf_.begin() + gap_end_, buf_.begin() + gap_end_ + count,
+                buf_.begin() + gap_start_);
+      gap_start_ += count;
+      gap_end_ += count;
+    }
+  }
+
+  void grow() {
+    const auto tail = buf_.size() - gap_end_;
+    const auto capacity = std::max<size_type>(16, buf_.size() * 2);
+    std::vector<T> n(capacity);
+    std::move(buf_.begin(), buf_.begin() + gap_start_, n.begin());
+    std::move(buf_.begin() + gap_end_, buf_.end(), n.end() - tail);
+    gap_end_ = capacity - tail;
+    buf_.swap(n);
+  }
+
+  std::vector<T> buf_;
+  size_type gap_start_{0};
+  size_type gap_end_{0};
+};
+
+} // namespace wwiv::fsed
+
+#endif
@@ -29,6 +29,8 @@ enum class ins_ovr_mode_t { ins, ovr };
 class cell_t {
 public:
   cell_t(int co, char cc) : wwiv_color(co), ch(cc) {}
+  bool operator==(const cell_t& o) const noexcept { return ch == o.ch && wwiv_color == o.wwiv_color; }
+  bool operator!=(const cell_t& o) const noexcept { return !(*this == o); }
   int wwiv_color{0};
   char ch{0};
 };
@@ -56,9 +58,6 @@ public:
   void set_wwiv_color(int c);
   [[nodiscard]] int wwiv_color() const noexcept;
 
-  // operators
-  line_t& operator=(const line_t& o);
-
   void assign(const std::vector<cell_t>& cells);
   void append(const std::vector<cell_t>& cells);
   [[nodiscard]] const std::vector<cell_t>& cells() const { return cell_; }
@@ -21,6 +21,9 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include "fmt/format.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace wwiv::fsed {
 
@@ -51,7 +54,7 @@ void FsedModel::set_view(const std::shared_ptr<editor_viewport_t>& view) { view_
 line_t& FsedModel::curline() const {
   // TODO: insert return statement here
   while (curli >= size_int(lines_)) {
-    lines_.emplace_back();
+    lines_.push_back(line_t());
   }
   try {
     return lines_.at(curli);
@@ -73,17 +76,17 @@ line_t& FsedModel::line(int n) const {
 }
 
 bool FsedModel::set_lines(std::vector<line_t>&& n) {
-  lines_ = n;
+  lines_.assign(std::move(n));
   return true;
 }
 
-void FsedModel::emplace_back(line_t&& n) { lines_.emplace_back(n); }
+void FsedModel::emplace_back(line_t&& n) { lines_.push_back(std::move(n)); }
 
 bool FsedModel::insert_line() {
-  if (size_int(lines_) >= maxli()) {
+  if (size_int(lines_) >= maxli() || curli < 0) {
     return false;
   }
-  return wwiv::stl::insert_at(lines_, curli, line_t());
+  return lines_.insert(curli, line_t());
 }
 
 bool FsedModel::insert_lines(std::vector<std::string>& lines) {
@@ -104,10 +107,114 @@ bool FsedModel::insert_lines(std::vector<std::string>& lines) {
 }
 
 bool FsedModel::remove_line() {
-  if (lines_.empty()) {
+  if (lines_.empty() || curli < 0) {
     return false;
   }
-  return wwiv::stl::erase_at(lines_, curli);
+  return lines_.erase(curli);
+}
+
+bool FsedModel::reflow_paragraph() {
+  // Make sure the current line exists.
+  curline();
+  auto first = curli;
+  while (first > 0 && line(first - 1).wrapped()) {
+    --first;
+  }
+  auto last = curli;
+  while (last < size_int(lines_) - 1 && line(last).wrapped()) {
+    ++last;
+  }
+
+  // Join the paragraph back into one run of cells, noting where the cursor is.
+  std::vector<cell_t> text;
+  auto cursor = 0;
+  for (auto i = first; i <= last; i++) {
+    const auto& cells = line(i).cells();
+    if (i == curli) {
+      cursor = size_int(text) + std::min<int>(cx, size_int(cells));
+    }
+    text.insert(text.end(), cells.begin(), cells.end());
+  }
+  const auto last_wrapped = line(last).wrapped();
+  const auto last_color = line(last).wwiv_color();
+
+  // Break it into lines that fit.  Like add, prefer breaking after a space
+  // unless that would leave the line less than half full.
+  const auto width = std::max<int>(max_line_len_ - 1, 1);
+  const auto len = size_int(text);
+  std::vector<std::pair<int, int>> breaks;
+  auto start = 0;
+  while (len - start > width) {
+    auto end = start + width;
+    for (auto i = start + width - 1; i > start; i--) {
+      if (text[i].ch == ' ' || text[i].ch == '\t') {
+        if (i + 1 - start > width / 2) {
+          end = i + 1;
+        }
+        break;
+      }
+    }
+    breaks.emplace_back(start, end);
+    start = end;
+  }
+  breaks.emplace_back(start, len);
+
+  // Only rewrite the lines that changed.
+  const auto old_count = last - first + 1;
+  const auto new_count = size_int(breaks);
+  auto first_changed = -1;
+  auto last_changed = -1;
+  for (auto n = 0; n < new_count; n++) {
+    const auto li = first + n;
+    const auto& [b, e] = breaks[n];
+    const std::vector<cell_t> cells(text.begin() + b, text.begin() + e);
+    const auto wrapped = n + 1 < new_count || last_wrapped;
+    if (n >= old_count) {
+      lines_.insert(li, line_t());
+    } else if (line(li).wrapped() == wrapped && line(li).cells() == cells) {
+      continue;
+    }
+    auto& l = line(li);
+    l.assign(cells);
+    l.wrapped(wrapped);
+    if (first_changed < 0) {
+      first_changed = li;
+    }
+    last_changed = li;
+  }
+  for (auto n = new_count; n < old_count; n++) {
+    lines_.erase(first + new_count);
+  }
+  // Keep the color the user was typing with.
+  line(first + new_count - 1).set_wwiv_color(last_color);
+
+  // Put the cursor back on the same character.
+  const auto orig_curli = curli;
+  auto n = 0;
+  for (; n < new_count - 1; n++) {
+    const auto line_len = breaks[n].second - breaks[n].first;
+    if (cursor <= line_len) {
+      break;
+    }
+    cursor -= line_len;
+  }
+  curli = first + n;
+  cx = cursor;
+  cy += curli - orig_curli;
+  if (cy < 0 || cy > view_->max_view_lines()) {
+    cy = std::clamp<int>(cy, 0, view_->max_view_lines());
+    view_->set_top_line(curli - cy);
+    invalidate_to_eof(view_->top_line());
+    return true;
+  }
+
+  const auto start_line = first_changed < 0 ? orig_curli : std::min<int>(first_changed, orig_curli);
+  if (new_count != old_count) {
+    invalidate_to_eof(start_line);
+  } else {
+    invalidate_range(start_line, std::max<int>(last_changed, orig_curli));
+  }
+  return true;
 }
 
 editor_add_result_t FsedModel::add(char c) {
@@ -119,6 +226,11 @@ editor_add_result_t FsedModel::add(char c) {
   const auto start_line = curli;
   ++cx;
   if (cx < max_line_len_) {
+    if (size_int(line) >= max_line_len_) {
+      // Inserting in the middle of the line pushed it past the margin.
+      reflow_paragraph();
+      return editor_add_result_t::wrapped;
+    }
     // no  wrapping is needed
     if (line_result == line_add_result_t::needs_redraw) {
       invalidate_range(start_line, curli);
@@ -313,10 +425,7 @@ bool FsedModel::delete_word_left() {
     line.assign(line.substr(0, cx));
     line.append(remainder);
   }
-  // TODO(rushfan): Should reflow paragraph here.
-  line.wrapped(false);
-  invalidate_to_eol();
-  return true;
+  return reflow_paragraph();
 }
 
 bool FsedModel::delete_right() {
@@ -343,8 +452,12 @@ bool FsedModel::del() {
   if (r == line_add_result_t::error) {
     return false;
   }
+  if (curline().wrapped()) {
+    // Pull text up from the rest of the paragraph.
+    return reflow_paragraph();
+  }
   if (r == line_add_result_t::needs_redraw) {
-    invalidate_to_eof(curli);
+    invalidate_range(curli, curli);
   }
   return true;
 }
@@ -355,7 +468,7 @@ bool FsedModel::bs_nowrap() {
     return false;
   }
   if (r == line_add_result_t::needs_redraw) {
-    invalidate_to_eof(curli);
+    invalidate_range(curli, curli);
   }
   return true;
 }
@@ -368,6 +481,9 @@ bool FsedModel::bs() {
   bs_nowrap();
   if (cx > 0) {
     --cx;
+    if (curline().wrapped()) {
+      reflow_paragraph();
+    }
   } else if (curli > 0 && size_int(curline()) == 0) {
     // If current line is empty then delete it and move up one line
     if (remove_line()) {
@@ -377,21 +493,19 @@ bool FsedModel::bs() {
       invalidate_to_eof(curli);
     }
   } else if (curli > 0) {
+    // Join this line onto the end of the previous one and let the reflow
+    // move back down whatever no longer fits.
     auto& prev = line(curli - 1);
-    auto& cur = curline();
-    const auto last_pos = std::max<int>(0, max_line_len() - size_int(prev) - 1);
-    const auto new_cx = size_int(prev);
-    if (ssize(cur) < last_pos) {
-      prev.append(cur.cells());
-      remove_line();
-    } else if (const int space = cur.last_space_before(last_pos) > 0) {
-      prev.append(cur.substr(0, space));
-      cur.assign(cur.substr(space));
-    }
-    --cy;
+    prev.wrapped(true);
+    cx = size_int(prev);
     --curli;
-    cx = new_cx;
-    invalidate_to_eof(curli);
+    if (cy > 0) {
+      --cy;
+    } else {
+      view_->set_top_line(curli);
+      invalidate_to_eof(curli);
+    }
+    reflow_paragraph();
   }
   current_line_dirty(previous_line);
   view_->gotoxy(*this);
@@ -472,7 +586,8 @@ void FsedModel::current_line_dirty(int previous_line) {
 std::vector<std::string> FsedModel::to_lines(bool wrap) {
   std::vector<std::string> out;
   std::string curline;
-  for (const auto& l : lines_) {
+  for (auto i = 0; i < size_int(lines_); i++) {
+    const auto& l = lines_[i];
     if (!curline.empty() && curline.back() != ' ') {
       curline.push_back(' ');
     }
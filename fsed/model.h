@@ -18,6 +18,7 @@
 #ifndef INCLUDED_FSED_MODEL_H
 #define INCLUDED_FSED_MODEL_H
 
+#include "fsed/gap_buffer.h"
 #include "fsed/line.h"
 #include <functional>
 #include <vector>
@@ -94,6 +95,11 @@ public:
   // deletes the current line.
   bool remove_line();
 
+  // Re-wraps the paragraph containing the current line so that every line
+  // in it fits within max_line_len, keeping the cursor on the same character.
+  // Only lines in that paragraph are changed and invalidated.
+  bool reflow_paragraph();
+
   /**
    * Return the text as a vector of strings
    * If wrap is true then the text is wrapped in WWIV format, this means the
@@ -180,8 +186,9 @@ private:
   // Max number of lines allowed
   int maxli_{255};
   // Lines of text.  mark mutable so we can add the current line
-  // into the array and stay logically const.
-  mutable std::vector<line_t> lines_;
+  // into the array and stay logically const.  This is a gap buffer since
+  // lines are inserted and removed at the cursor.
+  mutable GapBuffer<line_t> lines_;
   // Insert or Overwrite mode
   ins_ovr_mode_t mode_{ins_ovr_mode_t::ins};
   // Max number of lines allowed.
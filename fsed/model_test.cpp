@@ -20,6 +20,10 @@
 #include "gmock/gmock.h"
 
 #include "fsed/model.h"
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace wwiv::fsed;
 using namespace testing;
@@ -94,3 +98,37 @@ TEST(Model, Wrap_WWIV_End) {
  EXPECT_THAT(lines[0], Eq("Hello\x1"));
  EXPECT_THAT(lines[1], Eq("World\x1"));
 }
+
+TEST(GapBufferTest, InsertErase) {
+  GapBuffer<int> b;
+  b.push_back(1);
+  b.push_back(3);
+  EXPECT_TRUE(b.insert(1, 2));
+  EXPECT_TRUE(b.insert(0, 0));
+  EXPECT_THAT(b.to_vector(), ElementsAre(0, 1, 2, 3));
+
+  EXPECT_TRUE(b.erase(2));
+  EXPECT_THAT(b.to_vector(), ElementsAre(0, 1, 3));
+  EXPECT_EQ(3, b.at(2));
+  EXPECT_FALSE(b.erase(3));
+  EXPECT_FALSE(b.insert(4, 4));
+  EXPECT_THROW(b.at(3), std::out_of_range);
+}
+
+TEST(GapBufferTest, MatchesVector) {
+  GapBuffer<std::string> b;
+  std::vector<std::string> v;
+  std::mt19937 gen(1);
+  for (auto i = 0; i < 2000; i++) {
+    const auto pos = v.empty() ? 0 : gen() % (v.size() + 1);
+    if (gen() % 3 == 0 && pos < v.size()) {
+      v.erase(v.begin() + pos);
+      ASSERT_TRUE(b.erase(pos));
+    } else {
+      const auto s = std::to_string(i);
+      v.insert(v.begin() + pos, s);
+      ASSERT_TRUE(b.insert(pos, std::string(s)));
+    }
+  }
+  EXPECT_EQ(v, b.to_vector());
+}
@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "fsed/screen.h"
+
+#include <algorithm>
+
+namespace wwiv::fsed {
+
+ScreenBuffer::ScreenBuffer(int num_rows)
+    : rows_(std::max<int>(num_rows, 0)), dirty_(std::max<int>(num_rows, 0), false) {}
+
+int ScreenBuffer::num_rows() const noexcept { return static_cast<int>(rows_.size()); }
+
+void ScreenBuffer::clear() {
+  for (auto& r : rows_) {
+    r.clear();
+  }
+}
+
+void ScreenBuffer::invalidate(int start_row, int end_row) {
+  start_row = std::max<int>(start_row, 0);
+  end_row = std::min<int>(end_row, num_rows() - 1);
+  for (auto row = start_row; row <= end_row; row++) {
+    if (!dirty_[row]) {
+      dirty_[row] = true;
+      ++num_dirty_;
+    }
+  }
+}
+
+bool ScreenBuffer::dirty(int row) const {
+  return row >= 0 && row < num_rows() && dirty_[row];
+}
+
+void ScreenBuffer::put(int row, int x, const cell_t& c) {
+  if (row < 0 || row >= num_rows() || x < 0) {
+    return;
+  }
+  auto& r = rows_[row];
+  // Anything skipped over is blank on the remote.
+  while (static_cast<int>(r.size()) < x) {
+    r.emplace_back(0, ' ');
+  }
+  if (static_cast<int>(r.size()) == x) {
+    r.emplace_back(c);
+  } else {
+    r[x] = c;
+  }
+}
+
+std::optional<screen_damage_t> ScreenBuffer::update(int row, const std::vector<cell_t>& cells) {
+  if (row < 0 || row >= num_rows()) {
+    return std::nullopt;
+  }
+  if (dirty_[row]) {
+    dirty_[row] = false;
+    --num_dirty_;
+  }
+  auto& old = rows_[row];
+  const auto common = std::min(old.size(), cells.size());
+
+  // Skip the unchanged prefix.
+  std::size_t first = 0;
+  while (first < common && old[first] == cells[first]) {
+    ++first;
+  }
+  if (first == cells.size() && first == old.size()) {
+    return std::nullopt;
+  }
+
+  // When the lengths match, skip the unchanged suffix too.  Otherwise
+  // everything to the end of the new text is written and the rest of the
+  // old text cleared.
+  auto last = cells.size();
+  if (old.size() == cells.size()) {
+    while (last > first && old[last - 1] == cells[last - 1]) {
+      --last;
+    }
+  }
+
+  screen_damage_t d{};
+  d.row = row;
+  d.x = static_cast<int>(first);
+  d.cells.assign(cells.begin() + first, cells.begin() + last);
+  d.clear_eol = old.size() > cells.size();
+  old = cells;
+  return d;
+}
+
+} // namespace wwiv::fsed
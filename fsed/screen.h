@@ -0,0 +1,86 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_FSED_SCREEN_H
+#define INCLUDED_FSED_SCREEN_H
+
+#include "fsed/line.h"
+#include <optional>
+#include <vector>
+
+namespace wwiv::fsed {
+
+/**
+ * Cells on one row of the remote terminal that must be sent to make it
+ * match the editor.
+ */
+struct screen_damage_t {
+  int row{0};
+  // First column that differs.
+  int x{0};
+  // Cells to write starting at x.
+  std::vector<cell_t> cells;
+  // True if the row must also be cleared after the last cell written.
+  bool clear_eol{false};
+};
+
+/**
+ * Copy of what the editor area of the remote terminal is displaying.
+ *
+ * The view marks rows as dirty when the model invalidates them and then
+ * calls update with what each dirty row should display.  Only the cells
+ * that differ from what the remote already has are returned as damage, so
+ * redrawing a range of lines where most of them have not changed costs
+ * nothing on the wire.
+ */
+class ScreenBuffer final {
+public:
+  explicit ScreenBuffer(int num_rows);
+
+  [[nodiscard]] int num_rows() const noexcept;
+
+  /** Resets every row to blank, used after the remote screen is cleared. */
+  void clear();
+
+  /** Marks the rows from start_row to end_row (inclusive) as dirty. */
+  void invalidate(int start_row, int end_row);
+  [[nodiscard]] bool dirty(int row) const;
+  [[nodiscard]] bool any_dirty() const noexcept { return num_dirty_ > 0; }
+
+  /**
+   * Records a cell written directly to the remote terminal at (x, row), such
+   * as echoing a typed character, so that it is not sent again.
+   */
+  void put(int row, int x, const cell_t& c);
+
+  /**
+   * Sets the contents of row to cells and clears its dirty flag.  Returns
+   * the damage needed to update the remote, or std::nullopt if the row is
+   * unchanged.
+   */
+  std::optional<screen_damage_t> update(int row, const std::vector<cell_t>& cells);
+
+private:
+  std::vector<std::vector<cell_t>> rows_;
+  std::vector<bool> dirty_;
+  int num_dirty_{0};
+};
+
+} // namespace wwiv::fsed
+
+#endif
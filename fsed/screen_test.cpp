@@ -0,0 +1,122 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "fsed/screen.h"
+#include <string>
+#include <vector>
+
+using namespace wwiv::fsed;
+
+static std::vector<cell_t> cells(const std::string& s, int color = 0) {
+  std::vector<cell_t> out;
+  for (const auto c : s) {
+    out.emplace_back(color, c);
+  }
+  return out;
+}
+
+static std::string text(const std::vector<cell_t>& c) {
+  std::string s;
+  for (const auto& cell : c) {
+    s.push_back(cell.ch);
+  }
+  return s;
+}
+
+TEST(ScreenBufferTest, Unchanged) {
+  ScreenBuffer s(5);
+  ASSERT_TRUE(s.update(0, cells("Hello")));
+  EXPECT_FALSE(s.update(0, cells("Hello")));
+}
+
+TEST(ScreenBufferTest, OnlyChangedCells) {
+  ScreenBuffer s(5);
+  s.update(1, cells("Hello World"));
+
+  auto d = s.update(1, cells("Hello Wxrld"));
+  ASSERT_TRUE(d);
+  EXPECT_EQ(1, d->row);
+  EXPECT_EQ(7, d->x);
+  EXPECT_EQ("x", text(d->cells));
+  EXPECT_FALSE(d->clear_eol);
+}
+
+TEST(ScreenBufferTest, Shorter_ClearsToEol) {
+  ScreenBuffer s(5);
+  s.update(0, cells("Hello World"));
+
+  auto d = s.update(0, cells("Hello"));
+  ASSERT_TRUE(d);
+  EXPECT_EQ(5, d->x);
+  EXPECT_TRUE(d->cells.empty());
+  EXPECT_TRUE(d->clear_eol);
+}
+
+TEST(ScreenBufferTest, Longer_WritesTail) {
+  ScreenBuffer s(5);
+  s.update(0, cells("Hello"));
+
+  auto d = s.update(0, cells("Hello World"));
+  ASSERT_TRUE(d);
+  EXPECT_EQ(5, d->x);
+  EXPECT_EQ(" World", text(d->cells));
+  EXPECT_FALSE(d->clear_eol);
+}
+
+TEST(ScreenBufferTest, ColorChange) {
+  ScreenBuffer s(5);
+  s.update(0, cells("Hello"));
+  auto d = s.update(0, cells("Hello", 2));
+  ASSERT_TRUE(d);
+  EXPECT_EQ(0, d->x);
+  EXPECT_EQ("Hello", text(d->cells));
+}
+
+TEST(ScreenBufferTest, Put) {
+  ScreenBuffer s(5);
+  s.update(0, cells("Hell"));
+  s.put(0, 4, cell_t{0, 'o'});
+  EXPECT_FALSE(s.update(0, cells("Hello")));
+}
+
+TEST(ScreenBufferTest, Dirty) {
+  ScreenBuffer s(5);
+  EXPECT_FALSE(s.any_dirty());
+  s.invalidate(-2, 1);
+  s.invalidate(4, 10);
+  EXPECT_TRUE(s.dirty(0));
+  EXPECT_TRUE(s.dirty(1));
+  EXPECT_FALSE(s.dirty(2));
+  EXPECT_TRUE(s.dirty(4));
+
+  s.update(0, cells(""));
+  s.update(1, cells(""));
+  s.update(4, cells(""));
+  EXPECT_FALSE(s.any_dirty());
+}
+
+TEST(ScreenBufferTest, Clear) {
+  ScreenBuffer s(5);
+  s.update(0, cells("Hello"));
+  s.clear();
+  auto d = s.update(0, cells("Hello"));
+  ASSERT_TRUE(d);
+  EXPECT_EQ("Hello", text(d->cells));
+}
@@ -37,7 +37,8 @@ using namespace wwiv::strings;
 namespace wwiv::fsed {
 
 FsedView::FsedView(const FullScreenView& fs, MessageEditorData& data, bool file)
-    : fs_(fs), bout_(fs_.out()), bin_(fs_.in()), data_(data), file_(file) {
+    : fs_(fs), bout_(fs_.out()), bin_(fs_.in()), data_(data), file_(file),
+      screen_(fs.message_height()) {
   max_view_lines_ = fs.message_height() - 1;
   max_view_columns_ = fs.screen_width();
 }
@@ -45,6 +46,8 @@ FsedView::FsedView(const FullScreenView& fs, MessageEditorData& data, bool file)
 FullScreenView& FsedView::fs() { return fs_; }
 
 void FsedView::gotoxy(const FsedModel& ed) {
+  cursor_x_ = ed.cx;
+  cursor_row_ = ed.cy;
   bout_.goxy(ed.cx + 1, ed.cy + fs_.lines_start()); // - top_line() 
 }
 
@@ -68,75 +71,79 @@ void FsedView::macro(Context& ctx, int cc) {
 
 void FsedView::draw_current_line(FsedModel& ed, int previous_line) { 
   if (previous_line != ed.curli) {
-    const auto py = previous_line - top_line() + fs_.lines_start();
-    bout_.goxy(0, py);
-    if (previous_line < size_int(ed)) {
-      bout_.outstr(ed.line(previous_line).to_colored_text(-1));
-    }
-    bout_.clreol();
-  }
-
-  const auto y = ed.curli - top_line() + fs_.lines_start(); 
-  bout_.goxy(0, y);
-  bout_.ansic(0);
-  for (const auto& c : ed.curline().cells()) {
-    // Draw char by char for the current line so we don't display
-    // color codes where we are editing.
-    bout_.ansic(c.wwiv_color);
-    bout_.outchr(c.ch);
+    screen_.invalidate(previous_line - top_line(), previous_line - top_line());
   }
-  bout_.clreol();
-  gotoxy(ed);
+  screen_.invalidate(ed.curli - top_line(), ed.curli - top_line());
+  flush_if_idle(ed);
 }
 
 void FsedView::handle_editor_invalidate(FsedModel& e, editor_range_t t) {
-  // TODO: optimize for first line
+  // Rows past the end of the text are cleared when invalidating to the end.
+  const auto end_row =
+      t.end.line >= size_int(e) - 1 ? screen_.num_rows() - 1 : t.end.line - top_line();
+  screen_.invalidate(t.start.line - top_line(), end_row);
+  flush_if_idle(e);
+}
 
-  // Never go below top line.
-  const auto start_line = std::max<int>(t.start.line, top_line());
+void FsedView::flush(const FsedModel& ed) {
+  static const std::vector<cell_t> empty_row;
   auto last_color = -1;
-
-  for (auto i = start_line; i <= t.end.line; i++) {
-    auto y = i - top_line() + fs_.lines_start();
-    if (y >= fs_.lines_end()) {
-      break;
+  for (auto row = 0; row < screen_.num_rows(); row++) {
+    if (!screen_.dirty(row)) {
+      continue;
     }
-    if (i >= size_int(e)) {
-      break;
+    const auto i = row + top_line();
+    const auto& cells = i < size_int(ed) ? ed.line(i).cells() : empty_row;
+    const auto d = screen_.update(row, cells);
+    if (!d) {
+      continue;
     }
-    bout_.goxy(0, y);
-    auto& rl = e.line(i);
-    if (i == e.curli) {
-      for (const auto& c : rl.cells()) {
-        // Draw char by char for the current line so we don't display
-        // color codes where we are editing.
-        if (c.wwiv_color != last_color) {
-          last_color = c.wwiv_color;
-          bout_.ansic(c.wwiv_color);
-        }
-        bout_.outchr(c.ch);
+    bout_.goxy(d->x + 1, row + fs_.lines_start());
+    for (const auto& c : d->cells) {
+      // Draw char by char so we don't display color codes.
+      if (c.wwiv_color != last_color) {
+        last_color = c.wwiv_color;
+        bout_.ansic(c.wwiv_color);
       }
-    } else {
-      bout_.outstr(rl.to_colored_text(-1));
+      bout_.outchr(c.ch);
     }
-    bout_.clreol();
-  }
-
-  // Clean up the bottom.
-  // clear the current and then remaining
-  if (size_int(e) == t.end.line + 1) {
-    for (auto z = size_int(e) - top_line() + fs_.lines_start(); z < fs_.lines_end(); z++) {
-      bout_.goxy(0, z);
+    if (d->clear_eol) {
+      if (last_color != 0) {
+        last_color = 0;
+        bout_.ansic(0);
+      }
       bout_.clreol();
     }
   }
+  gotoxy(ed);
+}
+
+void FsedView::flush_if_idle(const FsedModel& ed) {
+  if (bin_.bkbhit()) {
+    return;
+  }
+  if (screen_.any_dirty()) {
+    flush(ed);
+  } else {
+    gotoxy(ed);
+  }
+}
 
-  gotoxy(e);
+void FsedView::echo(const FsedModel& ed, char ch) {
+  if (bin_.bkbhit()) {
+    screen_.invalidate(ed.cy, ed.cy);
+    return;
+  }
+  gotoxy(ed);
+  outchr(ed.curline().wwiv_color(), ch);
 }
 
 void FsedView::draw_header() {
   const auto oldcuratr = bout_.curatr();
   bout_.cls();
+  // The whole screen was cleared, so the text needs to be drawn again.
+  screen_.clear();
+  screen_.invalidate(0, screen_.num_rows() - 1);
   const auto to = data_.to_name.empty() ? "All" : data_.to_name;
   bout_.print("|#7From: |#2{}\r\n", data_.from_name);
   bout_.print("|#7To:   |#2{}\r\n", to);
@@ -219,9 +226,13 @@ int FsedView::bgetch(FsedModel& ed) {
 void FsedView::outchr(int color, char ch) {
   bout_.ansic(color);
   bout_.outchr(ch);
+  screen_.put(cursor_row_, cursor_x_++, cell_t{color, ch});
 }
 
-void FsedView::cls() { bout_.cls(); }
+void FsedView::cls() {
+  bout_.cls();
+  screen_.clear();
+}
 
 void FsedView::ansic(int c) { bout_.ansic(c); }
 
@@ -21,6 +21,7 @@
 #include "common/full_screen.h"
 #include "common/message_editor_data.h"
 #include "fsed/model.h"
+#include "fsed/screen.h"
 
 namespace wwiv {
 namespace common {
@@ -44,6 +45,14 @@ public:
   // Updates the editor line number based on the cy and fs view of the 
   // world.
   void handle_editor_invalidate(FsedModel&, editor_range_t t);
+  // Sends the changed cells of all dirty rows to the remote.
+  void flush(const FsedModel& ed);
+  // Flushes and positions the cursor unless more input is waiting, so that
+  // a burst of keys such as a paste is drawn once rather than once per key.
+  void flush_if_idle(const FsedModel& ed);
+  // Echoes a typed character at the cursor, or leaves it for the next flush
+  // if more input is waiting.
+  void echo(const FsedModel& ed, char ch);
   void draw_header();
   void redraw();
   void redraw(const FsedModel& ed);
@@ -70,6 +79,11 @@ private:
   int max_view_columns_;
   common::MessageEditorData& data_;
   bool file_{false};
+  // What the remote terminal is displaying in the editor area.
+  ScreenBuffer screen_;
+  // Last position set by gotoxy, used to track echoed characters.
+  int cursor_x_{0};
+  int cursor_row_{0};
   //  Saved positions for the bottom bar caching.
   int sx{-1};
   int sy{-1};
@@ -24,6 +24,7 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include "core/version.h"
+#include "sdk/latency_histograms.h"
 #include "sdk/net/packets.h"
 #include <filesystem>
 #include <iomanip>
@@ -49,9 +50,18 @@ void AddStandardNetworkArgs(wwiv::core::CommandLine& cmdline) {
       {"semaphore_timeout",
       "Timeout (in seconds) to wait for the network semaphore to become available.",
       "30"});
+  cmdline.add_argument(BooleanCommandLineArgument(
+      "trace", "Record latency histograms of packet handling for wwivd's /metrics"));
   cmdline.add_argument(BooleanCommandLineArgument("help", 'h', "Displays Help", false));
 }
 
+// Returns the name of the network command for the command character
+// e.g. returns "network1" for '1', etc.  If 0 or '\0' then it returns
+// "network".
+static std::string network_cmd_name(char net_cmd) {
+  return (net_cmd == '\0') ? "network" : StrCat("network", net_cmd);
+}
+
 NetworkCommandLine::NetworkCommandLine(wwiv::core::CommandLine& cmdline, char net_cmd)
     : cmdline_(cmdline), net_cmd_(net_cmd) {
   cmdline.set_no_args_allowed(true);
@@ -105,13 +115,9 @@ NetworkCommandLine::NetworkCommandLine(wwiv::core::CommandLine& cmdline, char ne
     std::cerr << cmdline.program_name() << " [" << full_version() << "]"
               << " for network: " << network_name_ << std::endl;
   }
-}
-
-// Returns the name of the network command for the command character
-// e.g. returns "network1" for '1', etc.  If 0 or '\0' then it returns
-// "network".
-static std::string network_cmd_name(char net_cmd) {
-  return (net_cmd == '\0') ? "network" : StrCat("network", net_cmd);
+  if (cmdline.barg("trace")) {
+    sdk::EnableTracing(config_->datadir(), network_cmd_name(net_cmd));
+  }
 }
 
 std::filesystem::path NetworkCommandLine::semaphore_path() const noexcept {
@@ -137,6 +143,7 @@ bool NetworkCommandLine::LoadNetIni(char net_cmd, const std::string& bbsdir) {
   SetNewIntDefault(cmdline_, *ini, "semaphore_timeout");
   SetNewIntDefault(cmdline_, *ini, "v", [](int v) { Logger::set_cmdline_verbosity(v); });
   SetNewBooleanDefault(cmdline_, *ini, "skip_delete");
+  SetNewBooleanDefault(cmdline_, *ini, "trace");
   SetNewStringDefault(cmdline_, *ini, "configdir");
   SetNewStringDefault(cmdline_, *ini, "bindir");
   SetNewStringDefault(cmdline_, *ini, "logdir");
@@ -0,0 +1,79 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "network2/area_cache.h"
+
+#include "core/log.h"
+#include <algorithm>
+
+using namespace wwiv::sdk::msgapi;
+
+namespace wwiv::net::network2 {
+
+MessageAreaCache::MessageAreaCache(int capacity) : capacity_(std::max(1, capacity)) {}
+
+MessageAreaCache::~MessageAreaCache() { flush(); }
+
+MessageArea* MessageAreaCache::get(const std::string& filename) {
+  const auto it = index_.find(filename);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  areas_.splice(areas_.begin(), areas_, it->second);
+  return it->second->second.get();
+}
+
+MessageArea* MessageAreaCache::put(const std::string& filename,
+                                   std::unique_ptr<MessageArea> area) {
+  if (const auto it = index_.find(filename); it != index_.end()) {
+    it->second->second->EndBatch();
+    areas_.erase(it->second);
+    index_.erase(it);
+  }
+  while (size() >= capacity_) {
+    auto& [name, lru] = areas_.back();
+    VLOG(1) << "Closing message area: " << name;
+    if (!lru->EndBatch()) {
+      LOG(ERROR) << "    ! ERROR Failed to update message area: " << name;
+    }
+    index_.erase(name);
+    areas_.pop_back();
+  }
+  if (!area->BeginBatch()) {
+    // Still usable, just without deferring any updates.
+    LOG(WARNING) << "Unable to start a batch on message area: " << filename;
+  }
+  areas_.emplace_front(filename, std::move(area));
+  index_.emplace(filename, areas_.begin());
+  return areas_.front().second.get();
+}
+
+bool MessageAreaCache::flush() {
+  auto result = true;
+  for (auto& [name, area] : areas_) {
+    if (!area->EndBatch()) {
+      LOG(ERROR) << "    ! ERROR Failed to update message area: " << name;
+      result = false;
+    }
+  }
+  index_.clear();
+  areas_.clear();
+  return result;
+}
+
+} // namespace wwiv::net::network2
@@ -0,0 +1,69 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_NETWORK2_AREA_CACHE_H
+#define INCLUDED_NETWORK2_AREA_CACHE_H
+
+#include "sdk/msgapi/message_area.h"
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace wwiv::net::network2 {
+
+/**
+ * Keeps the most recently used message areas open across posts so that a
+ * packet with many posts on the same subs only opens each of them once.
+ *
+ * Areas are batching (see MessageArea::BeginBatch) while they are in the
+ * cache, and EndBatch is called when they are evicted or flushed.
+ */
+class MessageAreaCache final {
+public:
+  explicit MessageAreaCache(int capacity);
+  ~MessageAreaCache();
+
+  /** Returns the open area for the sub named filename, or nullptr. */
+  [[nodiscard]] sdk::msgapi::MessageArea* get(const std::string& filename);
+
+  /**
+   * Adds area to the cache as the sub named filename, evicting the least
+   * recently used area if the cache is full.  Returns the area.
+   */
+  sdk::msgapi::MessageArea* put(const std::string& filename,
+                                std::unique_ptr<sdk::msgapi::MessageArea> area);
+
+  /** Ends the batch on and closes every area, returning false if any failed. */
+  bool flush();
+
+  [[nodiscard]] int size() const noexcept { return static_cast<int>(index_.size()); }
+
+private:
+  using entry_t = std::pair<std::string, std::unique_ptr<sdk::msgapi::MessageArea>>;
+
+  const int capacity_;
+  // Most recently used first.
+  std::list<entry_t> areas_;
+  std::unordered_map<std::string, std::list<entry_t>::iterator> index_;
+};
+
+} // namespace wwiv::net::network2
+
+#endif // INCLUDED_NETWORK2_AREA_CACHE_H
@@ -17,15 +17,44 @@
 /**************************************************************************/
 #include "network2/context.h"
 
+#include "core/strings.h"
+#include "fmt/format.h"
 
 namespace wwiv::net::network2 {
 
 using namespace wwiv::sdk::net;
+using namespace wwiv::strings;
+
+static std::string sub_index_key(int network_number, const std::string& subtype) {
+  return fmt::format("{}.{}", network_number, ToStringUpperCase(subtype));
+}
 
 Context::Context(const sdk::Config& c, const Network& n, sdk::UserManager& u,
                  const std::vector<Network>& ns, NetDat& netdat)
   : config(c), net(n), user_manager(u), subs(c.datadir(), ns), networks_(ns), netdat_(netdat), ssm(c, u) {
   subs_initialized = subs.Load();
+  index_subs();
+}
+
+void Context::index_subs() {
+  sub_index_.clear();
+  auto current = 0;
+  for (const auto& x : subs.subs()) {
+    for (const auto& n : x.nets) {
+      // The first sub carrying a subtype wins.
+      sub_index_.try_emplace(sub_index_key(n.net_num, n.stype), current);
+    }
+    ++current;
+  }
+}
+
+std::optional<sdk::subboard_t> Context::find_sub(int network_number,
+                                                 const std::string& subtype) const {
+  if (const auto it = sub_index_.find(sub_index_key(network_number, subtype));
+      it != sub_index_.end()) {
+    return subs.sub(it->second);
+  }
+  return std::nullopt;
 }
 
 void Context::set_api(int type, std::unique_ptr<sdk::msgapi::MessageApi>&& a) {
@@ -19,6 +19,7 @@
 #define INCLUDED_NETWORK2_CONTEXT_H
 
 #include "net_core/netdat.h"
+#include "network2/area_cache.h"
 #include "sdk/config.h"
 #include "sdk/ssm.h"
 #include "sdk/msgapi/message_api_wwiv.h"
@@ -26,6 +27,9 @@
 #include "sdk/subxtr.h"
 #include "sdk/usermanager.h"
 #include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace wwiv::net::network2 {
@@ -59,6 +63,12 @@ public:
   [[nodiscard]] const std::vector<sdk::net::Network>& networks() const noexcept { return networks_; }
   [[nodiscard]] NetDat& netdat() const { return netdat_; }
 
+  /** Rebuilds the index used by find_sub. Call after changing subs. */
+  void index_subs();
+  /** Returns the sub carrying subtype on network_number, if there is one. */
+  [[nodiscard]] std::optional<sdk::subboard_t> find_sub(int network_number,
+                                                        const std::string& subtype) const;
+
   const sdk::Config& config;
   const sdk::net::Network& net;
   sdk::UserManager& user_manager;
@@ -75,6 +85,12 @@ public:
   sdk::SSM ssm;
   std::unique_ptr<std::vector<external_programs_t>> external_programs;
   std::set<int> external_programs_saved;
+  // Message areas posted to, held open until flushed.
+  MessageAreaCache area_cache{64};
+
+private:
+  // Index into subs by network number and upper case subtype.
+  std::unordered_map<std::string, int> sub_index_;
 };
 
 } // namespace wwiv::net::network2
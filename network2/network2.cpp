@@ -26,6 +26,7 @@
 #include "core/semaphore_file.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/trace.h"
 #include "network2/context.h"
 #include "network2/email.h"
 #include "network2/post.h"
@@ -47,6 +48,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::net;
@@ -63,15 +65,12 @@ static bool posts_changed = false;
 
 static void update_filechange_status_dat(const std::filesystem::path& datadir, bool email, bool posts) {
   StatusMgr sm(datadir);
-  sm.Run([=](Status& s)
-  {
-    if (email) {
-      s.increment_filechanged(Status::file_change_email);
-    }
-    if (posts) {
-      s.increment_filechanged(Status::file_change_posts);
-    }
-  });
+  if (email) {
+    sm.increment_filechanged(Status::file_change_email);
+  }
+  if (posts) {
+    sm.increment_filechanged(Status::file_change_posts);
+  }
 }
 
 static void ShowHelp(const NetworkCommandLine& cmdline) {
@@ -202,8 +201,9 @@ static bool handle_sub_list(Context& context, NetPacket& p) {
 }
 
 static bool handle_packet(Context& context, NetPacket& p) {
-  LOG(INFO) << "Processing message with type: " << main_type_name(p.nh.main_type) << "/"
-            << p.nh.minor_type;
+  const auto type_name = main_type_name(p.nh.main_type);
+  TraceSpan span("network2", type_name);
+  LOG(INFO) << "Processing message with type: " << type_name << "/" << p.nh.minor_type;
 
   switch (p.nh.main_type) {
     /*
@@ -325,14 +325,31 @@ static bool handle_local_net(Context& context) {
   if (!packets) {
     return false;
   }
+  // Posts are not all on disk until the area cache is flushed, so their
+  // packets are only marked deleted after that.
+  std::vector<NetPacket> posts;
   for (auto packet : packets) {
     if (!handle_packet(context, packet)) {
       LOG(ERROR) << "Error handing packet: type: " << packet.nh.main_type;
     } else if (packet.source() == NetPacketSource::DISK) {
-      // Seek to start of packet and mark it deleted.
-      delete_packet(packets.file(), packet);
+      if (packet.nh.main_type == main_type_new_post) {
+        NetPacket p(packet.nh, {}, std::string());
+        p.set_source(NetPacketSource::DISK);
+        p.set_offset(packet.offset());
+        p.set_end_offset(packet.end_offset());
+        posts.emplace_back(std::move(p));
+      } else {
+        // Seek to start of packet and mark it deleted.
+        delete_packet(packets.file(), packet);
+      }
     }
   }
+  if (!context.area_cache.flush()) {
+    LOG(ERROR) << "Error updating message areas.";
+  }
+  for (auto& p : posts) {
+    delete_packet(packets.file(), p);
+  }
   return true;
 }
 
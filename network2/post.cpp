@@ -49,24 +49,6 @@ using namespace wwiv::strings;
 
 namespace wwiv::net::network2 {
 
-static bool find_sub(const Subs& subs, int network_number, const std::string& netname, subboard_t& sub) {
-  auto current = 0;
-  for (const auto& x : subs.subs()) {
-    for (const auto& n : x.nets) {
-      if (n.net_num == network_number) {
-        if (iequals(netname, n.stype)) {
-          // Since the subtype matches, we need to find the subboard base filename.
-          // and return that.
-          sub = subs.sub(current);
-          return true;
-        }
-      }
-    }
-    ++current;
-  }
-  return false;
-}
-
 // Creates a single element vector of the echotag's info from the backbone list
 static std::vector<backbone_t> single_echo_backbone_list(std::vector<backbone_t> backbone,
                                                          std::string echotag) {
@@ -95,6 +77,7 @@ static bool attempt_auto_add(Context& context, const ParsedNetPacketText& ppt) {
   const auto r = ImportSubsFromBackbone(context.subs, context.net,
                                         static_cast<int16_t>(context.network_number), ini, echo);
   if (r.subs_dirty && r.success) {
+    context.index_subs();
     return context.subs.Save();
   } 
   if (!r.success) {
@@ -124,14 +107,15 @@ bool handle_inbound_post(Context& context, NetPacket& p) {
     VLOG(1) << "  Date:    " << ppt.date();
   }
 
-  subboard_t sub;
   const auto can_auto_add =
       context.net.settings.auto_add && context.net.type == network_type_t::ftn;
-  auto found = find_sub(context.subs, context.network_number, ppt.subtype(), sub);
-  if (!found && can_auto_add) {
+  auto o = context.find_sub(context.network_number, ppt.subtype());
+  if (!o && can_auto_add) {
     LOG(INFO) << "      Attempting to auto add area: " << ppt.subtype();
-    found = attempt_auto_add(context, ppt);
-    if (found) {
+    if (attempt_auto_add(context, ppt)) {
+      o = context.find_sub(context.network_number, ppt.subtype());
+    }
+    if (o) {
       // Log that we added this both in log file and netdat.
       const auto msg = fmt::format("Auto added sub for type: '{}'", ppt.subtype());
       LOG(INFO) << "      " << msg;
@@ -139,15 +123,17 @@ bool handle_inbound_post(Context& context, NetPacket& p) {
     }
   }
 
-  if (!found) {
+  if (!o) {
     LOG(INFO) << "    ! ERROR: Unable to find message of subtype: " << ppt.subtype();
     LOG(INFO) << "      title: " << ppt.title() << "; writing to dead.net.";
     const auto msg = fmt::format("Unable to find message of subtype: '{}'; writing to dead.net", ppt.subtype());
     context.netdat().add_message(NetDat::netdat_msgtype_t::error, msg);
     return write_deadnet_packet(context.net.dir, p);
   }
+  const auto& sub = o.value();
 
-  if (!context.api(sub.storage_type).Exist(sub)) {
+  auto* area = context.area_cache.get(sub.filename);
+  if (!area && !context.api(sub.storage_type).Exist(sub)) {
     // Since the area does not exist, let's create it automatically like WWIV always does.
     const auto created = context.api(sub.storage_type).Create(sub, -1);
     if (!created) {
@@ -159,13 +145,16 @@ bool handle_inbound_post(Context& context, NetPacket& p) {
     }
   }
 
-  std::unique_ptr<MessageArea> area(context.api(sub.storage_type).Open(sub, -1));
   if (!area) {
-    const auto msg = fmt::format("Failed to open message area: '{}'; writing to dead.net", sub.filename);
-    context.netdat().add_message(NetDat::netdat_msgtype_t::error, msg);
-    LOG(INFO) << "    ! ERROR Unable to open message area: '" << sub.filename
-              << "'; writing to dead.net.";
-    return write_deadnet_packet(context.net.dir, p);
+    auto opened = context.api(sub.storage_type).Open(sub, -1);
+    if (!opened) {
+      const auto msg = fmt::format("Failed to open message area: '{}'; writing to dead.net", sub.filename);
+      context.netdat().add_message(NetDat::netdat_msgtype_t::error, msg);
+      LOG(INFO) << "    ! ERROR Unable to open message area: '" << sub.filename
+                << "'; writing to dead.net.";
+      return write_deadnet_packet(context.net.dir, p);
+    }
+    area = context.area_cache.put(sub.filename, std::move(opened));
   }
 
   if (area->Exists(p.nh.daten, ppt.title(), p.nh.fromsys, p.nh.fromuser)) {
@@ -232,14 +221,15 @@ bool send_post_to_subscribers(Context& context, NetPacket& template_packet,
     return false;
   }
 
-  subboard_t sub;
-  if (!find_sub(context.subs, context.network_number, original_subtype, sub)) {
+  const auto o = context.find_sub(context.network_number, original_subtype);
+  if (!o) {
     const auto msg = fmt::format("Unable to find message of subtype: '{}'; writing to dead.net", original_subtype);
     context.netdat().add_message(NetDat::netdat_msgtype_t::error, msg);
     LOG(INFO) << msg;
     NetPacket p(template_packet.nh, {}, template_packet.text());
     return write_deadnet_packet(context.net.dir, p);
   }
+  const auto& sub = o.value();
   VLOG(1) << "DEBUG: Found sub: " << sub.name;
 
   return send_post_to_subscribers(context.networks(), context.network_number, original_subtype, sub,
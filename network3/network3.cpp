@@ -314,27 +314,29 @@ static int write_bbsdata_files(const std::vector<net_system_list_rec>& bbsdata_d
     bbsdata_net_file.WriteVector(bbsdata_data);
    }
   update_timestamps(dir);
+  // Both index files are derived from the routes already computed for
+  // bbsdata.net, so build them together in a single pass.
   auto num_reachable = 0;
+  std::vector<uint16_t> bbsdata_ind_data;
+  std::vector<uint16_t> bbsdata_rou_data;
+  bbsdata_ind_data.reserve(bbsdata_data.size());
+  bbsdata_rou_data.reserve(bbsdata_data.size());
+  for (const auto& n : bbsdata_data) {
+    const auto is_reachable = n.forsys != WWIVNET_NO_NODE;
+    if (is_reachable) {
+      ++num_reachable;
+    }
+    bbsdata_ind_data.push_back(is_reachable ? n.sysnum : 0);
+    bbsdata_rou_data.push_back(n.forsys);
+  }
   {
     LOG(INFO) << "Writing bbsdata.ind...";
-    std::vector<uint16_t> bbsdata_ind_data;
-    for (const auto& n : bbsdata_data) {
-      const auto is_reachable = n.forsys != WWIVNET_NO_NODE;
-      if (is_reachable) {
-        ++num_reachable;
-      }
-      bbsdata_ind_data.push_back(is_reachable ? n.sysnum : 0);
-    }
     DataFile<uint16_t> bbsdata_ind_file(FilePath(dir, BBSDATA_IND), File::modeBinary |
                                         File::modeReadWrite | File::modeCreateFile);
     bbsdata_ind_file.WriteVector(bbsdata_ind_data);
   }
   {
     LOG(INFO) << "Writing bbsdata.rou...";
-    std::vector<uint16_t> bbsdata_rou_data;
-    for (const auto& n : bbsdata_data) {
-      bbsdata_rou_data.push_back(n.forsys);
-    }
     DataFile<uint16_t> bbsdata_rou_file(FilePath(dir, BBSDATA_ROU), File::modeBinary |
                                                                             File::modeReadWrite |
                                                                             File::modeCreateFile);
@@ -63,6 +63,8 @@ static void RegisterNetworkBCommands(CommandLine& cmdline) {
   cmdline.add_argument({"port", "Port number to use (receiving only)", "24554"});
   cmdline.add_argument(BooleanCommandLineArgument(
       "daemon", "Run continually as a daemon until stopped  (only used when receiving)", true));
+  cmdline.add_argument(BooleanCommandLineArgument(
+      "compress", "Compress data when the remote supports it (OPT PLZ)", true));
 }
 
 static void ShowHelp(const NetworkCommandLine& cmdline) {
@@ -102,7 +104,8 @@ static bool Receive(const CommandLine& cmdline, BinkConfig& bink_config, int por
       BinkP::received_transfer_file_factory_t factory = [&](const std::string& network_name,
                                                             const std::string& filename) {
         const auto dir = bink_config.receive_dir(network_name);
-        return new WFileTransferFile(filename, std::make_unique<File>(FilePath(dir, filename)));
+        return new WFileTransferFile(filename, std::make_unique<File>(FilePath(dir, filename)),
+                                     bink_config.partial_dir(network_name));
       };
       BinkP binkp(c.get(), &bink_config, side, "0", factory);
       binkp.Run(cmdline);
@@ -149,7 +152,8 @@ static bool Send(const CommandLine& cmdline, BinkConfig& bink_config, const std:
   const auto& net = bink_config.networks()[network_name];
   BinkP::received_transfer_file_factory_t factory = [&](const std::string&, const std::string& filename) {
     const auto dir = bink_config.receive_dir(network_name);
-    return new WFileTransferFile(filename, std::make_unique<File>(FilePath(dir, filename)));
+    return new WFileTransferFile(filename, std::make_unique<File>(FilePath(dir, filename)),
+                                 bink_config.partial_dir(network_name));
   };
 
   std::string sendto_ftn_node;
@@ -181,6 +185,7 @@ static int Main(const NetworkCommandLine& net_cmdline) {
     BinkConfig bink_config(network_name, net_cmdline.config(), net_cmdline.networks());
 
     bink_config.set_skip_net(skip_net);
+    bink_config.set_compress(net_cmdline.cmdline().barg("compress"));
     bink_config.set_verbose(net_cmdline.cmdline().verbose());
     bink_config.set_network_version(status->status_net_version());
 
@@ -43,6 +43,7 @@
 #include "sdk/net/ftn_msgdupe.h"
 #include "sdk/net/packets.h"
 #include "sdk/net/subscribers.h"
+#include <chrono>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
@@ -100,10 +101,12 @@ void ShowNetworkfHelp(const NetworkCommandLine& cmdline) {
 }
 
 static std::string get_echomail_areaname(const std::string& text) {
-  auto lines = split_message(text);
-  for (const auto& line : lines) {
+  std::string buffer;
+  std::vector<std::string_view> lines;
+  split_message(text, &buffer, &lines);
+  for (const auto line : lines) {
     if (starts_with(line, "AREA:")) {
-      return line.substr(5);
+      return std::string(line.substr(5));
     }
   }
   return "";
@@ -166,26 +169,27 @@ bool NetworkF::import_packet_file(const std::filesystem::path& path) {
   }
 
   while (true) {
-    auto [response, msg] = packet.Read();
+    // Parse each message in place and only copy the ones that will be imported.
+    auto [response, view] = packet.ReadView();
     if (response != ReadNetPacketResponse::OK) {
       return true;
     }
 
-    const auto is_email = (msg.nh.attribute & MSGPRIVATE) != 0;
+    const auto is_email = (view.nh.attribute & MSGPRIVATE) != 0;
     if (!is_email) {
 
       // Only check age for echomail, not email
       const auto max_days = net().fido.max_echomail_age_days;
       if (!is_email && max_days > 0) {
         // Only check if max_days > 0, otherwise 0 means unlimited.
-        const auto days_old = ftn_date_days_old(clock_, msg.vh.date_time);
+        const auto days_old = ftn_date_days_old(clock_, std::string(view.date_time));
         if (days_old > max_days) {
           // Packet is too old, skip it.
-          const auto msgid = FtnMessageDupe::GetMessageIDFromText(msg.vh.text);
+          const auto msgid = FtnMessageDupe::GetMessageIDFromText(view.text);
           const auto logmsg = fmt::format("Too old FTN message ({} days): msgid:{}; '{}'", days_old,
-            msgid, msg.vh.subject);
+            msgid, view.subject);
           LOG(ERROR) << logmsg;
-          LOG(ERROR) << "Text: " << msg.vh.text;
+          LOG(ERROR) << "Text: " << view.text;
           // TODO(rushfan): move this or write out saved copy?
           continue;
         }
@@ -194,17 +198,21 @@ bool NetworkF::import_packet_file(const std::filesystem::path& path) {
 
       // Don't check for dupes in emails since we certainly won't have a MSGID and also
       // likely the header may match for automated responses split over multiple messages (#1395)
-      if (dupe().is_dupe(msg)) {
-        const auto msgid = FtnMessageDupe::GetMessageIDFromText(msg.vh.text);
-        LOG(ERROR) << "Skipping duplicate FTN message: '" << msg.vh.subject << "' msgid: (" << msgid
+      uint32_t header_crc32 = 0;
+      uint32_t msgid_crc32 = 0;
+      FtnMessageDupe::GetMessageCrc32s(view, header_crc32, msgid_crc32);
+      if (dupe().is_dupe(header_crc32, msgid_crc32)) {
+        const auto msgid = FtnMessageDupe::GetMessageIDFromText(view.text);
+        LOG(ERROR) << "Skipping duplicate FTN message: '" << view.subject << "' msgid: (" << msgid
                    << ")";
-        LOG(ERROR) << "Text: " << msg.vh.text;
+        LOG(ERROR) << "Text: " << view.text;
         // TODO(rushfan): move this or write out saved copy?
         continue;
       }
-      dupe().add(msg);
+      dupe().add(header_crc32, msgid_crc32);
     }
 
+    const auto msg = to_packed_message(view);
     const auto ftn_packet_daten = fido_to_daten(msg.vh.date_time);
     net_header_rec nh{};
     nh.daten = static_cast<uint32_t>(ftn_packet_daten);
@@ -379,8 +387,9 @@ static std::string rename_fido_packet(const std::filesystem::path& dir, const st
   return origname;
 }
 
-std::optional<std::string> NetworkF::create_ftn_bundle(const FidoAddress& route_to,
-                                                       const std::string& fido_packet_name) {
+std::optional<std::vector<std::string>>
+NetworkF::create_ftn_bundle(const FidoAddress& route_to,
+                            const std::vector<std::string>& fido_packet_names) {
   // were in the temp dir now.
   auto arcs = files::read_arcs(datadir_);
   if (arcs.empty()) {
@@ -397,20 +406,23 @@ std::optional<std::string> NetworkF::create_ftn_bundle(const FidoAddress& route_
 
   if (ctype == "PKT") {
     // No bundles, only packet files.
-    const auto in = FilePath(dirs_.temp_outbound_dir(), fido_packet_name);
-    auto out = FilePath(dirs_.outbound_dir(), fido_packet_name);
-    if (File::Exists(out)) {
-      LOG(INFO) << "Outbound dir already has a packet named: " << fido_packet_name;
-      const auto newname = rename_fido_packet(dirs_.outbound_dir(), fido_packet_name);
-      LOG(INFO) << "Renamed to: " << newname;
-      out = FilePath(dirs_.outbound_dir(), newname);
-    }
-    if (!File::Move(in, out)) {
-      LOG(ERROR) << "Unable to move packet file into outbound dir. file: " << fido_packet_name;
-      return std::nullopt;
+    std::vector<std::string> names;
+    for (const auto& fido_packet_name : fido_packet_names) {
+      const auto in = FilePath(dirs_.temp_outbound_dir(), fido_packet_name);
+      auto name = fido_packet_name;
+      if (File::Exists(FilePath(dirs_.outbound_dir(), name))) {
+        LOG(INFO) << "Outbound dir already has a packet named: " << fido_packet_name;
+        name = rename_fido_packet(dirs_.outbound_dir(), fido_packet_name);
+        LOG(INFO) << "Renamed to: " << name;
+      }
+      if (!File::Move(in, FilePath(dirs_.outbound_dir(), name))) {
+        LOG(ERROR) << "Unable to move packet file into outbound dir. file: " << fido_packet_name;
+        return std::nullopt;
+      }
+      LOG(INFO) << "Created bundle(packet): " << FilePath(dirs_.outbound_dir(), name);
+      names.push_back(name);
     }
-    LOG(INFO) << "Created bundle(packet): " << FilePath(dirs_.outbound_dir(), fido_packet_name);
-    return fido_packet_name;
+    return names;
   }
 
   FidoAddress orig(net_.fido.fido_address);
@@ -432,7 +444,9 @@ std::optional<std::string> NetworkF::create_ftn_bundle(const FidoAddress& route_
                    << "'";
       continue;
     }
-    const auto zip_cmd = arc_stuff_in(arc->arca, full_bundle_path.string(), fido_packet_name);
+    // All of the packets are added by a single run of the archiver.
+    const auto zip_cmd =
+        arc_stuff_in(arc->arca, full_bundle_path.string(), JoinStrings(fido_packet_names, " "));
     LOG(INFO) << "Command: " << zip_cmd;
     if (0 != system(zip_cmd.c_str())) {
       LOG(ERROR) << "Failed executing: " << zip_cmd;
@@ -443,11 +457,13 @@ std::optional<std::string> NetworkF::create_ftn_bundle(const FidoAddress& route_
     File::set_current_directory(saved_dir);
 
     LOG(INFO) << "Created bundle: " << full_bundle_path.string();
-    if (!File::Remove(FilePath(dirs_.temp_outbound_dir(), fido_packet_name))) {
-      LOG(ERROR) << "Error removing packet: "
-                 << FilePath(dirs_.temp_outbound_dir(), fido_packet_name);
+    for (const auto& fido_packet_name : fido_packet_names) {
+      if (!File::Remove(FilePath(dirs_.temp_outbound_dir(), fido_packet_name))) {
+        LOG(ERROR) << "Error removing packet: "
+                   << FilePath(dirs_.temp_outbound_dir(), fido_packet_name);
+      }
     }
-    return bname;
+    return std::vector<std::string>{bname};
   }
   return std::nullopt;
 }
@@ -463,7 +479,8 @@ static bool CleanupWWIVName(std::string& sender_name) {
 }
 
 template <typename C, typename I>
-static std::string get_control_line(const C& c, I& iter, std::set<char> stop, std::size_t max) {
+static std::string get_control_line(const C& c, I& iter, std::initializer_list<char> stop,
+                                    std::size_t max) {
   // No need to continue if we're already at the end.
   if (iter == c.end()) {
     return "";
@@ -476,7 +493,8 @@ static std::string get_control_line(const C& c, I& iter, std::set<char> stop, st
 }
 
 template <typename C, typename I>
-static std::string get_fido_addr(const C& c, I& iter, std::set<char> stop, std::size_t max) {
+static std::string get_fido_addr(const C& c, I& iter, std::initializer_list<char> stop,
+                                 std::size_t max) {
   static const std::string kFidoAddr = "\x04"
                                        "0FidoAddr: ";
   std::string address;
@@ -530,205 +548,241 @@ static std::string remove_fido_addr(std::string to_user) {
   return to_user_new;
 }
 
-std::optional<std::string> NetworkF::create_ftn_packet(const FidoAddress& dest,
-                                                       const FidoAddress& route_to,
-                                                       const NetPacket& wwivnet_packet) {
-
-  VLOG(1) << "create_ftn_packet: dest: " << dest << "; route: " << route_to;
-
-  FidoAddress from_address(net_.fido.fido_address);
-  std::string pw = fido_callout_.packet_config_for(route_to).packet_password;
-  for (auto tries = 0; tries < 10; tries++) {
-    auto now = clock_.Now().now();
-    File file(FilePath(dirs_.temp_outbound_dir(), packet_name(now)));
-    if (!file.Open(File::modeCreateFile | File::modeExclusive | File::modeReadWrite |
-                       File::modeBinary,
-                   File::shareDenyReadWrite)) {
-      LOG(INFO) << "Will try again: Unable to create packet file: " << file;
-      clock_.SleepFor(std::chrono::seconds(1));
-      continue;
-    }
+std::optional<FidoPackedMessage> NetworkF::create_packed_message(const FidoAddress& dest,
+                                                                const NetPacket& wwivnet_packet) {
+  VLOG(1) << "create_packed_message: dest: " << dest;
 
-    auto header = CreateType2PlusPacketHeader(from_address, route_to, now, pw);
+  const FidoAddress from_address(net_.fido.fido_address);
+  auto is_email = wwivnet_packet.nh.main_type == main_type_email ||
+                  wwivnet_packet.nh.main_type == main_type_email_name;
+  const auto raw_text = wwivnet_packet.text();
+  auto iter = raw_text.cbegin();
 
-    if (!write_fido_packet_header(file, header)) {
-      LOG(ERROR) << "Error writing packet header.";
-      return std::nullopt;
-    }
+  std::string subtype;
+  std::string to_user_name;
+  // or we can put code in for email here??
 
-    auto is_email = wwivnet_packet.nh.main_type == main_type_email ||
-                    wwivnet_packet.nh.main_type == main_type_email_name;
-    const auto raw_text = wwivnet_packet.text();
-    auto iter = raw_text.cbegin();
+  if (is_email) {
+    to_user_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+    CleanupWWIVName(to_user_name);
+  } else {
+    subtype = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  }
+  auto title = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  auto sender_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  auto date_string = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+
+  // TODO(rushfan: These next 2 here should be done differently. We should
+  // split the message here and look for these in all lines.  For the By:
+  // line we just want to remove it since it's useless.
+  if (!is_email) {
+    to_user_name = get_fido_addr(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  }
 
-    std::string subtype;
-    std::string to_user_name;
-    // or we can put code in for email here??
+  if (!is_email && iter_starts_with(raw_text, iter, "BY: ")) {
+    // Skip BY line.
+    get_message_field(raw_text, iter, {'\r', '\n'}, 80);
+  }
 
-    if (is_email) {
-      to_user_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-      CleanupWWIVName(to_user_name);
-    } else {
-      subtype = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-    }
-    auto title = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-    auto sender_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-    auto date_string = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  fido_variable_length_header_t vh{};
+  vh.date_time = daten_to_fido(wwivnet_packet.nh.daten);
+  // Clean up sender name.
+  CleanupWWIVName(sender_name);
+  vh.from_user_name = sender_name;
+  vh.subject = title;
+  if (!to_user_name.empty()) {
+    const auto username_only = remove_fido_addr(to_user_name);
+    vh.to_user_name = properize(username_only);
+  } else {
+    vh.to_user_name = "All";
+  }
 
-    // TODO(rushfan: These next 2 here should be done differently. We should
-    // split the message here and look for these in all lines.  For the By:
-    // line we just want to remove it since it's useless.
-    if (!is_email) {
-      to_user_name = get_fido_addr(raw_text, iter, {'\0', '\r', '\n'}, 80);
-    }
+  auto msgid = FtnMessageDupe::GetMessageIDFromWWIVText(raw_text);
+  auto needs_msgid = false;
+  if (msgid.empty()) {
+    // Create a new MSGID if the BBS didn't put one in there already.
+    // We'll do this for emails too since Mystic needs this for a proper
+    // reply to address. Otherwise we'd just do it for conference mail.
+    msgid = dupe().CreateMessageID(from_address);
+    needs_msgid = true;
+  }
 
-    if (!is_email && iter_starts_with(raw_text, iter, "BY: ")) {
-      // Skip BY line.
-      get_message_field(raw_text, iter, {'\r', '\n'}, 80);
+  // TODO(rushfan): need to add in INTL for netmails, and all that nonsense.
+  // We probably have other stuff we need to add for echomail too.
+  std::ostringstream text;
+  if (is_email) {
+    text << "\001"
+         << "INTL " << dest.as_string(false, false) << " "
+         << from_address.as_string(false, false) << "\r";
+    if (from_address.point()) {
+      // FMPT (FROM POINT) just has the point address
+      text << "\001" << "FMPT " << from_address.point() << "\r";
     }
-
-    fido_variable_length_header_t vh{};
-    vh.date_time = daten_to_fido(wwivnet_packet.nh.daten);
-    // Clean up sender name.
-    CleanupWWIVName(sender_name);
-    vh.from_user_name = sender_name;
-    vh.subject = title;
-    if (!to_user_name.empty()) {
-      const auto username_only = remove_fido_addr(to_user_name);
-      vh.to_user_name = properize(username_only);
-    } else {
-      vh.to_user_name = "All";
+    if (dest.point()) {
+      // TOPT (TO POINT) just has the point address
+      text << "\001" << "TOPT " << dest.point() << "\r";
     }
+  } else {
+    text << "AREA:" << subtype << "\r";
+  }
+  // As of 5.3, the PID is added by the BBS software.
+  // text << "\001PID: WWIV " << full_version() << "\r";
+  text << "\001TID: WWIV NET" << full_version() << "\r";
+  if (needs_msgid && !is_email) {
+    text << "\001MSGID: " << msgid << "\r";
+  }
+  // Implement FTS-5003. [http://ftsc.org/docs/fts-5003.001]
+  // All outbound WWIV messages are always CP437.
+  text << "\001CHRS: CP437 2\r";
+
+  // Implement FRL-1004. [http://ftsc.org/docs/frl-1004.002]
+  text << "\001TZUTC: " << tz_offset_from_utc(clock_.Now()) << "\r";
+
+  // TODO(rushfan): We should rip through the bbs_text here.
+  // and add in any special kludges like ^AREPLY here.
+  // Add the text from the message (as entered from the BBS).
+  wwiv_to_fido_options opts{};
+  opts.colors = colors_;
+  opts.wwiv_heart_color_codes = net_.fido.wwiv_heart_color_codes;
+  opts.wwiv_pipe_color_codes = net_.fido.wwiv_pipe_color_codes;
+  opts.allow_any_pipe_codes = net_.fido.allow_any_pipe_codes;
+  auto bbs_text = WWIVToFidoText(std::string(iter, raw_text.end()), opts);
+  text << bbs_text;
+
+  // Now we need tear + origin lines
+  auto origin_line = net_.fido.origin_line;
+  if (origin_line.empty()) {
+    // default origin line to system name if it doesn't exist.
+    origin_line = opts_.system_name;
+  }
 
-    FtnMessageDupe dupe(datadir_, true);
-    auto msgid = FtnMessageDupe::GetMessageIDFromWWIVText(raw_text);
-    auto needs_msgid = false;
-    if (msgid.empty()) {
-      // Create a new MSGID if the BBS didn't put one in there already.
-      // We'll do this for emails too since Mystic needs this for a proper
-      // reply to address. Otherwise we'd just do it for conference mail.
-      msgid = dupe.CreateMessageID(from_address);
-      needs_msgid = true;
-    }
+  if (from_address.point() == 0) {
+    text << "\r"
+         << "--- WWIV " << full_version() << "[" << os_version_string() << "]\r"
+         << " * Origin: " << origin_line << " (" << to_zone_net_node(from_address) << ")\r";
+  } else {
+    text << "\r"
+         << "--- WWIV " << full_version() << "\r"
+         << " * Origin: " << origin_line << " (" << to_zone_net_node_point(from_address) << ")\r";
+  }
+  // Finally we need SEEN-BY and PATH lines for routing.
+  if (!is_email) {
+    // TODO(rushfan): Add the nodes we are exporting this to.
+    text << "SEEN-BY: " << to_net_node(from_address) << "\r\r";
+    // Also we need to add a ^APATH: line here, starting with us.
+  }
 
-    // TODO(rushfan): need to add in INTL for netmails, and all that nonsense.
-    // We probably have other stuff we need to add for echomail too.
-    std::ostringstream text;
-    if (is_email) {
-      text << "\001"
-           << "INTL " << dest.as_string(false, false) << " "
-           << from_address.as_string(false, false) << "\r";
-      if (from_address.point()) {
-        // FMPT (FROM POINT) just has the point address
-        text << "\001" << "FMPT " << from_address.point() << "\r";
-      }
-      if (dest.point()) {
-        // TOPT (TO POINT) just has the point address
-        text << "\001" << "TOPT " << dest.point() << "\r";
-      }
-    } else {
-      text << "AREA:" << subtype << "\r";
-    }
-    // As of 5.3, the PID is added by the BBS software.
-    // text << "\001PID: WWIV " << full_version() << "\r";
-    text << "\001TID: WWIV NET" << full_version() << "\r";
-    if (needs_msgid && !is_email) {
-      text << "\001MSGID: " << msgid << "\r";
-    }
-    // Implement FTS-5003. [http://ftsc.org/docs/fts-5003.001]
-    // All outbound WWIV messages are always CP437.
-    text << "\001CHRS: CP437 2\r";
-
-    // Implement FRL-1004. [http://ftsc.org/docs/frl-1004.002]
-    text << "\001TZUTC: " << tz_offset_from_utc(clock_.Now()) << "\r";
-
-    // TODO(rushfan): We should rip through the bbs_text here.
-    // and add in any special kludges like ^AREPLY here.
-    // Add the text from the message (as entered from the BBS).
-    wwiv_to_fido_options opts{};
-    opts.colors = colors_;
-    opts.wwiv_heart_color_codes = net_.fido.wwiv_heart_color_codes;
-    opts.wwiv_pipe_color_codes = net_.fido.wwiv_pipe_color_codes;
-    opts.allow_any_pipe_codes = net_.fido.allow_any_pipe_codes;
-    auto bbs_text = WWIVToFidoText(std::string(iter, raw_text.end()), opts);
-    text << bbs_text;
-
-    // Now we need tear + origin lines
-    auto origin_line = net_.fido.origin_line;
-    if (origin_line.empty()) {
-      // default origin line to system name if it doesn't exist.
-      origin_line = opts_.system_name;
-    }
+  vh.text = text.str();
 
-    if (from_address.point() == 0) {
-      text << "\r"
-           << "--- WWIV " << full_version() << "[" << os_version_string() << "]\r"
-           << " * Origin: " << origin_line << " (" << to_zone_net_node(from_address) << ")\r";
-    } else {
-      text << "\r"
-           << "--- WWIV " << full_version() << "\r"
-           << " * Origin: " << origin_line << " (" << to_zone_net_node_point(from_address) << ")\r";
-    }
-    // Finally we need SEEN-BY and PATH lines for routing.
-    if (!is_email) {
-      // TODO(rushfan): Add the nodes we are exporting this to.
-      text << "SEEN-BY: " << to_net_node(from_address) << "\r\r";
-      // Also we need to add a ^APATH: line here, starting with us.
-    }
+  fido_packed_message_t nh{};
+  nh.message_type = 2;
+  nh.attribute = 0;
+  nh.cost = 0;
+  nh.orig_net = from_address.net();
+  nh.orig_node = from_address.node();
+  nh.dest_net = dest.net();
+  nh.dest_node = dest.node();
+  nh.attribute = MSGLOCAL;
 
-    vh.text = text.str();
+  if (wwivnet_packet.nh.main_type == main_type_email_name) {
+    nh.attribute |= MSGPRIVATE;
+  }
 
-    fido_packed_message_t nh{};
-    nh.message_type = 2;
-    nh.attribute = 0;
-    nh.cost = 0;
-    nh.orig_net = from_address.net();
-    nh.orig_node = from_address.node();
-    nh.dest_net = dest.net();
-    nh.dest_node = dest.node();
-    nh.attribute = MSGLOCAL;
+  return FidoPackedMessage(nh, vh);
+}
 
-    if (wwivnet_packet.nh.main_type == main_type_email_name) {
-      nh.attribute |= MSGPRIVATE;
-    }
+static std::string next_packet_name(ftn_export_t& ex, const DateTime& now) {
+  if (ex.next_packet_number == 0) {
+    ex.next_packet_number = static_cast<uint32_t>(now.to_time_t());
+  }
+  return fmt::format("{:08x}.pkt", ex.next_packet_number++);
+}
 
-    FidoPackedMessage p(nh, vh);
-    if (!write_packed_message(file, p)) {
-      LOG(ERROR) << "Error writing packed message.";
-      return std::nullopt;
-    }
+bool NetworkF::write_to_route(ftn_export_t& ex, const FidoAddress& route_to,
+                              const FidoPackedMessage& msg) {
+  auto it = ex.routes.find(route_to);
+  if (it == std::end(ex.routes)) {
+    ftn_route_t r{};
+    r.route_to = route_to;
+    r.packet_config = fido_callout_.packet_config_for(route_to);
+    it = ex.routes.emplace(route_to, std::move(r)).first;
+  }
+  auto& route = it->second;
 
-    // Since we wrote the packed message, let's add it to the
-    // duplicate message database if it's a post.
-    if (!is_email) {
-      dupe.add(p);
+  const auto size = packed_message_size(msg);
+  if (const auto max_size = route.packet_config.max_packet_size;
+      route.packet && max_size > 0 && route.packet_size + size > max_size) {
+    close_route_packet(route);
+  }
+  if (!route.packet) {
+    const FidoAddress from_address(net_.fido.fido_address);
+    const auto now = clock_.Now();
+    const auto header = CreateType2PlusPacketHeader(from_address, route_to, now,
+                                                    route.packet_config.packet_password);
+    for (auto tries = 0; tries < 1000 && !route.packet; tries++) {
+      const auto path = FilePath(dirs_.temp_outbound_dir(), next_packet_name(ex, now));
+      if (auto o = FidoPacket::Create(path, header)) {
+        route.packet.emplace(std::move(o.value()));
+      }
+    }
+    if (!route.packet) {
+      LOG(ERROR) << "Unable to create packet in: " << dirs_.temp_outbound_dir();
+      return false;
     }
-    return file.path().filename().string();
+    VLOG(1) << "Created packet: " << route.packet->path() << " for route_to: " << route_to;
+    route.packet_size = 0;
+    ++ex.num_packets;
   }
-  return std::nullopt;
+  if (!route.packet->Write(msg)) {
+    LOG(ERROR) << "Error writing packed message to: " << route.packet->path();
+    return false;
+  }
+  route.packet_size += size;
+  return true;
 }
 
-std::optional<std::string> NetworkF::create_ftn_packet_and_bundle(const FidoAddress& dest,
-                                                                  const FidoAddress& route_to,
-                                                                  NetPacket& p) {
-  LOG(INFO) << "Creating packet for subscriber: " << dest << "; route_to: " << route_to;
-  // TODO(rushfan): Really this shouldn't go to dead.net since the wwivnet side exported it
-  // already, not really sure what to do here.
-  auto fido_packet_name = create_ftn_packet(dest, route_to, p);
-  if (!fido_packet_name) {
-    LOG(ERROR) << "    ! ERROR Failed to create FTN packet; writing to dead.net";
-    write_deadnet_packet(net_.dir, p);
-    return std::nullopt;
+void NetworkF::close_route_packet(ftn_route_t& route) {
+  if (!route.packet) {
+    return;
   }
-  LOG(INFO) << "Created packet: " << FilePath(dirs_.temp_outbound_dir(), fido_packet_name.value());
+  route.packet->Close();
+  route.packet_names.push_back(route.packet->path().filename().string());
+  route.packet.reset();
+  route.packet_size = 0;
+}
 
-  const auto bundlename = create_ftn_bundle(route_to, fido_packet_name.value());
-  if (!bundlename) {
-    LOG(ERROR) << "    ! ERROR Failed to create FTN bundle; writing to dead.net";
-    write_deadnet_packet(net_.dir, p);
-    return std::nullopt;
+void NetworkF::finish_export(ftn_export_t& ex) {
+  for (auto& [route_to, route] : ex.routes) {
+    close_route_packet(route);
+
+    // Bundles hold at most max_archive_size bytes of packets, but always at
+    // least one packet.
+    const auto max_size = route.packet_config.max_archive_size;
+    std::vector<std::vector<std::string>> bundles;
+    File::size_type bundle_size = 0;
+    for (const auto& name : route.packet_names) {
+      const auto size = File(FilePath(dirs_.temp_outbound_dir(), name)).length();
+      if (bundles.empty() || (max_size > 0 && bundle_size + size > max_size)) {
+        bundles.emplace_back();
+        bundle_size = 0;
+      }
+      bundles.back().push_back(name);
+      bundle_size += size;
+    }
+
+    for (const auto& packets : bundles) {
+      const auto names = create_ftn_bundle(route_to, packets);
+      if (!names) {
+        LOG(ERROR) << "    ! ERROR Failed to create FTN bundle for: " << route_to
+                   << "; leaving packets in: " << dirs_.temp_outbound_dir();
+        continue;
+      }
+      for (const auto& name : names.value()) {
+        ++ex.num_bundles;
+        CreateNetmailAttachOrFloFile(route_to, name, route.packet_config);
+      }
+    }
   }
-  return bundlename;
 }
 
 static std::string NextNetmailFilePath(const std::filesystem::path& path) {
@@ -889,34 +943,51 @@ static FidoAddress find_route_to(const FidoAddress& dest, const FidoCallout& cal
   return dest;
 }
 
-bool NetworkF::export_main_type_new_post(std::set<std::string>& bundles, NetPacket& p) {
-  // Lame implementation that creates 1 file per message.
-  auto subtype = get_subtype_from_packet_text(p.text());
-  LOG(INFO) << "Creating packet for subtype: " << subtype;
+bool NetworkF::export_main_type_new_post(ftn_export_t& ex, NetPacket& p) {
+  const auto subtype = get_subtype_from_packet_text(p.text());
+  VLOG(1) << "Exporting post on subtype: " << subtype;
 
-  auto subscribers = ReadFidoSubcriberFile(FilePath(net_.dir, StrCat("n", subtype, ".net")));
+  auto it = ex.subscribers.find(subtype);
+  if (it == std::end(ex.subscribers)) {
+    const auto fn = FilePath(net_.dir, StrCat("n", subtype, ".net"));
+    it = ex.subscribers.emplace(subtype, ReadFidoSubcriberFile(fn)).first;
+  }
+  const auto& subscribers = it->second;
   if (subscribers.empty()) {
     LOG(INFO) << "There are no subscribers on echo: '" << subtype << "'. Nothing to do!";
+    return true;
   }
+
+  auto msg = create_packed_message(*std::begin(subscribers), p);
+  if (!msg) {
+    LOG(ERROR) << "    ! ERROR Failed to create FTN message; writing to dead.net";
+    write_deadnet_packet(net_.dir, p);
+    return false;
+  }
+  auto ok = true;
   for (const auto& sub : subscribers) {
     const auto packet_config = fido_callout_.packet_config_for(sub);
     const auto route_to = find_route_to(sub, fido_callout_, packet_config);
-    if (auto bundlename = create_ftn_packet_and_bundle(sub, route_to, p)) {
-      if (!contains(bundles, bundlename.value())) {
-        // We only want to attach the bundle (or add it to the flo file)
-        // one time, so skip ones that have already been done.
-        bundles.insert(bundlename.value());
-        auto route_packet_config = fido_callout_.packet_config_for(route_to);
-        CreateNetmailAttachOrFloFile(route_to, bundlename.value(), route_packet_config);
-      }
+    VLOG(2) << "Adding message for subscriber: " << sub << "; route_to: " << route_to;
+    msg->nh.dest_net = sub.net();
+    msg->nh.dest_node = sub.node();
+    if (!write_to_route(ex, route_to, msg.value())) {
+      ok = false;
     }
   }
-  return true;
+  if (!ok) {
+    LOG(ERROR) << "    ! ERROR Failed to write FTN message; writing to dead.net";
+    write_deadnet_packet(net_.dir, p);
+  }
+  // Since we wrote the packed message, let's add it to the
+  // duplicate message database.
+  dupe().add(msg.value());
+  ++ex.num_messages;
+  return ok;
 }
 
-bool NetworkF::export_main_type_email_name(std::set<std::string>& bundles, NetPacket& p) {
-  // Lame implementation that creates 1 file per message.
-  LOG(INFO) << "Creating packet for netmail.";
+bool NetworkF::export_main_type_email_name(ftn_export_t& ex, NetPacket& p) {
+  VLOG(1) << "Exporting netmail.";
 
   auto it = std::begin(p.text());
   const auto to = get_message_field(p.text(), it, {0}, 80);
@@ -930,15 +1001,14 @@ bool NetworkF::export_main_type_email_name(std::set<std::string>& bundles, NetPa
   // todo - actually we need a new way of making the ftn packet that works
   // right with net mail
   const auto packet_config = fido_callout_.packet_config_for(dest);
-  const FidoAddress route_to = find_route_to(dest, fido_callout_, packet_config);
-  if (auto bundlename = create_ftn_packet_and_bundle(dest, route_to, p)) {
-    if (!contains(bundles, bundlename.value())) {
-      // We only want to attach the bundle (or add it to the flo file)
-      // one time, so skip ones that have already been done.
-      bundles.insert(bundlename.value());
-      CreateNetmailAttachOrFloFile(route_to, bundlename.value(), packet_config);
-    }
+  const auto route_to = find_route_to(dest, fido_callout_, packet_config);
+  const auto msg = create_packed_message(dest, p);
+  if (!msg || !write_to_route(ex, route_to, msg.value())) {
+    LOG(ERROR) << "    ! ERROR Failed to write FTN netmail; writing to dead.net";
+    write_deadnet_packet(net_.dir, p);
+    return false;
   }
+  ++ex.num_messages;
   return true;
 }
 
@@ -977,18 +1047,19 @@ bool NetworkF::DoExport() {
     return false;
   }
 
-  std::set<std::string> bundles;
+  const auto start = std::chrono::steady_clock::now();
+  ftn_export_t ex;
   auto num_packets_processed = 0;
   for (auto p : file) {
     // If we got here, we had a packet to process.
     ++num_packets_processed;
 
     if (p.nh.main_type == main_type_new_post) {
-      if (!export_main_type_new_post(bundles, p)) {
+      if (!export_main_type_new_post(ex, p)) {
         LOG(ERROR) << "Error exporting post.";
       }
     } else if (p.nh.main_type == main_type_email_name) {
-      if (!export_main_type_email_name(bundles, p)) {
+      if (!export_main_type_email_name(ex, p)) {
         LOG(ERROR) << "Error exporting email.";
       }
     } else {
@@ -1001,6 +1072,13 @@ bool NetworkF::DoExport() {
     }
   }
 
+  finish_export(ex);
+  const auto elapsed =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  LOG(INFO) << "Exported " << ex.num_messages << " messages to " << ex.routes.size()
+            << " routes in " << ex.num_packets << " packets and " << ex.num_bundles
+            << " bundles; took " << elapsed.count() << "ms";
+
   // Delete the packet.
   file.Close();
   if (opts_.skip_delete) {
@@ -24,10 +24,15 @@
 #include "sdk/bbslist.h"
 #include "sdk/fido/fido_callout.h"
 #include "sdk/fido/fido_directories.h"
+#include "sdk/fido/fido_packets.h"
 #include "sdk/net/ftn_msgdupe.h"
 #include "sdk/net/packets.h"
+#include <cstdint>
+#include <map>
 #include <optional>
+#include <set>
 #include <string>
+#include <vector>
 
 namespace wwiv::net::networkf {
 
@@ -38,6 +43,31 @@ struct networkf_options_t {
   std::string system_name;
 };
 
+/** Outbound FTN packets for one route_to address during an export. */
+struct ftn_route_t {
+  sdk::fido::FidoAddress route_to;
+  sdk::net::fido_packet_config_t packet_config;
+  /** The packet currently being written, if any. */
+  std::optional<sdk::fido::FidoPacket> packet;
+  /** Bytes written to packet so far. */
+  int packet_size{0};
+  /** Names of the closed packets for this route, in the temp outbound dir. */
+  std::vector<std::string> packet_names;
+};
+
+/** State for one run of networkf export. */
+struct ftn_export_t {
+  /** Subscribers for each echo tag, read once per run. */
+  std::map<std::string, std::set<sdk::fido::FidoAddress>> subscribers;
+  /** Packets being written, by route_to address. */
+  std::map<sdk::fido::FidoAddress, ftn_route_t> routes;
+  /** Used to give each packet created during the run a unique name. */
+  uint32_t next_packet_number{0};
+  int num_messages{0};
+  int num_packets{0};
+  int num_bundles{0};
+};
+
 class NetworkF final {
 public:
   NetworkF(const sdk::BbsDirectories& bbsdirs,
@@ -68,31 +98,42 @@ private:
   int import_bundles(const std::filesystem::path& dir, const std::string& mask);
 
   /**
-   * Creates a FTN bundle using the appropriate archiver for the route_to system,
-   * if PKT is and adds the FTN packet named 'fido_packet_name'.
+   * Creates a FTN bundle using the appropriate archiver for the route_to system
+   * and adds the FTN packets named in fido_packet_names to it.  If the
+   * compression type is PKT, the packets are moved to the outbound directory
+   * as they are.
    *
-   * Returns the name of the fido bundle on success.
+   * Returns the names of the files created in the outbound directory.
    */
-  std::optional<std::string> create_ftn_bundle(const sdk::fido::FidoAddress& route_to,
-                                               const std::string& fido_packet_name);
+  std::optional<std::vector<std::string>>
+  create_ftn_bundle(const sdk::fido::FidoAddress& route_to,
+                    const std::vector<std::string>& fido_packet_names);
 
   /**
-   * Creates a FTN packet from the contents of the WWIVnet style packet.
-   *
-   * Returns the name of the fido packet on success.
+   * Creates a FTN packed message to dest from the contents of the WWIVnet
+   * style packet.
    */
-  std::optional<std::string> create_ftn_packet(const sdk::fido::FidoAddress& dest,
-                                               const sdk::fido::FidoAddress& route_to,
-                                               const sdk::net::NetPacket& wwivnet_packet);
+  std::optional<sdk::fido::FidoPackedMessage>
+  create_packed_message(const sdk::fido::FidoAddress& dest,
+                        const sdk::net::NetPacket& wwivnet_packet);
 
   /**
-   * Creates a FTN packet and bundle from the contents of the WWIVnet style packet.
-   *
-   * Returns the name of the fido packet on success.
+   * Writes msg to the open packet for route_to, starting a new packet when
+   * there is none yet or the current one would grow past the maximum
+   * packet size for route_to.
+   */
+  bool write_to_route(ftn_export_t& ex, const sdk::fido::FidoAddress& route_to,
+                      const sdk::fido::FidoPackedMessage& msg);
+
+  /** Closes the open packet for route, if any. */
+  void close_route_packet(ftn_route_t& route);
+
+  /**
+   * Closes every packet written during the export, bundles them (at most
+   * max_archive_size bytes of packets per bundle) and attaches the
+   * bundles, or adds them to the FLO file, for each route.
    */
-  std::optional<std::string> create_ftn_packet_and_bundle(const sdk::fido::FidoAddress& dest,
-                                                          const sdk::fido::FidoAddress& route_to,
-                                                          sdk::net::NetPacket& p);
+  void finish_export(ftn_export_t& ex);
 
   /** Create a FLO file, returning the name generated or nullopt */
   std::optional<std::string> CreateFloFile(const wwiv::sdk::fido::FidoAddress& dest,
@@ -109,9 +150,9 @@ private:
   CreateNetmailAttachOrFloFile(const sdk::fido::FidoAddress& dest, const std::string& bundlename,
                                const sdk::net::fido_packet_config_t& packet_config);
 
-  bool export_main_type_new_post(std::set<std::string>& bundles, sdk::net::NetPacket& p);
+  bool export_main_type_new_post(ftn_export_t& ex, sdk::net::NetPacket& p);
 
-  bool export_main_type_email_name(std::set<std::string>& bundles, sdk::net::NetPacket& p);
+  bool export_main_type_email_name(ftn_export_t& ex, sdk::net::NetPacket& p);
 
   sdk::FtnMessageDupe& dupe();
 
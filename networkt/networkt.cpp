@@ -36,10 +36,20 @@
 #include "sdk/files/files.h"
 #include "sdk/files/tic.h"
 #include "sdk/net/packets.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
+#include <future>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::net;
@@ -56,46 +66,99 @@ static void ShowHelp(const NetworkCommandLine& cmdline) {
   exit(1);
 }
 
-bool process_ftn_tic(const Config& config, const Network& net, bool save_tic_files, bool skip_delete) {
-  if (!net.fido.process_tic) {
-    LOG(WARNING) << "TIC processing disabled for network: " << net.name;
-    return false;
+/** A TIC file that has been parsed, verified and matched to a file area. */
+struct tic_file_t {
+  // Name of the .TIC file in the TIC directory.
+  std::string tic_name;
+  files::Tic tic;
+};
+
+/** The TIC files destined for a single file area. */
+struct tic_area_t {
+  files::directory_t dir;
+  std::vector<tic_file_t> files;
+};
+
+struct tic_stats_t {
+  int num_tics{0};
+  int num_invalid{0};
+  int num_no_area{0};
+  int num_areas{0};
+  int num_added{0};
+  int num_updated{0};
+  int num_failed{0};
+};
+
+/**
+ * Stage one: parses and verifies (which CRCs the whole file) each of the TIC
+ * files using up to num_threads threads. The TICs that are valid are
+ * returned grouped by destination area, in the order the areas and files were
+ * first seen.
+ */
+static std::vector<tic_area_t> verify_tics(const files::TicParser& parser, const files::Dirs& dirs,
+                                           const Network& net,
+                                           const std::vector<std::string>& tic_names,
+                                           int num_threads, tic_stats_t& stats) {
+  std::vector<std::optional<files::Tic>> tics(tic_names.size());
+  std::atomic<size_t> next{0};
+  std::vector<std::future<void>> workers;
+  for (auto i = 0; i < std::max(1, num_threads); i++) {
+    workers.emplace_back(std::async(std::launch::async, [&] {
+      for (auto n = next++; n < tic_names.size(); n = next++) {
+        auto ot = parser.parse(tic_names[n]);
+        if (ot && ot->IsValid()) {
+          tics[n].emplace(std::move(ot.value()));
+        }
+      }
+    }));
   }
-  const FtnDirectories ftn_directories(config.root_directory(), net);
-  files::Dirs dirs(config.datadir(), 0);
-  if (!dirs.Load()) {
-    LOG(ERROR) << "Unable to load directories.";
-    return false;
+  for (auto& w : workers) {
+    w.get();
   }
-  files::FileApi api(config.datadir());
 
-  FindFiles ff(FilePath(ftn_directories.tic_dir(), "*.tic"), FindFiles::FindFilesType::files);
-  auto first = true;
-  const files::TicParser parser(ftn_directories.tic_dir());
-  for (const auto& f : ff) {
-    auto ot = parser.parse(f.name);
-    if (!ot) {
-      continue;
-    }
-    auto t = ot.value();
-    if (!t.IsValid()) {
+  std::vector<tic_area_t> areas;
+  std::map<std::string, size_t> area_index;
+  for (size_t n = 0; n < tics.size(); n++) {
+    if (!tics[n]) {
+      ++stats.num_invalid;
       continue;
     }
+    const auto& t = tics[n].value();
     auto od = FindFileAreaForTic(dirs, t, net);
     if (!od) {
-      LOG(ERROR) << "Unable to find AREA_TAG for tic file: TAG: " << t.area << "; file; " << f.name;
+      LOG(ERROR) << "Unable to find AREA_TAG for tic file: TAG: " << t.area
+                 << "; file; " << tic_names[n];
+      ++stats.num_no_area;
       continue;
     }
-    auto d = od.value();
-    auto fa = api.CreateOrOpen(d);
-    if (!fa) {
-      LOG(ERROR) << "Unable to open file area: " << d.filename;
-      continue;
-    }
-    if (first) {
-      LOG(INFO) << "------------------------------------------------------------------------------";
-      first = false;
+    auto [it, inserted] = area_index.emplace(od->filename, areas.size());
+    if (inserted) {
+      areas.push_back(tic_area_t{od.value(), {}});
     }
+    areas.at(it->second).files.push_back(tic_file_t{tic_names[n], t});
+  }
+  stats.num_areas = size_int(areas);
+  return areas;
+}
+
+/**
+ * Stage two: adds or updates all of the files for one area, saving the area
+ * once, and then moves the files into the area's directory.
+ */
+static void import_tic_area(files::FileApi& api, const FtnDirectories& ftn_directories,
+                            const tic_area_t& area, bool save_tic_files, bool skip_delete,
+                            tic_stats_t& stats) {
+  const auto& d = area.dir;
+  auto fa = api.CreateOrOpen(d);
+  if (!fa) {
+    LOG(ERROR) << "Unable to open file area: " << d.filename;
+    stats.num_failed += size_int(area.files);
+    return;
+  }
+
+  std::vector<std::tuple<const tic_file_t*, files::FileRecord>> imported;
+  for (const auto& tf : area.files) {
+    const auto& t = tf.tic;
     files::FileName fn(t.file);
     auto op = fa->FindFile(fn);
     files::FileRecord r;
@@ -109,28 +172,23 @@ bool process_ftn_tic(const Config& config, const Network& net, bool save_tic_fil
     r.set_actual_date(DateTime::from_time_t(actual_t));
     const auto ext_desc = JoinStrings(t.ldesc, "\r\n");
 
-    if (!net.fido.process_tic) {
-      LOG(INFO) << "Skipping processing file. process_tic is not enabled. file: " << t.file;
-      continue;
-    }
-
     if (op.has_value()) {
       LOG(INFO) << "File already exists in file area";
       LOG(INFO) << "** Updating: "  << r;
       if (!fa->UpdateFile(r, op.value(), ext_desc)) {
         LOG(ERROR) << "Failed to update File: " << fn;
+        ++stats.num_failed;
         continue;
       }
+      ++stats.num_updated;
     } else {
       LOG(INFO) << "** Adding  :" << r;
       if (!fa->AddFile(r, ext_desc)) {
         LOG(ERROR) << "Error adding file: " << r;
+        ++stats.num_failed;
         continue;
       }
-      if (!fa->Save()) {
-        LOG(ERROR) << "Error saving file area: " << d.filename;
-        continue;
-      }
+      ++stats.num_added;
     }
     // Display information about the file;
     LOG(INFO) << "Area Name  : " << t.area;
@@ -143,11 +201,20 @@ bool process_ftn_tic(const Config& config, const Network& net, bool save_tic_fil
       LOG(INFO) << "    " << l;
     }
     LOG(INFO) << "------------------------------------------------------------------------------";
+    imported.emplace_back(&tf, r);
+  }
+
+  if (!fa->Save()) {
+    LOG(ERROR) << "Error saving file area: " << d.filename;
+    stats.num_failed += size_int(imported);
+    return;
+  }
+
+  for (const auto& [tf, r] : imported) {
     // Use t.file not r here since r will be the unaligned and lower-case filename,
     // and we have to match the exact case specified. So use t.file.
-    const auto src = FilePath(ftn_directories.tic_dir(), t.file);
-    // f.name is the name of the TIC file
-    const auto tic = FilePath(ftn_directories.tic_dir(), f.name);
+    const auto src = FilePath(ftn_directories.tic_dir(), tf->tic.file);
+    const auto tic = FilePath(ftn_directories.tic_dir(), tf->tic_name);
     const auto dest = FilePath(d.path, r);
     if (save_tic_files) {
       LOG(INFO) << "Not moving file, just copy, --save_tic_files == true";
@@ -160,6 +227,56 @@ bool process_ftn_tic(const Config& config, const Network& net, bool save_tic_fil
       }
     }
   }
+}
+
+bool process_ftn_tic(const Config& config, const Network& net, bool save_tic_files,
+                     bool skip_delete, int num_threads) {
+  if (!net.fido.process_tic) {
+    LOG(WARNING) << "TIC processing disabled for network: " << net.name;
+    return false;
+  }
+  const FtnDirectories ftn_directories(config.root_directory(), net);
+  files::Dirs dirs(config.datadir(), 0);
+  if (!dirs.Load()) {
+    LOG(ERROR) << "Unable to load directories.";
+    return false;
+  }
+  files::FileApi api(config.datadir());
+
+  FindFiles ff(FilePath(ftn_directories.tic_dir(), "*.tic"), FindFiles::FindFilesType::files);
+  std::vector<std::string> tic_names;
+  for (const auto& f : ff) {
+    tic_names.push_back(f.name);
+  }
+  if (tic_names.empty()) {
+    return true;
+  }
+
+  tic_stats_t stats{};
+  stats.num_tics = size_int(tic_names);
+  const files::TicParser parser(ftn_directories.tic_dir());
+  const auto verify_start = std::chrono::steady_clock::now();
+  const auto areas = verify_tics(parser, dirs, net, tic_names, num_threads, stats);
+  const auto verify_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - verify_start);
+  LOG(INFO) << fmt::format("Verified {} TIC files in {}ms using {} threads; invalid: {}; "
+                           "no area: {}",
+                           stats.num_tics, verify_ms.count(), num_threads, stats.num_invalid,
+                           stats.num_no_area);
+
+  if (!areas.empty()) {
+    LOG(INFO) << "------------------------------------------------------------------------------";
+  }
+  const auto import_start = std::chrono::steady_clock::now();
+  for (const auto& area : areas) {
+    import_tic_area(api, ftn_directories, area, save_tic_files, skip_delete, stats);
+  }
+  const auto import_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - import_start);
+  LOG(INFO) << fmt::format("Imported TIC files into {} areas in {}ms; added: {}; updated: {}; "
+                           "failed: {}",
+                           stats.num_areas, import_ms.count(), stats.num_added, stats.num_updated,
+                           stats.num_failed);
   return true;
 }
 
@@ -174,7 +291,8 @@ int networkt_main(const NetworkCommandLine& net_cmdline) {
     case network_type_t::ftn: {
       const auto save_tic_files = net_cmdline.cmdline().barg("save_tic_files");
       const auto skip_delete = net_cmdline.skip_delete();
-      if (!process_ftn_tic(net_cmdline.config(), net, save_tic_files, skip_delete)) {
+      const auto num_threads = net_cmdline.cmdline().iarg<int>("threads");
+      if (!process_ftn_tic(net_cmdline.config(), net, save_tic_files, skip_delete, num_threads)) {
         return 1;
       }
     } break;
@@ -208,6 +326,8 @@ int main(int argc, char** argv) {
   cmdline.add_argument({"process_instance", "Also process pending files for BBS instance #", "0"});
   cmdline.add_argument(BooleanCommandLineArgument{
       "save_tic_files", 'S', "Save TIC files, do not delete TIC and archives", false});
+  cmdline.add_argument({"threads", "Number of TIC files to verify at once.",
+                        std::to_string(std::max(1u, std::thread::hardware_concurrency()))});
 
   const NetworkCommandLine net_cmdline(cmdline, 't');
   if (!net_cmdline.IsInitialized() || net_cmdline.cmdline().help_requested()) {
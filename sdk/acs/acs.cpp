@@ -25,6 +25,7 @@
 
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 using namespace wwiv::stl;
@@ -51,6 +52,42 @@ check_acs(const Config&, const std::string& expression,
   return std::make_tuple(result, eval.debug_info());  
 }
 
+CompiledAcs::CompiledAcs(std::string expression)
+    : expression_(std::move(expression)), empty_(StringTrim(expression_).empty()) {
+  if (empty_) {
+    return;
+  }
+  try {
+    ast_ = Eval::Parse(expression_);
+  } catch (const eval_error& e) {
+    error_ = e.what();
+  }
+}
+
+std::tuple<bool, std::vector<std::string>>
+CompiledAcs::check(const std::vector<const ValueProvider*>& providers) const {
+  if (empty_) {
+    // Empty expression is always allowed.
+    std::vector<std::string> debug_lines;
+    return std::make_tuple(true, debug_lines);
+  }
+  if (!ast_) {
+    // Same as check_acs, invalid expressions never allow access.
+    std::vector<std::string> debug_lines;
+    if (!error_.empty()) {
+      debug_lines.push_back(error_);
+    }
+    return std::make_tuple(false, debug_lines);
+  }
+
+  Eval eval(expression_, ast_);
+  for (const auto* p : providers) {
+    eval.add(p);
+  }
+  const auto result = eval.eval();
+  return std::make_tuple(result, eval.debug_info());
+}
+
 std::tuple<bool, std::string, std::vector<std::string>>
 validate_acs(const std::string& expression, const std::vector<const ValueProvider*>& providers) {
   Eval eval(expression);
@@ -22,10 +22,15 @@
 #include "sdk/user.h"
 #include "sdk/value/valueprovider.h"
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
+namespace wwiv::core::parser {
+class Ast;
+}
+
 namespace wwiv::sdk::acs {
 
 enum class acs_debug_t { local, remote, none };
@@ -47,6 +52,30 @@ check_acs(const Config& config, const std::string& expression, Args... args) {
   return check_acs(config, expression, v);
 }
 
+/**
+ * An ACS expression that is lexed and parsed once, so that it may be checked
+ * many times without parsing it again.
+ */
+class CompiledAcs final {
+public:
+  CompiledAcs() = default;
+  explicit CompiledAcs(std::string expression);
+
+  [[nodiscard]] const std::string& expression() const noexcept { return expression_; }
+  /** True if the expression is empty, which always allows access. */
+  [[nodiscard]] bool empty() const noexcept { return empty_; }
+
+  // Result: (true|false), debug lines
+  [[nodiscard]] std::tuple<bool, std::vector<std::string>>
+  check(const std::vector<const value::ValueProvider*>& providers) const;
+
+private:
+  std::string expression_;
+  bool empty_{true};
+  std::shared_ptr<core::parser::Ast> ast_;
+  std::string error_;
+};
+
 // Result: (true|false), exception message (if any), debug lines
 std::tuple<bool, std::string, std::vector<std::string>>
 validate_acs(const std::string& expression,
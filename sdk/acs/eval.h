@@ -56,8 +56,17 @@ public:
 class Eval final : public core::parser::AstVisitor {
 public:
   explicit Eval(std::string expression);
+  /** Evaluates expression using ast, which was already created by Parse. */
+  Eval(std::string expression, std::shared_ptr<core::parser::Ast> ast);
   ~Eval() override = default;
 
+  /**
+   * Lexes and parses expression, throwing an eval_error if it is invalid.
+   * Returns nullptr if the expression could not be parsed but did not
+   * contain an error.
+   */
+  static std::shared_ptr<core::parser::Ast> Parse(const std::string& expression);
+
   bool eval_throws();
   bool eval();
   bool add(std::unique_ptr<value::ValueProvider>&& p);
@@ -86,6 +95,7 @@ public:
 
 private:
   std::string expression_;
+  std::shared_ptr<core::parser::Ast> ast_;
   std::unordered_map<std::string, const value::ValueProvider*> providers_;
   std::unordered_map<int, value::Value> values_;
   std::string error_text_;
@@ -151,37 +151,39 @@ static bool ParseBbsListNetFile(
 
   // A line will be of the format @node *phone options [reg] "name"
   std::string line;
+  std::vector<uint16_t> path;
   while (bbs_list_file.ReadLine(&line)) {
     StringTrim(&line);
     net_system_list_rec node_config{};
     int32_t reg_number;
     if (ParseBbsListNetLine(line, &node_config, &reg_number)) {
       // Parsed a line correctly.
-      auto path = graph.shortest_path_to(node_config.sysnum);
-      auto cost = graph.cost_to(node_config.sysnum);
+      const auto sysnum = node_config.sysnum;
+      const auto cost = graph.cost_to(sysnum);
       if (!std::isfinite(cost)) {
         if(VLOG_IS_ON(2)) {
           std::ostringstream ss; 
-          VLOG(2) << "high cost " << cost << " to " << node_config.sysnum;
-          ss << "Path to " << node_config.sysnum << ": ";
+          VLOG(2) << "high cost " << cost << " to " << sysnum;
+          ss << "Path to " << sysnum << ": ";
+          graph.path_to(sysnum, path);
           std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(ss, " "));
           VLOG(2) << ss.str();
           VLOG(2) << graph.DumpCosts();
         }
       }
-      if (graph.has_node(node_config.sysnum) && path.front() == net_node_number) {
-        path.pop_front();
+      // The hop count and first hop are kept by the graph, so there is no
+      // need to build the path to each node here.
+      if (graph.has_node(sysnum) && (sysnum == net_node_number || std::isfinite(cost))) {
         // We have a path...
-        //std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(std::cout, " "));
-        node_config.numhops = static_cast<int16_t>(path.size());
+        node_config.numhops = static_cast<int16_t>(graph.num_hops_to(sysnum));
         node_config.xx.cost = cost;
-        if (!path.empty()) {
-          node_config.forsys = path.front();
+        if (sysnum != net_node_number) {
+          node_config.forsys = graph.next_hop_to(sysnum);
         } else {
-          node_config.forsys = node_config.sysnum;
+          node_config.forsys = sysnum;
         }
       } else {
-        VLOG(2) << "no path to " << node_config.sysnum;
+        VLOG(2) << "no path to " << sysnum;
         node_config.numhops = 10000;
         node_config.xx.cost = 10000;
         node_config.forsys = std::numeric_limits<uint16_t>::max();
@@ -22,7 +22,7 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include <cctype>
-#include <set>
+#include <initializer_list>
 #include <string>
 
 using namespace wwiv::core;
@@ -31,7 +31,8 @@ using namespace wwiv::stl;
 
 namespace wwiv::sdk::fido {
 
-template <typename T, typename C, typename I> static T next_int(C& c, I& it, std::set<char> stop) {
+template <typename T, typename C, typename I>
+static T next_int(C& c, I& it, std::initializer_list<char> stop) {
   std::string s;
   while (it != std::end(c) && !contains(stop, *it)) {
     if (!std::isdigit(*it)) {
@@ -25,8 +25,10 @@
 #include "sdk/fido/fido_util.h"
 #include "sdk/net/packets.h"
 #include <algorithm>
+#include <cstring>
 #include <optional>
 #include <string>
+#include <string_view>
 
 using namespace wwiv::core;
 using namespace wwiv::strings;
@@ -34,14 +36,6 @@ using namespace wwiv::sdk::net;
 
 namespace wwiv::sdk::fido {
 
-static char ReadCharFromFile(File& f) {
-  char buf[1];
-  if (const auto num_read = f.Read(buf, 1); num_read == 0) {
-    return 0;
-  }
-  return buf[0];
-}
-
 static std::string ReadRestOfFile(File& f, int max_size) {
   auto current = f.current_position();
   const auto size = f.length();
@@ -76,16 +70,52 @@ static std::string ReadFixedLengthField(File& f, int len) {
  */
 static std::string ReadVariableLengthField(File& f, int max_len) {
   std::string s;
-  for (auto i = 0; i < max_len; i++) {
-    const auto ch = ReadCharFromFile(f);
-    if (ch == 0) {
+  char buf[512];
+  while (ssize(s) < max_len) {
+    const auto to_read = std::min<int>(sizeof(buf), max_len - ssize(s));
+    const auto num_read = f.Read(buf, to_read);
+    if (num_read <= 0) {
+      return s;
+    }
+    if (const auto* nul = static_cast<const char*>(memchr(buf, 0, num_read))) {
+      const auto len = nul - buf;
+      s.append(buf, len);
+      // Leave the file positioned just past the null.
+      f.Seek(len + 1 - num_read, File::Whence::current);
       return s;
     }
-    s.push_back(ch);
+    s.append(buf, num_read);
   }
   return s;
 }
 
+/**
+ * Returns the field of length {len} at the start of data.  Will trim the
+ * field to remove any trailing nulls.
+ */
+static std::string_view ParseFixedLengthField(std::string_view& data, int len) {
+  auto s = data.substr(0, len);
+  data.remove_prefix(s.size());
+  while (!s.empty() && s.back() == '\0') {
+    s.remove_suffix(1);
+  }
+  return s;
+}
+
+/**
+ * Returns the null-terminated field of up to length {len} at the start of
+ * data.  Behaves the same as ReadVariableLengthField.
+ */
+static std::string_view ParseVariableLengthField(std::string_view& data, int max_len) {
+  const auto field = data.substr(0, max_len);
+  if (const auto idx = field.find('\0'); idx != std::string_view::npos) {
+    data.remove_prefix(idx + 1);
+    return field.substr(0, idx);
+  }
+  data.remove_prefix(field.size());
+  return field;
+}
+
 FidoStoredMessage::~FidoStoredMessage()  = default;
 
 bool write_fido_packet_header(File& f, const packet_header_2p_t& header) {
@@ -98,7 +128,8 @@ bool write_fido_packet_header(File& f, const packet_header_2p_t& header) {
   return true;
 }
 
-bool write_packed_message(File& f, const FidoPackedMessage& packet) {
+// Writes the message without the end of packet marker.
+static bool write_packed_message_only(File& f, const FidoPackedMessage& packet) {
   if (const auto num_written = f.Write(&packet.nh, sizeof(fido_packed_message_t));
       num_written != sizeof(fido_packed_message_t)) {
     LOG(ERROR) << "short write to packet, wrote " << num_written
@@ -115,11 +146,24 @@ bool write_packed_message(File& f, const FidoPackedMessage& packet) {
   f.Write("\0", 1);
   f.Write(packet.vh.text);
   f.Write("\0", 1);
+  return true;
+}
+
+bool write_packed_message(File& f, const FidoPackedMessage& packet) {
+  if (!write_packed_message_only(f, packet)) {
+    return false;
+  }
   // End of packet.
   f.Write("\0\0", 2);
   return true;
 }
 
+int packed_message_size(const FidoPackedMessage& packet) {
+  return static_cast<int>(sizeof(fido_packed_message_t) + 20 + packet.vh.to_user_name.size() + 1 +
+                          packet.vh.from_user_name.size() + 1 + packet.vh.subject.size() + 1 +
+                          packet.vh.text.size() + 1);
+}
+
 bool write_stored_message(File& f, FidoStoredMessage& packet) {
   if (const auto num = f.Write(&packet.nh, sizeof(fido_stored_message_t));
       num != sizeof(fido_stored_message_t)) {
@@ -164,6 +208,61 @@ ReadNetPacketResponse read_packed_message(File& f, FidoPackedMessage& packet) {
   return ReadNetPacketResponse::OK;
 }
 
+ReadNetPacketResponse parse_packed_message(std::string_view& data,
+                                           fido_packed_message_view_t& packet) {
+  const auto num_read = std::min(data.size(), sizeof(fido_packed_message_t));
+  if (num_read == 0) {
+    // at the end of the packet.
+    return ReadNetPacketResponse::END_OF_FILE;
+  }
+  memcpy(&packet.nh, data.data(), num_read);
+  data.remove_prefix(num_read);
+  if (num_read == 2) {
+    // FIDO packets have 2 bytes of NULL at the end;
+    if (packet.nh.message_type == 0) {
+      return ReadNetPacketResponse::END_OF_FILE;
+    }
+  }
+
+  if (num_read != sizeof(fido_packed_message_t)) {
+    LOG(INFO) << "error reading header, got short read of size: " << num_read
+              << "; expected: " << sizeof(fido_packed_message_t);
+    return ReadNetPacketResponse::ERROR;
+  }
+
+  if (packet.nh.message_type != 2) {
+    LOG(INFO) << "invalid message_type: " << packet.nh.message_type << "; expected: 2";
+  }
+  packet.date_time = ParseFixedLengthField(data, 20);
+  packet.to_user_name = ParseVariableLengthField(data, 36);
+  packet.from_user_name = ParseVariableLengthField(data, 36);
+  packet.subject = ParseVariableLengthField(data, 72);
+  packet.text = ParseVariableLengthField(data, 256 * 1024);
+  return ReadNetPacketResponse::OK;
+}
+
+FidoPackedMessage to_packed_message(const fido_packed_message_view_t& m) {
+  FidoPackedMessage p;
+  p.nh = m.nh;
+  p.vh.date_time = std::string(m.date_time);
+  p.vh.to_user_name = std::string(m.to_user_name);
+  p.vh.from_user_name = std::string(m.from_user_name);
+  p.vh.subject = std::string(m.subject);
+  p.vh.text = std::string(m.text);
+  return p;
+}
+
+fido_packed_message_view_t to_packed_message_view(const FidoPackedMessage& m) {
+  fido_packed_message_view_t v;
+  v.nh = m.nh;
+  v.date_time = m.vh.date_time;
+  v.to_user_name = m.vh.to_user_name;
+  v.from_user_name = m.vh.from_user_name;
+  v.subject = m.vh.subject;
+  v.text = m.vh.text;
+  return v;
+}
+
 ReadNetPacketResponse read_stored_message(File& f, FidoStoredMessage& packet) {
   if (const auto num_read = f.Read(&packet.nh, sizeof(fido_stored_message_t)); num_read == 0) {
     // at the end of the packet.
@@ -225,13 +324,21 @@ std::optional<FidoPacket> FidoPacket::Open(const std::filesystem::path& path) {
     return std::nullopt;
   }
 
-  FidoPacket packet(std::move(f), true);
+  FidoPacket packet(std::move(f), false);
   auto num_header_read = packet.file_.Read(&packet.header_, sizeof(packet_header_2p_t));
   if (num_header_read < static_cast<int>(sizeof(packet_header_2p_t))) {
     LOG(ERROR) << "Read less than packet header";
     return std::nullopt;
   }
 
+  // Read the rest of the packet at once, messages are parsed from this buffer.
+  const auto size = packet.file_.length() - num_header_read;
+  if (size > 0) {
+    packet.buffer_.resize(size);
+    const auto num_read = packet.file_.Read(packet.buffer_.data(), size);
+    packet.buffer_.resize(std::max<File::size_type>(0, num_read));
+  }
+  packet.file_.Close();
   return packet;
 }
 
@@ -270,6 +377,23 @@ std::optional<FidoPacket> FidoPacket::Create(const std::filesystem::path& outbou
   return std::nullopt;
 }
 
+// static
+std::optional<FidoPacket> FidoPacket::Create(const std::filesystem::path& path,
+                                             const packet_header_2p_t& header) {
+  File file(path);
+  if (!file.Open(File::modeCreateFile | File::modeExclusive | File::modeReadWrite |
+                     File::modeBinary,
+                 File::shareDenyReadWrite)) {
+    VLOG(1) << "Unable to create packet file: " << file;
+    return std::nullopt;
+  }
+  FidoPacket packet(std::move(file), true, header);
+  if (!packet.write_fido_packet_header()) {
+    return std::nullopt;
+  }
+  return packet;
+}
+
 bool FidoPacket::write_fido_packet_header() {
   if (const auto num_written = file_.Write(&header_, sizeof(packet_header_2p_t));
       num_written != sizeof(packet_header_2p_t)) {
@@ -281,23 +405,40 @@ bool FidoPacket::write_fido_packet_header() {
 }
 
 bool FidoPacket::Write(const FidoPackedMessage& packet) {
-  return write_packed_message(file_, packet);
+  return write_packed_message_only(file_, packet);
+}
+
+void FidoPacket::Close() {
+  if (!file_.IsOpen()) {
+    return;
+  }
+  if (writable_) {
+    // End of packet.
+    file_.Write("\0\0", 2);
+  }
+  file_.Close();
 }
 
 std::tuple<wwiv::sdk::net::ReadNetPacketResponse, FidoPackedMessage> FidoPacket::Read() {
-  FidoPackedMessage msg;
-  auto response = read_packed_message(file_, msg);
+  auto [response, view] = ReadView();
+  return std::make_tuple(response, to_packed_message(view));
+}
+
+std::tuple<wwiv::sdk::net::ReadNetPacketResponse, fido_packed_message_view_t>
+FidoPacket::ReadView() {
+  fido_packed_message_view_t msg;
+  std::string_view data(buffer_.data(), buffer_.size());
+  data.remove_prefix(pos_);
+  auto response = parse_packed_message(data, msg);
+  pos_ = buffer_.size() - data.size();
   return std::make_tuple(response, msg);
 }
 
 std::string FidoPacket::password() const {
-  // Do this dance to ensure that if there's no trailing null on header.password, we add one.
-  char temp[9];
-  memset(temp, 0, sizeof(temp));
-  strncpy(temp, header_.password, 8);
-  temp[8] = '\0';
-  std::string actual = temp;
-  return ToStringUpperCase(actual);
+  // header.password may not have a trailing null.
+  std::string actual;
+  ToStringUpperCase(std::string_view(header_.password, strnlen(header_.password, 8)), &actual);
+  return actual;
 }
 
 } // namespace wwiv
@@ -26,8 +26,10 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace wwiv::sdk::fido {
 
@@ -217,6 +219,26 @@ public:
   fido_variable_length_header_t vh;
 };
 
+/**
+ * A message in a .PKT file parsed in place.  The variable length fields point
+ * into the buffer the message was parsed from and are only valid as long as
+ * that buffer is, use to_packed_message to keep a copy of the message.
+ */
+struct fido_packed_message_view_t {
+  fido_packed_message_t nh{};
+  std::string_view date_time;
+  std::string_view to_user_name;
+  std::string_view from_user_name;
+  std::string_view subject;
+  std::string_view text;
+};
+
+/** Creates a FidoPackedMessage owning a copy of the fields of m. */
+FidoPackedMessage to_packed_message(const fido_packed_message_view_t& m);
+
+/** Creates a view of the fields of m, valid as long as m is. */
+fido_packed_message_view_t to_packed_message_view(const FidoPackedMessage& m);
+
 /**
  * Represents a .MSG file in FidoNET.
  */
@@ -232,44 +254,77 @@ public:
 
 /**
  * Represents a .PKT file in FidoNET.
+ *
+ * Any number of messages may be written to a writable packet, the end of
+ * packet marker is written when it is closed.
+ *
+ * Packets opened for reading are read into memory in one go when opened and
+ * messages are parsed in place from that buffer.
  */
 class FidoPacket {
 public:
   FidoPacket(wwiv::core::File&& f, bool writable) : file_(std::move(f)), writable_(writable) {}
   FidoPacket(wwiv::core::File&& f, bool writable, const packet_header_2p_t& header)
       : file_(std::move(f)), writable_(writable), header_(header) {}
+  ~FidoPacket() { Close(); }
 
   static std::optional<FidoPacket> Create(const std::filesystem::path& outbound_path,
                                           const packet_header_2p_t& header,
                                           wwiv::core::Clock& clock);
+  /**
+   * Creates a new packet at path, which must not already exist, and writes
+   * header to it.
+   */
+  static std::optional<FidoPacket> Create(const std::filesystem::path& path,
+                                          const packet_header_2p_t& header);
   static std::optional<FidoPacket> Open(const std::filesystem::path& path);
 
   FidoPacket(FidoPacket&& o) noexcept
-      : file_(std::move(o.file_)), writable_(o.writable_), header_(o.header_) {}
+      : file_(std::move(o.file_)), writable_(o.writable_), header_(o.header_),
+        buffer_(std::move(o.buffer_)), pos_(o.pos_) {}
 
   bool Write(const FidoPackedMessage& packet);
   [[nodiscard]] std::tuple<wwiv::sdk::net::ReadNetPacketResponse, FidoPackedMessage> Read();
+  /**
+   * Reads the next message without copying it.  The fields of the view are
+   * valid until this packet is destroyed.
+   */
+  [[nodiscard]] std::tuple<wwiv::sdk::net::ReadNetPacketResponse, fido_packed_message_view_t>
+  ReadView();
   [[nodiscard]] packet_header_2p_t& header() { return header_; }
 
   // Gets the packet password as a UPPER case string.
   [[nodiscard]] std::string password() const;
 
-  // Close the packet
-  void Close() { file_.Close(); }
+  [[nodiscard]] const std::filesystem::path& path() const noexcept { return file_.path(); }
+
+  // Close the packet, ending it first if it was created for writing.
+  void Close();
 
 private:
   bool write_fido_packet_header();
   wwiv::core::File file_;
   bool writable_{false};
   packet_header_2p_t header_{};
+  // Contents of a packet opened for reading, after the packet header.
+  std::vector<char> buffer_;
+  std::vector<char>::size_type pos_{0};
 };
   
 bool write_fido_packet_header(wwiv::core::File& f, const packet_header_2p_t& header);
 bool write_packed_message(wwiv::core::File& f, const FidoPackedMessage& packet);
+/** Number of bytes packet will take when written to a .PKT file. */
+int packed_message_size(const FidoPackedMessage& packet);
 bool write_stored_message(wwiv::core::File& f, FidoStoredMessage& packet);
 
 wwiv::sdk::net::ReadNetPacketResponse read_packed_message(wwiv::core::File& file,
                                                        FidoPackedMessage& packet);
+/**
+ * Parses the packed message at the start of data into packet, advancing data
+ * past it.  The fields of packet point into data.
+ */
+wwiv::sdk::net::ReadNetPacketResponse parse_packed_message(std::string_view& data,
+                                                        fido_packed_message_view_t& packet);
 wwiv::sdk::net::ReadNetPacketResponse read_stored_message(wwiv::core::File& file,
                                                        FidoStoredMessage& packet);
 packet_header_2p_t CreateType2PlusPacketHeader(const FidoAddress& from_address,
@@ -15,11 +15,16 @@
 /*    language governing permissions and limitations under the License.   */
 /**************************************************************************/
 
+#include "core/datetime.h"
 #include "core/file.h"
+#include "core/log.h"
 #include "core/test/file_helper.h"
 #include "core/test/wwivtest.h"
 #include "sdk/fido/fido_packets.h"
 #include "gtest/gtest.h"
+#include <chrono>
+#include <string>
+#include <string_view>
 
 class FidoPacketsTestDataTest : public wwiv::core::test::TestDataTest {};
 
@@ -97,4 +102,126 @@ TEST_F(FidoPacketsTestDataTest, ThreeMessages) {
     auto [result, msg] = packet.Read();
     ASSERT_EQ(ReadNetPacketResponse::END_OF_FILE, result);
   }
-}
\ No newline at end of file
+}
+
+TEST(FidoPacketsTest, WriteMultipleMessages) {
+  FileHelper helper;
+  const auto path = FilePath(helper.TempDir(), "00000001.pkt");
+  const FidoAddress from("1:2/3");
+  const FidoAddress to("1:2/4");
+  const auto header = CreateType2PlusPacketHeader(from, to, DateTime::now(), "PW");
+  {
+    auto o = FidoPacket::Create(path, header);
+    ASSERT_TRUE(o.has_value());
+    for (const auto* subject : {"one", "two"}) {
+      fido_variable_length_header_t vh{};
+      vh.date_time = "01 Jan 20  00:00:00";
+      vh.to_user_name = "All";
+      vh.from_user_name = "Sysop";
+      vh.subject = subject;
+      vh.text = "text\r";
+      fido_packed_message_t nh{};
+      nh.message_type = 2;
+      ASSERT_TRUE(o->Write(FidoPackedMessage(nh, vh)));
+    }
+    // Creating it again fails since it already exists.
+    EXPECT_FALSE(FidoPacket::Create(path, header).has_value());
+  }
+
+  auto o = FidoPacket::Open(path);
+  ASSERT_TRUE(o.has_value());
+  EXPECT_EQ("PW", o->password());
+  for (const auto* subject : {"one", "two"}) {
+    auto [result, msg] = o->Read();
+    ASSERT_EQ(ReadNetPacketResponse::OK, result);
+    EXPECT_EQ(subject, msg.vh.subject);
+    EXPECT_EQ("text\r", msg.vh.text);
+  }
+  auto [result, msg] = o->Read();
+  EXPECT_EQ(ReadNetPacketResponse::END_OF_FILE, result);
+}
+
+TEST(FidoPacketsTest, ParsePackedMessage_SameAsReadPackedMessage) {
+  fido_packed_message_t nh{};
+  nh.message_type = 2;
+  nh.orig_node = 3;
+  std::string raw(reinterpret_cast<const char*>(&nh), sizeof(nh));
+  // Date with an embedded null, only trailing nulls are trimmed.
+  raw.append("01 Jan\0 20  00:00\0\0\0", 20);
+  // To name with no terminating null.
+  raw.append(std::string(36, 'T'));
+  raw.append("From").push_back(0);
+  raw.append("Subject").push_back(0);
+  // Text is cut off without a terminating null.
+  raw.append("text\r");
+
+  FileHelper helper;
+  const auto path = FilePath(helper.TempDir(), "raw.msg");
+  {
+    File w(path);
+    ASSERT_TRUE(w.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite));
+    ASSERT_EQ(static_cast<File::size_type>(raw.size()), w.Write(raw));
+  }
+  File f(path);
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+  FidoPackedMessage expected;
+  ASSERT_EQ(ReadNetPacketResponse::OK, read_packed_message(f, expected));
+
+  std::string_view data(raw);
+  fido_packed_message_view_t actual;
+  ASSERT_EQ(ReadNetPacketResponse::OK, parse_packed_message(data, actual));
+  EXPECT_TRUE(data.empty());
+  EXPECT_EQ(3, actual.nh.orig_node);
+  EXPECT_EQ(std::string("01 Jan\0 20  00:00", 17), expected.vh.date_time);
+  EXPECT_EQ(expected.vh.date_time, actual.date_time);
+  EXPECT_EQ(std::string(36, 'T'), expected.vh.to_user_name);
+  EXPECT_EQ(expected.vh.to_user_name, actual.to_user_name);
+  EXPECT_EQ(expected.vh.from_user_name, actual.from_user_name);
+  EXPECT_EQ(expected.vh.subject, actual.subject);
+  EXPECT_EQ("text\r", expected.vh.text);
+  EXPECT_EQ(expected.vh.text, actual.text);
+
+  EXPECT_EQ(ReadNetPacketResponse::END_OF_FILE, read_packed_message(f, expected));
+  EXPECT_EQ(ReadNetPacketResponse::END_OF_FILE, parse_packed_message(data, actual));
+}
+
+TEST(FidoPacketsTest, ReadLargePacket) {
+  constexpr int kNumMessages = 50000;
+  FileHelper helper;
+  const auto path = FilePath(helper.TempDir(), "00000002.pkt");
+  const auto header =
+      CreateType2PlusPacketHeader(FidoAddress("1:2/3"), FidoAddress("1:2/4"), DateTime::now(), "");
+  {
+    auto o = FidoPacket::Create(path, header);
+    ASSERT_TRUE(o.has_value());
+    fido_variable_length_header_t vh{};
+    vh.date_time = "01 Jan 20  00:00:00";
+    vh.to_user_name = "All";
+    vh.from_user_name = "Sysop";
+    vh.text = std::string(80, 'x').append("\r\001MSGID: 1:2/3 00000001\r");
+    fido_packed_message_t nh{};
+    nh.message_type = 2;
+    for (auto i = 0; i < kNumMessages; i++) {
+      vh.subject = std::to_string(i);
+      ASSERT_TRUE(o->Write(FidoPackedMessage(nh, vh)));
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  auto o = FidoPacket::Open(path);
+  ASSERT_TRUE(o.has_value());
+  auto count = 0;
+  for (;;) {
+    auto [result, msg] = o->ReadView();
+    if (result != ReadNetPacketResponse::OK) {
+      EXPECT_EQ(ReadNetPacketResponse::END_OF_FILE, result);
+      break;
+    }
+    ASSERT_EQ(std::to_string(count), msg.subject);
+    ++count;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  EXPECT_EQ(kNumMessages, count);
+  LOG(INFO) << "Read " << count << " messages in " << elapsed.count() << "ms";
+}
@@ -29,6 +29,8 @@
 #include "sdk/fido/fido_directories.h"
 #include "sdk/fido/fido_packets.h"
 #include "sdk/fido/flo_file.h"
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -194,10 +196,19 @@ std::string to_zone_net_node_point(const wwiv::sdk::fido::FidoAddress& a) {
 }
 
 std::vector<std::string> split_message(const std::string& s) {
-  std::string temp(s);
-  temp.erase(std::remove(temp.begin(), temp.end(), 10), temp.end());
-  temp.erase(std::remove(temp.begin(), temp.end(), '\x8d'), temp.end());
-  return SplitString(temp, "\r");
+  std::string temp;
+  std::vector<std::string_view> lines;
+  split_message(s, &temp, &lines);
+  return {lines.begin(), lines.end()};
+}
+
+void split_message(std::string_view text, std::string* buffer,
+                   std::vector<std::string_view>* lines) {
+  buffer->clear();
+  std::remove_copy_if(text.begin(), text.end(), std::back_inserter(*buffer),
+                      [](char c) { return c == 10 || c == '\x8d'; });
+  lines->clear();
+  SplitString(*buffer, "\r", true, lines);
 }
 
 /**
@@ -205,7 +216,7 @@ std::vector<std::string> split_message(const std::string& s) {
  */
 enum class FtnControlLineType { control_a, plain_control_line, none };
 
-static FtnControlLineType determine_kludge_line_type(const std::string& line) {
+static FtnControlLineType determine_kludge_line_type(std::string_view line) {
   if (line.empty()) {
     return FtnControlLineType::none;
   }
@@ -226,6 +237,7 @@ std::string FidoToWWIVText(const std::string& ft, bool convert_control_codes) {
   // Split text into lines and process one at a time
   // this is easier to handle control lines, etc.
   std::string wt;
+  wt.reserve(ft.size());
   for (const auto& sc : ft) {
     if (const auto c = static_cast<unsigned char>(sc); c == 0x8d) {
       // FIDOnet style Soft CR. Convert to CR
@@ -241,19 +253,20 @@ std::string FidoToWWIVText(const std::string& ft, bool convert_control_codes) {
     }
   }
 
-  auto lines = SplitString(wt, "\r", false);
-  wt.clear();
+  // Each line grows by at most a LF and a two character control code.
+  std::string out;
+  out.reserve(wt.size() + 3 * std::count(wt.begin(), wt.end(), '\r') + 3);
 
   if (!convert_control_codes) {
-    for (const auto& line : lines) {
-      wt.append(line).append("\r\n");
+    for (const auto line : SplitView(wt, "\r", false)) {
+      out.append(line).append("\r\n");
     }
-    return wt;
+    return out;
   }
 
-  for (auto line : lines) {
+  for (auto line : SplitView(wt, "\r", false)) {
     if (line.empty()) {
-      wt.append("\r\n");
+      out.append("\r\n");
       continue;
     }
 
@@ -261,21 +274,21 @@ std::string FidoToWWIVText(const std::string& ft, bool convert_control_codes) {
     // when reading messages.
     switch (determine_kludge_line_type(line)) {
     case FtnControlLineType::control_a: {
-      line = line.substr(1);
-      wt.push_back(4);
-      wt.push_back('0');
+      line.remove_prefix(1);
+      out.push_back(4);
+      out.push_back('0');
     } break;
     case FtnControlLineType::plain_control_line: {
-      wt.push_back(4);
-      wt.push_back('0');
+      out.push_back(4);
+      out.push_back('0');
     } break;
     case FtnControlLineType::none:
     default:
       break;
     }
-    wt.append(line).append("\r\n");
+    out.append(line).append("\r\n");
   }
-  return wt;
+  return out;
 }
 
 std::string WWIVToFidoText(const std::string& wt, const wwiv_to_fido_options& opts) {
@@ -292,9 +305,8 @@ std::string WWIVToFidoText(const std::string& wt, const wwiv_to_fido_options& op
 
   // Split this into lines, then we'll handle converting of
   // WWIV style control codes to FTN style kludges as needed.
-  const auto lines = SplitString(temp, "\r", false);
   std::ostringstream out;
-  for (auto line : lines) {
+  for (auto line : SplitView(temp, "\r", false)) {
     if (line.empty()) {
       // Handle the empty line case first. Everything else can assume non-empty now.
       out << "\r";
@@ -302,14 +314,14 @@ std::string WWIVToFidoText(const std::string& wt, const wwiv_to_fido_options& op
     }
     if (line.front() == 0x04 && line.size() > 2) {
       // WWIV style control code.
-      const auto code = at(line, 1);
+      const auto code = line[1];
       if (code < '0' || code > '9') {
         // Bogus control-D line, let's skip.
         VLOG(1) << "Invalid control-D line: '" << line << "'";
         continue;
       }
       // Strip WWIV control off.
-      line = line.substr(2);
+      line.remove_prefix(2);
       const int8_t code_num = code - '0';
       if (code == '0') {
         if (starts_with(line, "MSGID:") || starts_with(line, "REPLY:") ||
@@ -335,11 +347,11 @@ std::string WWIVToFidoText(const std::string& wt, const wwiv_to_fido_options& op
     }
     if (line.back() == 0x01 /* CA */) {
       // A line ending in ^A means it soft-wrapped.
-      line.pop_back();
+      line.remove_suffix(1);
     }
-    if (line.front() == 0x02 /* CB */) {
+    if (!line.empty() && line.front() == 0x02 /* CB */) {
       // Starting with CB is centered. Let's just strip it.
-      line = line.substr(1);
+      line.remove_prefix(1);
     }
 
     // Strip out WWIV color codes.
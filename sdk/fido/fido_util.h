@@ -27,6 +27,7 @@
 #include <ctime>
 #include <filesystem>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace wwiv::sdk::fido {
@@ -70,6 +71,13 @@ std::optional<FidoAddress> FindRouteToAddress(const FidoAddress& a, const FidoCa
 // FTN Text Handling
 /** Splits a message to find a specific line. This will strip blank lines. */
 std::vector<std::string> split_message(const std::string& string);
+/**
+ * Like split_message, but fills lines with views into buffer, which is set to
+ * the text without LFs and soft CRs.  Reusing buffer and lines between
+ * messages avoids allocating for each line.
+ */
+void split_message(std::string_view text, std::string* buffer,
+                   std::vector<std::string_view>* lines);
 
 /** Converts Ftn style text to WWIV style */
 std::string FidoToWWIVText(const std::string& ft, bool convert_control_codes = true);
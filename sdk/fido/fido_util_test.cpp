@@ -27,6 +27,8 @@
 #include <ctime>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::strings;
@@ -144,6 +146,18 @@ TEST_F(FidoUtilTest, FidoToWWIVText_ControlLine_DoNotConvert) {
             wwiv);
 }
 
+TEST_F(FidoUtilTest, SplitMessage) {
+  const std::string text = "AREA:A\r\n\r\n\001MSGID: 1\x8d\rHello\n World\r";
+  const std::vector<std::string> expected{"AREA:A", "\001MSGID: 1", "Hello World"};
+  EXPECT_EQ(expected, split_message(text));
+
+  // Reusing the buffers from a longer message.
+  std::string buffer = "0123456789012345678901234567890123456789";
+  std::vector<std::string_view> lines{"x", "y"};
+  split_message(text, &buffer, &lines);
+  EXPECT_EQ(expected, std::vector<std::string>(lines.begin(), lines.end()));
+}
+
 TEST_F(FidoUtilTest, WWIVToFido_Basic) {
   const std::string wwiv = "a\r\nb\r\n";
   const auto  fido = WWIVToFidoText(wwiv, opts);
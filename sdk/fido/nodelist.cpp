@@ -24,6 +24,7 @@
 #include "core/strings.h"
 #include "core/textfile.h"
 #include "fmt/printf.h"
+#include <iterator>
 #include <set>
 #include <string>
 #include <utility>
@@ -35,7 +36,7 @@ using namespace wwiv::stl;
 
 namespace wwiv::sdk::fido {
 
-static NodelistKeyword to_keyword(const std::string& k) {
+static NodelistKeyword to_keyword(std::string_view k) {
   if (k.empty()) {
     return NodelistKeyword::node;
   }
@@ -50,7 +51,7 @@ static NodelistKeyword to_keyword(const std::string& k) {
   return NodelistKeyword::node;
 }
 
-static inline bool bool_flag(const std::string& value, const std::string& flag_name, bool& f) {
+static inline bool bool_flag(std::string_view value, std::string_view flag_name, bool& f) {
   if (value == flag_name) {
     f = true;
     return true;
@@ -58,34 +59,38 @@ static inline bool bool_flag(const std::string& value, const std::string& flag_n
   return false;
 }
 
-static bool internet_flag(const std::string& value, const std::string& flag_name, bool& f, std::string& host, uint16_t& port) {
-  if (!contains(value, ':')) return false;
-  auto parts = SplitString(value, ":");
-  if (parts.size() > 3) return false;
+static bool internet_flag(std::string_view value, std::string_view flag_name, bool& f, std::string& host, uint16_t& port) {
+  if (value.find(':') == std::string_view::npos) return false;
+  const SplitView parts(value, ":");
+  const auto num_parts = std::distance(parts.begin(), parts.end());
+  if (num_parts == 0 || num_parts > 3) return false;
 
-  if (parts.front() == flag_name) {
+  auto it = parts.begin();
+  if (*it == flag_name) {
     f = true;
-    if (parts.size() > 1) {
-      port = to_number<uint16_t>(parts.back());
-    }
-    if (parts.size() == 3) {
+    if (num_parts == 3) {
       // flag:host:port
-      host = at(parts, 1);
+      host = *++it;
+    }
+    if (num_parts > 1) {
+      port = to_number<uint16_t>(std::string(*++it));
     }
     return true;
   }
   return false;
 }
 
-static bool bool_flag(const std::string& value, const std::string& flag_name, bool& f, std::string& fs) {
-  if (!contains(value, ':')) return false;
-  std::vector<std::string> parts = SplitString(value, ":");
-  if (parts.size() > 2) return false;
+static bool bool_flag(std::string_view value, std::string_view flag_name, bool& f, std::string& fs) {
+  if (value.find(':') == std::string_view::npos) return false;
+  const SplitView parts(value, ":");
+  const auto num_parts = std::distance(parts.begin(), parts.end());
+  if (num_parts == 0 || num_parts > 2) return false;
 
-  if (parts.front() == flag_name) {
+  auto it = parts.begin();
+  if (*it == flag_name) {
     f = true;
-    if (parts.size() > 1) {
-      fs = parts.back();
+    if (num_parts > 1) {
+      fs = *++it;
 //      StringTrim(&fs);
     }
     return true;
@@ -93,42 +98,43 @@ static bool bool_flag(const std::string& value, const std::string& flag_name, bo
   return false;
 }
 
-static std::string ToSpaces(const std::string& orig) {
+static std::string ToSpaces(std::string_view orig) {
   std::string s(orig);
   std::replace(std::begin(s), std::end(s), '_', ' ');
   return s;
 }
 
 //static 
-std::optional<NodelistEntry> NodelistEntry::ParseDataLine(const std::string& data_line) {
-  if (data_line.front() == ';') {
+std::optional<NodelistEntry> NodelistEntry::ParseDataLine(std::string_view data_line) {
+  if (data_line.empty() || data_line.front() == ';') {
     return std::nullopt;
   }
 
-  auto parts = SplitString(data_line, ",");
-  if (parts.size() < 6) {
+  // Walks the fields in place rather than copying each one into a vector.
+  const SplitView parts(data_line, ",");
+  if (std::distance(parts.begin(), parts.end()) < 6) {
     return std::nullopt;
   }
 
   NodelistEntry e{};
-  auto it = parts.cbegin();
+  auto it = parts.begin();
   if (data_line.front() == ',') {
     // We have no 1st field, default the keyword and skip the iterator.
     e.keyword_ = NodelistKeyword::node;
   } else {
     e.keyword_ = to_keyword(*it++);
   }
-  e.number_ = to_number<uint16_t>(*it++);
+  e.number_ = to_number<uint16_t>(std::string(*it++));
   e.name_ = ToSpaces(*it++);
   e.location_ = ToSpaces(*it++);
   e.sysop_name_ = ToSpaces(*it++);
   e.phone_number_ = *it++;
   if (it != parts.end()) {
-    e.baud_rate_ = to_number<unsigned int>(*it++);
+    e.baud_rate_ = to_number<unsigned int>(std::string(*it++));
   }
 
   while (it != parts.end()) {
-    const auto& f = *it++;
+    const auto f = *it++;
     if (bool_flag(f, "CM", e.cm_)) continue;
     if (bool_flag(f, "ICM", e.icm_)) continue;
     if (bool_flag(f, "MO", e.mo_)) continue;
@@ -175,7 +181,7 @@ bool Nodelist::AddEntry(uint16_t zone, uint16_t net, NodelistEntry& e) {
   return true;
 }
 
-bool Nodelist::HandleLine(const std::string& line, uint16_t& zone, uint16_t& region, uint16_t& net, uint16_t& hub) {
+bool Nodelist::HandleLine(std::string_view line, uint16_t& zone, uint16_t& region, uint16_t& net, uint16_t& hub) {
   if (line.empty()) return true;
   if (line.front() == ';') {
     // TODO(rushfan): Do we care to do anything with this?
@@ -238,8 +244,7 @@ bool Nodelist::Load(const std::vector<std::string>& lines) {
   uint16_t zone = 0, region = 0, net = 0, hub = 0;
   // ReSharper restore CppTooWideScope
   for (const auto& raw_line : lines) {
-    auto line = StringTrim(raw_line);
-    HandleLine(line, zone, region, net, hub);
+    HandleLine(StringTrimView(raw_line), zone, region, net, hub);
   }
   return true;
 }
@@ -23,6 +23,7 @@
 #include <filesystem>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -47,7 +48,7 @@ public:
   NodelistEntry() = default;
   ~NodelistEntry() = default;
 
-  static std::optional<NodelistEntry> ParseDataLine(const std::string& data_line);
+  static std::optional<NodelistEntry> ParseDataLine(std::string_view data_line);
 
   [[nodiscard]] FidoAddress address() const { return address_; }
   void address(const FidoAddress& a) { address_ = a; }
@@ -160,7 +161,7 @@ private:
   bool Load(const std::vector<std::string>& lines);
 
   bool AddEntry(uint16_t zone, uint16_t net, NodelistEntry& e);
-  bool HandleLine(const std::string& line, uint16_t& zone, uint16_t& region, uint16_t& net, uint16_t& hub );
+  bool HandleLine(std::string_view line, uint16_t& zone, uint16_t& region, uint16_t& net, uint16_t& hub );
   
   std::map<FidoAddress, NodelistEntry> entries_;
   std::string domain_;
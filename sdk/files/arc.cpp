@@ -24,8 +24,12 @@
 #include "sdk/filenames.h"
 #include "sdk/vardec.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
+#include <utility>
 #include <vector>
+#include <zlib.h>
 
 using namespace wwiv::core;
 using namespace wwiv::strings;
@@ -179,6 +183,125 @@ list_archive_zip(const std::filesystem::path& path) {
   return {files};
 }
 
+// Finds the end of central directory record, which is followed by a comment
+// of up to 64k.
+static std::optional<zip_end_dir> find_zip_end_dir(File& file) {
+  const auto len = file.length();
+  const auto tail_len = std::min<File::size_type>(len, sizeof(zip_end_dir) + 0xffff);
+  if (tail_len < static_cast<File::size_type>(sizeof(zip_end_dir))) {
+    return std::nullopt;
+  }
+  std::string tail(tail_len, '\0');
+  file.Seek(len - tail_len, File::Whence::begin);
+  if (file.Read(&tail[0], tail_len) != tail_len) {
+    return std::nullopt;
+  }
+  for (auto i = tail_len - static_cast<File::size_type>(sizeof(zip_end_dir)); i >= 0; i--) {
+    uint32_t sig;
+    memcpy(&sig, &tail[i], sizeof(sig));
+    if (sig == ZIP_CENT_END_SIG) {
+      zip_end_dir end{};
+      memcpy(&end, &tail[i], sizeof(end));
+      return end;
+    }
+  }
+  return std::nullopt;
+}
+
+static std::optional<std::string> inflate_zip_member(const std::string& compressed,
+                                                     uint32_t uncompressed_size) {
+  std::string out(uncompressed_size, '\0');
+  if (out.empty()) {
+    return out;
+  }
+  z_stream zs{};
+  // Negative window bits for a raw deflate stream with no zlib header.
+  if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+    return std::nullopt;
+  }
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+  zs.avail_in = static_cast<uInt>(compressed.size());
+  zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+  zs.avail_out = static_cast<uInt>(out.size());
+  const auto ret = inflate(&zs, Z_FINISH);
+  const auto total_out = zs.total_out;
+  inflateEnd(&zs);
+  if (ret != Z_STREAM_END || total_out != uncompressed_size) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+static std::optional<std::string> extract_zip_member(const std::filesystem::path& path,
+                                                     const std::string& member, int max_size) {
+  File file(path);
+  if (!file.Open(File::modeBinary | File::modeReadOnly)) {
+    return std::nullopt;
+  }
+  const auto end = find_zip_end_dir(file);
+  if (!end) {
+    VLOG(1) << "No ZIP central directory in: " << path;
+    return std::nullopt;
+  }
+
+  std::string dir(end->central_dir_size, '\0');
+  file.Seek(end->ofs_cent_dir, File::Whence::begin);
+  if (file.Read(&dir[0], ssize(dir)) != ssize(dir)) {
+    return std::nullopt;
+  }
+  for (size_t pos = 0; pos + sizeof(zip_central_dir) <= dir.size();) {
+    zip_central_dir zc{};
+    memcpy(&zc, &dir[pos], sizeof(zc));
+    if (zc.signature != ZIP_CENT_START_SIG) {
+      return std::nullopt;
+    }
+    pos += sizeof(zc);
+    const auto fn = dir.substr(pos, zc.filename_len);
+    pos += zc.filename_len + zc.extra_len + zc.comment_len;
+    if (!iequals(fn, member)) {
+      continue;
+    }
+    // Bit 0 of the flags means the member is encrypted.
+    if ((zc.flags & 0x01) || zip_method(zc.comp_meth) == archive_method_t::UNKNOWN) {
+      VLOG(1) << "Unable to extract " << fn << " from: " << path << "; method: " << zc.comp_meth;
+      return std::nullopt;
+    }
+    if (zc.uncomp_size > static_cast<uint32_t>(max_size)) {
+      VLOG(1) << "Not extracting " << fn << " from: " << path << "; size: " << zc.uncomp_size;
+      return std::nullopt;
+    }
+
+    zip_local_header zl{};
+    file.Seek(zc.rel_ofs_header, File::Whence::begin);
+    if (file.Read(&zl, sizeof(zl)) != sizeof(zl) || zl.signature != ZIP_LOCAL_SIG) {
+      return std::nullopt;
+    }
+    // The sizes in the local header may be 0 when a data descriptor follows
+    // the data, so use the ones from the central directory.
+    file.Seek(zl.filename_len + zl.extra_length, File::Whence::current);
+    std::string data(zc.comp_size, '\0');
+    if (!data.empty() && file.Read(&data[0], ssize(data)) != ssize(data)) {
+      return std::nullopt;
+    }
+    if (zip_method(zc.comp_meth) == archive_method_t::ZIP_DEFLATED) {
+      auto o = inflate_zip_member(data, zc.uncomp_size);
+      if (!o) {
+        LOG(ERROR) << "Error inflating " << fn << " from: " << path;
+        return std::nullopt;
+      }
+      data = std::move(o.value());
+    }
+    if (data.size() != zc.uncomp_size ||
+        crc32(0L, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())) !=
+            zc.crc_32) {
+      LOG(ERROR) << "CRC mismatch on " << fn << " from: " << path;
+      return std::nullopt;
+    }
+    return data;
+  }
+  return std::nullopt;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // ARC FILE
 // http://fileformats.archiveteam.org/wiki/ARC_(compression_format)
@@ -514,6 +637,19 @@ std::optional<std::vector<archive_entry_t>> list_archive(const std::filesystem::
   return std::nullopt;
 }
 
+bool can_extract_archive_member(const std::filesystem::path& path) {
+  const auto ext = determine_arc_extension(path);
+  return ext.has_value() && ext.value() == "ZIP";
+}
+
+std::optional<std::string> extract_archive_member(const std::filesystem::path& path,
+                                                  const std::string& member, int max_size) {
+  if (!can_extract_archive_member(path)) {
+    return std::nullopt;
+  }
+  return extract_zip_member(path, member, max_size);
+}
+
 // One thing to note, if an 'arc' is found, it uses pak, and returns that
 // The reason being, PAK does all ARC does, plus a little more, I believe
 // PAK has its own special modes, but still look like an ARC, thus, an ARC
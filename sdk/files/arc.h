@@ -55,6 +55,22 @@ std::vector<arcrec> read_arcs(const std::filesystem::path& datadir);
  */
 std::optional<std::vector<archive_entry_t>> list_archive(const std::filesystem::path& path);
 
+/**
+ * Returns true if extract_archive_member is able to read members of the archive
+ * identified by path.  Only ZIP files are supported.
+ */
+bool can_extract_archive_member(const std::filesystem::path& path);
+
+/**
+ * Returns the contents of the file named member, compared case insensitively,
+ * from the archive identified by path without extracting it to disk.  Returns
+ * std::nullopt if the member does not exist, is larger than max_size, or uses
+ * a compression method other than stored or deflated.
+ */
+std::optional<std::string> extract_archive_member(const std::filesystem::path& path,
+                                                  const std::string& member,
+                                                  int max_size = 1024 * 1024);
+
 /**
  * Returns the arc extension for the file identified by filename or std::nullopt of none
  * could be determined.  The contents of the file are checked first and if there is no
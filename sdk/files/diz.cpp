@@ -21,7 +21,11 @@
 #include "core/log.h"
 #include "core/strings.h"
 #include "core/textfile.h"
+#include "sdk/filenames.h"
+#include "sdk/files/arc.h"
+#include <cstring>
 #include <utility>
+#include <vector>
 
 static const char* invalid_chars = "ڿĳôɻȼͺ̹ոԾͳƵַӽĺǶװ";
 
@@ -63,10 +67,45 @@ std::optional<wwiv::sdk::files::Diz> wwiv::sdk::files::DizParser::parse(
     return std::nullopt;
   }
 
+  TextFile file(path, "rt");
+  return parse_lines(file.ReadFileIntoVector());
+}
+
+std::optional<wwiv::sdk::files::Diz>
+wwiv::sdk::files::DizParser::parse_text(const std::string& text) const {
+  // Split the same way TextFile::ReadLine does.
+  std::vector<std::string> lines;
+  for (std::string::size_type start = 0; start < text.size();) {
+    auto end = text.find('\n', start);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    auto line = text.substr(start, end - start);
+    line.resize(strnlen(line.c_str(), line.size()));
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) {
+      line.pop_back();
+    }
+    lines.emplace_back(std::move(line));
+    start = end + 1;
+  }
+  return parse_lines(lines);
+}
+
+std::optional<wwiv::sdk::files::Diz>
+wwiv::sdk::files::DizParser::parse_archive(const std::filesystem::path& path) const {
+  for (const auto* name : {FILE_ID_DIZ, DESC_SDI}) {
+    if (auto o = extract_archive_member(path, name)) {
+      VLOG(1) << "Found " << name << " in: " << path;
+      return parse_text(o.value());
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<wwiv::sdk::files::Diz>
+wwiv::sdk::files::DizParser::parse_lines(const std::vector<std::string>& lines) const {
   std::string description;
 
-  TextFile file(path, "rt");
-  auto lines = file.ReadFileIntoVector();
   auto iter = std::begin(lines);
   const auto end = std::end(lines);
   while (iter != end && iter->empty()) {
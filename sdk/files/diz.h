@@ -21,6 +21,7 @@
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace wwiv::sdk::files {
 
@@ -44,7 +45,17 @@ public:
   ~DizParser() = default;
 
   [[nodiscard]] std::optional<Diz> parse(const std::filesystem::path& path) const;
+  /** Parses the contents of a DIZ file. */
+  [[nodiscard]] std::optional<Diz> parse_text(const std::string& text) const;
+  /**
+   * Parses FILE_ID.DIZ or DESC.SDI read directly from the archive at path,
+   * see extract_archive_member for the archives supported.
+   */
+  [[nodiscard]] std::optional<Diz> parse_archive(const std::filesystem::path& path) const;
+
 private:
+  [[nodiscard]] std::optional<Diz> parse_lines(const std::vector<std::string>& lines) const;
+
   bool firstline_as_desc_;
 };
 
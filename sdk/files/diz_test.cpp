@@ -16,12 +16,15 @@
 /*    language governing permissions and limitations under the License.   */
 /*                                                                        */
 /**************************************************************************/
+#include "core/file.h"
 #include "core/log.h"
 #include "core/strings.h"
 
 #include "gtest/gtest.h"
 
 #include "core/test/file_helper.h"
+#include "core/test/wwivtest.h"
+#include "sdk/files/arc.h"
 #include "sdk/files/diz.h"
 
 class DizTest : public testing::Test {
@@ -112,6 +115,48 @@ TEST_F(DizTest, EmptyLinesAtStart) {
   EXPECT_EQ(d.description(), "<<< null e-magazine x00A (exec edition) >>>");
 }
 
+TEST_F(DizTest, ParseText_SameAsParse) {
+  const std::string kDIZ = "\r\nLine1\r\nLine2\r\n\r\nLine3";
+  const auto file = helper.CreateTempFile("FILE_ID.DIZ", kDIZ);
+
+  wwiv::sdk::files::DizParser p(true);
+  auto expected = p.parse(file);
+  auto actual = p.parse_text(kDIZ);
+  ASSERT_TRUE(expected);
+  ASSERT_TRUE(actual);
+  EXPECT_EQ(expected->description(), actual->description());
+  EXPECT_EQ(expected->extended_description(), actual->extended_description());
+  EXPECT_EQ("Line1", actual->description());
+  EXPECT_EQ("Line2\n\nLine3\n", actual->extended_description());
+}
+
+class DizArchiveTest : public wwiv::core::test::TestDataTest {};
+
+TEST_F(DizArchiveTest, Deflated) {
+  const auto path = wwiv::core::FilePath(wwiv::core::test::FileHelper::TestData(), "files/diz.zip");
+  wwiv::sdk::files::DizParser p(true);
+  auto o = p.parse_archive(path);
+  ASSERT_TRUE(o);
+  EXPECT_EQ("Test Program v1.0", o->description());
+  EXPECT_EQ("A program used to test\nreading FILE_ID.DIZ.\n", o->extended_description());
+}
+
+TEST_F(DizArchiveTest, ExtractArchiveMember) {
+  const auto path = wwiv::core::FilePath(wwiv::core::test::FileHelper::TestData(), "files/diz.zip");
+  EXPECT_EQ("readme\r\n", wwiv::sdk::files::extract_archive_member(path, "readme.txt").value_or(""));
+  EXPECT_FALSE(wwiv::sdk::files::extract_archive_member(path, "MISSING.TXT"));
+  // Larger than the maximum size allowed.
+  EXPECT_FALSE(wwiv::sdk::files::extract_archive_member(path, "FILE_ID.DIZ", 10));
+}
+
+TEST_F(DizArchiveTest, Stored_DescSdi) {
+  const auto path = wwiv::core::FilePath(wwiv::core::test::FileHelper::TestData(), "files/sdi.zip");
+  wwiv::sdk::files::DizParser p(true);
+  auto o = p.parse_archive(path);
+  ASSERT_TRUE(o);
+  EXPECT_EQ("Stored SDI", o->description());
+}
+
 /**
 
 
@@ -24,6 +24,7 @@
 #include "core/log.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/trace.h"
 #include "sdk/vardec.h"
 #include "sdk/files/files_ext.h"
 #include <algorithm>
@@ -145,6 +146,7 @@ FileAreaHeader& FileArea::header() const {
 }
 
 bool FileArea::Load() {
+  TraceSpan span("files", "Load");
   dirty_ = false;
 
   if (auto file = DataFile<uploadsrec>(path(), File::modeReadOnly | File::modeBinary)) {
@@ -389,6 +391,7 @@ std::optional<int> FileArea::FindFile(const FileName& f) {
 }
 
 std::optional<int> FileArea::FindFile(const std::string& file_name) {
+  TraceSpan span("files", "FindFile");
   for (auto i = 0; i < stl::ssize(files_); i++) {
     if (const auto & c = stl::at(files_, i); file_name == c.filename) {
       return {i};
@@ -425,6 +428,7 @@ std::optional<int> FileArea::SearchFile(const std::string& filemask, int start_n
 
 
 bool FileArea::Save() {
+  TraceSpan span("files", "Save");
   DataFile<uploadsrec> file(path(), File::modeReadWrite | File::modeCreateFile | File::modeBinary);
 
   if (!file) {
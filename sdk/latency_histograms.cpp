@@ -0,0 +1,304 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "sdk/latency_histograms.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/trace.h"
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <tuple>
+
+#if !defined(_WIN32) && !defined(__OS2__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define WWIV_SHARED_LATENCY_HISTOGRAMS
+#endif
+
+using namespace wwiv::core;
+
+namespace wwiv::sdk {
+
+// Shared between processes, so these must not need a lock.
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+static constexpr char kMagic[4] = {'W', 'L', 'A', 'T'};
+static constexpr uint32_t kVersion = 1;
+
+// States of a histogram slot.
+static constexpr uint32_t kSlotEmpty = 0;
+static constexpr uint32_t kSlotClaimed = 1;
+static constexpr uint32_t kSlotReady = 2;
+
+struct latency_histogram_shm_t {
+  std::atomic<uint32_t> state;
+  char source[16];
+  char category[16];
+  char name[40];
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> sum_ns;
+  std::atomic<uint64_t> buckets[kNumLatencyBuckets];
+};
+
+struct latency_histograms_shm_t {
+  char magic[4];
+  uint32_t version;
+  latency_histogram_shm_t histograms[SharedLatencyHistograms::max_histograms];
+};
+
+static constexpr int64_t kFirstBucketBoundNs = 16 * 1000;
+
+int64_t latency_bucket_bound_ns(int b) {
+  if (b >= kNumLatencyBuckets - 1) {
+    return -1;
+  }
+  return kFirstBucketBoundNs << b;
+}
+
+int latency_bucket(int64_t duration_ns) {
+  for (auto b = 0; b < kNumLatencyBuckets - 1; b++) {
+    if (duration_ns <= latency_bucket_bound_ns(b)) {
+      return b;
+    }
+  }
+  return kNumLatencyBuckets - 1;
+}
+
+std::filesystem::path latency_histograms_filename(const std::filesystem::path& datadir) {
+  return FilePath(datadir, "metrics.shm");
+}
+
+SharedLatencyHistograms::SharedLatencyHistograms(latency_histograms_shm_t* shm) : shm_(shm) {}
+
+SharedLatencyHistograms::~SharedLatencyHistograms() {
+#ifdef WWIV_SHARED_LATENCY_HISTOGRAMS
+  munmap(shm_, sizeof(latency_histograms_shm_t));
+#endif
+}
+
+std::unique_ptr<SharedLatencyHistograms>
+SharedLatencyHistograms::Open(const std::filesystem::path& datadir) {
+#ifdef WWIV_SHARED_LATENCY_HISTOGRAMS
+  const auto path = latency_histograms_filename(datadir);
+  const auto fd = open(path.string().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0660);
+  if (fd < 0) {
+    VLOG(1) << "Unable to open " << path << "; errno: " << errno;
+    return nullptr;
+  }
+  // Only one process creates the histograms.
+  flock(fd, LOCK_EX);
+  struct stat st {};
+  if (fstat(fd, &st) != 0 ||
+      (st.st_size < static_cast<off_t>(sizeof(latency_histograms_shm_t)) &&
+       ftruncate(fd, sizeof(latency_histograms_shm_t)) != 0)) {
+    LOG(ERROR) << "Unable to size " << path << "; errno: " << errno;
+    flock(fd, LOCK_UN);
+    close(fd);
+    return nullptr;
+  }
+  auto* m =
+      mmap(nullptr, sizeof(latency_histograms_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (m == MAP_FAILED) {
+    LOG(ERROR) << "Unable to map " << path << "; errno: " << errno;
+    flock(fd, LOCK_UN);
+    close(fd);
+    return nullptr;
+  }
+  auto* shm = static_cast<latency_histograms_shm_t*>(m);
+  if (memcmp(shm->magic, kMagic, sizeof(kMagic)) != 0 || shm->version != kVersion) {
+    VLOG(1) << "Creating shared latency histograms: " << path;
+    memset(static_cast<void*>(shm), 0, sizeof(latency_histograms_shm_t));
+    shm->version = kVersion;
+    memcpy(shm->magic, kMagic, sizeof(kMagic));
+  }
+  flock(fd, LOCK_UN);
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  return std::unique_ptr<SharedLatencyHistograms>(new SharedLatencyHistograms(shm));
+#else
+  VLOG(2) << "Shared latency histograms are not supported for: " << datadir;
+  return nullptr;
+#endif
+}
+
+template <size_t N> static void copy_truncated(std::string_view s, char (&dest)[N]) {
+  const auto len = std::min(s.size(), N - 1);
+  memcpy(dest, s.data(), len);
+  dest[len] = '\0';
+}
+
+template <size_t N> static bool equals_truncated(std::string_view s, const char (&field)[N]) {
+  return s.substr(0, N - 1) == std::string_view(field, strnlen(field, N));
+}
+
+// Every process must probe from the same slot, so this can't be std::hash.
+static uint32_t fnv1a(const std::string& s) {
+  uint32_t h = 2166136261u;
+  for (const auto c : s) {
+    h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return h;
+}
+
+latency_histogram_shm_t* SharedLatencyHistograms::Find(std::string_view source,
+                                                       std::string_view category,
+                                                       std::string_view name) {
+  std::string key(source);
+  key.push_back('\0');
+  key.append(category);
+  key.push_back('\0');
+  key.append(name);
+  if (const auto it = cache_.find(key); it != cache_.end()) {
+    return it->second;
+  }
+
+  const auto matches = [&](const latency_histogram_shm_t& h) {
+    return equals_truncated(source, h.source) && equals_truncated(category, h.category) &&
+           equals_truncated(name, h.name);
+  };
+  const auto start = fnv1a(key) % max_histograms;
+  for (auto i = 0; i < max_histograms; i++) {
+    auto& h = shm_->histograms[(start + i) % max_histograms];
+    auto state = h.state.load(std::memory_order_acquire);
+    if (state == kSlotEmpty &&
+        h.state.compare_exchange_strong(state, kSlotClaimed, std::memory_order_acquire)) {
+      copy_truncated(source, h.source);
+      copy_truncated(category, h.category);
+      copy_truncated(name, h.name);
+      h.state.store(kSlotReady, std::memory_order_release);
+      cache_.emplace(key, &h);
+      return &h;
+    }
+    // Another process is naming this slot; it will be done shortly.  Give up
+    // on it eventually in case that process died part way through.
+    for (auto spins = 0; state == kSlotClaimed && spins < 1000; spins++) {
+      std::this_thread::yield();
+      state = h.state.load(std::memory_order_acquire);
+    }
+    if (state == kSlotReady && matches(h)) {
+      cache_.emplace(key, &h);
+      return &h;
+    }
+  }
+  return nullptr;
+}
+
+bool SharedLatencyHistograms::Record(std::string_view source, std::string_view category,
+                                     std::string_view name, int64_t duration_ns) {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto* h = Find(source, category, name);
+  if (h == nullptr) {
+    return false;
+  }
+  const auto d = static_cast<uint64_t>(std::max<int64_t>(duration_ns, 0));
+  h->count.fetch_add(1, std::memory_order_relaxed);
+  h->sum_ns.fetch_add(d, std::memory_order_relaxed);
+  h->buckets[latency_bucket(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+std::vector<latency_histogram_t> SharedLatencyHistograms::histograms() const {
+  std::vector<latency_histogram_t> result;
+  for (const auto& h : shm_->histograms) {
+    if (h.state.load(std::memory_order_acquire) != kSlotReady) {
+      continue;
+    }
+    latency_histogram_t l;
+    l.source = std::string(h.source, strnlen(h.source, sizeof(h.source)));
+    l.category = std::string(h.category, strnlen(h.category, sizeof(h.category)));
+    l.name = std::string(h.name, strnlen(h.name, sizeof(h.name)));
+    l.count = h.count.load(std::memory_order_relaxed);
+    l.sum_ns = h.sum_ns.load(std::memory_order_relaxed);
+    for (auto b = 0; b < kNumLatencyBuckets; b++) {
+      l.buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+    }
+    result.emplace_back(std::move(l));
+  }
+  std::sort(result.begin(), result.end(), [](const auto& l, const auto& r) {
+    return std::tie(l.source, l.category, l.name) < std::tie(r.source, r.category, r.name);
+  });
+  return result;
+}
+
+static std::string escape_label(const std::string& s) {
+  std::string out;
+  for (const auto c : s) {
+    if (c == '\\' || c == '"') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (c == '\n') {
+      out.append("\\n");
+    } else {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+
+std::string to_prometheus_text(const std::vector<latency_histogram_t>& histograms) {
+  static const std::string kMetric = "wwiv_span_duration_seconds";
+  std::string out;
+  out.append(fmt::format("# HELP {} Latency of traced BBS commands and operations.\n", kMetric));
+  out.append(fmt::format("# TYPE {} histogram\n", kMetric));
+  for (const auto& h : histograms) {
+    const auto labels =
+        fmt::format(R"(source="{}",category="{}",name="{}")", escape_label(h.source),
+                    escape_label(h.category), escape_label(h.name));
+    // Prometheus buckets are cumulative.
+    uint64_t cumulative = 0;
+    for (auto b = 0; b < kNumLatencyBuckets; b++) {
+      cumulative += h.buckets[b];
+      const auto bound = latency_bucket_bound_ns(b);
+      const auto le = bound < 0 ? std::string("+Inf") : fmt::format("{}", bound / 1e9);
+      out.append(fmt::format("{}_bucket{{{},le=\"{}\"}} {}\n", kMetric, labels, le, cumulative));
+    }
+    out.append(fmt::format("{}_sum{{{}}} {}\n", kMetric, labels, h.sum_ns / 1e9));
+    out.append(fmt::format("{}_count{{{}}} {}\n", kMetric, labels, h.count));
+  }
+  return out;
+}
+
+static std::unique_ptr<SharedLatencyHistograms> tracing_histograms;
+static std::string tracing_source;
+
+static void record_span(const trace_span_t& span) {
+  tracing_histograms->Record(tracing_source, span.category, span.name, span.duration_ns);
+}
+
+bool EnableTracing(const std::filesystem::path& datadir, const std::string& source) {
+  set_trace_sink(nullptr);
+  tracing_source = source;
+  tracing_histograms = SharedLatencyHistograms::Open(datadir);
+  if (tracing_histograms) {
+    set_trace_sink(record_span);
+  }
+  set_tracing_enabled(true);
+  return tracing_histograms != nullptr;
+}
+
+} // namespace wwiv::sdk
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_LATENCY_HISTOGRAMS_H
+#define INCLUDED_SDK_LATENCY_HISTOGRAMS_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace wwiv::sdk {
+
+struct latency_histograms_shm_t;
+struct latency_histogram_shm_t;
+
+static constexpr int kNumLatencyBuckets = 20;
+
+/**
+ * Upper bound of latency bucket b in nanoseconds.  They double from 16us
+ * up to ~4s, and the last bucket has no upper bound (returns -1).
+ */
+[[nodiscard]] int64_t latency_bucket_bound_ns(int b);
+
+/** Returns the bucket for a span of duration_ns. */
+[[nodiscard]] int latency_bucket(int64_t duration_ns);
+
+/** Copy of one histogram from SharedLatencyHistograms. */
+struct latency_histogram_t {
+  // Process that recorded the spans, i.e. "node1" or "network2".
+  std::string source;
+  std::string category;
+  std::string name;
+  uint64_t count{0};
+  uint64_t sum_ns{0};
+  // Number of spans in each bucket (not cumulative).
+  std::array<uint64_t, kNumLatencyBuckets> buckets{};
+};
+
+/**
+ * Latency histograms of trace spans, keyed by the recording process and
+ * the span's category and name, kept in a file mapped into the memory of
+ * every process using the data directory (as metrics.shm) so that wwivd
+ * can publish them.
+ */
+class SharedLatencyHistograms final {
+public:
+  static constexpr int max_histograms = 256;
+
+  ~SharedLatencyHistograms();
+
+  /**
+   * Maps the shared histograms for datadir, creating them if needed.
+   * Returns nullptr if they can not be used on this platform or the
+   * mapping fails.
+   */
+  static std::unique_ptr<SharedLatencyHistograms> Open(const std::filesystem::path& datadir);
+
+  /** Adds a span to its histogram. Returns false if there's no room for a new one. */
+  bool Record(std::string_view source, std::string_view category, std::string_view name,
+              int64_t duration_ns);
+
+  [[nodiscard]] std::vector<latency_histogram_t> histograms() const;
+
+private:
+  explicit SharedLatencyHistograms(latency_histograms_shm_t* shm);
+  latency_histogram_shm_t* Find(std::string_view source, std::string_view category,
+                                std::string_view name);
+
+  latency_histograms_shm_t* shm_;
+  std::mutex mu_;
+  // Histograms already found by this process, by source, category and name.
+  std::unordered_map<std::string, latency_histogram_shm_t*> cache_;
+};
+
+/** Filename of the shared histograms in the data directory. */
+std::filesystem::path latency_histograms_filename(const std::filesystem::path& datadir);
+
+/** Returns the histograms in the Prometheus text exposition format. */
+std::string to_prometheus_text(const std::vector<latency_histogram_t>& histograms);
+
+/**
+ * Turns on tracing for this process and records every completed span into
+ * the shared histograms for datadir, labelled with source.  Returns false if
+ * the histograms can't be used, in which case tracing is still enabled so
+ * the spans may be dumped.
+ */
+bool EnableTracing(const std::filesystem::path& datadir, const std::string& source);
+
+} // namespace wwiv::sdk
+
+#endif
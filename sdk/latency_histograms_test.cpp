@@ -0,0 +1,132 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/test/file_helper.h"
+#include "sdk/latency_histograms.h"
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+
+TEST(LatencyBucketTest, Bounds) {
+  EXPECT_EQ(16000, latency_bucket_bound_ns(0));
+  EXPECT_EQ(32000, latency_bucket_bound_ns(1));
+  EXPECT_EQ(-1, latency_bucket_bound_ns(kNumLatencyBuckets - 1));
+
+  EXPECT_EQ(0, latency_bucket(0));
+  EXPECT_EQ(0, latency_bucket(16000));
+  EXPECT_EQ(1, latency_bucket(16001));
+  EXPECT_EQ(kNumLatencyBuckets - 1, latency_bucket(60LL * 1000 * 1000 * 1000));
+}
+
+TEST(LatencyHistogramsTest, Prometheus) {
+  latency_histogram_t h;
+  h.source = "node1";
+  h.category = "menu";
+  h.name = "Say \"hi\"";
+  h.count = 3;
+  h.sum_ns = 1500000000;
+  h.buckets[0] = 1;
+  h.buckets[2] = 1;
+  h.buckets[kNumLatencyBuckets - 1] = 1;
+  const auto text = to_prometheus_text({h});
+  const std::string labels = R"(source="node1",category="menu",name="Say \"hi\"")";
+  EXPECT_NE(std::string::npos, text.find("# TYPE wwiv_span_duration_seconds histogram\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("wwiv_span_duration_seconds_bucket{" + labels + ",le=\"1.6e-05\"} 1\n"))
+      << text;
+  EXPECT_NE(std::string::npos,
+            text.find("wwiv_span_duration_seconds_bucket{" + labels + ",le=\"3.2e-05\"} 1\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("wwiv_span_duration_seconds_bucket{" + labels + ",le=\"6.4e-05\"} 2\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("wwiv_span_duration_seconds_bucket{" + labels + ",le=\"+Inf\"} 3\n"));
+  EXPECT_NE(std::string::npos, text.find("wwiv_span_duration_seconds_sum{" + labels + "} 1.5\n"));
+  EXPECT_NE(std::string::npos, text.find("wwiv_span_duration_seconds_count{" + labels + "} 3\n"));
+}
+
+#ifndef _WIN32
+
+TEST(LatencyHistogramsTest, Record) {
+  test::FileHelper helper;
+  auto h = SharedLatencyHistograms::Open(helper.TempDir());
+  ASSERT_TRUE(h);
+  ASSERT_TRUE(h->Record("node1", "menu", "ReadMessages", 10000));
+  ASSERT_TRUE(h->Record("node1", "menu", "ReadMessages", 20000));
+  ASSERT_TRUE(h->Record("node1", "files", "Save", 5000));
+
+  const auto all = h->histograms();
+  ASSERT_EQ(2u, all.size());
+  EXPECT_EQ("files", all[0].category);
+  EXPECT_EQ(1u, all[0].count);
+  EXPECT_EQ("node1", all[1].source);
+  EXPECT_EQ("menu", all[1].category);
+  EXPECT_EQ("ReadMessages", all[1].name);
+  EXPECT_EQ(2u, all[1].count);
+  EXPECT_EQ(30000u, all[1].sum_ns);
+  EXPECT_EQ(1u, all[1].buckets[0]);
+  EXPECT_EQ(1u, all[1].buckets[1]);
+}
+
+TEST(LatencyHistogramsTest, SharedBetweenProcesses) {
+  test::FileHelper helper;
+  auto node1 = SharedLatencyHistograms::Open(helper.TempDir());
+  auto wwivd = SharedLatencyHistograms::Open(helper.TempDir());
+  ASSERT_TRUE(node1);
+  ASSERT_TRUE(wwivd);
+  ASSERT_TRUE(node1->Record("node1", "menu", "Logoff", 1000));
+  ASSERT_TRUE(wwivd->Record("node1", "menu", "Logoff", 1000));
+  ASSERT_TRUE(node1->Record("node2", "menu", "Logoff", 1000));
+
+  const auto all = wwivd->histograms();
+  ASSERT_EQ(2u, all.size());
+  EXPECT_EQ("node1", all[0].source);
+  EXPECT_EQ(2u, all[0].count);
+  EXPECT_EQ("node2", all[1].source);
+  EXPECT_EQ(1u, all[1].count);
+}
+
+TEST(LatencyHistogramsTest, LongNamesAreTruncated) {
+  test::FileHelper helper;
+  auto h = SharedLatencyHistograms::Open(helper.TempDir());
+  ASSERT_TRUE(h);
+  const std::string name(100, 'x');
+  ASSERT_TRUE(h->Record("node1", "menu", name, 1000));
+  auto other = SharedLatencyHistograms::Open(helper.TempDir());
+  ASSERT_TRUE(other->Record("node1", "menu", name, 1000));
+
+  const auto all = h->histograms();
+  ASSERT_EQ(1u, all.size());
+  EXPECT_EQ(2u, all[0].count);
+  EXPECT_EQ(39u, all[0].name.size());
+}
+
+TEST(LatencyHistogramsTest, Full) {
+  test::FileHelper helper;
+  auto h = SharedLatencyHistograms::Open(helper.TempDir());
+  ASSERT_TRUE(h);
+  for (auto i = 0; i < SharedLatencyHistograms::max_histograms; i++) {
+    ASSERT_TRUE(h->Record("node1", "test", std::to_string(i), 1000));
+  }
+  EXPECT_FALSE(h->Record("node1", "test", "one too many", 1000));
+  EXPECT_TRUE(h->Record("node1", "test", "0", 1000));
+}
+
+#endif
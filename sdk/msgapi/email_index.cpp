@@ -0,0 +1,414 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "sdk/msgapi/email_index.h"
+
+#include "core/datafile.h"
+#include "core/log.h"
+#include "core/stl.h"
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+namespace wwiv::sdk::msgapi {
+
+using namespace wwiv::core;
+using namespace wwiv::stl;
+
+namespace {
+
+// "WEIX" - Used to make sure this is an email index.
+constexpr char kEmailIndexMagic[4] = {'W', 'E', 'I', 'X'};
+constexpr uint32_t kEmailIndexVersion = 1;
+
+// The network pseudo-user that network mail is from.
+constexpr uint16_t kNetworkUser = 65535;
+
+#pragma pack(push, 1)
+struct email_index_header_t {
+  char magic[4];
+  uint32_t version;
+  // Size and modification time of email.dat when the index was written.
+  uint64_t dat_size;
+  int64_t dat_mtime;
+  uint32_t num_users;
+  uint32_t num_to;
+  uint32_t num_from;
+  uint32_t reserved;
+};
+
+// Indexes into the to and from record number tables that follow the users.
+struct email_index_user_t {
+  uint32_t to_first;
+  uint32_t to_count;
+  uint32_t from_first;
+  uint32_t from_count;
+  uint32_t unread;
+};
+#pragma pack(pop)
+
+struct dat_stamp_t {
+  uint64_t size;
+  int64_t mtime;
+};
+
+std::optional<dat_stamp_t> dat_stamp(const std::filesystem::path& dat_fn) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(dat_fn, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  const auto mtime = std::filesystem::last_write_time(dat_fn, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  return dat_stamp_t{size, static_cast<int64_t>(mtime.time_since_epoch().count())};
+}
+
+bool is_deleted(const mailrec& m) { return m.tosys == 0 && m.touser == 0; }
+
+// Opens the index for dat_fn and returns its header if the index is current.
+std::optional<email_index_header_t> open_current_index(File& f,
+                                                       const std::filesystem::path& dat_fn) {
+  const auto stamp = dat_stamp(dat_fn);
+  if (!stamp) {
+    return std::nullopt;
+  }
+  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+    return std::nullopt;
+  }
+  email_index_header_t h{};
+  if (f.Read(&h, sizeof(h)) != sizeof(h) ||
+      memcmp(h.magic, kEmailIndexMagic, sizeof(kEmailIndexMagic)) != 0 ||
+      h.version != kEmailIndexVersion || h.dat_size != stamp->size ||
+      h.dat_mtime != stamp->mtime) {
+    return std::nullopt;
+  }
+  const auto expected_length = sizeof(h) + h.num_users * sizeof(email_index_user_t) +
+                               (h.num_to + h.num_from) * sizeof(uint32_t);
+  if (f.length() != static_cast<File::size_type>(expected_length)) {
+    return std::nullopt;
+  }
+  return h;
+}
+
+std::optional<email_index_user_t> read_user(File& f, const email_index_header_t& h,
+                                            int user_number) {
+  if (user_number < 0 || static_cast<uint32_t>(user_number) >= h.num_users) {
+    return email_index_user_t{};
+  }
+  const auto pos =
+      static_cast<File::size_type>(sizeof(h) + user_number * sizeof(email_index_user_t));
+  email_index_user_t u{};
+  if (f.Seek(pos, File::Whence::begin) != pos || f.Read(&u, sizeof(u)) != sizeof(u)) {
+    return std::nullopt;
+  }
+  return u;
+}
+
+bool read_records(File& f, std::vector<uint32_t>& records) {
+  if (records.empty()) {
+    return true;
+  }
+  const auto len = static_cast<File::size_type>(records.size() * sizeof(uint32_t));
+  return f.Read(&records[0], len) == len;
+}
+
+void insert_record(std::vector<uint32_t>& v, uint32_t recno) {
+  if (const auto it = std::lower_bound(std::begin(v), std::end(v), recno);
+      it == std::end(v) || *it != recno) {
+    v.insert(it, recno);
+  }
+}
+
+bool erase_record(std::vector<uint32_t>& v, uint32_t recno) {
+  if (const auto it = std::lower_bound(std::begin(v), std::end(v), recno);
+      it != std::end(v) && *it == recno) {
+    v.erase(it);
+    return true;
+  }
+  return false;
+}
+
+std::vector<int> to_int_vector(const std::vector<uint32_t>& v) {
+  return std::vector<int>(std::begin(v), std::end(v));
+}
+
+} // namespace
+
+EmailIndex::EmailIndex(const std::vector<mailrec>& headers) {
+  for (auto i = 0; i < ssize(headers); i++) {
+    Add(i, headers[i]);
+  }
+}
+
+EmailIndex::user_t& EmailIndex::user(int user_number) {
+  if (user_number >= ssize(users_)) {
+    users_.resize(user_number + 1);
+  }
+  return users_[user_number];
+}
+
+const EmailIndex::user_t* EmailIndex::find_user(int user_number) const {
+  if (user_number < 0 || user_number >= ssize(users_)) {
+    return nullptr;
+  }
+  return &users_[user_number];
+}
+
+void EmailIndex::Add(int recno, const mailrec& m) {
+  if (recno < 0 || is_deleted(m)) {
+    return;
+  }
+  const auto r = static_cast<uint32_t>(recno);
+  if (m.tosys == 0) {
+    auto& u = user(m.touser);
+    const auto before = u.to.size();
+    insert_record(u.to, r);
+    if (u.to.size() != before && !(m.status & status_seen)) {
+      ++u.unread;
+    }
+  }
+  if (m.fromsys == 0 && m.fromuser != 0 && m.fromuser != kNetworkUser) {
+    insert_record(user(m.fromuser).from, r);
+  }
+}
+
+void EmailIndex::Remove(int recno, const mailrec& m) {
+  if (recno < 0 || is_deleted(m)) {
+    return;
+  }
+  const auto r = static_cast<uint32_t>(recno);
+  if (m.tosys == 0 && m.touser < ssize(users_)) {
+    auto& u = users_[m.touser];
+    if (erase_record(u.to, r) && !(m.status & status_seen) && u.unread > 0) {
+      --u.unread;
+    }
+  }
+  if (m.fromsys == 0 && m.fromuser < ssize(users_)) {
+    erase_record(users_[m.fromuser].from, r);
+  }
+}
+
+std::vector<int> EmailIndex::to_user(int user_number) const {
+  const auto* u = find_user(user_number);
+  return u ? to_int_vector(u->to) : std::vector<int>{};
+}
+
+std::vector<int> EmailIndex::from_user(int user_number) const {
+  const auto* u = find_user(user_number);
+  return u ? to_int_vector(u->from) : std::vector<int>{};
+}
+
+int EmailIndex::unread(int user_number) const {
+  const auto* u = find_user(user_number);
+  return u ? u->unread : 0;
+}
+
+std::optional<EmailIndex> EmailIndex::Load(const std::filesystem::path& dat_fn) {
+  File f(email_index_filename(dat_fn));
+  const auto h = open_current_index(f, dat_fn);
+  if (!h) {
+    return std::nullopt;
+  }
+  std::vector<email_index_user_t> users(h->num_users);
+  std::vector<uint32_t> to(h->num_to);
+  std::vector<uint32_t> from(h->num_from);
+  if (!users.empty()) {
+    const auto len = static_cast<File::size_type>(users.size() * sizeof(email_index_user_t));
+    if (f.Read(&users[0], len) != len) {
+      return std::nullopt;
+    }
+  }
+  if (!read_records(f, to) || !read_records(f, from)) {
+    return std::nullopt;
+  }
+
+  EmailIndex index;
+  index.users_.resize(users.size());
+  for (auto i = 0; i < ssize(users); i++) {
+    const auto& u = users[i];
+    if (u.to_first + u.to_count > to.size() || u.from_first + u.from_count > from.size()) {
+      LOG(WARNING) << "Ignoring corrupt email index: " << email_index_filename(dat_fn);
+      return std::nullopt;
+    }
+    auto& iu = index.users_[i];
+    iu.to.assign(std::begin(to) + u.to_first, std::begin(to) + u.to_first + u.to_count);
+    iu.from.assign(std::begin(from) + u.from_first,
+                   std::begin(from) + u.from_first + u.from_count);
+    iu.unread = static_cast<int>(u.unread);
+  }
+  return index;
+}
+
+EmailIndex EmailIndex::LoadOrRebuild(const std::filesystem::path& dat_fn) {
+  if (auto o = Load(dat_fn)) {
+    return std::move(o.value());
+  }
+  // Take the stamp before reading, so that if email.dat is written while
+  // the index is being built, the saved index is out of date rather than
+  // wrong.
+  const auto stamp = dat_stamp(dat_fn);
+  std::vector<mailrec> headers;
+  if (DataFile<mailrec> file(dat_fn, File::modeBinary | File::modeReadOnly); file) {
+    file.ReadVector(headers);
+  }
+  VLOG(1) << "Rebuilt email index for " << dat_fn << " from " << headers.size() << " records.";
+  EmailIndex index(headers);
+  if (stamp) {
+    index.Save(dat_fn, stamp->size, stamp->mtime);
+  }
+  return index;
+}
+
+bool EmailIndex::Save(const std::filesystem::path& dat_fn) const {
+  const auto stamp = dat_stamp(dat_fn);
+  if (!stamp) {
+    return false;
+  }
+  return Save(dat_fn, stamp->size, stamp->mtime);
+}
+
+bool EmailIndex::Save(const std::filesystem::path& dat_fn, uint64_t dat_size,
+                      int64_t dat_mtime) const {
+  std::vector<email_index_user_t> users;
+  std::vector<uint32_t> to;
+  std::vector<uint32_t> from;
+  users.reserve(users_.size());
+  for (const auto& u : users_) {
+    email_index_user_t iu{};
+    iu.to_first = static_cast<uint32_t>(to.size());
+    iu.to_count = static_cast<uint32_t>(u.to.size());
+    iu.from_first = static_cast<uint32_t>(from.size());
+    iu.from_count = static_cast<uint32_t>(u.from.size());
+    iu.unread = static_cast<uint32_t>(u.unread);
+    to.insert(std::end(to), std::begin(u.to), std::end(u.to));
+    from.insert(std::end(from), std::begin(u.from), std::end(u.from));
+    users.push_back(iu);
+  }
+
+  email_index_header_t h{};
+  memcpy(h.magic, kEmailIndexMagic, sizeof(kEmailIndexMagic));
+  h.version = kEmailIndexVersion;
+  h.dat_size = dat_size;
+  h.dat_mtime = dat_mtime;
+  h.num_users = static_cast<uint32_t>(users.size());
+  h.num_to = static_cast<uint32_t>(to.size());
+  h.num_from = static_cast<uint32_t>(from.size());
+
+  // Write to a temporary file and rename it so other nodes never see a
+  // partially written index.
+  const auto fn = email_index_filename(dat_fn);
+  auto tmp_fn = fn;
+  tmp_fn += ".tmp";
+  {
+    File f(tmp_fn);
+    if (!f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                File::modeTruncate)) {
+      LOG(ERROR) << "Unable to write email index: " << tmp_fn;
+      return false;
+    }
+    auto ok = f.Write(&h, sizeof(h)) == sizeof(h);
+    if (ok && !users.empty()) {
+      const auto len = static_cast<File::size_type>(users.size() * sizeof(email_index_user_t));
+      ok = f.Write(&users[0], len) == len;
+    }
+    for (const auto* v : {&to, &from}) {
+      if (ok && !v->empty()) {
+        const auto len = static_cast<File::size_type>(v->size() * sizeof(uint32_t));
+        ok = f.Write(&(*v)[0], len) == len;
+      }
+    }
+    if (!ok) {
+      LOG(ERROR) << "Unable to write email index: " << tmp_fn;
+      f.Close();
+      File::Remove(tmp_fn);
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_fn, fn, ec);
+  if (ec) {
+    LOG(ERROR) << "Unable to rename " << tmp_fn << " to " << fn << ": " << ec.message();
+    File::Remove(tmp_fn);
+    return false;
+  }
+  return true;
+}
+
+std::filesystem::path email_index_filename(const std::filesystem::path& dat_fn) {
+  auto fn = dat_fn;
+  return fn.replace_extension(".idx");
+}
+
+int email_unread_count(const std::filesystem::path& dat_fn, int user_number) {
+  if (File f(email_index_filename(dat_fn)); const auto h = open_current_index(f, dat_fn)) {
+    if (const auto u = read_user(f, h.value(), user_number)) {
+      return static_cast<int>(u->unread);
+    }
+  }
+  return EmailIndex::LoadOrRebuild(dat_fn).unread(user_number);
+}
+
+std::vector<int> email_records_to_user(const std::filesystem::path& dat_fn, int user_number) {
+  if (File f(email_index_filename(dat_fn)); const auto h = open_current_index(f, dat_fn)) {
+    if (const auto u = read_user(f, h.value(), user_number)) {
+      std::vector<uint32_t> records(u->to_count);
+      const auto pos = static_cast<File::size_type>(
+          sizeof(email_index_header_t) + h->num_users * sizeof(email_index_user_t) +
+          u->to_first * sizeof(uint32_t));
+      if (records.empty() ||
+          (f.Seek(pos, File::Whence::begin) == pos && read_records(f, records))) {
+        return to_int_vector(records);
+      }
+    }
+  }
+  return EmailIndex::LoadOrRebuild(dat_fn).to_user(user_number);
+}
+
+std::vector<std::pair<int, mailrec>> read_email_headers(File& file,
+                                                        const std::vector<int>& records) {
+  auto sorted = records;
+  std::sort(std::begin(sorted), std::end(sorted));
+  sorted.erase(std::unique(std::begin(sorted), std::end(sorted)), std::end(sorted));
+
+  std::vector<std::pair<int, mailrec>> headers;
+  headers.reserve(sorted.size());
+  std::vector<mailrec> run;
+  for (size_t i = 0; i < sorted.size();) {
+    auto end = i + 1;
+    while (end < sorted.size() && sorted[end] == sorted[end - 1] + 1) {
+      ++end;
+    }
+    const auto first = sorted[i];
+    run.resize(end - i);
+    const auto pos = static_cast<File::size_type>(first * sizeof(mailrec));
+    if (first >= 0 && file.Seek(pos, File::Whence::begin) == pos) {
+      const auto len = static_cast<File::size_type>(run.size() * sizeof(mailrec));
+      const auto num_read = std::max<File::size_type>(0, file.Read(&run[0], len));
+      const auto num_records = static_cast<size_t>(num_read) / sizeof(mailrec);
+      for (size_t r = 0; r < num_records; r++) {
+        headers.emplace_back(first + static_cast<int>(r), run[r]);
+      }
+    }
+    i = end;
+  }
+  return headers;
+}
+
+} // namespace wwiv::sdk::msgapi
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_MSGAPI_EMAIL_INDEX_H
+#define INCLUDED_SDK_MSGAPI_EMAIL_INDEX_H
+
+#include "core/file.h"
+#include "sdk/vardec.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace wwiv::sdk::msgapi {
+
+/**
+ * Index of the records in email.dat by the local user the email is to and
+ * the local user it is from, along with the number of unread emails for
+ * each user.
+ *
+ * The index is saved next to email.dat (as email.idx) along with the size
+ * and modification time email.dat had when the index was built.  If either
+ * no longer matches, because email.dat was written by code that does not
+ * maintain the index, the index is rebuilt from a single read of email.dat.
+ */
+class EmailIndex final {
+public:
+  EmailIndex() = default;
+  /** Builds the index from every header in email.dat. */
+  explicit EmailIndex(const std::vector<mailrec>& headers);
+
+  /** Adds the email m stored at record recno. */
+  void Add(int recno, const mailrec& m);
+  /** Removes the email m that was stored at record recno. */
+  void Remove(int recno, const mailrec& m);
+
+  /** Record numbers of the emails to user_number, in the order stored. */
+  [[nodiscard]] std::vector<int> to_user(int user_number) const;
+  /** Record numbers of the emails from user_number, in the order stored. */
+  [[nodiscard]] std::vector<int> from_user(int user_number) const;
+  /** Number of emails to user_number that have not been read. */
+  [[nodiscard]] int unread(int user_number) const;
+
+  /**
+   * Loads the index for email.dat at dat_fn, returning std::nullopt if it
+   * does not exist or is out of date.
+   */
+  [[nodiscard]] static std::optional<EmailIndex> Load(const std::filesystem::path& dat_fn);
+
+  /**
+   * Loads the index for email.dat at dat_fn, rebuilding and saving it if
+   * it does not exist or is out of date.
+   */
+  [[nodiscard]] static EmailIndex LoadOrRebuild(const std::filesystem::path& dat_fn);
+
+  /** Saves the index as being current for the contents of dat_fn. */
+  bool Save(const std::filesystem::path& dat_fn) const;
+
+private:
+  bool Save(const std::filesystem::path& dat_fn, uint64_t dat_size, int64_t dat_mtime) const;
+
+  struct user_t {
+    std::vector<uint32_t> to;
+    std::vector<uint32_t> from;
+    int unread{0};
+  };
+  user_t& user(int user_number);
+  [[nodiscard]] const user_t* find_user(int user_number) const;
+
+  std::vector<user_t> users_;
+};
+
+/** Returns the name of the index file for the email.dat at dat_fn. */
+std::filesystem::path email_index_filename(const std::filesystem::path& dat_fn);
+
+/**
+ * Returns the number of unread emails to the local user user_number in the
+ * email.dat at dat_fn.  When the index is current only the entry for
+ * user_number is read.
+ */
+int email_unread_count(const std::filesystem::path& dat_fn, int user_number);
+
+/** Returns the record numbers of the emails to the local user user_number. */
+std::vector<int> email_records_to_user(const std::filesystem::path& dat_fn, int user_number);
+
+/**
+ * Reads the headers at records from the open email.dat file, reading each
+ * run of consecutive records at once.  Records that can not be read are
+ * skipped.
+ */
+std::vector<std::pair<int, mailrec>> read_email_headers(core::File& file,
+                                                        const std::vector<int>& records);
+
+} // namespace wwiv::sdk::msgapi
+
+#endif
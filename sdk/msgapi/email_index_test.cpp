@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "sdk/msgapi/email_index.h"
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace testing;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::msgapi;
+
+static mailrec email(uint16_t from, uint16_t to, uint8_t status = 0) {
+  mailrec m{};
+  m.fromuser = from;
+  m.touser = to;
+  m.status = status;
+  return m;
+}
+
+class EmailIndexTest : public testing::Test {
+public:
+  EmailIndexTest() : dat_(FilePath(helper_.TempDir(), "email.dat")) {}
+
+  void Write(const std::vector<mailrec>& headers) const {
+    DataFile<mailrec> f(dat_, File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                                  File::modeTruncate);
+    ASSERT_TRUE(f);
+    ASSERT_TRUE(f.WriteVector(headers));
+  }
+
+  test::FileHelper helper_;
+  const std::filesystem::path dat_;
+};
+
+TEST_F(EmailIndexTest, FromHeaders) {
+  mailrec deleted{};
+  deleted.fromuser = 2;
+  mailrec remote = email(2, 3);
+  remote.tosys = 1;
+  const EmailIndex index(std::vector<mailrec>{email(2, 3), deleted, email(4, 3, status_seen),
+                                              remote, email(3, 2), email(65535, 3)});
+
+  EXPECT_THAT(index.to_user(3), ElementsAre(0, 2, 5));
+  EXPECT_EQ(2, index.unread(3));
+  EXPECT_THAT(index.to_user(2), ElementsAre(4));
+  EXPECT_THAT(index.from_user(2), ElementsAre(0, 3));
+  EXPECT_THAT(index.from_user(65535), IsEmpty());
+  EXPECT_THAT(index.to_user(99), IsEmpty());
+  EXPECT_EQ(0, index.unread(99));
+}
+
+TEST_F(EmailIndexTest, AddRemove) {
+  EmailIndex index;
+  index.Add(5, email(2, 3));
+  index.Add(1, email(2, 3, status_seen));
+  index.Add(5, email(2, 3));
+  EXPECT_THAT(index.to_user(3), ElementsAre(1, 5));
+  EXPECT_EQ(1, index.unread(3));
+
+  index.Remove(5, email(2, 3));
+  EXPECT_THAT(index.to_user(3), ElementsAre(1));
+  EXPECT_THAT(index.from_user(2), ElementsAre(1));
+  EXPECT_EQ(0, index.unread(3));
+
+  // Removing something not in the index changes nothing.
+  index.Remove(7, email(2, 3));
+  EXPECT_THAT(index.to_user(3), ElementsAre(1));
+  EXPECT_EQ(0, index.unread(3));
+}
+
+TEST_F(EmailIndexTest, SaveAndLoad) {
+  const std::vector<mailrec> headers{email(2, 3), email(3, 2), email(4, 3)};
+  Write(headers);
+  ASSERT_FALSE(EmailIndex::Load(dat_).has_value());
+
+  ASSERT_TRUE(EmailIndex(headers).Save(dat_));
+  EXPECT_TRUE(File::Exists(email_index_filename(dat_)));
+  const auto index = EmailIndex::Load(dat_);
+  ASSERT_TRUE(index.has_value());
+  EXPECT_THAT(index->to_user(3), ElementsAre(0, 2));
+  EXPECT_THAT(index->from_user(3), ElementsAre(1));
+  EXPECT_EQ(2, index->unread(3));
+
+  EXPECT_EQ(2, email_unread_count(dat_, 3));
+  EXPECT_EQ(1, email_unread_count(dat_, 2));
+  EXPECT_EQ(0, email_unread_count(dat_, 100));
+  EXPECT_THAT(email_records_to_user(dat_, 3), ElementsAre(0, 2));
+  EXPECT_THAT(email_records_to_user(dat_, 4), IsEmpty());
+}
+
+TEST_F(EmailIndexTest, RebuildsWhenStale) {
+  Write({email(2, 3)});
+  EXPECT_EQ(1, email_unread_count(dat_, 3));
+  ASSERT_TRUE(EmailIndex::Load(dat_).has_value());
+
+  // Writing email.dat without updating the index makes it out of date.
+  Write({email(2, 3), email(2, 3)});
+  std::filesystem::last_write_time(dat_, std::filesystem::last_write_time(dat_) + 1s);
+  EXPECT_FALSE(EmailIndex::Load(dat_).has_value());
+  EXPECT_EQ(2, email_unread_count(dat_, 3));
+  EXPECT_THAT(email_records_to_user(dat_, 3), ElementsAre(0, 1));
+  EXPECT_TRUE(EmailIndex::Load(dat_).has_value());
+}
+
+TEST_F(EmailIndexTest, MissingDat) {
+  EXPECT_EQ(0, email_unread_count(dat_, 3));
+  EXPECT_THAT(email_records_to_user(dat_, 3), IsEmpty());
+  EXPECT_FALSE(File::Exists(email_index_filename(dat_)));
+}
+
+TEST_F(EmailIndexTest, ReadHeaders) {
+  std::vector<mailrec> headers;
+  for (uint16_t i = 0; i < 10; i++) {
+    headers.push_back(email(2, i));
+  }
+  Write(headers);
+  File f(dat_);
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+
+  const auto r = read_email_headers(f, {7, 1, 2, 3, 9, 12, 2});
+  std::vector<int> records;
+  for (const auto& [recno, m] : r) {
+    EXPECT_EQ(recno, m.touser);
+    records.push_back(recno);
+  }
+  EXPECT_THAT(records, ElementsAre(1, 2, 3, 7, 9));
+}
@@ -24,10 +24,13 @@
 #include "core/strings.h"
 #include "sdk/config.h"
 #include "sdk/filenames.h"
+#include "sdk/msgapi/email_index.h"
 #include "sdk/user.h"
 #include "sdk/usermanager.h"
 #include "sdk/vardec.h"
+#include <algorithm>
 #include <filesystem>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -230,6 +233,9 @@ bool WWIVEmail::DeleteMessage(int email_number) {
     modify_email_waiting(config_, m.touser, -1);
   }
 
+  auto index = EmailIndex::LoadOrRebuild(data_filename_);
+  index.Remove(email_number, m);
+
   // Clear out the email record and write it back to EMAIL.DAT
   // so the slot may be reused later.
   m.touser = 0;
@@ -237,7 +243,11 @@ bool WWIVEmail::DeleteMessage(int email_number) {
   m.daten = 0xffffffff;
   m.msg.storage_type = 0;
   m.msg.stored_as = 0xffffffff;
-  return mail_file_.Write(email_number, &m);
+  if (!mail_file_.Write(email_number, &m)) {
+    return false;
+  }
+  index.Save(data_filename_);
+  return true;
 }
 
 bool WWIVEmail::DeleteAllMailToOrFrom(int user_number) {
@@ -245,15 +255,20 @@ bool WWIVEmail::DeleteAllMailToOrFrom(int user_number) {
     // You can not take command.
     return false;
   }
-  std::vector<mailrec> headers;
-  mail_file_.Seek(0);
-  if (!mail_file_.ReadVector(headers)) {
-    // WTF
+  if (!open_) {
     return false;
   }
-  for (auto i = 0; i < ssize(headers); i++) {
-    if (const auto& m = at(headers, i);
-        (m.tosys == 0 && m.touser == user_number) || (m.fromsys == 0 && m.fromuser == user_number)) {
+  const auto index = EmailIndex::LoadOrRebuild(data_filename_);
+  const auto to = index.to_user(user_number);
+  const auto from = index.from_user(user_number);
+  std::vector<int> records;
+  std::set_union(std::begin(to), std::end(to), std::begin(from), std::end(from),
+                 std::back_inserter(records));
+  for (const auto i : records) {
+    // Check the header since email.dat may have changed since the index was loaded.
+    if (mailrec m{};
+        mail_file_.Read(i, &m) && ((m.tosys == 0 && m.touser == user_number) ||
+                                   (m.fromsys == 0 && m.fromuser == user_number))) {
       DeleteMessage(i);
     }
   }
@@ -280,7 +295,13 @@ bool WWIVEmail::add_email(const mailrec& m) {
     }
   }
 
-  return mail_file_.Write(recno, &m);
+  auto index = EmailIndex::LoadOrRebuild(data_filename_);
+  if (!mail_file_.Write(recno, &m)) {
+    return false;
+  }
+  index.Add(recno, m);
+  index.Save(data_filename_);
+  return true;
 }
 
 } // namespace wwiv
@@ -77,7 +77,7 @@ public:
   bool read_email_header_and_text(int email_number, mailrec& m, std::string& text);
   /** Deletes an email by number */
   bool DeleteMessage(int email_number);
-  /** Delete all email to a specified user */
+  /** Delete all email to or from a local user, found using the email index. */
   bool DeleteAllMailToOrFrom(int user_number);
 
 private:
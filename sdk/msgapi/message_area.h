@@ -99,6 +99,14 @@ public:
   [[nodiscard]] virtual Message CreateMessage() = 0;
   [[nodiscard]] virtual bool Exists(daten_t d, const std::string& title, uint16_t from_system, uint16_t from_user) = 0;
 
+  /**
+   * Starts adding a batch of messages.  Until EndBatch is called the area may
+   * keep its files open and defer updating its header and status.dat.
+   */
+  virtual bool BeginBatch() { return true; }
+  /** Writes out everything deferred since BeginBatch. */
+  virtual bool EndBatch() { return true; }
+
   [[nodiscard]] int max_messages() const;
   void set_max_messages(int m) { max_messages_ = m; }
 
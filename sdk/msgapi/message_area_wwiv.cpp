@@ -23,15 +23,18 @@
 #include "core/log.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/trace.h"
 #include "core/version.h"
 #include "fmt/format.h"
 #include "fmt/printf.h"
 #include "sdk/config.h"
 #include "sdk/filenames.h"
 #include "sdk/ssm.h"
+#include "sdk/status.h"
 #include "sdk/usermanager.h"
 #include "sdk/vardec.h"
 #include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/qscan_high_water.h"
 #include "sdk/net/packets.h"
 
 #include <memory>
@@ -118,8 +121,9 @@ WWIVMessageArea::WWIVMessageArea(WWIVMessageApi* api, const subboard_t& sub,
 WWIVMessageArea::~WWIVMessageArea() { WWIVMessageArea::Close(); }
 
 bool WWIVMessageArea::Close() {
+  const auto result = EndBatch();
   open_ = false;
-  return true;
+  return result;
 }
 
 bool WWIVMessageArea::Lock() { return false; }
@@ -127,6 +131,10 @@ bool WWIVMessageArea::Lock() { return false; }
 bool WWIVMessageArea::Unlock() { return false; }
 
 std::unique_ptr<MessageAreaHeader> WWIVMessageArea::ReadMessageAreaHeader() {
+  if (batch_file_) {
+    // The header on disk is stale until EndBatch.
+    return std::make_unique<WWIVMessageAreaHeader>(header_);
+  }
   DataFile<postrec> sub(sub_filename_);
   auto h = ReadHeader(sub);
   header_ = h->raw_header();
@@ -143,6 +151,9 @@ int WWIVMessageArea::FindUserMessages(const std::string&) {
 }
 
 int WWIVMessageArea::number_of_messages() {
+  if (batch_file_) {
+    return std::min<int>(header_.active_message_count, batch_file_->number_of_records() - 1);
+  }
   DataFile<postrec> sub(sub_filename_);
   if (!sub) {
     // TODO: throw exception
@@ -241,6 +252,7 @@ std::optional<wwiv_parsed_text_fieds> WWIVMessageArea::ParseMessageText(const po
 }
 
 std::optional<Message> WWIVMessageArea::ReadMessage(int message_number) {
+  TraceSpan span("msgapi", "ReadMessage");
   const auto num_messages = number_of_messages();
   if (message_number < 1) {
     return std::nullopt;
@@ -249,7 +261,8 @@ std::optional<Message> WWIVMessageArea::ReadMessage(int message_number) {
     message_number = num_messages;
   }
 
-  DataFile<postrec> sub(sub_filename_);
+  std::optional<DataFile<postrec>> file;
+  auto& sub = open_sub_file(file, File::modeDefault);
   if (!sub) {
     // TODO: throw exception
     return std::nullopt;
@@ -286,25 +299,11 @@ std::optional<MessageText> WWIVMessageArea::ReadMessageText(int message_number)
   return msg->text();
 }
 
-static uint32_t next_qscan_value_and_increment_post(const std::filesystem::path& bbsdir) {
-  statusrec_t statusrec{};
-  const Config config(bbsdir);
-  if (!config.IsInitialized()) {
-    LOG(ERROR) << "Unable to load CONFIG.DAT.";
-    return 1;
-  }
-  DataFile<statusrec_t> file(FilePath(config.datadir(), STATUS_DAT),
-                             File::modeBinary | File::modeReadWrite);
-  if (!file) {
-    return 0;
-  }
-  if (!file.Read(0, &statusrec)) {
-    return 0;
-  }
-  const auto next_qscan = statusrec.qscanptr++;
-  ++statusrec.msgposttoday;
-  if (!file.Write(0, &statusrec)) {
-    return 0;
+static uint32_t next_qscan_value_and_increment_post(const std::filesystem::path& datadir) {
+  StatusMgr sm(datadir);
+  const auto next_qscan = sm.next_qscanptr();
+  if (next_qscan != 0) {
+    sm.increment_msgs_today();
   }
   return next_qscan;
 }
@@ -376,6 +375,7 @@ static bool has_ftn_network(const std::vector<subboard_network_data_t>& sub_nets
 }
 
 bool WWIVMessageArea::AddMessage(Message& message, const MessageAreaOptions& options) {
+  TraceSpan span("msgapi", "AddMessage");
   messagerec m{STORAGE_TYPE, 0xffffff};
 
   const auto& header = message.header();
@@ -387,7 +387,9 @@ bool WWIVMessageArea::AddMessage(Message& message, const MessageAreaOptions& opt
   if (p.qscan == 0) {
     // new message.
     VLOG(3) << "AddMessage needs a qscan";
-    p.qscan = next_qscan_value_and_increment_post(api_->root_directory());
+    // When batching, msgs_today is incremented once by EndBatch.
+    p.qscan = batch_status_ ? batch_status_->next_qscanptr()
+                            : next_qscan_value_and_increment_post(sub_filename_.parent_path());
     if (p.qscan == 0) {
       LOG(ERROR) << "Failed to get qscan value!";
       return false;
@@ -471,13 +473,21 @@ bool WWIVMessageArea::AddMessage(Message& message, const MessageAreaOptions& opt
   }
   p.msg = msg.value();
   auto result = add_post(p);
-  if (result) {
+  if (result && !batch_file_) {
     DeleteExcess();
   }
   return result;
 }
 
 bool WWIVMessageArea::DeleteMessage(int message_number) {
+  TraceSpan span("msgapi", "DeleteMessage");
+  if (batch_file_) {
+    // Write the batch's header first since this updates the one on disk.
+    if (!WriteBatchHeader()) {
+      return false;
+    }
+    exists_index_.reset();
+  }
   const auto num_messages = number_of_messages();
   if (message_number < 1) {
     return false;
@@ -486,8 +496,9 @@ bool WWIVMessageArea::DeleteMessage(int message_number) {
     return false;
   }
 
-  DataFile<postrec> sub(sub_filename_,
-                        File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+  std::optional<DataFile<postrec>> file;
+  auto& sub =
+      open_sub_file(file, File::modeBinary | File::modeCreateFile | File::modeReadWrite);
   if (!sub) {
     // TODO: throw exception
     return false;
@@ -518,6 +529,9 @@ bool WWIVMessageArea::DeleteMessage(int message_number) {
   header.owneruser = static_cast<uint16_t>(std::max(0, num_messages - 1));
   sub.Write(0, &header);
 
+  if (batch_file_) {
+    header_ = ReadHeader(sub)->raw_header();
+  }
   return true;
 }
 
@@ -541,6 +555,10 @@ bool WWIVMessageArea::ResyncMessage(int& message_number) {
 }
 
 bool WWIVMessageArea::HasSubChanged() const {
+  if (batch_file_) {
+    // Nothing else can change the sub while the batch holds it open.
+    return false;
+  }
   const auto last_read_header = this->header_;
   DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadOnly);
   const auto h = ReadHeader(sub);
@@ -619,8 +637,32 @@ Message WWIVMessageArea::CreateMessage() {
   return Message(api_);
 }
 
+// Since we don't have a global message id, use the combination of
+// date + title + from system + from user.
+static std::string exists_key(daten_t d, const std::string& title, uint16_t from_system,
+                              uint16_t from_user) {
+  return fmt::format("{}\t{}\t{}\t{}", d, ToStringLowerCase(title), from_system, from_user);
+}
+
 bool WWIVMessageArea::Exists(daten_t d, const std::string& title, uint16_t from_system,
                              uint16_t from_user) {
+  if (batch_file_) {
+    if (!exists_index_) {
+      const auto num_messages = number_of_messages();
+      std::vector<postrec> headers(num_messages);
+      if (num_messages > 0 &&
+          !(batch_file_->Seek(1) && batch_file_->Read(headers.data(), num_messages))) {
+        return false;
+      }
+      exists_index_.emplace();
+      for (const auto& h : headers) {
+        if (!(h.status & status_delete)) {
+          exists_index_->insert(exists_key(h.daten, h.title, h.ownersys, h.owneruser));
+        }
+      }
+    }
+    return exists_index_->count(exists_key(d, title, from_system, from_user)) > 0;
+  }
   DataFile<postrec> sub(sub_filename_);
   if (!sub) {
     return false;
@@ -665,9 +707,91 @@ message_anonymous_t WWIVMessageArea::anonymous_type() const noexcept {
   }
 }
 
+bool WWIVMessageArea::BeginBatch() {
+  if (batch_file_) {
+    return true;
+  }
+  auto file = std::make_unique<DataFile<postrec>>(sub_filename_,
+                                                  File::modeBinary | File::modeReadWrite);
+  if (!*file || file->number_of_records() == 0) {
+    return false;
+  }
+  const auto h = ReadHeader(*file);
+  if (!h->initialized()) {
+    // This is an invalid header.
+    return false;
+  }
+  header_ = h->raw_header();
+  batch_file_ = std::move(file);
+  batch_status_ = std::make_unique<StatusMgr>(sub_filename_.parent_path());
+  batch_posts_ = 0;
+  batch_high_water_ = 0;
+  batch_header_dirty_ = false;
+  exists_index_.reset();
+  return true;
+}
+
+bool WWIVMessageArea::EndBatch() {
+  if (!batch_file_) {
+    return true;
+  }
+  const auto num_posts = batch_posts_;
+  auto result = WriteBatchHeader();
+  if (num_posts > 0) {
+    QScanHighWater::Update(sub_filename_.parent_path(), sub_filename_.stem().string(),
+                           batch_high_water_);
+    batch_status_->increment_msgs_today(num_posts);
+  }
+  batch_file_.reset();
+  batch_status_.reset();
+  exists_index_.reset();
+  if (num_posts > 0) {
+    DeleteExcess();
+  }
+  return result;
+}
+
 // Implementation Details
 
+DataFile<postrec>& WWIVMessageArea::open_sub_file(std::optional<DataFile<postrec>>& file,
+                                                  int file_mode) {
+  if (batch_file_) {
+    return *batch_file_;
+  }
+  file.emplace(sub_filename_, file_mode);
+  return file.value();
+}
+
+bool WWIVMessageArea::WriteBatchHeader() {
+  if (!batch_header_dirty_) {
+    return true;
+  }
+  if (!WriteHeader(*batch_file_, WWIVMessageAreaHeader(header_))) {
+    return false;
+  }
+  // WriteHeader incremented the mod_count on disk.
+  ++header_.mod_count;
+  batch_header_dirty_ = false;
+  return true;
+}
+
 bool WWIVMessageArea::add_post(const postrec& post) {
+  if (batch_file_) {
+    const uint32_t msgnum = header_.active_message_count + 1;
+    if (!batch_file_->Write(msgnum, &post)) {
+      return false;
+    }
+    header_.active_message_count = static_cast<uint16_t>(msgnum);
+    batch_header_dirty_ = true;
+    ++batch_posts_;
+    batch_high_water_ = std::max(batch_high_water_, post.qscan);
+    if (exists_index_) {
+      exists_index_->insert(exists_key(post.daten, post.title, post.ownersys, post.owneruser));
+    }
+    ++nonce_;
+    return true;
+  }
+
   DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadWrite);
   if (!sub) {
     return false;
@@ -689,7 +813,11 @@ bool WWIVMessageArea::add_post(const postrec& post) {
   // No reason other than make sure we're not const.
   ++nonce_;
   // Write the header now.
-  return WriteHeader(sub, *wwiv_header);
+  if (!WriteHeader(sub, *wwiv_header)) {
+    return false;
+  }
+  QScanHighWater::Update(sub_filename_.parent_path(), sub_filename_.stem().string(), post.qscan);
+  return true;
 }
 
 } // namespace wwiv::sdk::msgapi
@@ -18,13 +18,17 @@
 #ifndef INCLUDED_SDK_MESSAGE_AREA_WWIV_H
 #define INCLUDED_SDK_MESSAGE_AREA_WWIV_H
 
+#include "core/datafile.h"
+#include "sdk/status.h"
 #include "sdk/msgapi/message.h"
 #include "sdk/msgapi/message_api.h"
 #include "sdk/msgapi/type2_text.h"
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_set>
 
 namespace wwiv::sdk::msgapi {
 
@@ -92,12 +96,24 @@ public:
   [[nodiscard]] const MessageAreaLastRead& last_read() const noexcept override;
   [[nodiscard]] message_anonymous_t anonymous_type() const noexcept override;
 
+  // While batching, the sub file stays open (and locked), duplicates are
+  // checked against an in-memory index of the headers, and the sub header,
+  // qscan high water mark and status.dat are updated once by EndBatch.
+  // Excess messages are also deleted then.
+  bool BeginBatch() override;
+  bool EndBatch() override;
+
 private:
   int DeleteExcess();
   [[nodiscard]] bool add_post(const postrec& post);
   [[nodiscard]] std::optional<wwiv_parsed_text_fieds> ParseMessageText(const postrec& header, int message_number);
   [[nodiscard]] [[nodiscard]] bool HasSubChanged() const;
   [[nodiscard]] bool ResyncMessageImpl(int& message_number, const Message& message);
+  [[nodiscard]] bool WriteBatchHeader();
+  // Returns the sub file held open by the batch if there is one, otherwise
+  // opens it into file.
+  [[nodiscard]] core::DataFile<postrec>& open_sub_file(std::optional<core::DataFile<postrec>>& file,
+                                                       int file_mode);
 
   static constexpr uint8_t STORAGE_TYPE = 2;
 
@@ -113,6 +129,17 @@ private:
   const std::vector<net::Network> net_networks_;
   MessageAreaLastRead last_read_;
   int nonce_{0};
+
+  // Only set between BeginBatch and EndBatch.
+  std::unique_ptr<core::DataFile<postrec>> batch_file_;
+  std::unique_ptr<StatusMgr> batch_status_;
+  // Messages added since BeginBatch.
+  int batch_posts_{0};
+  uint32_t batch_high_water_{0};
+  // The header in header_ has not been written since the last post.
+  bool batch_header_dirty_{false};
+  // Keys of the messages on the sub for Exists, built on first use.
+  std::optional<std::unordered_set<std::string>> exists_index_;
 };
 
 } // namespace
@@ -172,3 +172,70 @@ TEST_F(MsgApiTest, Resynch_MessageNumber) {
   a2->ResyncMessage(msgnum);
   EXPECT_EQ(1, msgnum);
 }
+
+TEST_F(MsgApiTest, Batch_HeaderWrittenByEndBatch) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  auto area(api->Open(sub, -1));
+  ASSERT_TRUE(area->BeginBatch());
+  for (auto i = 0; i < 3; i++) {
+    auto m(CreateMessage(*area, 1234, "From", StrCat("Title", i), "Line1\r\n"));
+    EXPECT_TRUE(area->AddMessage(m, {}));
+  }
+  EXPECT_EQ(3, area->number_of_messages());
+  EXPECT_EQ("Title2", area->ReadMessage(3)->header().title());
+  EXPECT_TRUE(area->DeleteMessage(1));
+  auto m(CreateMessage(*area, 1234, "From", "Title3", "Line1\r\n"));
+  EXPECT_TRUE(area->AddMessage(m, {}));
+  EXPECT_TRUE(area->EndBatch());
+
+  auto a2(api->Open(sub, -1));
+  ASSERT_EQ(3, a2->number_of_messages());
+  EXPECT_EQ("Title1", a2->ReadMessage(1)->header().title());
+  EXPECT_EQ("Title3", a2->ReadMessage(3)->header().title());
+}
+
+TEST_F(MsgApiTest, Batch_Exists) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  auto area(api->Open(sub, -1));
+  auto m1(CreateMessage(*area, 1234, "From", "Title", "Line1\r\n"));
+  EXPECT_TRUE(area->AddMessage(m1, {}));
+  const auto d1 = m1.header().daten();
+
+  ASSERT_TRUE(area->BeginBatch());
+  EXPECT_TRUE(area->Exists(d1, "TITLE", 0, 1234));
+  EXPECT_FALSE(area->Exists(d1, "Title", 0, 1));
+  EXPECT_FALSE(area->Exists(d1 + 1, "Other", 0, 1234));
+
+  auto m2(CreateMessage(*area, 1234, "From", "Other", "Line1\r\n"));
+  m2.header().set_daten(d1 + 1);
+  EXPECT_TRUE(area->AddMessage(m2, {}));
+  EXPECT_TRUE(area->Exists(d1 + 1, "Other", 0, 1234));
+  EXPECT_TRUE(area->EndBatch());
+}
+
+TEST_F(MsgApiTest, Batch_DeletesExcessAtEnd) {
+  MessageApiOptions options;
+  options.overflow_strategy = OverflowStrategy::delete_all;
+  api.reset(new WWIVMessageApi(options, helper.config(), {}, new NullLastReadImpl()));
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  auto area(api->Open(sub, -1));
+  area->set_max_messages(2);
+  ASSERT_TRUE(area->BeginBatch());
+  for (auto i = 0; i < 4; i++) {
+    auto m(CreateMessage(*area, 1234, "From", StrCat("Title", i), "Line1\r\n"));
+    EXPECT_TRUE(area->AddMessage(m, {}));
+  }
+  EXPECT_EQ(4, area->number_of_messages());
+  EXPECT_TRUE(area->EndBatch());
+
+  auto a2(api->Open(sub, -1));
+  ASSERT_EQ(2, a2->number_of_messages());
+  EXPECT_EQ("Title2", a2->ReadMessage(1)->header().title());
+  EXPECT_EQ("Title3", a2->ReadMessage(2)->header().title());
+}
@@ -0,0 +1,187 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "sdk/msgapi/qscan_high_water.h"
+
+#include "core/crc32.h"
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+#include "sdk/vardec.h"
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+namespace wwiv::sdk::msgapi {
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace {
+
+// "WQHW" - Used to make sure this is a qscan high water table.
+constexpr char kHighWaterMagic[4] = {'W', 'Q', 'H', 'W'};
+constexpr uint32_t kHighWaterVersion = 1;
+
+#pragma pack(push, 1)
+struct qscan_high_water_header_t {
+  char magic[4];
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t reserved;
+};
+#pragma pack(pop)
+
+constexpr auto kHeaderSize = static_cast<File::size_type>(sizeof(qscan_high_water_header_t));
+constexpr auto kSlotsSize =
+    static_cast<File::size_type>(QScanHighWater::kNumSlots * sizeof(uint32_t));
+
+uint32_t slot_of(const std::string& sub_filename) {
+  return crc32string(ToStringLowerCase(sub_filename)) % QScanHighWater::kNumSlots;
+}
+
+bool valid_header(const qscan_high_water_header_t& h) {
+  return memcmp(h.magic, kHighWaterMagic, sizeof(kHighWaterMagic)) == 0 &&
+         h.version == kHighWaterVersion && h.num_slots == QScanHighWater::kNumSlots;
+}
+
+std::optional<std::vector<uint32_t>> read_table(const std::filesystem::path& fn) {
+  File f(fn);
+  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+    return std::nullopt;
+  }
+  qscan_high_water_header_t h{};
+  if (f.Read(&h, sizeof(h)) != sizeof(h) || !valid_header(h) ||
+      f.length() != kHeaderSize + kSlotsSize) {
+    return std::nullopt;
+  }
+  std::vector<uint32_t> slots(QScanHighWater::kNumSlots);
+  if (f.Read(&slots[0], kSlotsSize) != kSlotsSize) {
+    return std::nullopt;
+  }
+  return slots;
+}
+
+// Creates the table with every slot at the last qscan value handed out.
+// Since this is read from status.dat when creating the table rather than
+// passed in, a node that loses a race to create the table can never leave
+// a slot lower than a post another node has already made.
+std::optional<std::vector<uint32_t>> create_table(const std::filesystem::path& datadir) {
+  statusrec_t status{};
+  if (DataFile<statusrec_t> file(FilePath(datadir, STATUS_DAT),
+                                 File::modeBinary | File::modeReadOnly);
+      !file || !file.Read(0, &status)) {
+    LOG(ERROR) << "Unable to read status.dat to create: " << qscan_high_water_filename(datadir);
+    return std::nullopt;
+  }
+  const auto last_qscan = status.qscanptr > 0 ? status.qscanptr - 1 : 0;
+  std::vector<uint32_t> slots(QScanHighWater::kNumSlots, last_qscan);
+
+  qscan_high_water_header_t h{};
+  memcpy(h.magic, kHighWaterMagic, sizeof(kHighWaterMagic));
+  h.version = kHighWaterVersion;
+  h.num_slots = QScanHighWater::kNumSlots;
+
+  // Write to a temporary file and rename it so other nodes never see a
+  // partially written table.
+  const auto fn = qscan_high_water_filename(datadir);
+  auto tmp_fn = fn;
+  tmp_fn += ".tmp";
+  {
+    File f(tmp_fn);
+    if (!f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                File::modeTruncate)) {
+      LOG(ERROR) << "Unable to write qscan high water table: " << tmp_fn;
+      return std::nullopt;
+    }
+    if (f.Write(&h, sizeof(h)) != sizeof(h) || f.Write(&slots[0], kSlotsSize) != kSlotsSize) {
+      LOG(ERROR) << "Unable to write qscan high water table: " << tmp_fn;
+      f.Close();
+      File::Remove(tmp_fn);
+      return std::nullopt;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_fn, fn, ec);
+  if (ec) {
+    LOG(ERROR) << "Unable to rename " << tmp_fn << " to " << fn << ": " << ec.message();
+    File::Remove(tmp_fn);
+    return std::nullopt;
+  }
+  VLOG(1) << "Created qscan high water table: " << fn << " at qscan: " << last_qscan;
+  return slots;
+}
+
+} // namespace
+
+std::filesystem::path qscan_high_water_filename(const std::filesystem::path& datadir) {
+  return FilePath(datadir, "qscanhw.dat");
+}
+
+std::optional<QScanHighWater> QScanHighWater::Load(const std::filesystem::path& datadir) {
+  if (auto slots = read_table(qscan_high_water_filename(datadir))) {
+    return QScanHighWater(std::move(slots.value()));
+  }
+  return std::nullopt;
+}
+
+std::optional<QScanHighWater> QScanHighWater::LoadOrCreate(const std::filesystem::path& datadir) {
+  if (auto o = Load(datadir)) {
+    return o;
+  }
+  if (auto slots = create_table(datadir)) {
+    return QScanHighWater(std::move(slots.value()));
+  }
+  return std::nullopt;
+}
+
+bool QScanHighWater::Update(const std::filesystem::path& datadir, const std::string& sub_filename,
+                            uint32_t qscan) {
+  const auto fn = qscan_high_water_filename(datadir);
+  if (!File::Exists(fn) && !create_table(datadir)) {
+    return false;
+  }
+  File f(fn);
+  if (!f.Open(File::modeBinary | File::modeReadWrite)) {
+    LOG(ERROR) << "Unable to open qscan high water table: " << fn;
+    return false;
+  }
+  qscan_high_water_header_t h{};
+  if (f.Read(&h, sizeof(h)) != sizeof(h) || !valid_header(h)) {
+    LOG(ERROR) << "Invalid qscan high water table: " << fn;
+    return false;
+  }
+  const auto pos = kHeaderSize + slot_of(sub_filename) * static_cast<File::size_type>(sizeof(uint32_t));
+  uint32_t current = 0;
+  if (f.Seek(pos, File::Whence::begin) != pos || f.Read(&current, sizeof(current)) != sizeof(current)) {
+    return false;
+  }
+  if (current >= qscan) {
+    return true;
+  }
+  return f.Seek(pos, File::Whence::begin) == pos && f.Write(&qscan, sizeof(qscan)) == sizeof(qscan);
+}
+
+uint32_t QScanHighWater::high_water(const std::string& sub_filename) const {
+  return slots_.at(slot_of(sub_filename));
+}
+
+} // namespace wwiv::sdk::msgapi
@@ -0,0 +1,85 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_MSGAPI_QSCAN_HIGH_WATER_H
+#define INCLUDED_SDK_MSGAPI_QSCAN_HIGH_WATER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wwiv::sdk::msgapi {
+
+/**
+ * Table of the newest qscan value posted to each message sub, kept in the
+ * data directory (as qscanhw.dat) and updated by everything that posts.
+ *
+ * Subs are hashed by filename into a fixed number of slots and each slot
+ * holds the largest qscan value posted to any sub in it.  Slots that have
+ * not been posted to since the table was created hold the last qscan
+ * value handed out before it was created.  Either way high_water() is never
+ * lower than the qscan of the newest post on a sub, so a new-scan can skip
+ * any sub whose high water mark is not past the user's last read pointer
+ * without opening it.
+ */
+class QScanHighWater final {
+public:
+  /** Number of slots in the table. */
+  static constexpr uint32_t kNumSlots = 8192;
+
+  /**
+   * Loads the table from datadir, returning std::nullopt if it does not
+   * exist or is not valid.
+   */
+  [[nodiscard]] static std::optional<QScanHighWater> Load(const std::filesystem::path& datadir);
+
+  /**
+   * Loads the table from datadir, creating it if needed.  A new table starts
+   * with every slot just below the qscan pointer in status.dat, which is
+   * higher than anything posted so far.
+   */
+  [[nodiscard]] static std::optional<QScanHighWater> LoadOrCreate(const std::filesystem::path& datadir);
+
+  /**
+   * Records that a post with qscan value qscan was added to the sub named
+   * sub_filename (with no extension), creating the table if needed.
+   */
+  static bool Update(const std::filesystem::path& datadir, const std::string& sub_filename,
+                     uint32_t qscan);
+
+  /**
+   * The highest qscan value that may have been posted on the sub named
+   * sub_filename (with no extension).
+   */
+  [[nodiscard]] uint32_t high_water(const std::string& sub_filename) const;
+
+private:
+  explicit QScanHighWater(std::vector<uint32_t> slots) : slots_(std::move(slots)) {}
+
+  std::vector<uint32_t> slots_;
+};
+
+/** Returns the name of the high water table in datadir. */
+std::filesystem::path qscan_high_water_filename(const std::filesystem::path& datadir);
+
+} // namespace wwiv::sdk::msgapi
+
+#endif
@@ -0,0 +1,92 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "sdk/filenames.h"
+#include "sdk/msgapi/qscan_high_water.h"
+#include "sdk/vardec.h"
+#include <filesystem>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::msgapi;
+
+class QScanHighWaterTest : public testing::Test {
+public:
+  QScanHighWaterTest() : datadir_(helper_.TempDir()) {}
+
+  void SetQScanPtr(uint32_t qscanptr) const {
+    statusrec_t s{};
+    s.qscanptr = qscanptr;
+    DataFile<statusrec_t> f(FilePath(datadir_, STATUS_DAT),
+                            File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    ASSERT_TRUE(f);
+    ASSERT_TRUE(f.Write(0, &s));
+  }
+
+  test::FileHelper helper_;
+  const std::filesystem::path datadir_;
+};
+
+TEST_F(QScanHighWaterTest, Load_Missing) {
+  EXPECT_FALSE(QScanHighWater::Load(datadir_).has_value());
+}
+
+TEST_F(QScanHighWaterTest, LoadOrCreate_StartsAtLastQScan) {
+  SetQScanPtr(100);
+  const auto hw = QScanHighWater::LoadOrCreate(datadir_);
+  ASSERT_TRUE(hw.has_value());
+  EXPECT_EQ(99u, hw->high_water("general"));
+  EXPECT_EQ(99u, hw->high_water("sysop"));
+  EXPECT_TRUE(File::Exists(qscan_high_water_filename(datadir_)));
+}
+
+TEST_F(QScanHighWaterTest, LoadOrCreate_NoStatus) {
+  EXPECT_FALSE(QScanHighWater::LoadOrCreate(datadir_).has_value());
+  EXPECT_FALSE(File::Exists(qscan_high_water_filename(datadir_)));
+}
+
+TEST_F(QScanHighWaterTest, Update) {
+  SetQScanPtr(100);
+  ASSERT_TRUE(QScanHighWater::Update(datadir_, "general", 100));
+  // Creating the table later must not lower what is already there.
+  SetQScanPtr(102);
+  ASSERT_TRUE(QScanHighWater::Update(datadir_, "sysop", 101));
+  ASSERT_TRUE(QScanHighWater::Update(datadir_, "sysop", 90));
+
+  const auto hw = QScanHighWater::Load(datadir_);
+  ASSERT_TRUE(hw.has_value());
+  EXPECT_EQ(100u, hw->high_water("general"));
+  EXPECT_EQ(100u, hw->high_water("GENERAL"));
+  EXPECT_EQ(101u, hw->high_water("sysop"));
+  EXPECT_EQ(99u, hw->high_water("other"));
+}
+
+TEST_F(QScanHighWaterTest, Load_Corrupt) {
+  SetQScanPtr(100);
+  ASSERT_TRUE(QScanHighWater::LoadOrCreate(datadir_).has_value());
+  File f(qscan_high_water_filename(datadir_));
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadWrite));
+  f.set_length(100);
+  f.Close();
+  EXPECT_FALSE(QScanHighWater::Load(datadir_).has_value());
+}
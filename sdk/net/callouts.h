@@ -24,6 +24,7 @@
 
 namespace wwiv::sdk::net {
 
+network_callout_config_t to_network_callout_config_t(const net_call_out_rec& con);
 bool allowed_to_call(const network_callout_config_t& con);
 bool allowed_to_call(const net_call_out_rec& con, const wwiv::core::DateTime& dt);
 bool should_call(const wwiv::sdk::NetworkContact& ncn, const network_callout_config_t& callout,
@@ -26,9 +26,13 @@
 #include "sdk/fido/fido_packets.h"
 #include "sdk/fido/fido_util.h"
 #include "sdk/filenames.h"
+#include <algorithm>
 #include <cstdint>
 #include <ctime>
+#include <iterator>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -129,11 +133,23 @@ std::string FtnMessageDupe::CreateMessageID(const wwiv::sdk::fido::FidoAddress&
 }
 
 // static
-std::string FtnMessageDupe::GetMessageIDFromText(const std::string& text) {
+std::string FtnMessageDupe::GetMessageIDFromText(std::string_view text) {
   static const std::string kMSGID = "MSGID: ";
-  auto lines = wwiv::sdk::fido::split_message(text);
-  for (const auto& line : lines) {
-    if (line.empty() || line.front() != '\001' || line.size() < 2) {
+  // Same as looking through split_message(text), but only copies the lines
+  // that are control lines instead of the whole message.
+  const auto is_ignored = [](char c) { return c == 10 || c == '\x8d'; };
+  while (!text.empty()) {
+    const auto cr = text.find('\r');
+    const auto raw = text.substr(0, cr);
+    text.remove_prefix(cr == std::string_view::npos ? text.size() : cr + 1);
+
+    const auto first = std::find_if_not(raw.begin(), raw.end(), is_ignored);
+    if (first == raw.end() || *first != '\001') {
+      continue;
+    }
+    std::string line;
+    std::remove_copy_if(first, raw.end(), std::back_inserter(line), is_ignored);
+    if (line.size() < 2) {
       continue;
     }
     auto s = line.substr(1);
@@ -148,37 +164,45 @@ std::string FtnMessageDupe::GetMessageIDFromText(const std::string& text) {
 // static
 std::string FtnMessageDupe::GetMessageIDFromWWIVText(const std::string& text) {
   static const std::string kMSGID = "0MSGID: ";
-  auto lines = wwiv::sdk::fido::split_message(text);
-  for (const auto& line : lines) {
+  std::string buffer;
+  std::vector<std::string_view> lines;
+  wwiv::sdk::fido::split_message(text, &buffer, &lines);
+  for (const auto line : lines) {
     if (line.empty() || line.front() != '\004' || line.size() < 2) {
       continue;
     }
-    auto s = line.substr(1);
+    const auto s = line.substr(1);
     if (starts_with(s, kMSGID)) {
       // Found the message ID, mail here.
-      return StringTrim(s.substr(kMSGID.size()));
+      return std::string(StringTrimView(s.substr(kMSGID.size())));
     }
   }
   return "";
 }
 
 // static
-bool FtnMessageDupe::GetMessageCrc32s(const wwiv::sdk::fido::FidoPackedMessage& msg,
+bool FtnMessageDupe::GetMessageCrc32s(const fido_packed_message_view_t& msg,
                                       uint32_t& header_crc32, uint32_t& msgid_crc32) {
   std::ostringstream s;
   s << msg.nh.orig_net << "/" << msg.nh.orig_node << "\r\n";
   s << msg.nh.dest_net << "/" << msg.nh.dest_node << "\r\n";
-  s << msg.vh.date_time << "\r\n";
-  s << msg.vh.from_user_name << "\r\n";
-  s << msg.vh.subject << "\r\n";
-  s << msg.vh.to_user_name << "\r\n";
+  s << msg.date_time << "\r\n";
+  s << msg.from_user_name << "\r\n";
+  s << msg.subject << "\r\n";
+  s << msg.to_user_name << "\r\n";
 
   header_crc32 = crc32string(s.str());
-  const auto msgid = FtnMessageDupe::GetMessageIDFromText(msg.vh.text);
+  const auto msgid = FtnMessageDupe::GetMessageIDFromText(msg.text);
   msgid_crc32 = crc32string(msgid);
   return true;
 }
 
+// static
+bool FtnMessageDupe::GetMessageCrc32s(const FidoPackedMessage& msg,
+                                      uint32_t& header_crc32, uint32_t& msgid_crc32) {
+  return GetMessageCrc32s(to_packed_message_view(msg), header_crc32, msgid_crc32);
+}
+
 bool FtnMessageDupe::add(const FidoPackedMessage& msg) {
   uint32_t header_crc32 = 0;
   uint32_t msgid_crc32 = 0;
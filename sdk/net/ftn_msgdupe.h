@@ -20,6 +20,7 @@
 
 #include <filesystem>
 #include <string>
+#include <string_view>
 #include <set>
 #include <vector>
 #include "sdk/config.h"
@@ -54,9 +55,11 @@ public:
   [[nodiscard]] bool is_dupe(const fido::FidoPackedMessage& msg) const;
 
   /** Returns the MSGID from this message or an empty string. */
-  [[nodiscard]] static std::string GetMessageIDFromText(const std::string& text);
+  [[nodiscard]] static std::string GetMessageIDFromText(std::string_view text);
   static bool GetMessageCrc32s(const fido::FidoPackedMessage& msg,
                                uint32_t& header_crc32, uint32_t& msgid_crc32);
+  static bool GetMessageCrc32s(const fido::fido_packed_message_view_t& msg,
+                               uint32_t& header_crc32, uint32_t& msgid_crc32);
 
   /**
    * Returns the MSGID from this message in WWIV format 
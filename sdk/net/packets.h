@@ -22,7 +22,9 @@
 #include "sdk/bbslist.h"
 #include "sdk/msgapi/message.h"
 #include "sdk/net/net.h"
+#include <algorithm>
 #include <filesystem>
+#include <initializer_list>
 #include <set>
 #include <string>
 #include <vector>
@@ -247,23 +249,30 @@ private:
  * Gets the next message field from a NetPacket text c with iterator iter.
  * The next message field will be the next set of characters that do not include
  * anything in the set of stop characters (stop) and less than a total of max.
+ *
+ * stop is an initializer_list rather than a std::set since this runs for
+ * every field of every message, and building a set allocates.
  */
 template <typename C, typename I>
-static std::string get_message_field(const C& c, I& iter, std::set<char> stop, std::size_t max) {
+static std::string get_message_field(const C& c, I& iter, std::initializer_list<char> stop,
+                                     std::size_t max) {
   // No need to continue if we're already at the end.
   if (iter == c.end()) {
     return {};
   }
 
+  const auto is_stop = [&stop](char ch) {
+    return std::find(std::begin(stop), std::end(stop), ch) != std::end(stop);
+  };
   const auto begin = iter;
   std::size_t count = 0;
-  while (iter != std::end(c) && stop.find(*iter) == std::end(stop) && ++count < max) {
+  while (iter != std::end(c) && !is_stop(*iter) && ++count < max) {
     ++iter;
   }
   std::string result(begin, iter);
 
   // Stop over stop chars
-  while (iter != std::end(c) && stop.find(*iter) != std::end(stop)) {
+  while (iter != std::end(c) && is_stop(*iter)) {
     ++iter;
   }
 
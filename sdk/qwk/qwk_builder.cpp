@@ -0,0 +1,172 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2022, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "sdk/qwk/qwk_builder.h"
+
+#include "core/log.h"
+#include "core/strings.h"
+#include "fmt/format.h"
+#include "sdk/msgapi/message.h"
+#include "sdk/msgapi/message_area.h"
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <utility>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::strings;
+
+namespace wwiv::sdk::qwk {
+
+namespace {
+
+struct qwk_sub_messages_t {
+  qwk_sub_result_t result;
+  std::vector<std::pair<uint32_t, qwk_message_blocks>> messages;
+};
+
+// Finds the first message with a qscan pointer after qscan, or total + 1.
+int first_new_message(MessageArea& area, int total, uint32_t qscan) {
+  // qscan pointers only increase within a sub, so a binary search is fine
+  // and avoids reading every header in large subs.
+  auto lo = 1;
+  auto hi = total + 1;
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    const auto h = area.ReadMessageHeader(mid);
+    if (h && h->data().qscan > qscan) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+std::optional<qwk_message_t> to_qwk_message(const Message& msg, int msgnum, uint16_t conf_num,
+                                            const qwk_text_options& options) {
+  const auto& h = msg.header();
+  if (h.deleted() || h.unvalidated()) {
+    return std::nullopt;
+  }
+  if (msg.text().string().empty()) {
+    return std::nullopt;
+  }
+  // Never reveal the sender of anonymous posts in offline packets.
+  const auto from = (h.anony() & 0x0f) ? std::string(">UNKNOWN<") : h.from();
+
+  auto qwk_address = StrCat(QWK_FROM, from);
+  if (qwk_address.find('@') != std::string::npos) {
+    qwk_address.append(fmt::format("@{}", h.from_system()));
+  }
+
+  qwk_message_t m{};
+  m.msgnum = msgnum;
+  m.conf_num = conf_num;
+  m.daten = h.daten();
+  const auto to = h.to();
+  m.to = to == "All" ? "ALL" : to;
+  m.from = ToStringUpperCase(stripcolors(from));
+  m.subject = stripcolors(h.title());
+  m.text = make_qwk_ready(msg.text().string(), qwk_address, options);
+  return m;
+}
+
+qwk_sub_messages_t read_sub(MessageApi& api, const qwk_sub_t& s,
+                            const qwk_builder_options_t& options) {
+  qwk_sub_messages_t r{};
+  r.result.conf_num = s.conf_num;
+  r.result.last_qscan = s.qscan;
+  try {
+    auto area = api.Open(s.sub, -1);
+    if (!area) {
+      return r;
+    }
+    const auto total = area->number_of_messages();
+    r.result.total = total;
+    const auto start = first_new_message(*area, total, s.qscan);
+    r.result.num_new = total - start + 1;
+
+    auto limit = r.result.num_new;
+    if (options.max_msgs_per_sub > 0) {
+      limit = std::min(limit, options.max_msgs_per_sub);
+    }
+    if (options.max_msgs > 0) {
+      limit = std::min(limit, options.max_msgs);
+    }
+    for (auto i = start; i <= total && static_cast<int>(r.messages.size()) < limit; i++) {
+      const auto msg = area->ReadMessage(i);
+      if (!msg) {
+        continue;
+      }
+      const auto qscan = msg->header().data().qscan;
+      if (auto m = to_qwk_message(*msg, i, s.conf_num, options.text)) {
+        r.messages.emplace_back(qscan, format_qwk_message(*m));
+      }
+    }
+  } catch (const bad_message_area& e) {
+    LOG(ERROR) << "Unable to open message area: " << e.what();
+  }
+  return r;
+}
+
+}
+
+QwkPacketBuilder::QwkPacketBuilder(MessageApi& api, qwk_builder_options_t options)
+    : api_(api), options_(std::move(options)) {}
+
+std::vector<qwk_sub_result_t> QwkPacketBuilder::Build(const std::vector<qwk_sub_t>& subs,
+                                                      QwkPacketWriter& writer) {
+  std::vector<qwk_sub_result_t> results;
+  const auto num_threads = static_cast<size_t>(std::max(1, options_.num_threads));
+  std::deque<std::future<qwk_sub_messages_t>> pending;
+  size_t next = 0;
+  auto full = false;
+
+  while (!full && (next < subs.size() || !pending.empty())) {
+    // Keep num_threads subs being read while the previous ones are written.
+    while (next < subs.size() && pending.size() < num_threads) {
+      const auto& s = subs.at(next++);
+      pending.emplace_back(
+          std::async(std::launch::async, [this, &s] { return read_sub(api_, s, options_); }));
+    }
+    auto r = pending.front().get();
+    pending.pop_front();
+
+    for (const auto& [qscan, blocks] : r.messages) {
+      if (options_.max_msgs > 0 && writer.num_messages() >= options_.max_msgs) {
+        full = true;
+        break;
+      }
+      if (!writer.Write(blocks)) {
+        LOG(ERROR) << "Error writing QWK packet.";
+        full = true;
+        break;
+      }
+      r.result.last_qscan = qscan;
+      ++r.result.num_written;
+    }
+    results.push_back(r.result);
+  }
+  // Subs still being read when the packet is full are waited for by the
+  // future destructors and then discarded.
+  return results;
+}
+
+}
@@ -0,0 +1,83 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2022, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_QWK_QWK_BUILDER_H
+#define INCLUDED_SDK_QWK_QWK_BUILDER_H
+
+#include "sdk/subxtr.h"
+#include "sdk/msgapi/message_api.h"
+#include "sdk/qwk/qwk_packet.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wwiv::sdk::qwk {
+
+/** A sub to add to a QWK packet */
+struct qwk_sub_t {
+  subboard_t sub;
+  /** Conference number in the packet, subnum + 1 on the BBS. */
+  uint16_t conf_num{0};
+  /** Messages with a qscan pointer after this one are added. */
+  uint32_t qscan{0};
+};
+
+struct qwk_builder_options_t {
+  qwk_text_options text;
+  /** Maximum number of messages in the packet, 0 for no limit. */
+  int max_msgs{0};
+  /** Maximum number of messages from each sub, 0 for no limit. */
+  int max_msgs_per_sub{0};
+  /** Number of subs read at the same time. */
+  int num_threads{4};
+};
+
+/** What was added to the packet from a sub */
+struct qwk_sub_result_t {
+  uint16_t conf_num{0};
+  int total{0};
+  int num_new{0};
+  int num_written{0};
+  /** qscan pointer of the last message written, or the original one. */
+  uint32_t last_qscan{0};
+};
+
+/**
+ * Builds the messages for a QWK packet from many subs.
+ *
+ * Each sub is read and converted into MESSAGES.DAT blocks on a worker
+ * thread, up to num_threads subs at a time.  The calling thread hands the
+ * results to the QwkPacketWriter in sub order, so packets are identical to
+ * ones built one sub at a time.
+ */
+class QwkPacketBuilder final {
+public:
+  QwkPacketBuilder(msgapi::MessageApi& api, qwk_builder_options_t options);
+
+  /** Adds the new messages in subs to writer, returning what was added from each. */
+  std::vector<qwk_sub_result_t> Build(const std::vector<qwk_sub_t>& subs,
+                                      QwkPacketWriter& writer);
+
+private:
+  msgapi::MessageApi& api_;
+  const qwk_builder_options_t options_;
+};
+
+}
+
+#endif
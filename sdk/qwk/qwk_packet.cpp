@@ -0,0 +1,318 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2022, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "sdk/qwk/qwk_packet.h"
+
+#include "core/datetime.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "core/textfile.h"
+#include "fmt/format.h"
+#include "sdk/ansi/makeansi.h"
+#include <cstddef>
+#include <cstring>
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace wwiv::sdk::qwk {
+
+// Write MESSAGES.DAT and the indexes in large chunks.
+static constexpr size_t kMessagesBufferSize = 256 * 1024;
+static constexpr size_t kIndexBufferSize = 64 * 1024;
+
+// Give us 3000 extra bytes to play with in the message text
+static constexpr int PAD_SPACE = 3000;
+
+static void insert_after_routing(std::string& text, const std::string& text2insert) {
+  const auto text_to_insert_nc = StrCat(stripcolors(text2insert), "\xE3\xE3");
+
+  size_t pos = 0;
+  const auto len = text.size();
+  while (pos < len && text[pos] != 0) {
+    if (text[pos] == 4 && pos + 1 < len && text[pos + 1] == '0') {
+      while (pos < len && text[pos] != '\xE3') {
+        ++pos;
+      }
+
+      if (pos < len && text[pos] == '\xE3') {
+        ++pos;
+      }
+    } else {
+      text.insert(pos, text_to_insert_nc);
+      return;
+    }
+  }
+}
+
+std::string make_qwk_ready(const std::string& text, const std::string& address,
+                           const qwk_text_options& options) {
+  std::string::size_type pos = 0;
+
+  std::string temp;
+  temp.reserve(text.size() + PAD_SPACE + 1);
+
+  // Safe lookahead, since text is not always null terminated.
+  const auto at = [&text](std::string::size_type p) -> char {
+    return p < text.size() ? text[p] : '\0';
+  };
+
+  while (pos < text.size()) {
+    const auto x = static_cast<unsigned char>(text[pos]);
+    const auto xo = text[pos];
+    if (x == 0) {
+      break;
+    }
+    if (x == 13) {
+      temp.push_back('\xE3');
+      ++pos;
+    } else if (x == 10 || x < 3) {
+      // Strip out Newlines, NULLS, 1's and 2's
+      ++pos;
+    } else if (options.remove_color && x == 3) {
+      pos += 2;
+    } else if (options.convert_color && x == 3) {
+      temp.append(ansi::makeansi(at(pos + 1) - '0', 255));
+      pos += 2;
+    } else if (!options.keep_routing && x == 4 && at(pos + 1) == '0') {
+      while (pos < text.size() && text[pos] != '\xE3' && text[pos] != '\r' && text[pos] != 0) {
+        ++pos;
+      }
+      ++pos;
+      if (pos < text.size() && text[pos] == '\n') {
+        ++pos;
+      }
+    } else if (x == 4 && at(pos + 1) != '0') {
+      pos += 2;
+    } else {
+      temp.push_back(xo);
+      ++pos;
+    }
+  }
+
+  // Only add address if it does not yet exist
+  if (temp.find("QWKFrom:") != std::string::npos) {
+    // Don't search for diamond or number, just text after that
+    insert_after_routing(temp, address);
+  }
+
+  temp.shrink_to_fit();
+  return temp;
+}
+
+float ieee_to_msbin(float f) {
+  uint8_t ieee[4];
+  memcpy(ieee, &f, sizeof(ieee));
+  uint8_t msbin[4]{};
+
+  const uint8_t sign = ieee[3] & 0x80;
+  uint8_t msbin_exp = 0x00;
+  msbin_exp |= ieee[3] << 1;
+  msbin_exp |= ieee[2] >> 7;
+
+  // An ieee exponent of 0xfe overflows in MBF
+  if (msbin_exp != 0xfe) {
+    // actually, -127 + 128 + 1
+    msbin_exp += 2;
+    msbin[3] = msbin_exp;
+    msbin[2] = sign | (ieee[2] & 0x7f);
+    msbin[1] = ieee[1];
+    msbin[0] = ieee[0];
+  }
+
+  float result;
+  memcpy(&result, msbin, sizeof(result));
+  return result;
+}
+
+// Copies s into a space padded field, like strncpy followed by replacing
+// the nulls with spaces.
+static void set_field(char* field, size_t size, const std::string& s) {
+  for (size_t i = 0; i < size && i < s.size() && s[i] != 0; i++) {
+    field[i] = s[i];
+  }
+}
+
+qwk_message_blocks format_qwk_message(const qwk_message_t& m) {
+  const auto len = m.text.size();
+  const auto amount_blocks = static_cast<int>(len / QWK_BLOCK_SIZE + 2);
+
+  qwk_message_blocks result{};
+  result.conf_num = m.conf_num;
+  result.personal = m.personal;
+  result.blocks.assign(static_cast<size_t>(amount_blocks) * QWK_BLOCK_SIZE, ' ');
+
+  qwk_record rec{};
+  memset(&rec, ' ', sizeof(qwk_record));
+  set_field(rec.msgnum, sizeof(rec.msgnum), std::to_string(m.msgnum));
+  const auto date = DateTime::from_daten(m.daten).to_string("%m-%d-%y");
+  set_field(rec.date, sizeof(rec.date), date);
+  set_field(rec.to, sizeof(rec.to), m.to);
+  set_field(rec.from, sizeof(rec.from), m.from);
+  set_field(rec.subject, sizeof(rec.subject), m.subject);
+  set_field(rec.amount_blocks, sizeof(rec.amount_blocks), std::to_string(amount_blocks));
+  rec.conf_num = m.conf_num;
+  rec.logical_num = 0;
+  memcpy(result.blocks.data(), &rec, sizeof(qwk_record));
+
+  for (size_t this_pos = 0; this_pos < len; this_pos += QWK_BLOCK_SIZE) {
+    // The last partial block has always been written without the final
+    // character of the text, keep doing that so packets are unchanged.
+    const auto size = this_pos + QWK_BLOCK_SIZE > len ? len - this_pos - 1 : QWK_BLOCK_SIZE;
+    memcpy(result.blocks.data() + QWK_BLOCK_SIZE + this_pos, m.text.data() + this_pos, size);
+  }
+  return result;
+}
+
+QwkPacketWriter::QwkPacketWriter(std::filesystem::path messages_dat,
+                                 std::filesystem::path index_dir)
+    : messages_dat_(std::move(messages_dat)), index_dir_(std::move(index_dir)),
+      file_(messages_dat_) {}
+
+QwkPacketWriter::~QwkPacketWriter() { Close(); }
+
+bool QwkPacketWriter::Open() {
+  if (!file_.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile |
+                  File::modeTruncate)) {
+    LOG(ERROR) << "Unable to create: " << messages_dat_;
+    return false;
+  }
+  ok_ = true;
+  buffer_.reserve(kMessagesBufferSize + QWK_BLOCK_SIZE * 64);
+  // Required header at the start of MESSAGES.DAT
+  buffer_.append("Produced by Qmail...Copyright (c) 1987 by Sparkware.  All Rights Reserved "
+                 "(For Compatibility with Qmail)");
+  buffer_.resize(QWK_BLOCK_SIZE, ' ');
+  return true;
+}
+
+bool QwkPacketWriter::Write(const qwk_message_blocks& m) {
+  if (!ok_) {
+    return false;
+  }
+  const auto start = buffer_.size();
+  buffer_.append(m.blocks);
+  const auto logical_num = static_cast<uint16_t>(logical_num_);
+  memcpy(buffer_.data() + start + offsetof(qwk_record, logical_num), &logical_num,
+         sizeof(uint16_t));
+
+  qwk_index ndx{};
+  ndx.pos = ieee_to_msbin(static_cast<float>(block_pos_));
+  ndx.nouse = 0;
+  const auto* ndx_bytes = reinterpret_cast<const char*>(&ndx);
+  if (m.conf_num == 0) {
+    // email conference is always zero.
+    index_buffers_["000.NDX"].append(ndx_bytes, sizeof(qwk_index));
+  } else {
+    index_buffers_[fmt::format("{:03}.NDX", m.conf_num)].append(ndx_bytes, sizeof(qwk_index));
+  }
+  if (m.personal) {
+    index_buffers_["PERSONAL.NDX"].append(ndx_bytes, sizeof(qwk_index));
+  }
+  index_buffered_ += sizeof(qwk_index);
+
+  block_pos_ += m.num_blocks();
+  ++logical_num_;
+
+  if (buffer_.size() >= kMessagesBufferSize || index_buffered_ >= kIndexBufferSize) {
+    return Flush();
+  }
+  return ok_;
+}
+
+bool QwkPacketWriter::FlushIndex(const std::string& filename, std::string& buffer) {
+  if (buffer.empty()) {
+    return true;
+  }
+  File f(FilePath(index_dir_, filename));
+  // The first flush of an index creates it, later ones append to it.
+  const auto created = index_files_.insert(filename).second;
+  const auto mode = File::modeReadWrite | File::modeBinary | File::modeCreateFile |
+                    (created ? File::modeTruncate : File::modeAppend);
+  if (!f.Open(mode) || f.Write(buffer) != static_cast<File::size_type>(buffer.size())) {
+    LOG(ERROR) << "Error writing: " << f;
+    return false;
+  }
+  buffer.clear();
+  return true;
+}
+
+bool QwkPacketWriter::Flush() {
+  if (!ok_) {
+    return false;
+  }
+  if (!buffer_.empty()) {
+    if (file_.Write(buffer_) != static_cast<File::size_type>(buffer_.size())) {
+      // Must be out of disk space
+      LOG(ERROR) << "Error writing: " << messages_dat_;
+      ok_ = false;
+    }
+    buffer_.clear();
+  }
+  for (auto& [filename, buffer] : index_buffers_) {
+    if (!FlushIndex(filename, buffer)) {
+      ok_ = false;
+    }
+  }
+  index_buffered_ = 0;
+  return ok_;
+}
+
+bool QwkPacketWriter::Close() {
+  if (!file_.IsOpen()) {
+    return ok_;
+  }
+  Flush();
+  file_.Close();
+  return ok_;
+}
+
+bool write_control_dat(const std::filesystem::path& path, const qwk_control_dat_t& c) {
+  TextFile fp(path, "wd");
+  if (!fp) {
+    return false;
+  }
+
+  fp.WriteLine(fmt::format("{}.qwk", c.system_name));
+  fp.WriteLine();  // System City and State
+  fp.WriteLine(c.system_phone);
+  fp.WriteLine(c.sysop_name);
+  fp.WriteLine(fmt::format("00000,{}", c.system_name));
+  fp.WriteLine(c.date_time);
+  fp.WriteLine(c.user_name);
+  fp.WriteLine("");
+  fp.WriteLine("0");
+  fp.WriteLine(c.num_messages);
+  fp.WriteLine(c.subs.size());
+
+  fp.WriteLine("0");
+  fp.WriteLine("E-Mail");
+
+  for (const auto& [sub_num, sub_name] : c.subs) {
+    // Write the subs in the format of "Sub Number\r\nSub Name\r\n"
+    fp.WriteLine(sub_num);
+    fp.WriteLine(sub_name);
+  }
+
+  fp.WriteLine(c.hello);
+  fp.WriteLine(c.news);
+  fp.WriteLine(c.bye);
+  return fp.Close();
+}
+
+}
@@ -0,0 +1,191 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2022, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_QWK_QWK_PACKET_H
+#define INCLUDED_SDK_QWK_QWK_PACKET_H
+
+#include "core/file.h"
+#include "core/wwivport.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wwiv::sdk::qwk {
+
+#pragma pack(push, 1)
+struct qwk_record {
+  char status;   // ' ' for public
+
+  char msgnum[7]; // all strings are space padded
+  char date[8];
+  char time[5];
+
+  char to[25]; // Uppercase, left justified
+  char from[25]; // Uppercase left justified
+  char subject[25];
+  char password[12];
+  char reference[8];
+
+  char amount_blocks[6];
+  char flag;
+
+  uint16_t conf_num;
+  uint16_t logical_num;
+  char tagline;
+};
+
+struct qwk_index {
+  float pos;
+  char nouse;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(qwk_record) == 128u, "qwk_record should be 128 bytes");
+static_assert(sizeof(qwk_index) == 5u, "qwk_index should be 5 bytes");
+
+/** Size of every block in MESSAGES.DAT */
+static constexpr int QWK_BLOCK_SIZE = sizeof(qwk_record);
+
+/** Prefix of the routing line added to messages from QWK networks. */
+inline constexpr char QWK_FROM[] = "\x04" "0QWKFrom:";
+
+/** Per user options controlling how message text is rewritten for QWK. */
+struct qwk_text_options {
+  bool remove_color{false};
+  bool convert_color{false};
+  bool keep_routing{false};
+};
+
+/**
+ * Takes text, deletes all ascii '10' and converts '13' to '227' (π) and does
+ * the color and routing line conversions specified by options.  If the text
+ * has a QWKFrom line, address is inserted after the routing lines.
+ */
+std::string make_qwk_ready(const std::string& text, const std::string& address,
+                           const qwk_text_options& options);
+
+/** Converts an IEEE float into the Microsoft Binary Format used by .NDX files. */
+float ieee_to_msbin(float f);
+
+/** A message to be added to a QWK packet, already converted by make_qwk_ready. */
+struct qwk_message_t {
+  int msgnum{0};
+  /** Conference number, 0 is used for email. */
+  uint16_t conf_num{0};
+  daten_t daten{0};
+  std::string to;
+  std::string from;
+  std::string subject;
+  std::string text;
+  /** Also add this message to PERSONAL.NDX */
+  bool personal{false};
+};
+
+/**
+ * A message formatted as the 128 byte blocks written to MESSAGES.DAT.  The
+ * logical message number in the header is filled in by QwkPacketWriter since
+ * it depends on the order messages are written.
+ */
+struct qwk_message_blocks {
+  uint16_t conf_num{0};
+  bool personal{false};
+  std::string blocks;
+
+  [[nodiscard]] int num_blocks() const noexcept {
+    return static_cast<int>(blocks.size() / QWK_BLOCK_SIZE);
+  }
+};
+
+/** Formats m into the header and text blocks for MESSAGES.DAT */
+qwk_message_blocks format_qwk_message(const qwk_message_t& m);
+
+/**
+ * Writes MESSAGES.DAT and the .NDX files for a QWK packet.
+ *
+ * All output is buffered and written in large chunks, so this should be the
+ * only writer for a packet.  Write errors are sticky and reported by Write and
+ * Close.
+ */
+class QwkPacketWriter final {
+public:
+  /** Creates the writer for a packet whose MESSAGES.DAT is messages_dat. */
+  QwkPacketWriter(std::filesystem::path messages_dat, std::filesystem::path index_dir);
+  ~QwkPacketWriter();
+  QwkPacketWriter(const QwkPacketWriter&) = delete;
+  QwkPacketWriter& operator=(const QwkPacketWriter&) = delete;
+
+  /** Creates MESSAGES.DAT and writes the required header block. */
+  bool Open();
+  /** Adds a message to MESSAGES.DAT and the indexes. */
+  bool Write(const qwk_message_blocks& m);
+  /** Writes all pending data to disk. */
+  bool Flush();
+  /** Flushes and closes all files. */
+  bool Close();
+
+  /** Number of messages written to this packet. */
+  [[nodiscard]] int num_messages() const noexcept { return logical_num_ - 1; }
+  /** Logical number that will be used for the next message. */
+  [[nodiscard]] int next_logical_num() const noexcept { return logical_num_; }
+  [[nodiscard]] bool ok() const noexcept { return ok_; }
+
+private:
+  bool FlushIndex(const std::string& filename, std::string& buffer);
+
+  const std::filesystem::path messages_dat_;
+  const std::filesystem::path index_dir_;
+  core::File file_;
+  std::string buffer_;
+  /** Pending index entries by .NDX filename */
+  std::map<std::string, std::string> index_buffers_;
+  /** .NDX files that have been created by this writer */
+  std::set<std::string> index_files_;
+  size_t index_buffered_{0};
+  int logical_num_{1};
+  // MESSAGES.DAT block (1 based) of the next message. Block 1 is the header.
+  int block_pos_{2};
+  bool ok_{false};
+};
+
+/** Contents of CONTROL.DAT */
+struct qwk_control_dat_t {
+  std::string system_name;
+  std::string system_phone;
+  std::string sysop_name;
+  /** Packet creation time as 'mm-dd-yyyy,hh:mm:ss' */
+  std::string date_time;
+  std::string user_name;
+  int num_messages{0};
+  /** Conference number and name for each sub in the packet, email is implied. */
+  std::vector<std::pair<int, std::string>> subs;
+  std::string hello;
+  std::string news;
+  std::string bye;
+};
+
+/** Writes CONTROL.DAT for a QWK packet. */
+bool write_control_dat(const std::filesystem::path& path, const qwk_control_dat_t& c);
+
+}
+
+#endif
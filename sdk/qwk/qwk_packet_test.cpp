@@ -0,0 +1,189 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2022, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/file.h"
+#include "core/strings.h"
+#include "core/test/file_helper.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/msgapi.h"
+#include "sdk/qwk/qwk_builder.h"
+#include "sdk/qwk/qwk_packet.h"
+#include "sdk/sdk_helper.h"
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::sdk::qwk;
+using namespace wwiv::strings;
+
+static std::string read_file(const std::filesystem::path& p) {
+  File f(p);
+  if (!f.Open(File::modeReadOnly | File::modeBinary)) {
+    return {};
+  }
+  std::string s(static_cast<size_t>(f.length()), '\0');
+  f.Read(s.data(), f.length());
+  return s;
+}
+
+static qwk_record header_of(const std::string& blocks, int block_num) {
+  qwk_record r{};
+  memcpy(&r, blocks.data() + static_cast<size_t>(block_num) * QWK_BLOCK_SIZE, sizeof(qwk_record));
+  return r;
+}
+
+TEST(QwkPacketTest, MakeQwkReady) {
+  const std::string text = "Hello\r\nWorld\r\n";
+  EXPECT_EQ("Hello\xE3World\xE3", make_qwk_ready(text, "", {}));
+}
+
+TEST(QwkPacketTest, MakeQwkReady_Color) {
+  const std::string text = "\x03" "1Hello";
+  EXPECT_EQ("Hello", make_qwk_ready(text, "", qwk_text_options{true, false, false}));
+  EXPECT_EQ("\x03" "1Hello", make_qwk_ready(text, "", {}));
+  EXPECT_NE(std::string::npos,
+            make_qwk_ready(text, "", qwk_text_options{false, true, false}).find("\x1b["));
+}
+
+TEST(QwkPacketTest, MakeQwkReady_Routing) {
+  const std::string text = "\x04" "0R:routing\r\nHello\r\n";
+  EXPECT_EQ("Hello\xE3", make_qwk_ready(text, "", {}));
+  EXPECT_EQ("\x04" "0R:routing\xE3Hello\xE3",
+            make_qwk_ready(text, "", qwk_text_options{false, false, true}));
+}
+
+TEST(QwkPacketTest, IeeeToMsbin) {
+  const auto f = ieee_to_msbin(2.0f);
+  uint8_t b[4];
+  memcpy(b, &f, sizeof(b));
+  EXPECT_EQ(0x00, b[0]);
+  EXPECT_EQ(0x00, b[1]);
+  EXPECT_EQ(0x00, b[2]);
+  EXPECT_EQ(0x82, b[3]);
+}
+
+TEST(QwkPacketTest, FormatMessage) {
+  qwk_message_t m{};
+  m.msgnum = 12;
+  m.conf_num = 3;
+  m.to = "ALL";
+  m.from = "SYSOP";
+  m.subject = "Hi";
+  m.text = std::string(200, 'x');
+
+  const auto b = format_qwk_message(m);
+  ASSERT_EQ(3, b.num_blocks());
+  const auto h = header_of(b.blocks, 0);
+  EXPECT_EQ("12     ", std::string(h.msgnum, sizeof(h.msgnum)));
+  EXPECT_EQ("3     ", std::string(h.amount_blocks, sizeof(h.amount_blocks)));
+  EXPECT_EQ(StrCat("ALL", std::string(22, ' ')), std::string(h.to, sizeof(h.to)));
+  EXPECT_EQ(3, h.conf_num);
+  EXPECT_EQ(std::string(128, 'x'), b.blocks.substr(128, 128));
+}
+
+TEST(QwkPacketTest, Writer) {
+  const wwiv::core::test::FileHelper helper;
+  const auto dat = FilePath(helper.TempDir(), "MESSAGES.DAT");
+  QwkPacketWriter w(dat, helper.TempDir());
+  ASSERT_TRUE(w.Open());
+
+  qwk_message_t email{};
+  email.personal = true;
+  email.text = "email";
+  qwk_message_t post{};
+  post.conf_num = 2;
+  post.text = std::string(300, 'p');
+  ASSERT_TRUE(w.Write(format_qwk_message(email)));
+  ASSERT_TRUE(w.Write(format_qwk_message(post)));
+  EXPECT_EQ(2, w.num_messages());
+  ASSERT_TRUE(w.Close());
+
+  const auto contents = read_file(dat);
+  // header + (1 + 1) + (1 + 3)
+  ASSERT_EQ(7u * QWK_BLOCK_SIZE, contents.size());
+  EXPECT_TRUE(starts_with(contents, "Produced by Qmail"));
+  EXPECT_EQ(1, header_of(contents, 1).logical_num);
+  EXPECT_EQ(2, header_of(contents, 3).logical_num);
+
+  const auto zero = read_file(FilePath(helper.TempDir(), "000.NDX"));
+  ASSERT_EQ(sizeof(qwk_index), zero.size());
+  EXPECT_EQ(zero, read_file(FilePath(helper.TempDir(), "PERSONAL.NDX")));
+  const auto two = read_file(FilePath(helper.TempDir(), "002.NDX"));
+  ASSERT_EQ(sizeof(qwk_index), two.size());
+  qwk_index ndx{};
+  memcpy(&ndx, two.data(), sizeof(qwk_index));
+  EXPECT_EQ(ieee_to_msbin(4.0f), ndx.pos);
+}
+
+TEST(QwkPacketTest, Builder) {
+  SdkHelper helper;
+  MessageApiOptions options;
+  options.overflow_strategy = OverflowStrategy::delete_none;
+  WWIVMessageApi api(options, helper.config(), {}, new NullLastReadImpl());
+
+  std::vector<qwk_sub_t> subs;
+  uint32_t first_qscan = 0;
+  for (const auto* name : {"a1", "a2", "a3"}) {
+    subboard_t sub{};
+    sub.filename = name;
+    sub.storage_type = 2;
+    ASSERT_TRUE(api.Create(sub, -1));
+    auto area = api.Open(sub, -1);
+    for (auto i = 0; i < 3; i++) {
+      auto msg = area->CreateMessage();
+      msg.header().set_title(fmt::format("{} #{}", name, i));
+      msg.header().set_from("Rushfan");
+      msg.header().set_daten(915192000);
+      msg.set_text("Hello\r\n");
+      ASSERT_TRUE(area->AddMessage(msg, {}));
+    }
+    if (!first_qscan) {
+      first_qscan = area->ReadMessageHeader(1)->data().qscan;
+    }
+    subs.push_back(qwk_sub_t{sub, static_cast<uint16_t>(subs.size() + 1), 0});
+  }
+  // Only the last 2 messages of the first sub are new.
+  subs.front().qscan = first_qscan;
+
+  QwkPacketWriter w(FilePath(helper.scratch(), "MESSAGES.DAT"), helper.scratch());
+  ASSERT_TRUE(w.Open());
+  qwk_builder_options_t bo{};
+  bo.num_threads = 2;
+  bo.max_msgs = 7;
+  QwkPacketBuilder builder(api, bo);
+  const auto results = builder.Build(subs, w);
+  ASSERT_TRUE(w.Close());
+
+  ASSERT_EQ(3u, results.size());
+  EXPECT_EQ(2, results.at(0).num_new);
+  EXPECT_EQ(2, results.at(0).num_written);
+  EXPECT_EQ(3, results.at(1).num_written);
+  EXPECT_EQ(2, results.at(2).num_written);
+  EXPECT_EQ(7, w.num_messages());
+
+  const auto contents = read_file(FilePath(helper.scratch(), "MESSAGES.DAT"));
+  const auto h = header_of(contents, 1);
+  EXPECT_EQ(1, h.conf_num);
+  EXPECT_EQ("a1 #1", std::string(h.subject, 5));
+  EXPECT_EQ("RUSHFAN", std::string(h.from, 7));
+}
@@ -27,6 +27,7 @@
 #include "fmt/printf.h"
 #include "sdk/filenames.h"
 
+#include <ctime>
 #include <memory>
 #include <string>
 #include <utility>
@@ -37,6 +38,9 @@ using namespace wwiv::strings;
 
 namespace wwiv::sdk {
 
+// How often the shared counters are written back to STATUS.DAT.
+static constexpr int kWriteBackSeconds = 5;
+
 static std::string sysoplog_filename(const std::string& d) {
   return fmt::sprintf("%c%c%c%c%c%c.log", d[6], d[7], d[0], d[1], d[3], d[4]);
 }
@@ -139,7 +143,19 @@ bool Status::NewDay() {
 }
 
 // StatusMgr
+StatusMgr::~StatusMgr() = default;
+
+SharedStatusCounters* StatusMgr::shared_counters() {
+  if (!shared_counters_opened_) {
+    shared_counters_opened_ = true;
+    shared_counters_ = SharedStatusCounters::Open(datadir_);
+  }
+  return shared_counters_.get();
+}
+
 bool StatusMgr::reload_status() {
+  // Opened first since creating them reads STATUS.DAT.
+  auto* counters = shared_counters();
   if (auto file = DataFile<statusrec_t>(FilePath(datadir_, STATUS_DAT),
                                         File::modeBinary | File::modeReadWrite)) {
     char oldFileChangeFlags[7];
@@ -149,6 +165,9 @@ bool StatusMgr::reload_status() {
     if (!file.Read(0, &statusrec_)) {
       return false;
     }
+    if (counters) {
+      counters->copy_to(statusrec_);
+    }
     if (!callback_) {
       return true;
     }
@@ -166,6 +185,7 @@ bool StatusMgr::reload_status() {
 }
 
 std::unique_ptr<Status> StatusMgr::get_status() {
+  write_back_if_due();
   this->reload_status();
   return std::make_unique<Status>(datadir_, statusrec_);
 }
@@ -176,11 +196,24 @@ int StatusMgr::user_count() {
 
 bool StatusMgr::Run(status_txn_fn fn) {
   auto at_exit = finally([&] { this->reload_status(); });
+  // Opened first since creating them reads STATUS.DAT.
+  auto* counters = shared_counters();
+  // Denying others read and write access holds an exclusive lock on
+  // STATUS.DAT until the transaction has been written.
   if (auto file = DataFile<statusrec_t>(FilePath(datadir_, STATUS_DAT),
-                                        File::modeBinary | File::modeReadWrite)) {
+                                        File::modeBinary | File::modeReadWrite,
+                                        File::shareDenyReadWrite)) {
     if (file.Read(0, &statusrec_)) {
+      if (counters) {
+        counters->copy_to(statusrec_);
+      }
       Status status(datadir_, statusrec_);
       fn(status);
+      if (counters) {
+        counters->add_changes(statusrec_, status.status_);
+        counters->mark_written(time(nullptr));
+        counters->copy_to(status.status_);
+      }
       file.Write(0, &status.status_);
     }
     return true;
@@ -188,5 +221,49 @@ bool StatusMgr::Run(status_txn_fn fn) {
   return false;
 }
 
+void StatusMgr::write_back_if_due() {
+  auto* counters = shared_counters();
+  if (counters && counters->dirty() &&
+      counters->claim_write_back(time(nullptr), kWriteBackSeconds)) {
+    Run([](Status&) {});
+  }
+}
+
+uint32_t StatusMgr::next_qscanptr() {
+  if (auto* counters = shared_counters()) {
+    const auto qscan = counters->fetch_add(SharedStatusCounters::qscanptr, 1);
+    write_back_if_due();
+    return qscan;
+  }
+  uint32_t qscan = 0;
+  Run([&](Status& s) { qscan = s.next_qscanptr(); });
+  return qscan;
+}
+
+void StatusMgr::increment_msgs_today(int count) {
+  if (auto* counters = shared_counters()) {
+    counters->fetch_add(SharedStatusCounters::msgs_today, static_cast<uint32_t>(count));
+    write_back_if_due();
+    return;
+  }
+  Run([=](Status& s) { s.msgs_today(s.msgs_today() + count); });
+}
+
+void StatusMgr::increment_filechanged(int nFlag) {
+  if (auto* counters = shared_counters()) {
+    counters->fetch_add(SharedStatusCounters::filechange + nFlag, 1);
+    write_back_if_due();
+    return;
+  }
+  Run([=](Status& s) { s.increment_filechanged(nFlag); });
+}
+
+std::optional<status_counters_t> StatusMgr::counters() {
+  if (auto* counters = shared_counters()) {
+    return counters->counters();
+  }
+  return std::nullopt;
+}
+
 
 }
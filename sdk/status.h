@@ -20,11 +20,13 @@
 #define INCLUDED_SDK_STATUS_H
 
 #include "core/strings.h"
+#include "sdk/status_counters.h"
 #include "sdk/vardec.h"
 
 #include <filesystem>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -120,6 +122,10 @@ private:
 /*!
  * @class StatusMgr
  * manages STATUS.DAT
+ *
+ * Where shared memory is available the counters in SharedStatusCounters
+ * are kept there and copied over what is read from STATUS.DAT, otherwise
+ * every change is a locked read and write of STATUS.DAT.
  */
 class StatusMgr {
 public:
@@ -132,7 +138,7 @@ public:
   StatusMgr(const std::filesystem::path& datadir, status_callabck_fn callback)
       : datadir_(datadir), callback_(std::move(callback)) {}
   explicit StatusMgr(const std::filesystem::path& datadir) : datadir_(datadir) {}
-  virtual ~StatusMgr() = default;
+  virtual ~StatusMgr();
   /*!
    * @function Loads the contents of STATUS.DAT
    * @return true on success
@@ -148,10 +154,33 @@ public:
 
   bool Run(status_txn_fn fn);
 
+  /** Returns the next qscan pointer, incrementing it. Returns 0 on error. */
+  uint32_t next_qscanptr();
+  void increment_msgs_today(int count = 1);
+  void increment_filechanged(int nFlag);
+
+  /**
+   * Returns the shared counters as last updated by any node without reading
+   * STATUS.DAT, or std::nullopt if they are not available.
+   */
+  std::optional<status_counters_t> counters();
+
+  /**
+   * Returns file change counter nFlag as of the last time STATUS.DAT was
+   * loaded, without reading it again.
+   */
+  [[nodiscard]] uint8_t filechanged(int nFlag) const { return statusrec_.filechange[nFlag]; }
+
 private:
+  SharedStatusCounters* shared_counters();
+  // Writes the shared counters back to STATUS.DAT if it's been a while.
+  void write_back_if_due();
+
   const std::filesystem::path datadir_;
   status_callabck_fn callback_;
   statusrec_t statusrec_{};
+  bool shared_counters_opened_{false};
+  std::unique_ptr<SharedStatusCounters> shared_counters_;
 };
 
 } // namespace
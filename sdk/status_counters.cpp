@@ -0,0 +1,202 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "sdk/status_counters.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "sdk/filenames.h"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+#if !defined(_WIN32) && !defined(__OS2__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define WWIV_SHARED_STATUS_COUNTERS
+#endif
+
+using namespace wwiv::core;
+
+namespace wwiv::sdk {
+
+// Shared between processes, so these must not need a lock.
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+static constexpr char kMagic[4] = {'W', 'S', 'T', 'C'};
+static constexpr uint32_t kVersion = 1;
+
+struct status_counters_shm_t {
+  char magic[4];
+  uint32_t version;
+  std::atomic<uint32_t> counters[SharedStatusCounters::num_counters];
+  std::atomic<uint32_t> dirty;
+  std::atomic<int64_t> last_write_back;
+};
+
+std::filesystem::path status_counters_filename(const std::filesystem::path& datadir) {
+  return FilePath(datadir, "status.shm");
+}
+
+SharedStatusCounters::SharedStatusCounters(status_counters_shm_t* shm) : shm_(shm) {}
+
+SharedStatusCounters::~SharedStatusCounters() {
+#ifdef WWIV_SHARED_STATUS_COUNTERS
+  munmap(shm_, sizeof(status_counters_shm_t));
+#endif
+}
+
+#ifdef WWIV_SHARED_STATUS_COUNTERS
+static void seed(status_counters_shm_t* shm, const std::filesystem::path& datadir) {
+  statusrec_t s{};
+  if (auto file = DataFile<statusrec_t>(FilePath(datadir, STATUS_DAT),
+                                        File::modeBinary | File::modeReadOnly)) {
+    file.Read(0, &s);
+  }
+  shm->version = kVersion;
+  shm->counters[SharedStatusCounters::qscanptr].store(s.qscanptr);
+  shm->counters[SharedStatusCounters::caller_num].store(s.callernum1);
+  shm->counters[SharedStatusCounters::msgs_today].store(s.msgposttoday);
+  for (auto i = 0; i < 7; i++) {
+    shm->counters[SharedStatusCounters::filechange + i].store(s.filechange[i]);
+  }
+  shm->dirty.store(0);
+  shm->last_write_back.store(time(nullptr));
+  // Written last so nobody uses the counters before they are seeded.
+  memcpy(shm->magic, kMagic, sizeof(kMagic));
+}
+#endif
+
+std::unique_ptr<SharedStatusCounters>
+SharedStatusCounters::Open(const std::filesystem::path& datadir) {
+#ifdef WWIV_SHARED_STATUS_COUNTERS
+  const auto path = status_counters_filename(datadir);
+  const auto fd = open(path.string().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0660);
+  if (fd < 0) {
+    VLOG(1) << "Unable to open " << path << "; errno: " << errno;
+    return nullptr;
+  }
+  // Only one process creates and seeds the counters.
+  flock(fd, LOCK_EX);
+  struct stat st {};
+  if (fstat(fd, &st) != 0 ||
+      (st.st_size < static_cast<off_t>(sizeof(status_counters_shm_t)) &&
+       ftruncate(fd, sizeof(status_counters_shm_t)) != 0)) {
+    LOG(ERROR) << "Unable to size " << path << "; errno: " << errno;
+    flock(fd, LOCK_UN);
+    close(fd);
+    return nullptr;
+  }
+  auto* m = mmap(nullptr, sizeof(status_counters_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (m == MAP_FAILED) {
+    LOG(ERROR) << "Unable to map " << path << "; errno: " << errno;
+    flock(fd, LOCK_UN);
+    close(fd);
+    return nullptr;
+  }
+  auto* shm = static_cast<status_counters_shm_t*>(m);
+  if (memcmp(shm->magic, kMagic, sizeof(kMagic)) != 0 || shm->version != kVersion) {
+    VLOG(1) << "Creating shared status counters: " << path;
+    seed(shm, datadir);
+  }
+  flock(fd, LOCK_UN);
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  return std::unique_ptr<SharedStatusCounters>(new SharedStatusCounters(shm));
+#else
+  VLOG(2) << "Shared status counters are not supported for: " << datadir;
+  return nullptr;
+#endif
+}
+
+uint32_t SharedStatusCounters::load(int counter) const {
+  return shm_->counters[counter].load();
+}
+
+uint32_t SharedStatusCounters::fetch_add(int counter, uint32_t delta) {
+  const auto previous = shm_->counters[counter].fetch_add(delta);
+  shm_->dirty.store(1);
+  return previous;
+}
+
+bool SharedStatusCounters::compare_exchange(int counter, uint32_t& expected, uint32_t desired) {
+  if (!shm_->counters[counter].compare_exchange_strong(expected, desired)) {
+    return false;
+  }
+  shm_->dirty.store(1);
+  return true;
+}
+
+status_counters_t SharedStatusCounters::counters() const {
+  status_counters_t c{};
+  c.qscanptr = load(qscanptr);
+  c.caller_num = load(caller_num);
+  c.msgs_today = static_cast<uint16_t>(load(msgs_today));
+  for (auto i = 0; i < 7; i++) {
+    c.filechange[i] = static_cast<uint8_t>(load(filechange + i));
+  }
+  return c;
+}
+
+void SharedStatusCounters::copy_to(statusrec_t& s) const {
+  const auto c = counters();
+  s.qscanptr = c.qscanptr;
+  s.callernum1 = c.caller_num;
+  s.msgposttoday = c.msgs_today;
+  memcpy(s.filechange, c.filechange, sizeof(s.filechange));
+}
+
+void SharedStatusCounters::add_changes(const statusrec_t& before, const statusrec_t& after) {
+  // Adding the difference, rather than storing the new value, keeps any
+  // increments made by other processes in the meantime.  The unsigned
+  // arithmetic wraps the same way the narrower fields in STATUS.DAT do.
+  const auto add = [this](int counter, uint32_t delta) {
+    if (delta != 0) {
+      fetch_add(counter, delta);
+    }
+  };
+  add(qscanptr, after.qscanptr - before.qscanptr);
+  add(caller_num, after.callernum1 - before.callernum1);
+  add(msgs_today, static_cast<uint16_t>(after.msgposttoday - before.msgposttoday));
+  for (auto i = 0; i < 7; i++) {
+    add(filechange + i, static_cast<uint8_t>(after.filechange[i] - before.filechange[i]));
+  }
+}
+
+bool SharedStatusCounters::dirty() const { return shm_->dirty.load() != 0; }
+
+bool SharedStatusCounters::claim_write_back(time_t now, int interval_seconds) {
+  auto last = shm_->last_write_back.load();
+  if (now - last < interval_seconds) {
+    return false;
+  }
+  return shm_->last_write_back.compare_exchange_strong(last, now);
+}
+
+void SharedStatusCounters::mark_written(time_t now) {
+  shm_->dirty.store(0);
+  shm_->last_write_back.store(now);
+}
+
+} // namespace wwiv::sdk
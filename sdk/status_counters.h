@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_STATUS_COUNTERS_H
+#define INCLUDED_SDK_STATUS_COUNTERS_H
+
+#include "sdk/vardec.h"
+
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+
+namespace wwiv::sdk {
+
+struct status_counters_shm_t;
+
+/** Counters from STATUS.DAT as last updated by any node. */
+struct status_counters_t {
+  uint32_t qscanptr{0};
+  uint32_t caller_num{0};
+  uint16_t msgs_today{0};
+  uint8_t filechange[7]{};
+};
+
+/**
+ * The frequently updated counters from STATUS.DAT (qscanptr, callernum,
+ * msgposttoday and the file change flags), kept in a file mapped into the
+ * memory of every process using the data directory (as status.shm) so they
+ * can be updated atomically without reading and writing STATUS.DAT.
+ *
+ * STATUS.DAT stays the file everything else reads, so StatusMgr copies
+ * these counters over what it reads from it and writes them back to it
+ * periodically.
+ */
+class SharedStatusCounters final {
+public:
+  static constexpr int qscanptr = 0;
+  static constexpr int caller_num = 1;
+  static constexpr int msgs_today = 2;
+  // Followed by one counter for each of statusrec_t::filechange.
+  static constexpr int filechange = 3;
+  static constexpr int num_counters = filechange + 7;
+
+  ~SharedStatusCounters();
+
+  /**
+   * Maps the shared counters for datadir, creating them from STATUS.DAT if
+   * needed.  Returns nullptr if they can not be used on this platform or
+   * the mapping fails, in which case callers should fall back to updating
+   * STATUS.DAT under its file lock.
+   */
+  static std::unique_ptr<SharedStatusCounters> Open(const std::filesystem::path& datadir);
+
+  [[nodiscard]] uint32_t load(int counter) const;
+  /** Adds delta to counter, returning the previous value. */
+  uint32_t fetch_add(int counter, uint32_t delta);
+  bool compare_exchange(int counter, uint32_t& expected, uint32_t desired);
+
+  [[nodiscard]] status_counters_t counters() const;
+  /** Copies the counters over the ones in s. */
+  void copy_to(statusrec_t& s) const;
+  /** Adds the changes made to the counters between before and after. */
+  void add_changes(const statusrec_t& before, const statusrec_t& after);
+
+  /** True if the counters have changed since they were last written back. */
+  [[nodiscard]] bool dirty() const;
+  /**
+   * Returns true if this caller should write the counters back to
+   * STATUS.DAT, which is at most once every interval_seconds across all
+   * processes.
+   */
+  bool claim_write_back(time_t now, int interval_seconds);
+  /** Marks the counters as written as of now; call before copy_to. */
+  void mark_written(time_t now);
+
+private:
+  explicit SharedStatusCounters(status_counters_shm_t* shm);
+  status_counters_shm_t* shm_;
+};
+
+/** Filename of the shared counters in the data directory. */
+std::filesystem::path status_counters_filename(const std::filesystem::path& datadir);
+
+} // namespace wwiv::sdk
+
+#endif
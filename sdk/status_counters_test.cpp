@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "sdk/filenames.h"
+#include "sdk/status.h"
+#include "sdk/status_counters.h"
+#include "sdk/vardec.h"
+#include <filesystem>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+
+class StatusCountersTest : public testing::Test {
+public:
+  StatusCountersTest() : datadir_(helper_.TempDir()) {}
+
+  void SetUp() override {
+    statusrec_t s{};
+    s.qscanptr = 100;
+    s.callernum1 = 20;
+    s.msgposttoday = 3;
+    s.filechange[Status::file_change_posts] = 7;
+    DataFile<statusrec_t> f(FilePath(datadir_, STATUS_DAT),
+                            File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    ASSERT_TRUE(f);
+    ASSERT_TRUE(f.Write(0, &s));
+  }
+
+  [[nodiscard]] statusrec_t ReadStatusDat() const {
+    statusrec_t s{};
+    DataFile<statusrec_t> f(FilePath(datadir_, STATUS_DAT), File::modeBinary | File::modeReadOnly);
+    EXPECT_TRUE(f.Read(0, &s));
+    return s;
+  }
+
+  test::FileHelper helper_;
+  const std::filesystem::path datadir_;
+};
+
+#ifndef _WIN32
+
+TEST_F(StatusCountersTest, Open_SeedsFromStatusDat) {
+  const auto c = SharedStatusCounters::Open(datadir_);
+  ASSERT_NE(nullptr, c);
+  EXPECT_TRUE(File::Exists(status_counters_filename(datadir_)));
+  const auto counters = c->counters();
+  EXPECT_EQ(100u, counters.qscanptr);
+  EXPECT_EQ(20u, counters.caller_num);
+  EXPECT_EQ(3, counters.msgs_today);
+  EXPECT_EQ(7, counters.filechange[Status::file_change_posts]);
+  EXPECT_FALSE(c->dirty());
+}
+
+TEST_F(StatusCountersTest, Shared) {
+  const auto c1 = SharedStatusCounters::Open(datadir_);
+  const auto c2 = SharedStatusCounters::Open(datadir_);
+  ASSERT_NE(nullptr, c1);
+  ASSERT_NE(nullptr, c2);
+  EXPECT_EQ(100u, c1->fetch_add(SharedStatusCounters::qscanptr, 1));
+  EXPECT_EQ(101u, c2->load(SharedStatusCounters::qscanptr));
+  EXPECT_TRUE(c2->dirty());
+
+  uint32_t expected = 100;
+  EXPECT_FALSE(c2->compare_exchange(SharedStatusCounters::qscanptr, expected, 200));
+  EXPECT_EQ(101u, expected);
+  EXPECT_TRUE(c2->compare_exchange(SharedStatusCounters::qscanptr, expected, 200));
+  EXPECT_EQ(200u, c1->load(SharedStatusCounters::qscanptr));
+}
+
+TEST_F(StatusCountersTest, StatusMgr_NextQScanPtr) {
+  std::vector<std::thread> threads;
+  std::vector<uint32_t> qscans[4];
+  for (auto& q : qscans) {
+    threads.emplace_back([&] {
+      StatusMgr sm(datadir_);
+      for (auto i = 0; i < 100; i++) {
+        q.push_back(sm.next_qscanptr());
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::set<uint32_t> all;
+  for (const auto& q : qscans) {
+    all.insert(q.begin(), q.end());
+  }
+  EXPECT_EQ(400u, all.size());
+  EXPECT_EQ(100u, *all.begin());
+  EXPECT_EQ(499u, *all.rbegin());
+
+  StatusMgr sm(datadir_);
+  EXPECT_EQ(500u, sm.get_status()->qscanptr());
+}
+
+TEST_F(StatusCountersTest, StatusMgr_RunKeepsOtherIncrements) {
+  StatusMgr sm(datadir_);
+  StatusMgr other(datadir_);
+  sm.Run([&](Status& s) {
+    // Made while this transaction has STATUS.DAT locked.
+    other.increment_filechanged(Status::file_change_posts);
+    other.increment_msgs_today();
+    s.increment_filechanged(Status::file_change_posts);
+    s.msgs_today(0);
+    s.increment_caller_num();
+  });
+
+  const auto s = ReadStatusDat();
+  EXPECT_EQ(9, s.filechange[Status::file_change_posts]);
+  EXPECT_EQ(1, s.msgposttoday);
+  EXPECT_EQ(21u, s.callernum1);
+  EXPECT_EQ(s.filechange[Status::file_change_posts], sm.filechanged(Status::file_change_posts));
+}
+
+TEST_F(StatusCountersTest, StatusMgr_ReloadSeesCounters) {
+  StatusMgr sm(datadir_);
+  StatusMgr other(datadir_);
+  ASSERT_TRUE(sm.reload_status());
+  other.increment_filechanged(Status::file_change_email);
+  ASSERT_TRUE(sm.reload_status());
+  EXPECT_EQ(1, sm.filechanged(Status::file_change_email));
+
+  const auto counters = sm.counters();
+  ASSERT_TRUE(counters.has_value());
+  EXPECT_EQ(1, counters->filechange[Status::file_change_email]);
+}
+
+#endif
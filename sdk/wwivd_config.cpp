@@ -84,6 +84,7 @@ void serialize(Archive& ar, wwivd_matrix_entry_t &a) {
   SERIALIZE(a, data_mode);
   SERIALIZE(a, working_directory);
   SERIALIZE(a, wwiv_bbs);
+  SERIALIZE(a, fork_server_socket);
 }
 
 template <class Archive>
@@ -94,6 +95,9 @@ void serialize(Archive & ar, wwivd_config_t &a) {
   SERIALIZE(a, binkp_cmd);
   SERIALIZE(a, do_network_callouts);
   SERIALIZE(a, network_callout_cmd);
+  SERIALIZE(a, max_concurrent_callouts);
+  SERIALIZE(a, do_network_processing);
+  SERIALIZE(a, network_process_cmd);
   SERIALIZE(a, do_beginday_event);
   SERIALIZE(a, beginday_cmd);
   SERIALIZE(a, http_address);
@@ -76,6 +76,12 @@ struct wwivd_matrix_entry_t {
   wwivd_data_mode_t data_mode{wwivd_data_mode_t::socket};
   /** Is this the primary WWIV BBS */
   bool wwiv_bbs{ true };
+  /**
+   * UNIX domain socket of a pre-initialized bbs template (bbs --fork_server=path)
+   * to ask for a forked node instead of launching telnet_cmd or ssh_cmd.  Relative
+   * paths are relative to the WWIV root directory. Empty disables this.
+   */
+  std::string fork_server_socket;
 };
 
 class wwivd_config_t {
@@ -86,6 +92,15 @@ public:
   std::string binkp_cmd;
   bool do_network_callouts{false};
   std::string network_callout_cmd;
+  /** Maximum number of network callouts to run at once, at most one per network. */
+  int max_concurrent_callouts{4};
+  /**
+   * Run network_process_cmd for a network as soon as new packets, bundles or
+   * TIC files for it finish arriving, instead of waiting for the BBS.
+   */
+  bool do_network_processing{false};
+  /** Command to process inbound and outbound files for network @T. */
+  std::string network_process_cmd;
   bool do_beginday_event{true};
   std::string beginday_cmd;
 
@@ -197,6 +197,13 @@ static void edit_matrix_entry(const Config& config, wwivd_matrix_entry_t& b) {
     y++;
     items.add(new Label("WWIV BBS:"), new BooleanEditItem(&b.wwiv_bbs),
       "Is this the primary WWIV BBS for this WWIVD.", 1, y);
+#if !defined(_WIN32) && !defined(__OS2__)
+    y++;
+    items.add(new Label("Fork Server:"),
+              new StringEditItem<std::string&>(52, b.fork_server_socket, EditLineMode::ALL),
+              "Socket of a 'bbs --fork_server' template to fork nodes from (blank to disable)",
+              1, y);
+#endif
   }
 
   items.relayout_items_and_labels();
@@ -292,12 +299,16 @@ wwivd_config_t LoadDaemonConfig(const wwiv::sdk::Config& config) {
     c.binkp_cmd = File::FixPathSeparators("./networkb --receive --handle=@H");
     c.network_callout_cmd = File::FixPathSeparators("./networkb --send --net=@T --node=@N");
     c.beginday_cmd = File::FixPathSeparators("./bbs -e");
+    c.network_process_cmd = File::FixPathSeparators("./networkc --net=@T");
 
     c.bbses.push_back(CreateWWIVMatrixEntry());
   } else {
     if (c.network_callout_cmd.empty()) {
       c.network_callout_cmd = File::FixPathSeparators("./networkb --send --net=@T --node=@N");
     }
+    if (c.network_process_cmd.empty()) {
+      c.network_process_cmd = File::FixPathSeparators("./networkc --net=@T");
+    }
     if (c.beginday_cmd.empty()) {
       c.beginday_cmd = File::FixPathSeparators("./bbs -e");
     }
@@ -369,6 +380,18 @@ void wwivd_ui(const Config& config) {
                                              EditLineMode::ALL),
             "Command to execute to perform a network callout.", 1, y);
   y++;
+  items.add(new Label("Max Callouts:"),
+            new NumberEditItem<int>(&c.max_concurrent_callouts),
+            "Maximum number of network callouts to run at once (one per network).", 1, y);
+  y++;
+  items.add(new Label("Net Processing:"),
+            new BooleanEditItem(&c.do_network_processing),
+            "Process network files as soon as they arrive.", 1, y);
+  y++;
+  items.add(new Label("Net Process Cmd:"),
+            new StringEditItem<std::string&>(52, c.network_process_cmd, EditLineMode::ALL),
+            "Command to execute to process network files (@T is the network number).", 1, y);
+  y++;
   items.add(new Label("Net receive cmd:"),
             new StringEditItem<std::string&>(52, c.binkp_cmd, EditLineMode::ALL),
             "Command to execute for an inbound network request.", 1, y);
@@ -0,0 +1,317 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivd/callout_scheduler.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "core/textfile.h"
+#include "sdk/net/callouts.h"
+#include "sdk/net/contact.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::net;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+
+namespace wwiv::wwivd {
+
+// Never call the same node more than once a minute.
+static constexpr auto kMinCalloutInterval = 1min;
+static constexpr auto kMaxCalloutBackoff = 1h;
+
+bool operator<(const callout_node_t& lhs, const callout_node_t& rhs) {
+  return std::tie(lhs.network_name, lhs.address) < std::tie(rhs.network_name, rhs.address);
+}
+
+bool operator==(const callout_node_t& lhs, const callout_node_t& rhs) {
+  return lhs.network_name == rhs.network_name && lhs.address == rhs.address;
+}
+
+seconds callout_backoff(int failures) {
+  if (failures <= 0) {
+    return 0s;
+  }
+  // Doubles from one minute, capped at an hour.
+  const auto shift = std::min(failures - 1, 6);
+  return std::min<seconds>(kMinCalloutInterval * (1 << shift), kMaxCalloutBackoff);
+}
+
+static NetworkContact contact_for(const callout_candidate_t& c, time_t last_contact) {
+  network_contact_record ncr{};
+  ncr.address = c.node.address;
+  ncr.ncr.bytes_waiting = c.bytes_waiting;
+  ncr.ncr.lastcontact = static_cast<daten_t>(last_contact);
+  return NetworkContact{ncr};
+}
+
+std::optional<DateTime> next_callout_time(const callout_candidate_t& c,
+                                          const callout_state_t& state, const DateTime& now) {
+  // Is there any reason to call at all, ignoring when we last did.
+  if (!should_call(contact_for(c, 0), c.config, now)) {
+    return std::nullopt;
+  }
+  if (state.failures > 0) {
+    return DateTime::from_time_t(state.last_attempt) + callout_backoff(state.failures);
+  }
+  const auto last = std::max(c.last_contact, state.last_attempt);
+  if (should_call(contact_for(c, last), c.config, now)) {
+    return std::max(now, DateTime::from_time_t(state.last_attempt) + kMinCalloutInterval);
+  }
+  return DateTime::from_time_t(last) + minutes(std::max(c.config.call_every_x_minutes, 1));
+}
+
+///////////////////////////////////////////////////////////////////////////
+// CalloutJournal
+
+static std::string to_journal_line(const callout_node_t& node, const callout_state_t& state) {
+  return StrCat(node.network_name, "\t", node.address, "\t", state.last_attempt, "\t",
+                state.last_success, "\t", state.failures);
+}
+
+CalloutJournal::CalloutJournal(std::filesystem::path path) : path_(std::move(path)) {}
+
+std::map<callout_node_t, callout_state_t> CalloutJournal::Load() const {
+  std::map<callout_node_t, callout_state_t> states;
+  TextFile tf(path_, "rt");
+  if (!tf) {
+    return states;
+  }
+  std::string line;
+  while (tf.ReadLine(&line)) {
+    const auto parts = SplitString(line, "\t", false);
+    if (parts.size() != 5) {
+      // Most likely a partial line from a crash while appending.
+      VLOG(1) << "Skipping malformed callout journal line: " << line;
+      continue;
+    }
+    callout_node_t node{0, parts[0], parts[1]};
+    callout_state_t state{};
+    state.last_attempt = to_number<time_t>(parts[2]);
+    state.last_success = to_number<time_t>(parts[3]);
+    state.failures = to_number<int>(parts[4]);
+    states.insert_or_assign(node, state);
+  }
+  return states;
+}
+
+bool CalloutJournal::Append(const callout_node_t& node, const callout_state_t& state) {
+  TextFile tf(path_, "at");
+  if (!tf) {
+    LOG(ERROR) << "Unable to append to callout journal: " << path_;
+    return false;
+  }
+  ++num_appended_;
+  return tf.WriteLine(to_journal_line(node, state)) > 0;
+}
+
+bool CalloutJournal::Rewrite(const std::map<callout_node_t, callout_state_t>& states) {
+  auto tmp = path_;
+  tmp += ".tmp";
+  {
+    TextFile tf(tmp, "wt");
+    if (!tf) {
+      LOG(ERROR) << "Unable to write callout journal: " << tmp;
+      return false;
+    }
+    for (const auto& [node, state] : states) {
+      tf.WriteLine(to_journal_line(node, state));
+    }
+  }
+  if (!File::Rename(tmp, path_)) {
+    LOG(ERROR) << "Unable to rename " << tmp << " to " << path_;
+    return false;
+  }
+  num_appended_ = 0;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// CalloutScheduler
+
+CalloutScheduler::CalloutScheduler(const Clock& clock, CalloutExecutor& executor,
+                                   CalloutJournal& journal, int max_concurrent)
+    : clock_(clock), executor_(executor), journal_(journal),
+      max_concurrent_(std::max(1, max_concurrent)), states_(journal.Load()) {
+  if (!states_.empty()) {
+    journal_.Rewrite(states_);
+  }
+}
+
+CalloutScheduler::~CalloutScheduler() {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this] { return running_.empty(); });
+}
+
+void CalloutScheduler::Update(const std::vector<callout_candidate_t>& candidates) {
+  std::lock_guard<std::mutex> lock(mu_);
+  const auto now = clock_.Now();
+  std::map<callout_node_t, callout_candidate_t> updated;
+  for (const auto& c : candidates) {
+    updated.insert_or_assign(c.node, c);
+  }
+  for (const auto& [node, _] : candidates_) {
+    if (!contains(updated, node)) {
+      Unschedule(node);
+    }
+  }
+  candidates_ = std::move(updated);
+  for (const auto& [node, c] : candidates_) {
+    if (!contains(running_, node)) {
+      Schedule(c, now);
+    }
+  }
+}
+
+int CalloutScheduler::RunDue() {
+  std::vector<callout_node_t> started;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    const auto now = clock_.Now();
+    for (auto it = queue_.begin(); it != queue_.end() && it->first <= now &&
+                                   size_int(running_) < max_concurrent_;) {
+      const auto node = it->second;
+      if (contains(running_networks_, node.network_name)) {
+        // Calls on the same network would just contend for the same semaphore.
+        ++it;
+        continue;
+      }
+      it = queue_.erase(it);
+      due_.erase(node);
+      running_.insert(node);
+      running_networks_.insert(node.network_name);
+      auto& state = states_[node];
+      state.last_attempt = now.to_time_t();
+      Record(node, state);
+      started.push_back(node);
+    }
+  }
+  // The executor may complete synchronously, so don't hold the lock.
+  for (const auto& node : started) {
+    LOG(INFO) << "Calling out to: " << node.address << "." << node.network_name;
+    executor_.Start(node, [this, node](bool success) { Completed(node, success); });
+  }
+  return size_int(started);
+}
+
+void CalloutScheduler::Completed(const callout_node_t& node, bool success) {
+  std::lock_guard<std::mutex> lock(mu_);
+  const auto now = clock_.Now();
+  running_.erase(node);
+  running_networks_.erase(node.network_name);
+  auto& state = states_[node];
+  if (success) {
+    state.failures = 0;
+    state.last_success = now.to_time_t();
+  } else {
+    ++state.failures;
+    LOG(INFO) << "Callout to: " << node.address << "." << node.network_name << " failed "
+              << state.failures << " time(s); next try in "
+              << duration_cast<minutes>(callout_backoff(state.failures)).count() << " minute(s).";
+  }
+  Record(node, state);
+  if (auto it = candidates_.find(node); it != candidates_.end()) {
+    if (success) {
+      // Whatever was waiting went out, until the next Update says otherwise.
+      it->second.bytes_waiting = 0;
+      it->second.last_contact = now.to_time_t();
+    }
+    Schedule(it->second, now);
+  }
+  ++completions_;
+  cv_.notify_all();
+}
+
+void CalloutScheduler::Schedule(const callout_candidate_t& candidate, const DateTime& now) {
+  Unschedule(candidate.node);
+  const auto it = states_.find(candidate.node);
+  const auto state = it == states_.end() ? callout_state_t{} : it->second;
+  if (const auto due = next_callout_time(candidate, state, now)) {
+    queue_.emplace(*due, candidate.node);
+    due_.insert_or_assign(candidate.node, *due);
+  }
+}
+
+void CalloutScheduler::Unschedule(const callout_node_t& node) {
+  if (const auto it = due_.find(node); it != due_.end()) {
+    queue_.erase({it->second, node});
+    due_.erase(it);
+  }
+}
+
+void CalloutScheduler::Record(const callout_node_t& node, const callout_state_t& state) {
+  journal_.Append(node, state);
+  if (journal_.num_appended() > 64 + 4 * size_int(states_)) {
+    journal_.Rewrite(states_);
+  }
+}
+
+void CalloutScheduler::Wait(milliseconds max_wait) {
+  std::unique_lock<std::mutex> lock(mu_);
+  auto wait = max_wait;
+  if (size_int(running_) < max_concurrent_) {
+    // The first deadline that could actually start; the rest wait on a completion.
+    const auto now = clock_.Now().to_system_clock();
+    for (const auto& [due, node] : queue_) {
+      if (!contains(running_networks_, node.network_name)) {
+        const auto until_due = duration_cast<milliseconds>(due.to_system_clock() - now);
+        wait = std::clamp(until_due, 0ms, max_wait);
+        break;
+      }
+    }
+  }
+  const auto completions = completions_;
+  cv_.wait_for(lock, wait, [&] { return completions_ != completions; });
+}
+
+void CalloutScheduler::set_max_concurrent(int max_concurrent) {
+  std::lock_guard<std::mutex> lock(mu_);
+  max_concurrent_ = std::max(1, max_concurrent);
+}
+
+std::optional<DateTime> CalloutScheduler::next_due() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (queue_.empty()) {
+    return std::nullopt;
+  }
+  return queue_.begin()->first;
+}
+
+int CalloutScheduler::num_running() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return size_int(running_);
+}
+
+std::optional<callout_state_t> CalloutScheduler::state(const callout_node_t& node) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (const auto it = states_.find(node); it != states_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+} // namespace wwiv::wwivd
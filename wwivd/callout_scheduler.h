@@ -0,0 +1,178 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_WWIVD_CALLOUT_SCHEDULER_H
+#define INCLUDED_WWIVD_CALLOUT_SCHEDULER_H
+
+#include "core/clock.h"
+#include "core/datetime.h"
+#include "sdk/net/net.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wwiv::wwivd {
+
+/** One node on one network that wwivd may call out to. */
+struct callout_node_t {
+  /** Network number passed to the callout command as @T */
+  int network_number{0};
+  std::string network_name;
+  /** WWIVnet node number or FTN address, passed to the callout command as @N */
+  std::string address;
+};
+
+/** Nodes are identified by network name and address, network numbers may change. */
+bool operator<(const callout_node_t& lhs, const callout_node_t& rhs);
+bool operator==(const callout_node_t& lhs, const callout_node_t& rhs);
+
+/** Callout state that is kept across wwivd restarts. */
+struct callout_state_t {
+  time_t last_attempt{0};
+  time_t last_success{0};
+  /** Number of failed callouts since the last successful one. */
+  int failures{0};
+};
+
+/**
+ * A node that is eligible to be called, built from Callout and Contact (or
+ * the FTN node configs) on each refresh.
+ */
+struct callout_candidate_t {
+  callout_node_t node;
+  sdk::net::network_callout_config_t config;
+  /** Last successful contact from contact.net, 0 if unknown. */
+  time_t last_contact{0};
+  int bytes_waiting{0};
+};
+
+/**
+ * Returns when node should next be called given its state, or std::nullopt
+ * if there is no reason to call it until something changes (i.e. more
+ * bytes are waiting).
+ */
+std::optional<core::DateTime> next_callout_time(const callout_candidate_t& candidate,
+                                                const callout_state_t& state,
+                                                const core::DateTime& now);
+
+/** How long to wait after the n-th consecutive failure before trying again. */
+std::chrono::seconds callout_backoff(int failures);
+
+/**
+ * Append only journal of callout_state_t.  Each line holds the complete state
+ * for one node, so the last line for a node wins.  The journal is rewritten
+ * when it grows too large.
+ */
+class CalloutJournal {
+public:
+  explicit CalloutJournal(std::filesystem::path path);
+
+  /** Reads the latest state for each node in the journal. */
+  [[nodiscard]] std::map<callout_node_t, callout_state_t> Load() const;
+  bool Append(const callout_node_t& node, const callout_state_t& state);
+  /** Replaces the journal with one line per node. */
+  bool Rewrite(const std::map<callout_node_t, callout_state_t>& states);
+
+  [[nodiscard]] int num_appended() const noexcept { return num_appended_; }
+  [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+private:
+  const std::filesystem::path path_;
+  int num_appended_{0};
+};
+
+/** Runs the actual callouts for the CalloutScheduler. */
+class CalloutExecutor {
+public:
+  virtual ~CalloutExecutor() = default;
+  /**
+   * Starts calling out to node.  done must be invoked exactly once, from any
+   * thread, with whether or not the callout succeeded.
+   */
+  virtual void Start(const callout_node_t& node, std::function<void(bool)> done) = 0;
+};
+
+/**
+ * Schedules network callouts.  Each node has a deadline for when it is next
+ * due, up to max_concurrent callouts run at once, and no more than one per
+ * network so that a slow or hung uplink only holds up its own network.
+ *
+ * Backoff and last attempt state is kept in the CalloutJournal so that it
+ * survives restarts.
+ */
+class CalloutScheduler {
+public:
+  CalloutScheduler(const core::Clock& clock, CalloutExecutor& executor, CalloutJournal& journal,
+                   int max_concurrent);
+  /** Waits for any running callouts to finish. */
+  ~CalloutScheduler();
+
+  CalloutScheduler(const CalloutScheduler&) = delete;
+  CalloutScheduler& operator=(const CalloutScheduler&) = delete;
+
+  /** Replaces the set of candidates and recomputes their deadlines. */
+  void Update(const std::vector<callout_candidate_t>& candidates);
+  /** Starts every due callout that fits in a free slot, returns the number started. */
+  int RunDue();
+  /**
+   * Waits until the earliest deadline, until a running callout finishes, or
+   * for at most max_wait; whichever comes first.
+   */
+  void Wait(std::chrono::milliseconds max_wait);
+
+  void set_max_concurrent(int max_concurrent);
+  [[nodiscard]] std::optional<core::DateTime> next_due() const;
+  [[nodiscard]] int num_running() const;
+  [[nodiscard]] std::optional<callout_state_t> state(const callout_node_t& node) const;
+
+private:
+  void Completed(const callout_node_t& node, bool success);
+  void Schedule(const callout_candidate_t& candidate, const core::DateTime& now);
+  void Unschedule(const callout_node_t& node);
+  void Record(const callout_node_t& node, const callout_state_t& state);
+
+  const core::Clock& clock_;
+  CalloutExecutor& executor_;
+  CalloutJournal& journal_;
+  int max_concurrent_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::map<callout_node_t, callout_candidate_t> candidates_;
+  std::map<callout_node_t, callout_state_t> states_;
+  // Ordered by deadline; due_ holds the deadline for each queued node.
+  std::set<std::pair<core::DateTime, callout_node_t>> queue_;
+  std::map<callout_node_t, core::DateTime> due_;
+  std::set<callout_node_t> running_;
+  std::set<std::string> running_networks_;
+  int completions_{0};
+};
+
+} // namespace wwiv::wwivd
+
+#endif
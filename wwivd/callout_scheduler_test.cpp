@@ -0,0 +1,225 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivd/callout_scheduler.h"
+
+#include "core/fake_clock.h"
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+using namespace wwiv::sdk::net;
+using namespace wwiv::wwivd;
+
+class FakeCalloutExecutor final : public CalloutExecutor {
+public:
+  void Start(const callout_node_t& node, std::function<void(bool)> done) override {
+    started.emplace_back(node, std::move(done));
+  }
+
+  // Finishes the i-th started callout.
+  void Finish(int i, bool success) {
+    auto [node, done] = std::move(started.at(i));
+    started.erase(started.begin() + i);
+    done(success);
+  }
+
+  std::vector<std::pair<callout_node_t, std::function<void(bool)>>> started;
+};
+
+class CalloutSchedulerTest : public testing::Test {
+public:
+  CalloutSchedulerTest()
+      : clock_(DateTime::from_time_t(1600000000)),
+        journal_(FilePath(helper_.TempDir(), "callouts.journal")) {}
+
+  static callout_candidate_t Candidate(const std::string& net, const std::string& address,
+                                       int call_every_x_minutes = 15) {
+    callout_candidate_t c{};
+    c.node = callout_node_t{0, net, address};
+    c.config.auto_callouts = true;
+    c.config.call_every_x_minutes = call_every_x_minutes;
+    return c;
+  }
+
+  test::FileHelper helper_;
+  FakeClock clock_;
+  CalloutJournal journal_;
+  FakeCalloutExecutor executor_;
+};
+
+TEST_F(CalloutSchedulerTest, NextCalloutTime_CallEvery) {
+  auto c = Candidate("wwivnet", "1");
+  const auto now = clock_.Now();
+  c.last_contact = (now - 5min).to_time_t();
+  EXPECT_EQ((now + 10min).to_time_t(), next_callout_time(c, {}, now)->to_time_t());
+
+  c.last_contact = (now - 20min).to_time_t();
+  EXPECT_EQ(now.to_time_t(), next_callout_time(c, {}, now)->to_time_t());
+}
+
+TEST_F(CalloutSchedulerTest, NextCalloutTime_NoReasonToCall) {
+  auto c = Candidate("wwivnet", "1", 0);
+  EXPECT_FALSE(next_callout_time(c, {}, clock_.Now()).has_value());
+
+  c.config.min_k = 1;
+  c.bytes_waiting = 2048;
+  EXPECT_TRUE(next_callout_time(c, {}, clock_.Now()).has_value());
+}
+
+TEST_F(CalloutSchedulerTest, NextCalloutTime_Backoff) {
+  const auto c = Candidate("wwivnet", "1");
+  const auto now = clock_.Now();
+  callout_state_t state{};
+  state.last_attempt = now.to_time_t();
+  state.failures = 3;
+  EXPECT_EQ((now + 4min).to_time_t(), next_callout_time(c, state, now)->to_time_t());
+
+  state.failures = 100;
+  EXPECT_EQ((now + 1h).to_time_t(), next_callout_time(c, state, now)->to_time_t());
+}
+
+TEST_F(CalloutSchedulerTest, RunDue_MaxConcurrent) {
+  CalloutScheduler s(clock_, executor_, journal_, 2);
+  s.Update({Candidate("a", "1"), Candidate("b", "1"), Candidate("c", "1")});
+
+  EXPECT_EQ(2, s.RunDue());
+  EXPECT_EQ(2, s.num_running());
+  EXPECT_EQ(0, s.RunDue());
+
+  executor_.Finish(0, true);
+  EXPECT_EQ(1, s.RunDue());
+  ASSERT_EQ(2u, executor_.started.size());
+  EXPECT_EQ("c", executor_.started.back().first.network_name);
+  executor_.Finish(0, true);
+  executor_.Finish(0, true);
+}
+
+TEST_F(CalloutSchedulerTest, RunDue_OnePerNetwork) {
+  CalloutScheduler s(clock_, executor_, journal_, 4);
+  s.Update({Candidate("a", "1"), Candidate("a", "2"), Candidate("b", "1")});
+
+  EXPECT_EQ(2, s.RunDue());
+  EXPECT_EQ("a", executor_.started.at(0).first.network_name);
+  EXPECT_EQ("b", executor_.started.at(1).first.network_name);
+
+  executor_.Finish(0, true);
+  EXPECT_EQ(1, s.RunDue());
+  EXPECT_EQ("2", executor_.started.back().first.address);
+  executor_.Finish(0, true);
+  executor_.Finish(0, true);
+}
+
+TEST_F(CalloutSchedulerTest, RunDue_NotDueYet) {
+  CalloutScheduler s(clock_, executor_, journal_, 4);
+  auto c = Candidate("a", "1");
+  c.last_contact = (clock_.Now() - 5min).to_time_t();
+  s.Update({c});
+
+  EXPECT_EQ(0, s.RunDue());
+  EXPECT_EQ((clock_.Now() + 10min).to_time_t(), s.next_due()->to_time_t());
+  clock_.tick(10min);
+  EXPECT_EQ(1, s.RunDue());
+  executor_.Finish(0, true);
+}
+
+TEST_F(CalloutSchedulerTest, Failure_BacksOff) {
+  CalloutScheduler s(clock_, executor_, journal_, 4);
+  s.Update({Candidate("a", "1")});
+  ASSERT_EQ(1, s.RunDue());
+  executor_.Finish(0, false);
+  EXPECT_EQ(1, s.state(callout_node_t{0, "a", "1"})->failures);
+
+  clock_.tick(30s);
+  EXPECT_EQ(0, s.RunDue());
+  clock_.tick(30s);
+  ASSERT_EQ(1, s.RunDue());
+  executor_.Finish(0, false);
+  EXPECT_EQ((clock_.Now() + 2min).to_time_t(), s.next_due()->to_time_t());
+
+  clock_.tick(2min);
+  ASSERT_EQ(1, s.RunDue());
+  executor_.Finish(0, true);
+  const auto state = s.state(callout_node_t{0, "a", "1"});
+  EXPECT_EQ(0, state->failures);
+  EXPECT_EQ(clock_.Now().to_time_t(), state->last_success);
+  // Back to the normal call_every_x_minutes schedule.
+  EXPECT_EQ((clock_.Now() + 15min).to_time_t(), s.next_due()->to_time_t());
+}
+
+TEST_F(CalloutSchedulerTest, Update_RemovesCandidates) {
+  CalloutScheduler s(clock_, executor_, journal_, 4);
+  s.Update({Candidate("a", "1")});
+  EXPECT_TRUE(s.next_due().has_value());
+  s.Update({});
+  EXPECT_FALSE(s.next_due().has_value());
+  EXPECT_EQ(0, s.RunDue());
+}
+
+TEST_F(CalloutSchedulerTest, State_PersistsAcrossRestart) {
+  const auto start = clock_.Now();
+  {
+    CalloutScheduler s(clock_, executor_, journal_, 4);
+    s.Update({Candidate("a", "1")});
+    ASSERT_EQ(1, s.RunDue());
+    executor_.Finish(0, false);
+  }
+
+  CalloutJournal journal(journal_.path());
+  CalloutScheduler s(clock_, executor_, journal, 4);
+  const auto state = s.state(callout_node_t{0, "a", "1"});
+  ASSERT_TRUE(state.has_value());
+  EXPECT_EQ(1, state->failures);
+  EXPECT_EQ(start.to_time_t(), state->last_attempt);
+
+  // Still backing off from before the restart.
+  s.Update({Candidate("a", "1")});
+  EXPECT_EQ(0, s.RunDue());
+  EXPECT_EQ((start + 1min).to_time_t(), s.next_due()->to_time_t());
+}
+
+TEST_F(CalloutSchedulerTest, Journal_LastLineWins) {
+  const callout_node_t node{0, "a", "1:2/3"};
+  for (auto i = 1; i <= 10; i++) {
+    ASSERT_TRUE(journal_.Append(node, callout_state_t{i, 0, i}));
+  }
+  EXPECT_EQ(10, journal_.num_appended());
+  auto states = journal_.Load();
+  ASSERT_EQ(1u, states.size());
+  EXPECT_EQ(10, states.at(node).failures);
+
+  ASSERT_TRUE(journal_.Rewrite(states));
+  EXPECT_EQ(0, journal_.num_appended());
+  EXPECT_EQ(states.at(node).last_attempt, journal_.Load().at(node).last_attempt);
+}
+
+TEST_F(CalloutSchedulerTest, Journal_SkipsPartialLine) {
+  const auto path = helper_.CreateTempFile("partial.journal", "a\t1\t100\t90\t2\nb\t1\t10");
+  const CalloutJournal journal(path);
+  const auto states = journal.Load();
+  ASSERT_EQ(1u, states.size());
+  EXPECT_EQ(2, states.at(callout_node_t{0, "a", "1"}).failures);
+}
@@ -0,0 +1,198 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivd/ip_trie.h"
+
+#include "core/strings.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace wwiv::wwivd {
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+// Bits of the IPv4-mapped prefix ::ffff:0:0/96.
+static constexpr int kIpv4MappedBits = 96;
+
+std::optional<ip_prefix_t> parse_ip_prefix(const std::string& s) {
+  const auto slash = s.find('/');
+  const auto addr = StringTrim(s.substr(0, slash));
+  const auto ipv4 = addr.find(':') == std::string::npos;
+  const auto a = ip_address::from_string(addr);
+  if (!a) {
+    return std::nullopt;
+  }
+  if (slash == std::string::npos) {
+    return ip_prefix_t{a.value(), 128};
+  }
+  const auto len = s.substr(slash + 1);
+  if (len.empty() || !std::all_of(len.begin(), len.end(), [](char c) { return isdigit(c); })) {
+    return std::nullopt;
+  }
+  const auto bits = to_number<int>(len);
+  const auto max_bits = ipv4 ? 32 : 128;
+  if (bits < 0 || bits > max_bits) {
+    return std::nullopt;
+  }
+  return ip_prefix_t{a.value(), ipv4 ? bits + kIpv4MappedBits : bits};
+}
+
+static bool bit_at(const uint8_t* key, int n) {
+  return (key[n / 8] >> (7 - n % 8)) & 1;
+}
+
+// Number of leading bits that are the same in a and b, up to max_bits.
+static int common_bits(const uint8_t* a, const uint8_t* b, int max_bits) {
+  auto n = 0;
+  for (auto i = 0; n < max_bits; i++, n += 8) {
+    if (const auto diff = static_cast<uint8_t>(a[i] ^ b[i]); diff != 0) {
+      auto bit = 0;
+      while (!(diff & (0x80 >> bit))) {
+        ++bit;
+      }
+      return std::min(n + bit, max_bits);
+    }
+  }
+  return max_bits;
+}
+
+static void mask_key(uint8_t* key, int bits) {
+  for (auto i = 0; i < 16; i++) {
+    const auto remaining = bits - i * 8;
+    if (remaining <= 0) {
+      key[i] = 0;
+    } else if (remaining < 8) {
+      key[i] &= static_cast<uint8_t>(0xff << (8 - remaining));
+    }
+  }
+}
+
+int32_t IpTrie::add_node(const uint8_t* key, int bits, bool terminal) {
+  node_t n{};
+  memcpy(n.key, key, sizeof(n.key));
+  mask_key(n.key, bits);
+  n.prefix_bits = static_cast<uint8_t>(bits);
+  n.terminal = terminal;
+  nodes_.push_back(n);
+  return static_cast<int32_t>(nodes_.size() - 1);
+}
+
+bool IpTrie::insert(const ip_prefix_t& prefix) {
+  uint8_t key[16];
+  memcpy(key, prefix.address.data(), sizeof(key));
+  const auto bits = std::clamp(prefix.bits, 0, 128);
+
+  // The link to idx is parent's child[parent_bit], or root_.  Links are
+  // found by index since add_node may move the nodes.
+  auto parent = -1;
+  auto parent_bit = 0;
+  for (;;) {
+    const auto idx = parent < 0 ? root_ : nodes_[parent].child[parent_bit];
+    if (idx < 0) {
+      const auto leaf = add_node(key, bits, true);
+      if (parent < 0) {
+        root_ = leaf;
+      } else {
+        nodes_[parent].child[parent_bit] = leaf;
+      }
+      ++size_;
+      return true;
+    }
+    const int node_bits = nodes_[idx].prefix_bits;
+    const auto common = common_bits(key, nodes_[idx].key, std::min(bits, node_bits));
+    if (common < node_bits) {
+      // The new prefix diverges from, or is a prefix of, this node: put a
+      // node at the point where they differ above it.
+      int32_t split;
+      if (common == bits) {
+        split = add_node(key, bits, true);
+      } else {
+        split = add_node(key, common, false);
+        const auto leaf = add_node(key, bits, true);
+        nodes_[split].child[bit_at(key, common)] = leaf;
+      }
+      nodes_[split].child[bit_at(nodes_[idx].key, common)] = idx;
+      if (parent < 0) {
+        root_ = split;
+      } else {
+        nodes_[parent].child[parent_bit] = split;
+      }
+      ++size_;
+      return true;
+    }
+    if (bits == node_bits) {
+      if (nodes_[idx].terminal) {
+        return false;
+      }
+      nodes_[idx].terminal = true;
+      ++size_;
+      return true;
+    }
+    parent = idx;
+    parent_bit = bit_at(key, node_bits);
+  }
+}
+
+std::optional<ip_prefix_t> IpTrie::longest_match(const ip_address& address) const {
+  const auto* key = reinterpret_cast<const uint8_t*>(address.data());
+  std::optional<ip_prefix_t> match;
+  for (auto idx = root_; idx >= 0;) {
+    const auto& n = nodes_[idx];
+    if (common_bits(key, n.key, n.prefix_bits) < n.prefix_bits) {
+      break;
+    }
+    if (n.terminal) {
+      char data[16];
+      memcpy(data, n.key, sizeof(data));
+      match = ip_prefix_t{ip_address(data), n.prefix_bits};
+    }
+    if (n.prefix_bits == 128) {
+      break;
+    }
+    idx = n.child[bit_at(key, n.prefix_bits)];
+  }
+  return match;
+}
+
+bool IpTrie::contains(const ip_address& address) const {
+  const auto* key = reinterpret_cast<const uint8_t*>(address.data());
+  for (auto idx = root_; idx >= 0;) {
+    const auto& n = nodes_[idx];
+    if (common_bits(key, n.key, n.prefix_bits) < n.prefix_bits) {
+      return false;
+    }
+    if (n.terminal) {
+      return true;
+    }
+    if (n.prefix_bits == 128) {
+      return false;
+    }
+    idx = n.child[bit_at(key, n.prefix_bits)];
+  }
+  return false;
+}
+
+void IpTrie::clear() {
+  nodes_.clear();
+  root_ = -1;
+  size_ = 0;
+}
+
+} // namespace wwiv::wwivd
@@ -0,0 +1,85 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_WWIVD_IP_TRIE_H
+#define INCLUDED_WWIVD_IP_TRIE_H
+
+#include "core/ip_address.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace wwiv::wwivd {
+
+/**
+ * An address prefix in CIDR notation.  IPv4 prefixes are stored as
+ * IPv4-mapped IPv6 ones, so 10.0.0.0/8 is ::ffff:10.0.0.0/104.
+ */
+struct ip_prefix_t {
+  core::ip_address address;
+  /** Number of leading bits of address that are significant, 0-128. */
+  int bits{128};
+};
+
+/**
+ * Parses "10.0.0.0/8", "2001:db8::/32" or a single address, which is the
+ * same as a /32 (IPv4) or /128 (IPv6) prefix.
+ */
+std::optional<ip_prefix_t> parse_ip_prefix(const std::string& s);
+
+/**
+ * Set of IPv4 and IPv6 prefixes stored as a path-compressed binary radix
+ * trie.  Lookups take at most one step per branch in the trie rather than
+ * one per prefix, and nodes are kept in a single vector.
+ */
+class IpTrie final {
+public:
+  IpTrie() = default;
+
+  /** Adds prefix, returns false if it was already present. */
+  bool insert(const ip_prefix_t& prefix);
+  /** True if address is covered by any prefix in the trie. */
+  [[nodiscard]] bool contains(const core::ip_address& address) const;
+  /** Returns the longest prefix that covers address. */
+  [[nodiscard]] std::optional<ip_prefix_t> longest_match(const core::ip_address& address) const;
+
+  /** Number of prefixes in the trie. */
+  [[nodiscard]] int size() const noexcept { return size_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  void clear();
+
+private:
+  struct node_t {
+    // Key with the bits past prefix_bits cleared.
+    uint8_t key[16]{};
+    uint8_t prefix_bits{0};
+    // True if key/prefix_bits was inserted, false for branch nodes.
+    bool terminal{false};
+    int32_t child[2]{-1, -1};
+  };
+  int32_t add_node(const uint8_t* key, int bits, bool terminal);
+
+  std::vector<node_t> nodes_;
+  int32_t root_{-1};
+  int size_{0};
+};
+
+} // namespace wwiv::wwivd
+
+#endif
@@ -0,0 +1,113 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivd/ip_trie.h"
+
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::wwivd;
+
+static ip_address ip(const std::string& s) { return ip_address::from_string(s).value(); }
+
+static ip_prefix_t prefix(const std::string& s) { return parse_ip_prefix(s).value(); }
+
+TEST(IpTrieTest, ParsePrefix) {
+  EXPECT_EQ(128, prefix("10.0.0.1").bits);
+  EXPECT_EQ(104, prefix("10.0.0.0/8").bits);
+  EXPECT_EQ(ip("10.0.0.0"), prefix("10.0.0.0/8").address);
+  EXPECT_EQ(32, prefix("2001:db8::/32").bits);
+  EXPECT_EQ(0, prefix("::/0").bits);
+
+  EXPECT_FALSE(parse_ip_prefix("10.0.0.0/33"));
+  EXPECT_FALSE(parse_ip_prefix("10.0.0.0/"));
+  EXPECT_FALSE(parse_ip_prefix("10.0.0.0/x"));
+  EXPECT_FALSE(parse_ip_prefix("2001:db8::/129"));
+  EXPECT_FALSE(parse_ip_prefix("bbs.example.com"));
+}
+
+TEST(IpTrieTest, Empty) {
+  const IpTrie t;
+  EXPECT_TRUE(t.empty());
+  EXPECT_FALSE(t.contains(ip("10.0.0.1")));
+  EXPECT_FALSE(t.longest_match(ip("10.0.0.1")));
+}
+
+TEST(IpTrieTest, Addresses) {
+  IpTrie t;
+  EXPECT_TRUE(t.insert(prefix("10.0.0.1")));
+  EXPECT_TRUE(t.insert(prefix("10.0.0.2")));
+  EXPECT_TRUE(t.insert(prefix("192.168.1.1")));
+  EXPECT_FALSE(t.insert(prefix("10.0.0.2")));
+  EXPECT_EQ(3, t.size());
+
+  EXPECT_TRUE(t.contains(ip("10.0.0.1")));
+  EXPECT_TRUE(t.contains(ip("10.0.0.2")));
+  EXPECT_TRUE(t.contains(ip("192.168.1.1")));
+  EXPECT_FALSE(t.contains(ip("10.0.0.3")));
+  EXPECT_FALSE(t.contains(ip("10.0.0.0")));
+  EXPECT_FALSE(t.contains(ip("::1")));
+}
+
+TEST(IpTrieTest, Cidr) {
+  IpTrie t;
+  EXPECT_TRUE(t.insert(prefix("10.1.2.3")));
+  EXPECT_TRUE(t.insert(prefix("10.0.0.0/8")));
+  EXPECT_TRUE(t.insert(prefix("172.16.0.0/12")));
+
+  EXPECT_TRUE(t.contains(ip("10.255.255.255")));
+  EXPECT_TRUE(t.contains(ip("172.31.0.1")));
+  EXPECT_FALSE(t.contains(ip("172.32.0.1")));
+  EXPECT_FALSE(t.contains(ip("11.0.0.0")));
+
+  EXPECT_EQ(128, t.longest_match(ip("10.1.2.3"))->bits);
+  EXPECT_EQ(104, t.longest_match(ip("10.1.2.4"))->bits);
+  EXPECT_EQ(ip("10.0.0.0"), t.longest_match(ip("10.1.2.4"))->address);
+}
+
+TEST(IpTrieTest, Ipv6) {
+  IpTrie t;
+  EXPECT_TRUE(t.insert(prefix("2001:db8::/32")));
+  EXPECT_TRUE(t.insert(prefix("fe80::1")));
+
+  EXPECT_TRUE(t.contains(ip("2001:db8:1234::1")));
+  EXPECT_FALSE(t.contains(ip("2001:db9::1")));
+  EXPECT_TRUE(t.contains(ip("fe80::1")));
+  EXPECT_FALSE(t.contains(ip("fe80::2")));
+  // IPv4 addresses are IPv4-mapped, so outside of these.
+  EXPECT_FALSE(t.contains(ip("32.1.13.184")));
+}
+
+TEST(IpTrieTest, Everything) {
+  IpTrie t;
+  EXPECT_TRUE(t.insert(prefix("10.0.0.1")));
+  EXPECT_TRUE(t.insert(prefix("::/0")));
+  EXPECT_TRUE(t.contains(ip("8.8.8.8")));
+  EXPECT_TRUE(t.contains(ip("2001:db8::1")));
+  EXPECT_EQ(128, t.longest_match(ip("10.0.0.1"))->bits);
+  EXPECT_EQ(0, t.longest_match(ip("10.0.0.2"))->bits);
+}
+
+TEST(IpTrieTest, Clear) {
+  IpTrie t;
+  t.insert(prefix("10.0.0.0/8"));
+  t.clear();
+  EXPECT_TRUE(t.empty());
+  EXPECT_FALSE(t.contains(ip("10.0.0.1")));
+}
@@ -19,11 +19,13 @@
 
 #include "core/clock.h"
 #include "core/datetime.h"
+#include "core/file.h"
 #include "core/jsonfile.h"
 #include "core/log.h"
 #include "core/os.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/textfile.h"
 #include "sdk/config.h"
 #include "wwivd/connection_data.h"
 #include <cereal/archives/json.hpp>
@@ -44,54 +46,72 @@ using namespace wwiv::stl;
 using namespace wwiv::strings;
 using namespace wwiv::os;
 
-static bool LoadLinesIntoSet(std::unordered_set<std::string>& s, const std::vector<std::string>& lines) {
-  for (auto line : lines) {
-    const auto space = line.find(' ');
-    if (space != std::string::npos) {
-      line = line.substr(0, space);
-    }
-    s.emplace(StringTrim(line));
+// Autoblock entries are journaled to this file and compacted into
+// wwivd.autoblock.json once it has this many entries.
+static constexpr char kAutoBlockJournal[] = "wwivd.autoblock.journal";
+static constexpr int kMaxJournalEntries = 1000;
+
+IpList::IpList(const std::vector<std::string>& lines) {
+  for (const auto& line : lines) {
+    Add(line);
   }
-  return true;
 }
 
-GoodIp::GoodIp(const std::vector<std::string>& lines) { (void)LoadLines(lines); }
+void IpList::Add(const std::string& l) {
+  auto line{l};
+  const auto space = line.find(' ');
+  if (space != std::string::npos) {
+    line = line.substr(0, space);
+  }
+  StringTrim(&line);
+  if (line.empty() || line.front() == '#') {
+    return;
+  }
+  if (const auto prefix = parse_ip_prefix(line)) {
+    prefixes_.insert(prefix.value());
+    return;
+  }
+  names_.emplace(line);
+}
 
-bool GoodIp::LoadLines(const std::vector<std::string>& lines) {
-  return LoadLinesIntoSet(ips_, lines);
+bool IpList::Contains(const std::string& ip) const {
+  if (empty()) {
+    return false;
+  }
+  if (!prefixes_.empty()) {
+    if (const auto a = ip_address::from_string(ip); a && prefixes_.contains(a.value())) {
+      return true;
+    }
+  }
+  return names_.find(ip) != names_.end();
 }
 
+GoodIp::GoodIp(const std::vector<std::string>& lines) : ips_(lines) {}
+
 GoodIp::GoodIp(const std::filesystem::path& fn) {
   TextFile f(fn, "r");
   if (f) {
-    const auto lines = f.ReadFileIntoVector();
-    (void)LoadLines(lines);
+    ips_ = IpList(f.ReadFileIntoVector());
   }
 }
 
 bool GoodIp::IsAlwaysAllowed(const std::string& ip) {
-  if (ips_.empty()) {
-    return false;
-  }
-  return ips_.find(ip) != ips_.end();
+  return ips_.Contains(ip);
 }
 
 BadIp::BadIp(const std::filesystem::path& fn, Clock& clock) : fn_(fn), clock_(clock) {
   TextFile f(fn, "r");
   if (f) {
-    const auto lines = f.ReadFileIntoVector();
-    LoadLinesIntoSet(ips_, lines);
+    ips_ = IpList(f.ReadFileIntoVector());
   }
 }
 
 bool BadIp::IsBlocked(const std::string& ip) {
-  if (ips_.empty()) {
-    return false;
-  }
-  return ips_.find(ip) != ips_.end();
+  return ips_.Contains(ip);
 }
+
 bool BadIp::Block(const std::string& ip) {
-  ips_.emplace(ip);
+  ips_.Add(ip);
   TextFile appender(fn_, "at");
   const auto now = clock_.Now();
   const auto written =
@@ -100,7 +120,8 @@ bool BadIp::Block(const std::string& ip) {
 }
 
 AutoBlocker::AutoBlocker(std::shared_ptr<BadIp> bip, wwivd_blocking_t b, std::filesystem::path datadir, Clock& clock)
-    : bip_(std::move(bip)), b_(std::move(b)), datadir_(std::move(datadir)), clock_(clock) {
+    : bip_(std::move(bip)), b_(std::move(b)), datadir_(std::move(datadir)),
+      session_expirations_(clock.Now().to_time_t()), clock_(clock) {
   if (b_.block_duration.empty()) {
     b_.block_duration.emplace_back("15m");
   }
@@ -113,7 +134,8 @@ AutoBlocker::AutoBlocker(std::shared_ptr<BadIp> bip, wwivd_blocking_t b, std::fi
   if (b_.block_duration.size() < 4) {
     b_.block_duration.emplace_back("30d");
   }
-  auto modified = !Load();
+  // Fold any journal entries into the json file.
+  auto modified = !Load() || num_journal_entries_ > 0;
 
   // Cleanup the autoblock list.
   const auto now = clock_.Now().to_time_t();
@@ -150,7 +172,23 @@ void AutoBlocker::escalate_block(const std::string& ip) {
     auto_blocked_.erase(ip);
     bip_->Block(ip);
   }
-  Save();
+  Append(ip);
+}
+
+void AutoBlocker::ExpireSessions(time_t now) {
+  for (const auto& ip : session_expirations_.Advance(now)) {
+    const auto it = sessions_.find(ip);
+    if (it == sessions_.end()) {
+      continue;
+    }
+    if (it->second.expiration > now) {
+      // More sessions arrived since this was scheduled.
+      session_expirations_.Schedule(ip, it->second.expiration);
+      continue;
+    }
+    VLOG(2) << "Erasing session window for IP: " << ip;
+    sessions_.erase(it);
+  }
 }
 
 bool AutoBlocker::Connection(const std::string& ip) {
@@ -175,8 +213,14 @@ bool AutoBlocker::Connection(const std::string& ip) {
   const auto auto_bl_sessions = b_.auto_bl_sessions;
   const auto auto_bl_seconds = b_.auto_bl_seconds;
   const auto oldest_in_window = now.to_time_t() - auto_bl_seconds;
+  ExpireSessions(now.to_time_t());
 
-  auto& s = sessions_[ip];
+  auto& w = sessions_[ip];
+  if (w.expiration == 0) {
+    session_expirations_.Schedule(ip, now.to_time_t() + auto_bl_seconds);
+  }
+  w.expiration = now.to_time_t() + auto_bl_seconds;
+  auto& s = w.sessions;
   s.emplace(now.to_time_t());
   if (s.size() == 1) {
     VLOG(1) << "OK: num sessions: " << size_int(s);
@@ -212,7 +256,26 @@ void serialize(Archive & ar, auto_blocked_entry_t &a) {
 bool AutoBlocker::Save() {
   LOG(INFO) << "AutoBlocker: Save";
   JsonFile<std::map<std::string, auto_blocked_entry_t>> file(FilePath(datadir_, "wwivd.autoblock.json"), "autoblock", auto_blocked_);
-  return file.Save();
+  if (!file.Save()) {
+    return false;
+  }
+  // Everything in the journal is now in the json file.
+  num_journal_entries_ = 0;
+  File::Remove(FilePath(datadir_, kAutoBlockJournal));
+  return true;
+}
+
+bool AutoBlocker::Append(const std::string& ip) {
+  if (++num_journal_entries_ > kMaxJournalEntries) {
+    return Save();
+  }
+  // A count of 0 means the entry was removed.
+  auto_blocked_entry_t e{};
+  if (const auto it = auto_blocked_.find(ip); it != auto_blocked_.end()) {
+    e = it->second;
+  }
+  TextFile journal(FilePath(datadir_, kAutoBlockJournal), "at");
+  return journal.WriteLine(StrCat(ip, "\t", e.count, "\t", e.expiration)) > 0;
 }
 
 bool AutoBlocker::blocked(const std::string& ip) const {
@@ -233,7 +296,27 @@ bool AutoBlocker::blocked(const std::string& ip) const {
 bool AutoBlocker::Load() {
   VLOG(1) << "AutoBlocker: Load";
   JsonFile<std::map<std::string, auto_blocked_entry_t>> file(FilePath(datadir_, "wwivd.autoblock.json"), "autoblock", auto_blocked_);
-  return file.Load();
+  const auto loaded = file.Load();
+
+  // Replay the journal over the json file, the last line for an address wins.
+  TextFile journal(FilePath(datadir_, kAutoBlockJournal), "r");
+  if (!journal) {
+    return loaded;
+  }
+  for (const auto& line : journal.ReadFileIntoVector()) {
+    const auto parts = SplitString(line, "\t");
+    if (parts.size() != 3) {
+      continue;
+    }
+    ++num_journal_entries_;
+    const auto count = to_number<int>(parts[1]);
+    if (count <= 0) {
+      auto_blocked_.erase(parts[0]);
+      continue;
+    }
+    auto_blocked_[parts[0]] = auto_blocked_entry_t{count, to_number<time_t>(parts[2])};
+  }
+  return loaded;
 }
 
 } // namespace wwiv::wwivd
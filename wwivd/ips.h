@@ -20,11 +20,15 @@
 
 #include "core/clock.h"
 #include "sdk/wwivd_config.h"
+#include "wwivd/ip_trie.h"
+#include "wwivd/timing_wheel.h"
 #include <ctime>
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -33,6 +37,24 @@ namespace wwiv::wwivd {
 
 using namespace wwiv::core;
 
+/**
+ * A list of addresses, one per line, each either a single address or a
+ * CIDR prefix (i.e. 10.0.0.0/8).  Anything after a space is a comment.
+ */
+class IpList {
+public:
+  IpList() = default;
+  explicit IpList(const std::vector<std::string>& lines);
+  void Add(const std::string& line);
+  [[nodiscard]] bool Contains(const std::string& ip) const;
+  [[nodiscard]] bool empty() const noexcept { return prefixes_.empty() && names_.empty(); }
+
+private:
+  IpTrie prefixes_;
+  // Entries that aren't addresses, matched exactly.
+  std::unordered_set<std::string> names_;
+};
+
 class GoodIp {
 public:
   explicit GoodIp(const std::filesystem::path& fn);
@@ -40,19 +62,19 @@ public:
   [[nodiscard]] bool IsAlwaysAllowed(const std::string& ip);
 
 private:
-  [[nodiscard]] bool LoadLines(const std::vector<std::string>& ips);
-  std::unordered_set<std::string> ips_;
+  IpList ips_;
 };
 
 class BadIp {
 public:
   BadIp(const std::filesystem::path& fn, Clock& clock);
   [[nodiscard]] bool IsBlocked(const std::string& ip);
+  /** Blocks ip (or a CIDR prefix), appending it to the file. */
   bool Block(const std::string& ip);
 
 private:
   const std::filesystem::path fn_;
-  std::unordered_set<std::string> ips_;
+  IpList ips_;
   Clock& clock_;
 };
 
@@ -61,6 +83,13 @@ struct auto_blocked_entry_t {
   time_t expiration{0};
 };
 
+/** Recent sessions from one address within the auto block window. */
+struct session_window_t {
+  std::set<time_t> sessions;
+  /** When the newest session leaves the window. */
+  time_t expiration{0};
+};
+
 class AutoBlocker final {
 public:
   AutoBlocker(std::shared_ptr<BadIp> bip, sdk::wwivd_blocking_t b, std::filesystem::path datadir, Clock& clock);
@@ -70,7 +99,9 @@ public:
   bool Save();
 
   // Used for testing
-  const std::map<std::string, std::set<time_t>>& recent_sessions() const { return sessions_; }
+  const std::unordered_map<std::string, session_window_t>& recent_sessions() const {
+    return sessions_;
+  }
   // Used for testing
   const std::map<std::string, auto_blocked_entry_t>& auto_blocked() const { return auto_blocked_; }
 
@@ -78,11 +109,20 @@ public:
 
 private:
   bool Load();
+  /** Appends the current entry for ip to the journal, compacting it when too long. */
+  bool Append(const std::string& ip);
+  /** Drops the session windows of addresses that haven't connected recently. */
+  void ExpireSessions(time_t now);
+
   std::shared_ptr<BadIp> bip_;
   sdk::wwivd_blocking_t b_;
   std::filesystem::path datadir_;
-  std::map<std::string, std::set<time_t>> sessions_;
+  std::unordered_map<std::string, session_window_t> sessions_;
+  // Expiration times of the windows in sessions_.
+  TimingWheel session_expirations_;
   std::map<std::string, auto_blocked_entry_t> auto_blocked_;
+  // Number of entries in the journal since it was last compacted.
+  int num_journal_entries_{0};
   Clock& clock_;
   std::mutex mu_;
 };
@@ -16,7 +16,9 @@
 /*    language governing permissions and limitations under the License.   */
 /**************************************************************************/
 
+#include "core/clock.h"
 #include "core/datetime.h"
+#include "core/file_watcher.h"
 #include "core/log.h"
 #include "core/os.h"
 #include "core/stl.h"
@@ -29,15 +31,22 @@
 #include "sdk/net/callouts.h"
 #include "sdk/net/contact.h"
 #include "sdk/net/networks.h"
+#include "wwivd/callout_scheduler.h"
 #include "wwivd/connection_data.h"
+#include "wwivd/network_pipeline.h"
 #include "wwivd/wwivd.h"
 #include "wwivd/wwivd_non_http.h"
 
+#include <algorithm>
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace wwiv::wwivd {
@@ -52,103 +61,125 @@ using namespace wwiv::os;
 
 std::atomic<bool> need_to_exit;
 std::atomic<bool> need_to_reload_config;
+std::atomic<bool> need_to_reload_pipeline;
 
-// TODO(rushfan): Add tests for new stuff in here.
+// Runs each callout through ExecCommandAndWait on its own thread.
+class ExecCalloutExecutor final : public CalloutExecutor {
+public:
+  ExecCalloutExecutor(const Config& config, wwivd_config_t c, std::shared_ptr<NodeManager> nodes)
+      : config_(config), c_(std::move(c)), nodes_(std::move(nodes)) {}
 
-static NetworkContact network_contact_from_last_time(const fido::FidoAddress& address,
-                                                     const DateTime& t, int ftn_bytes_waiting) {
-  network_contact_record ncr{};
-  ncr.address = address.as_string();
-  ncr.ncr.bytes_waiting = ftn_bytes_waiting;
-  ncr.ncr.lastcontact = t.to_daten_t();
-  ncr.ncr.lasttry = t.to_daten_t();
-  return NetworkContact{ncr};
-}
+  void set_config(const wwivd_config_t& c) {
+    std::lock_guard<std::mutex> lock(mu_);
+    c_ = c;
+  }
+
+  void Start(const callout_node_t& node, std::function<void(bool)> done) override {
+    wwivd_config_t c;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      c = c_;
+    }
+    const std::map<char, std::string> params = {{'N', node.address},
+                                                {'T', std::to_string(node.network_number)}};
+    auto cmd = CreateCommandLine(c.network_callout_cmd, params);
+    std::thread t([this, c, node, cmd = std::move(cmd), done = std::move(done), nodes = nodes_] {
+      const auto start = DateTime::now();
+      auto ok = ExecCommandAndWait(c, *nodes, cmd, StrCat("[", get_pid(), "]"), -1, INVALID_SOCKET);
+      if (!ok) {
+        LOG(ERROR) << "Error executing command: '" << cmd << "'";
+      } else {
+        ok = contacted_since(node, start);
+      }
+      done(ok);
+    });
+    t.detach();
+  }
+
+private:
+  // networkb records each connect and failure for WWIVnet nodes in contact.net,
+  // FTN nodes are only known to have succeeded if the command ran.
+  [[nodiscard]] bool contacted_since(const callout_node_t& node, const DateTime& t) const {
+    const Networks networks(config_);
+    if (node.network_number >= size_int(networks.networks())) {
+      return false;
+    }
+    const auto& net = networks.at(node.network_number);
+    if (net.type != network_type_t::wwivnet) {
+      return true;
+    }
+    Contact contact(net);
+    const auto* ncn = contact.contact_rec_for(to_number<int>(node.address));
+    return ncn != nullptr && static_cast<time_t>(ncn->lastcontact()) >= t.to_time_t();
+  }
 
-static void one_net_ftn_callout(const Config& config, const Network& net, const wwivd_config_t& c,
-                                std::shared_ptr<NodeManager> nodes, int network_number) {
+  const Config& config_;
+  std::mutex mu_;
+  wwivd_config_t c_;
+  std::shared_ptr<NodeManager> nodes_;
+};
+
+static void add_ftn_candidates(const Config& config, const Network& net, int network_number,
+                               std::vector<callout_candidate_t>& candidates) {
   const fido::FidoCallout callout(config.root_directory(), config.max_backups(), net);
 
-  // TODO(rushfan): 1. Right now we just keep the map of last call-out
-  // time in memory, but we should checkpoint this to disk and reload
-  // on startup.
-  // 2. Also we should look for files outbound to the node so that we can
-  // handle min_k right.
-  // 3. We should look for outbound files to other addresses we don't
+  // TODO(rushfan):
+  // 1. We should look for outbound files to other addresses we don't
   // know about and then figure out how to contact them (since their
   // address is in the nodelist_.
-  static std::map<int, std::map<fido::FidoAddress, time_t>> last_contact;
-  auto& current_last_contact = last_contact[network_number];
-
   for (const auto& [address, node_config] : callout.node_configs_map()) {
     const auto& callout_config = node_config.callout_config;
     if (!allowed_to_call(callout_config)) {
       // Is the call out bit set.
       continue;
     }
-    auto ncn = network_contact_from_last_time(address,
-                                              DateTime::from_time_t(current_last_contact[address]),
-                                              ftn_bytes_waiting(net, address));
-    if (!should_call(ncn, callout_config, DateTime::now())) {
-      // Has it been long enough, or do we have enough k waiting.
-      continue;
-    }
-    // 1: Update the last contact time to now.
-    current_last_contact[address] = DateTime::now().to_time_t();
-    // 2: Call it.
-    LOG(INFO) << "ftn: should call out to: " << address.as_string() << "." << net.name;
-    const std::map<char, std::string> params = {{'N', address.as_string()},
-                                           {'T', std::to_string(network_number)}};
-    const auto cmd = CreateCommandLine(c.network_callout_cmd, params);
-    if (!ExecCommandAndWait(c, *nodes, cmd, StrCat("[", get_pid(), "]"), -1, INVALID_SOCKET)) {
-      LOG(ERROR) << "Error executing command: '" << cmd << "'";
-    }
+    callout_candidate_t c{};
+    c.node = callout_node_t{network_number, net.name, address.as_string()};
+    c.config = callout_config;
+    c.bytes_waiting = ftn_bytes_waiting(net, address);
+    candidates.push_back(c);
   }
 }
 
-static void one_net_wwivnet_callout(const Network& net, const wwivd_config_t& c,
-                                    std::shared_ptr<NodeManager> nodes, int network_number) {
-  VLOG(2) << "one_net_wwivnet_callout: @" << net.sysnum << "; name: " << net.name;
+static void add_wwivnet_candidates(const Network& net, int network_number,
+                                   std::vector<callout_candidate_t>& candidates) {
+  VLOG(2) << "add_wwivnet_candidates: @" << net.sysnum << "; name: " << net.name;
   Contact contact(net);
   const Callout callout(net, 0);
-  for (const auto& kv : callout.callout_config()) {
-    VLOG(2) << "one_net_wwivnet_callout: node @" << kv.first;
-    auto* const ncn = contact.contact_rec_for(kv.first);
+  const auto now = DateTime::now();
+  for (const auto& [node, con] : callout.callout_config()) {
+    const auto* ncn = contact.contact_rec_for(node);
     if (ncn == nullptr) {
-      VLOG(2) << "ncn == nullptr for node @" << kv.first;
+      VLOG(2) << "ncn == nullptr for node @" << node;
       continue;
     }
-    if (!allowed_to_call(kv.second, DateTime::now())) {
-      VLOG(2) << "!allowed_to_call: #" << kv.second.sysnum;
+    if (!allowed_to_call(con, now)) {
+      VLOG(2) << "!allowed_to_call: #" << con.sysnum;
       continue;
     }
-    if (!should_call(*ncn, kv.second, DateTime::now())) {
-      VLOG(2) << "!should_call: #" << kv.second.sysnum;
-      continue;
-    }
-    // Call it.
-    LOG(INFO) << "should call out to: " << kv.first << "." << net.name;
-    const std::map<char, std::string> params = {{'N', std::to_string(kv.first)},
-                                           {'T', std::to_string(network_number)}};
-    const auto cmd = CreateCommandLine(c.network_callout_cmd, params);
-    if (!ExecCommandAndWait(c, *nodes, cmd, StrCat("[", get_pid(), "]"), -1, INVALID_SOCKET)) {
-      LOG(ERROR) << "Error executing command: " << cmd;
-    }
+    callout_candidate_t c{};
+    c.node = callout_node_t{network_number, net.name, std::to_string(node)};
+    c.config = to_network_callout_config_t(con);
+    c.last_contact = static_cast<time_t>(ncn->lastcontact());
+    c.bytes_waiting = static_cast<int>(ncn->bytes_waiting());
+    candidates.push_back(c);
   }
 }
 
-static void one_callout_loop(const Config& config, const wwivd_config_t& c, std::shared_ptr<NodeManager> nodes) {
-  VLOG(1) << "do_wwivd_callouts: one_callout_loop: ";
+static std::vector<callout_candidate_t> callout_candidates(const Config& config) {
+  VLOG(1) << "do_wwivd_callouts: callout_candidates";
+  std::vector<callout_candidate_t> candidates;
   const Networks networks(config);
-  const auto& nets = networks.networks();
   auto network_number = 0;
-  for (const auto& net : nets) {
+  for (const auto& net : networks.networks()) {
     if (net.type == network_type_t::wwivnet) {
-      one_net_wwivnet_callout(net, c, nodes, network_number++);
+      add_wwivnet_candidates(net, network_number, candidates);
     } else if (net.type == network_type_t::ftn) {
-      one_net_ftn_callout(config, net, c, nodes, network_number++);
+      add_ftn_candidates(config, net, network_number, candidates);
     }
+    ++network_number;
   }
+  return candidates;
 }
 
 // This is called from the thread
@@ -157,26 +188,35 @@ static void do_wwivd_callout_loop(const Config& config, const wwivd_config_t& or
   auto c{original_config};
 
   StatusMgr sm(config.datadir(), [](int) {});
-  auto e = need_to_exit.load();
-  auto last_callout = DateTime::now().to_system_clock();
-  while (!e) {
+  const SystemClock clock;
+  ExecCalloutExecutor executor(config, c, nodes);
+  CalloutJournal journal(FilePath(config.datadir(), "callouts.journal"));
+  CalloutScheduler scheduler(clock, executor, journal, c.max_concurrent_callouts);
+  // Contact and callout info is reread this often, deadlines come from the scheduler.
+  auto next_refresh = clock.Now();
+  while (!need_to_exit.load()) {
     // Reload the config if we've gotten a HUP?
     if (need_to_reload_config.load()) {
       LOG(INFO) << "Received HUP: Reloading Configuration for Callouts.";
       need_to_reload_config.store(false);
       c.Load(config);
+      executor.set_config(c);
+      scheduler.set_max_concurrent(c.max_concurrent_callouts);
+      next_refresh = clock.Now();
     }
     if (c.do_network_callouts) {
-      if (auto now = DateTime::now().to_system_clock(); now - last_callout > 60s) {
-        last_callout = DateTime::now().to_system_clock();
-        one_callout_loop(config, c, nodes);
+      if (const auto now = clock.Now(); now >= next_refresh) {
+        next_refresh = now + 60s;
+        scheduler.Update(callout_candidates(config));
       }
+      scheduler.RunDue();
     }
     if (need_to_exit.load()) {
       return;
     }
-    sleep_for(5s);
-    e = need_to_exit.load();
+    // Wakes up for the next deadline or when a callout finishes, but still
+    // checks for exit and beginday at least this often.
+    scheduler.Wait(5s);
 
     if (c.do_beginday_event) {
       const auto last_date_status = sm.get_status();
@@ -206,4 +246,78 @@ void do_wwivd_callouts(const Config& config, const wwivd_config_t& c, std::share
   callout_thread.detach();
 }
 
+// Watches the network directories and runs the network processing command
+// for each network once a burst of new files has finished arriving.
+static void do_wwivd_network_pipeline_loop(const Config& config,
+                                           const wwivd_config_t& original_config,
+                                           std::shared_ptr<NodeManager> nodes) {
+  auto c{original_config};
+
+  const SystemClock clock;
+  NetworkRunDebouncer debouncer(clock, 2s, 30s);
+  FileWatcher watcher;
+  std::vector<pipeline_dir_t> dirs;
+  auto reload = true;
+  while (!need_to_exit.load()) {
+    if (reload || need_to_reload_pipeline.load()) {
+      if (!reload) {
+        LOG(INFO) << "Received HUP: Reloading Configuration for Network Processing.";
+        c.Load(config);
+      }
+      reload = false;
+      need_to_reload_pipeline.store(false);
+      const Networks networks(config);
+      dirs = pipeline_dirs(config.root_directory(), networks.networks());
+      watcher.Clear();
+      std::set<std::filesystem::path> added;
+      for (const auto& d : dirs) {
+        if (added.insert(d.dir).second) {
+          watcher.Add(d.dir);
+        }
+      }
+      // Anything that arrived while nothing was watching.
+      for (const auto& d : dirs) {
+        debouncer.Arrived(d.network_number);
+      }
+      VLOG(1) << "Watching " << watcher.size() << " network directories"
+              << (watcher.native() ? "." : " by polling.");
+    }
+
+    // Wake up when the next network is due, but still check for exit at
+    // least this often.
+    auto timeout = std::chrono::milliseconds(5s);
+    if (const auto next = debouncer.next_due()) {
+      const auto d = next->to_system_clock() - clock.Now().to_system_clock();
+      timeout = std::clamp(std::chrono::duration_cast<std::chrono::milliseconds>(d),
+                           std::chrono::milliseconds(0), timeout);
+    }
+    for (const auto n : networks_for_events(dirs, watcher.Wait(timeout))) {
+      debouncer.Arrived(n);
+    }
+
+    for (const auto n : debouncer.TakeDue()) {
+      if (need_to_exit.load()) {
+        return;
+      }
+      const std::map<char, std::string> params = {{'T', std::to_string(n)}};
+      const auto cmd = CreateCommandLine(c.network_process_cmd, params);
+      VLOG(1) << "Processing network #" << n << ": '" << cmd << "'";
+      if (!ExecCommandAndWait(c, *nodes, cmd, StrCat("[", get_pid(), "]"), -1, INVALID_SOCKET)) {
+        LOG(ERROR) << "Error executing command: '" << cmd << "'";
+      }
+    }
+  }
+}
+
+void do_wwivd_network_pipeline(const Config& config, const wwivd_config_t& c,
+                               std::shared_ptr<NodeManager> nodes) {
+  if (!c.do_network_processing) {
+    return;
+  }
+  LOG(INFO) << "WWIVD is handling network processing.";
+  std::thread pipeline_thread(do_wwivd_network_pipeline_loop, std::cref(config), std::cref(c),
+                              nodes);
+  pipeline_thread.detach();
+}
+
 } // namespace wwiv
@@ -27,6 +27,8 @@ namespace wwiv::wwivd {
 class NodeManager;
 
 void do_wwivd_callouts(const sdk::Config& config, const sdk::wwivd_config_t& c, std::shared_ptr<NodeManager> nodes);
+void do_wwivd_network_pipeline(const sdk::Config& config, const sdk::wwivd_config_t& c,
+                               std::shared_ptr<NodeManager> nodes);
 
 } // namespace
 
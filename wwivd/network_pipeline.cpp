@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivd/network_pipeline.h"
+
+#include "core/strings.h"
+#include "sdk/fido/fido_directories.h"
+#include "sdk/fido/fido_util.h"
+#include "sdk/filenames.h"
+
+#include <algorithm>
+
+namespace wwiv::wwivd {
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::fido;
+using namespace wwiv::sdk::net;
+using namespace wwiv::strings;
+
+std::vector<pipeline_dir_t> pipeline_dirs(const std::filesystem::path& root_directory,
+                                          const std::vector<Network>& networks) {
+  std::vector<pipeline_dir_t> dirs;
+  auto network_number = 0;
+  for (const auto& net : networks) {
+    dirs.push_back({network_number, pipeline_dir_type_t::net, net.dir});
+    if (net.type == network_type_t::ftn) {
+      const FtnDirectories fdirs(root_directory, net);
+      dirs.push_back({network_number, pipeline_dir_type_t::ftn_inbound, fdirs.inbound_dir()});
+      if (net.fido.process_tic) {
+        dirs.push_back({network_number, pipeline_dir_type_t::ftn_tic, fdirs.tic_dir()});
+      }
+    }
+    ++network_number;
+  }
+  return dirs;
+}
+
+bool is_pipeline_file(pipeline_dir_type_t type, const std::string& filename) {
+  const auto name = ToStringLowerCase(filename);
+  switch (type) {
+  case pipeline_dir_type_t::net:
+    // Pending files from the BBS and networkb for network1, or updated
+    // node lists for network3.  Files written by network1 and network2
+    // themselves (local.net, s*.net) are handled within the same run.
+    return (starts_with(name, "p") && ends_with(name, ".net")) || name == BBSLIST_NET ||
+           name == CONNECT_NET || name == CALLOUT_NET;
+  case pipeline_dir_type_t::ftn_inbound:
+    return is_bundle_file(name) || is_packet_file(name);
+  case pipeline_dir_type_t::ftn_tic:
+    return ends_with(name, ".tic");
+  }
+  return false;
+}
+
+std::set<int> networks_for_events(const std::vector<pipeline_dir_t>& dirs,
+                                  const std::vector<file_watch_event_t>& events) {
+  std::set<int> networks;
+  for (const auto& e : events) {
+    for (const auto& d : dirs) {
+      // An empty filename means events were lost, so assume there is work.
+      if (d.dir == e.dir && (e.filename.empty() || is_pipeline_file(d.type, e.filename))) {
+        networks.insert(d.network_number);
+      }
+    }
+  }
+  return networks;
+}
+
+NetworkRunDebouncer::NetworkRunDebouncer(const Clock& clock, std::chrono::seconds quiet_period,
+                                         std::chrono::seconds max_delay)
+    : clock_(clock), quiet_period_(quiet_period), max_delay_(max_delay) {}
+
+void NetworkRunDebouncer::Arrived(int network_number) {
+  const auto now = clock_.Now();
+  if (auto it = pending_.find(network_number); it != pending_.end()) {
+    it->second.last = now;
+    return;
+  }
+  pending_.emplace(network_number, burst_t{now, now});
+}
+
+DateTime NetworkRunDebouncer::due(const burst_t& b) const {
+  return std::min(b.last + quiet_period_, b.first + max_delay_);
+}
+
+std::vector<int> NetworkRunDebouncer::TakeDue() {
+  const auto now = clock_.Now();
+  std::vector<int> result;
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (due(it->second) <= now) {
+      result.push_back(it->first);
+      it = pending_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return result;
+}
+
+std::optional<DateTime> NetworkRunDebouncer::next_due() const {
+  std::optional<DateTime> next;
+  for (const auto& [_, b] : pending_) {
+    if (const auto d = due(b); !next || d < *next) {
+      next = d;
+    }
+  }
+  return next;
+}
+
+} // namespace wwiv::wwivd
@@ -0,0 +1,101 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_WWIVD_NETWORK_PIPELINE_H
+#define INCLUDED_WWIVD_NETWORK_PIPELINE_H
+
+#include "core/clock.h"
+#include "core/datetime.h"
+#include "core/file_watcher.h"
+#include "sdk/net/net.h"
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace wwiv::wwivd {
+
+/** Kinds of directories that the network pipeline watches for new work. */
+enum class pipeline_dir_type_t {
+  /** Network directory: pending p*.net files and network3 inputs. */
+  net,
+  /** FTN inbound directory: packets and bundles for networkf import. */
+  ftn_inbound,
+  /** FTN TIC directory: TIC files for networkt. */
+  ftn_tic
+};
+
+struct pipeline_dir_t {
+  int network_number{0};
+  pipeline_dir_type_t type{pipeline_dir_type_t::net};
+  std::filesystem::path dir;
+};
+
+/** Returns the directories to watch for each network. */
+std::vector<pipeline_dir_t> pipeline_dirs(const std::filesystem::path& root_directory,
+                                          const std::vector<sdk::net::Network>& networks);
+
+/** True if filename arriving in a directory of type means the network has work to do. */
+bool is_pipeline_file(pipeline_dir_type_t type, const std::string& filename);
+
+/**
+ * Returns the networks with work to do for events from a FileWatcher that is
+ * watching dirs.
+ */
+std::set<int> networks_for_events(const std::vector<pipeline_dir_t>& dirs,
+                                  const std::vector<core::file_watch_event_t>& events);
+
+/**
+ * Coalesces bursts of arrivals for each network into a single run.  A
+ * network is due once nothing new has arrived for quiet_period, or
+ * max_delay after the first arrival of the burst so that a steady trickle
+ * of files can not postpone processing forever.
+ */
+class NetworkRunDebouncer {
+public:
+  NetworkRunDebouncer(const core::Clock& clock, std::chrono::seconds quiet_period,
+                      std::chrono::seconds max_delay);
+
+  /** Records that new work arrived for network_number. */
+  void Arrived(int network_number);
+  /** Removes and returns the networks that are due, in network number order. */
+  std::vector<int> TakeDue();
+  /** When the next network is due, or std::nullopt if none are pending. */
+  [[nodiscard]] std::optional<core::DateTime> next_due() const;
+  [[nodiscard]] bool empty() const noexcept { return pending_.empty(); }
+
+private:
+  struct burst_t {
+    core::DateTime first;
+    core::DateTime last;
+  };
+  [[nodiscard]] core::DateTime due(const burst_t& b) const;
+
+  const core::Clock& clock_;
+  const std::chrono::seconds quiet_period_;
+  const std::chrono::seconds max_delay_;
+  std::map<int, burst_t> pending_;
+};
+
+} // namespace wwiv::wwivd
+
+#endif
@@ -0,0 +1,136 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivd/network_pipeline.h"
+
+#include "core/fake_clock.h"
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+using namespace wwiv::sdk::net;
+using namespace wwiv::wwivd;
+
+TEST(NetworkPipelineTest, IsPipelineFile_Net) {
+  EXPECT_TRUE(is_pipeline_file(pipeline_dir_type_t::net, "p1.net"));
+  EXPECT_TRUE(is_pipeline_file(pipeline_dir_type_t::net, "P0-123.NET"));
+  EXPECT_TRUE(is_pipeline_file(pipeline_dir_type_t::net, "connect.net"));
+  EXPECT_TRUE(is_pipeline_file(pipeline_dir_type_t::net, "bbslist.net"));
+  EXPECT_FALSE(is_pipeline_file(pipeline_dir_type_t::net, "local.net"));
+  EXPECT_FALSE(is_pipeline_file(pipeline_dir_type_t::net, "s1.net"));
+  EXPECT_FALSE(is_pipeline_file(pipeline_dir_type_t::net, "p1.001"));
+}
+
+TEST(NetworkPipelineTest, IsPipelineFile_Ftn) {
+  EXPECT_TRUE(is_pipeline_file(pipeline_dir_type_t::ftn_inbound, "00010001.su0"));
+  EXPECT_TRUE(is_pipeline_file(pipeline_dir_type_t::ftn_inbound, "00010001.MOA"));
+  EXPECT_TRUE(is_pipeline_file(pipeline_dir_type_t::ftn_inbound, "12345678.pkt"));
+  EXPECT_FALSE(is_pipeline_file(pipeline_dir_type_t::ftn_inbound, "readme.txt"));
+  EXPECT_TRUE(is_pipeline_file(pipeline_dir_type_t::ftn_tic, "abc.TIC"));
+  EXPECT_FALSE(is_pipeline_file(pipeline_dir_type_t::ftn_tic, "file.zip"));
+}
+
+TEST(NetworkPipelineTest, PipelineDirs) {
+  test::FileHelper helper;
+  Network wwivnet{};
+  wwivnet.type = network_type_t::wwivnet;
+  wwivnet.dir = helper.Dir("wwivnet");
+  Network fido{};
+  fido.type = network_type_t::ftn;
+  fido.dir = helper.Dir("fido");
+  fido.fido.inbound_dir = "in";
+  fido.fido.tic_dir = "tic";
+  fido.fido.process_tic = true;
+
+  const auto dirs = pipeline_dirs(helper.TempDir(), {wwivnet, fido});
+  ASSERT_EQ(4u, dirs.size());
+  EXPECT_EQ(0, dirs[0].network_number);
+  EXPECT_EQ(pipeline_dir_type_t::net, dirs[0].type);
+  EXPECT_EQ(1, dirs[2].network_number);
+  EXPECT_EQ(pipeline_dir_type_t::ftn_inbound, dirs[2].type);
+  EXPECT_EQ(FilePath(fido.dir, "in"), dirs[2].dir);
+  EXPECT_EQ(pipeline_dir_type_t::ftn_tic, dirs[3].type);
+
+  const std::vector<file_watch_event_t> events{{dirs[2].dir, "readme.txt"},
+                                               {dirs[0].dir, "p1.net"}};
+  EXPECT_EQ(std::set<int>{0}, networks_for_events(dirs, events));
+  // Lost events mean every network watching that directory may have work.
+  EXPECT_EQ(std::set<int>{1}, networks_for_events(dirs, {{dirs[3].dir, ""}}));
+}
+
+class NetworkRunDebouncerTest : public testing::Test {
+public:
+  NetworkRunDebouncerTest()
+      : clock_(DateTime::from_time_t(1600000000)), debouncer_(clock_, 2s, 30s) {}
+
+  FakeClock clock_;
+  NetworkRunDebouncer debouncer_;
+};
+
+TEST_F(NetworkRunDebouncerTest, Empty) {
+  EXPECT_TRUE(debouncer_.empty());
+  EXPECT_FALSE(debouncer_.next_due().has_value());
+  EXPECT_TRUE(debouncer_.TakeDue().empty());
+}
+
+TEST_F(NetworkRunDebouncerTest, Burst) {
+  const auto start = clock_.Now();
+  debouncer_.Arrived(1);
+  clock_.tick(1s);
+  debouncer_.Arrived(1);
+  clock_.tick(1s);
+  debouncer_.Arrived(1);
+  EXPECT_TRUE(debouncer_.TakeDue().empty());
+  EXPECT_EQ((start + 4s).to_time_t(), debouncer_.next_due()->to_time_t());
+
+  clock_.tick(2s);
+  EXPECT_EQ(std::vector<int>{1}, debouncer_.TakeDue());
+  EXPECT_TRUE(debouncer_.empty());
+}
+
+TEST_F(NetworkRunDebouncerTest, MaxDelay) {
+  const auto start = clock_.Now();
+  for (int i = 0; i < 40; i++) {
+    debouncer_.Arrived(0);
+    if (clock_.Now() < start + 30s) {
+      EXPECT_TRUE(debouncer_.TakeDue().empty()) << i;
+    }
+    clock_.tick(1s);
+  }
+  EXPECT_EQ(std::vector<int>{0}, debouncer_.TakeDue());
+}
+
+TEST_F(NetworkRunDebouncerTest, Networks) {
+  debouncer_.Arrived(2);
+  clock_.tick(1s);
+  debouncer_.Arrived(0);
+  clock_.tick(1s);
+  EXPECT_EQ(std::vector<int>{2}, debouncer_.TakeDue());
+  clock_.tick(1s);
+  debouncer_.Arrived(2);
+  EXPECT_EQ(std::vector<int>{0}, debouncer_.TakeDue());
+  clock_.tick(2s);
+  EXPECT_EQ(std::vector<int>{2}, debouncer_.TakeDue());
+}
@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivd/timing_wheel.h"
+
+#include <utility>
+
+namespace wwiv::wwivd {
+
+TimingWheel::TimingWheel(time_t now) : current_(now) {}
+
+void TimingWheel::Schedule(const std::string& key, time_t when) {
+  ++size_;
+  Place(entry_t{when, key});
+}
+
+void TimingWheel::Place(entry_t e) {
+  const auto delta = e.when - current_;
+  if (delta <= 0) {
+    due_.push_back(std::move(e));
+    return;
+  }
+  for (auto level = 0; level < kLevels; level++) {
+    const auto shift = kSlotBits * level;
+    // Level n holds entries due within the next 64^(n+1) seconds, each slot
+    // spanning 64^n seconds.
+    if (delta < (time_t{1} << (shift + kSlotBits))) {
+      const auto slot = (e.when >> shift) & (kSlots - 1);
+      levels_[level][slot].push_back(std::move(e));
+      return;
+    }
+  }
+  overflow_.push_back(std::move(e));
+}
+
+std::vector<std::string> TimingWheel::Advance(time_t now) {
+  std::vector<std::string> expired;
+  for (auto& e : due_) {
+    expired.push_back(std::move(e.key));
+  }
+  due_.clear();
+
+  while (current_ < now) {
+    if (size_ == static_cast<int>(expired.size())) {
+      // Nothing left in the wheel, so there is nothing to step through.
+      current_ = now;
+      break;
+    }
+    const auto t = ++current_;
+    // When a higher level slot comes due, spread its entries over the lower
+    // levels, highest first so that they can cascade all the way down.
+    if ((t & ((time_t{1} << (kSlotBits * (kLevels - 1))) - 1)) == 0) {
+      auto overflow = std::move(overflow_);
+      overflow_.clear();
+      for (auto& e : overflow) {
+        Place(std::move(e));
+      }
+    }
+    for (auto level = kLevels - 1; level > 0; level--) {
+      const auto shift = kSlotBits * level;
+      if ((t & ((time_t{1} << shift) - 1)) != 0) {
+        continue;
+      }
+      auto entries = std::move(levels_[level][(t >> shift) & (kSlots - 1)]);
+      levels_[level][(t >> shift) & (kSlots - 1)].clear();
+      for (auto& e : entries) {
+        Place(std::move(e));
+      }
+    }
+    auto& slot = levels_[0][t & (kSlots - 1)];
+    for (auto& e : slot) {
+      expired.push_back(std::move(e.key));
+    }
+    slot.clear();
+    for (auto& e : due_) {
+      expired.push_back(std::move(e.key));
+    }
+    due_.clear();
+  }
+  size_ -= static_cast<int>(expired.size());
+  return expired;
+}
+
+} // namespace wwiv::wwivd
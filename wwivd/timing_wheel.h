@@ -0,0 +1,71 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_WWIVD_TIMING_WHEEL_H
+#define INCLUDED_WWIVD_TIMING_WHEEL_H
+
+#include <array>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace wwiv::wwivd {
+
+/**
+ * Hierarchical timing wheel of string keys with one second resolution.
+ *
+ * Four levels of 64 slots cover about 194 days; anything further out waits
+ * in an overflow list.  Scheduling and expiring a key are O(1), entries are
+ * only moved down a level when the slot they are in comes due.  Keys are
+ * not deduplicated nor cancelled, callers check whether an expired key is
+ * still current.
+ */
+class TimingWheel final {
+public:
+  explicit TimingWheel(time_t now);
+
+  /** Schedules key to expire at when.  Times in the past expire on the next Advance. */
+  void Schedule(const std::string& key, time_t when);
+  /** Moves the wheel forward to now, returning the keys that expired. */
+  std::vector<std::string> Advance(time_t now);
+
+  [[nodiscard]] int size() const noexcept { return size_; }
+  [[nodiscard]] time_t now() const noexcept { return current_; }
+
+private:
+  static constexpr int kLevels = 4;
+  static constexpr int kSlotBits = 6;
+  static constexpr int kSlots = 1 << kSlotBits;
+
+  struct entry_t {
+    time_t when;
+    std::string key;
+  };
+  void Place(entry_t e);
+
+  std::array<std::array<std::vector<entry_t>, kSlots>, kLevels> levels_;
+  std::vector<entry_t> overflow_;
+  // Entries that were already due when scheduled.
+  std::vector<entry_t> due_;
+  time_t current_;
+  int size_{0};
+};
+
+} // namespace wwiv::wwivd
+
+#endif
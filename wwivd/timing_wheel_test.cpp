@@ -0,0 +1,84 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivd/timing_wheel.h"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace wwiv::wwivd;
+
+static constexpr time_t kStart = 1600000000;
+
+static std::vector<std::string> sorted(std::vector<std::string> v) {
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+TEST(TimingWheelTest, Empty) {
+  TimingWheel w(kStart);
+  EXPECT_TRUE(w.Advance(kStart + 1000).empty());
+  EXPECT_EQ(kStart + 1000, w.now());
+}
+
+TEST(TimingWheelTest, Expires) {
+  TimingWheel w(kStart);
+  w.Schedule("a", kStart + 5);
+  w.Schedule("b", kStart + 5);
+  w.Schedule("c", kStart + 10);
+  EXPECT_EQ(3, w.size());
+
+  EXPECT_TRUE(w.Advance(kStart + 4).empty());
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), sorted(w.Advance(kStart + 5)));
+  EXPECT_TRUE(w.Advance(kStart + 9).empty());
+  EXPECT_EQ(std::vector<std::string>{"c"}, w.Advance(kStart + 100));
+  EXPECT_EQ(0, w.size());
+}
+
+TEST(TimingWheelTest, Past) {
+  TimingWheel w(kStart);
+  w.Schedule("a", kStart - 10);
+  w.Schedule("b", kStart);
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), sorted(w.Advance(kStart)));
+}
+
+// Entries on the higher levels come out at exactly the right second.
+TEST(TimingWheelTest, Levels) {
+  const std::vector<time_t> deltas{1, 63, 64, 65, 4095, 4096, 4097, 300000, 262144 * 64 - 1,
+                                   262144 * 64 + 5, 400 * 86400};
+  TimingWheel w(kStart);
+  for (const auto d : deltas) {
+    w.Schedule(std::to_string(d), kStart + d);
+  }
+  for (const auto d : deltas) {
+    EXPECT_TRUE(w.Advance(kStart + d - 1).empty()) << d;
+    EXPECT_EQ(std::vector<std::string>{std::to_string(d)}, w.Advance(kStart + d)) << d;
+  }
+  EXPECT_EQ(0, w.size());
+}
+
+TEST(TimingWheelTest, ScheduleWhileRunning) {
+  TimingWheel w(kStart);
+  w.Schedule("a", kStart + 100);
+  EXPECT_TRUE(w.Advance(kStart + 70).empty());
+  w.Schedule("b", kStart + 71);
+  EXPECT_EQ(std::vector<std::string>{"b"}, w.Advance(kStart + 71));
+  EXPECT_EQ(std::vector<std::string>{"a"}, w.Advance(kStart + 200));
+}
@@ -70,6 +70,7 @@ namespace wwiv::wwivd {
 
 extern std::atomic<bool> need_to_exit;
 extern std::atomic<bool> need_to_reload_config;
+extern std::atomic<bool> need_to_reload_pipeline;
 
 static bool DeleteAllSemaphores(const Config& config, int start_node, int end_node) {
   // Delete telnet/SSH node semaphore files.
@@ -166,10 +167,13 @@ int Main(CommandLine& cmdline) {
   SwitchToNonRootUser(wwiv_user);
   need_to_exit.store(false);
   need_to_reload_config.store(false);
+  need_to_reload_pipeline.store(false);
 
   // Do network callouts if enabled.
   auto& nodemgr = data.nodes->at("BINKP");
   do_wwivd_callouts(config, c, nodemgr);
+  // Run the network pipeline as files arrive if enabled.
+  do_wwivd_network_pipeline(config, c, nodemgr);
 
   std::unique_ptr<httplib::Server> svr;
   std::thread srv_thread;
@@ -185,6 +189,10 @@ int Main(CommandLine& cmdline) {
     svr->Get("/sysop", std::bind(SysopHandler, &data, _1, _2));
     // Register laston endpoint
     svr->Get("/laston", std::bind(LastOnHandler, &data, _1, _2));
+    // Register status counters endpoint
+    svr->Get("/counters", std::bind(CountersHandler, &data, _1, _2));
+    // Register latency histograms endpoint (Prometheus format)
+    svr->Get("/metrics", std::bind(MetricsHandler, &data, _1, _2));
     svr->set_logger(
         [](const httplib::Request& req, const httplib::Response& res) { VLOG(1) << res.body; });
     srv_thread = std::thread([&](const std::string http_address, int p) { 
@@ -47,6 +47,7 @@
 #include "sdk/config.h"
 #include "sdk/filenames.h"
 #include "sdk/instance.h"
+#include "sdk/latency_histograms.h"
 #include "sdk/names.h"
 #include "sdk/status.h"
 #include "sdk/usermanager.h"
@@ -476,6 +477,47 @@ void SysopHandler(ConnectionData* data, const httplib::Request&, httplib::Respon
   res.set_content(response.dump(4), MIME_TYPE_JSON);
 }
 
+void CountersHandler(ConnectionData* data, const httplib::Request&, httplib::Response& res) {
+  static std::mutex mu;
+  std::lock_guard<std::mutex> lock(mu);
+
+  // Only the shared counters are reported since they're available without
+  // reading status.dat.
+  static StatusMgr status_mgr(data->config->datadir());
+  const auto counters = status_mgr.counters();
+  if (!counters) {
+    res.status = 404;
+    res.set_content(R"({"error": "Shared status counters are not available"})", MIME_TYPE_JSON);
+    return;
+  }
+
+  nlohmann::json response;
+  response["qscanptr"] = counters->qscanptr;
+  response["total_calls"] = counters->caller_num;
+  response["messages_today"] = counters->msgs_today;
+  auto filechange = nlohmann::json::array();
+  for (const auto f : counters->filechange) {
+    filechange.push_back(f);
+  }
+  response["filechange"] = filechange;
+
+  res.set_content(response.dump(4), MIME_TYPE_JSON);
+}
+
+void MetricsHandler(ConnectionData* data, const httplib::Request&, httplib::Response& res) {
+  static std::mutex mu;
+  std::lock_guard<std::mutex> lock(mu);
+
+  // Filled in by the nodes and network programs run with --trace.
+  static auto histograms = SharedLatencyHistograms::Open(data->config->datadir());
+  if (!histograms) {
+    res.status = 404;
+    res.set_content("Latency histograms are not available\n", "text/plain");
+    return;
+  }
+  res.set_content(to_prometheus_text(histograms->histograms()), "text/plain; version=0.0.4");
+}
+
 struct laston_entry_t {
   int64_t caller_num{0};
   std::string username;
@@ -42,6 +42,12 @@ void SysopHandler(ConnectionData* data,
 void LastOnHandler(ConnectionData* data,
                    const httplib::Request&, httplib::Response& res);
 
+void CountersHandler(ConnectionData* data,
+                     const httplib::Request&, httplib::Response& res);
+
+void MetricsHandler(ConnectionData* data,
+                    const httplib::Request&, httplib::Response& res);
+
 } // namespace wwiv::wwivd
 
 #endif
@@ -46,6 +46,10 @@
 #include "core/pipe.h"
 #endif
 
+#if !defined(_WIN32) && !defined(__OS2__)
+#include "core/fork_server.h"
+#endif
+
 namespace wwiv::wwivd {
 
 using namespace std::chrono;
@@ -314,6 +318,36 @@ static bool launch_cmd(const wwivd_config_t& wc, const std::string& raw_cmd,
   return ExecCommandAndWait(wc, *nodes, cmd, wwiv_pid, node_number, sock);
 }
 
+#if !defined(_WIN32) && !defined(__OS2__)
+/**
+ * Asks the pre-initialized bbs template listening on the fork server socket to
+ * fork a node for this caller. Returns false if the fork server isn't available,
+ * in which case the bbs should be launched normally.
+ */
+static bool launch_forked_node(const Config& config, const wwivd_matrix_entry_t& bbs,
+                               const std::shared_ptr<NodeManager>& nodes, int node_number,
+                               SOCKET sock, ConnectionType connection_type,
+                               const std::string& remote_peer) {
+  const auto wwiv_pid = fmt::format("[{}] ", get_pid());
+  const auto socket_path = File::absolute(config.root_directory(), bbs.fork_server_socket);
+  if (!SetBlockingMode(sock)) {
+    LOG(ERROR) << "Failed to reset the socket to blocking mode.";
+  }
+  const fork_request_t request{node_number, connection_type == ConnectionType::SSH ? 'S' : 'T'};
+  const auto response = RequestFork(socket_path, request, sock);
+  if (!response) {
+    return false;
+  }
+  nodes->set_node(node_number, connection_type, StrCat("Connected: ", remote_peer));
+  auto at_exit = finally([=] { nodes->ReleaseNode(node_number); });
+  nodes->set_pid(node_number, response->pid);
+  VLOG(1) << wwiv_pid << "Node #" << node_number << " forked as pid: " << response->pid;
+  WaitForForkedNode(response->control_fd);
+  LOG(INFO) << wwiv_pid << "Node #" << node_number << " (forked) exited.";
+  return true;
+}
+#endif
+
 static bool launch_node(const Config& config, const wwivd_config_t& wc, wwivd_matrix_entry_t& bbs,
                         const std::shared_ptr<NodeManager>& nodes, int node_number, SOCKET sock,
                         ConnectionType connection_type, const std::string& remote_peer) {
@@ -339,6 +373,17 @@ static bool launch_node(const Config& config, const wwivd_config_t& wc, wwivd_ma
     Pipe data_pipe(node_number, false);
     Pipe control_pipe(node_number, true);
 #endif    
+#if !defined(_WIN32) && !defined(__OS2__)
+    if (!bbs.fork_server_socket.empty() && bbs.data_mode == wwivd_data_mode_t::socket &&
+        (connection_type == ConnectionType::TELNET || connection_type == ConnectionType::SSH)) {
+      if (launch_forked_node(config, bbs, nodes, node_number, sock, connection_type,
+                             remote_peer)) {
+        return true;
+      }
+      LOG(WARNING) << wwiv_pid << "Fork server not available at: " << bbs.fork_server_socket
+                   << "; launching the bbs instead.";
+    }
+#endif
     [[maybe_unused]] auto real_sock = sock;
     std::thread pipes_thread;
     if (bbs.data_mode == wwivd_data_mode_t::pipe) {
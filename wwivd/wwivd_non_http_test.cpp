@@ -45,6 +45,18 @@ TEST(GoodIps, IsAlwaysAllowed) {
   EXPECT_FALSE(ip.IsAlwaysAllowed("10.0.0.2"));
 }
 
+TEST(GoodIps, Cidr) {
+  const std::vector<std::string> lines{"# Local network", "192.168.0.0/16 # LAN", "2001:db8::/32",
+                                       "bbs.example.com"};
+  GoodIp ip(lines);
+  EXPECT_TRUE(ip.IsAlwaysAllowed("192.168.10.1"));
+  EXPECT_TRUE(ip.IsAlwaysAllowed("2001:db8::10"));
+  EXPECT_TRUE(ip.IsAlwaysAllowed("bbs.example.com"));
+
+  EXPECT_FALSE(ip.IsAlwaysAllowed("192.169.0.1"));
+  EXPECT_FALSE(ip.IsAlwaysAllowed("# Local network"));
+}
+
 TEST(BadIps, Smoke) {
   wwiv::core::test::FileHelper helper;
   auto fn = helper.CreateTempFile("badip.txt", "10.0.0.1\r\n8.8.8.8\r\n");
@@ -64,6 +76,21 @@ TEST(BadIps, Smoke) {
   EXPECT_FALSE(ip.IsBlocked("4.4.4.4"));
 }
 
+TEST(BadIps, BlockCidr) {
+  wwiv::core::test::FileHelper helper;
+  auto fn = helper.CreateTempFile("badip.txt", "10.0.0.0/8\r\n");
+  FakeClock clock(DateTime::now());
+  BadIp ip(fn, clock);
+  EXPECT_TRUE(ip.IsBlocked("10.20.30.40"));
+  EXPECT_FALSE(ip.IsBlocked("11.0.0.1"));
+  ip.Block("11.0.0.0/24");
+  EXPECT_TRUE(ip.IsBlocked("11.0.0.1"));
+
+  BadIp reloaded(fn, clock);
+  EXPECT_TRUE(reloaded.IsBlocked("11.0.0.255"));
+  EXPECT_FALSE(reloaded.IsBlocked("11.0.1.0"));
+}
+
 TEST(AutoBlock, ShouldBlock) {
   wwivd_blocking_t b{};
   b.auto_blocklist = true;
@@ -175,3 +202,55 @@ TEST(AutoBlock, ShouldNotBlock) {
   EXPECT_FALSE(bip->IsBlocked("1.1.1.1"));
 }
 
+TEST(AutoBlock, SessionsExpire) {
+  wwivd_blocking_t b{};
+  b.auto_blocklist = true;
+  b.auto_bl_seconds = 10;
+  b.auto_bl_sessions = 3;
+  wwiv::core::test::FileHelper helper;
+  const auto fn = helper.CreateTempFile("badip.txt", "");
+  FakeClock clock(DateTime::now());
+  auto bip = std::make_shared<BadIp>(fn, clock);
+  AutoBlocker blocker(bip, b, helper.TempDir(), clock);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(blocker.Connection(StrCat("10.0.0.", i)));
+  }
+  EXPECT_EQ(100u, blocker.recent_sessions().size());
+
+  clock.tick(5s);
+  EXPECT_TRUE(blocker.Connection("10.0.0.1"));
+  clock.tick(6s);
+  EXPECT_TRUE(blocker.Connection("10.0.1.1"));
+  // Only the addresses with sessions inside the window are left.
+  EXPECT_EQ(2u, blocker.recent_sessions().size());
+
+  clock.tick(11s);
+  EXPECT_TRUE(blocker.Connection("10.0.2.1"));
+  EXPECT_EQ(1u, blocker.recent_sessions().size());
+}
+
+TEST(AutoBlock, Journal) {
+  wwivd_blocking_t b{};
+  b.auto_blocklist = true;
+  b.auto_bl_seconds = 2;
+  b.auto_bl_sessions = 1;
+  wwiv::core::test::FileHelper helper;
+  const auto fn = helper.CreateTempFile("badip.txt", "");
+  FakeClock clock(DateTime::now());
+  auto bip = std::make_shared<BadIp>(fn, clock);
+  {
+    AutoBlocker blocker(bip, b, helper.TempDir(), clock);
+    blocker.Connection("1.1.1.1");
+    clock.tick(1s);
+    blocker.Connection("1.1.1.1");
+    EXPECT_TRUE(blocker.blocked("1.1.1.1"));
+  }
+  // Escalations are appended to the journal rather than rewriting the json file.
+  EXPECT_TRUE(File::Exists(FilePath(helper.TempDir(), "wwivd.autoblock.journal")));
+
+  AutoBlocker reloaded(bip, b, helper.TempDir(), clock);
+  EXPECT_TRUE(reloaded.blocked("1.1.1.1"));
+  EXPECT_EQ(1, reloaded.auto_blocked().at("1.1.1.1").count);
+  // Loading folds the journal into the json file.
+  EXPECT_FALSE(File::Exists(FilePath(helper.TempDir(), "wwivd.autoblock.journal")));
+}
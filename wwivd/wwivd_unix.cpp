@@ -65,6 +65,7 @@ namespace wwiv::wwivd {
 
 extern std::atomic<bool> need_to_exit;
 extern std::atomic<bool> need_to_reload_config;
+extern std::atomic<bool> need_to_reload_pipeline;
 
 } // namespace wwiv::wwivd
 
@@ -76,6 +77,7 @@ void signal_handler(int mysignal) {
   case SIGHUP: {
     cerr << "Received SIGHUP" << endl;
     need_to_reload_config.store(true);
+    need_to_reload_pipeline.store(true);
     break;
   }
   case SIGINT: {
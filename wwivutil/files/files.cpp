@@ -19,21 +19,29 @@
 #include "wwivutil/files/files.h"
 
 #include "core/command_line.h"
+#include "core/file.h"
 #include "core/log.h"
 #include "core/stl.h"
 #include "core/strings.h"
 #include "fmt/format.h"
 #include "sdk/config.h"
+#include "sdk/files/diz.h"
+#include "sdk/files/files.h"
 #include "wwivutil/files/allow.h"
 #include "wwivutil/files/arc.h"
 #include "wwivutil/files/tic.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iomanip>
 #include <filesystem>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace wwiv::core;
@@ -230,6 +238,113 @@ public:
   }
 };
 
+class DizCommand final : public UtilCommand {
+public:
+  DizCommand()
+      : UtilCommand("diz", "Reads the descriptions for an area from FILE_ID.DIZ or DESC.SDI") {}
+
+  [[nodiscard]] std::string GetUsage() const override {
+    std::ostringstream ss;
+    ss << "Usage:   diz [--threads=N] <area #>" << std::endl;
+    ss << "Example: diz --threads=8 1" << std::endl;
+    ss << std::endl;
+    ss << "Only ZIP files are read, other archives are skipped." << std::endl;
+    return ss.str();
+  }
+
+  int Execute() override {
+    if (remaining().empty()) {
+      std::clog << "Missing file area #." << std::endl;
+      std::cout << GetUsage() << GetHelp() << std::endl;
+      return 2;
+    }
+
+    auto o = ReadAreas(config()->config()->datadir());
+    if (!o) {
+      return 2;
+    }
+    const auto area_num = to_number<int>(remaining().front());
+    const auto dirs = o.value();
+    if (area_num < 0 || area_num >= size_int(dirs)) {
+      LOG(ERROR) << "invalid area number '" << area_num << "' specified. ";
+      const auto max_size = std::max<int>(0, dirs.size() - 1);
+      LOG(ERROR) << "area_num must be between 0 and " << max_size;
+      return 1;
+    }
+
+    const auto& dir = at(dirs, area_num);
+    sdk::files::FileApi api(config()->config()->datadir());
+    auto area = api.Open(dir);
+    if (!area) {
+      LOG(ERROR) << "Unable to open file: " << dir.filename;
+      return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto dir_path = File::absolute(config()->config()->root_directory(), dir.path);
+    const sdk::files::DizParser dp(barg("desc"));
+    const auto num_files = area->number_of_files();
+    std::vector<std::filesystem::path> paths;
+    for (auto num = 1; num <= num_files; num++) {
+      paths.emplace_back(FilePath(dir_path, area->ReadFile(num)));
+    }
+
+    // Reading the archives is independent per file, so spread it over a
+    // number of threads.  The area itself is only updated from this thread.
+    std::vector<std::optional<sdk::files::Diz>> dizs(paths.size());
+    std::atomic<size_t> next{0};
+    std::vector<std::future<void>> workers;
+    const auto num_threads = std::max(1, iarg<int>("threads"));
+    for (auto i = 0; i < num_threads; i++) {
+      workers.emplace_back(std::async(std::launch::async, [&] {
+        for (auto n = next++; n < paths.size(); n = next++) {
+          if (auto d = dp.parse_archive(paths[n])) {
+            dizs[n].emplace(d.value());
+          }
+        }
+      }));
+    }
+    for (auto& w : workers) {
+      w.get();
+    }
+
+    auto count = 0;
+    for (auto num = 1; num <= num_files; num++) {
+      const auto& diz = dizs.at(num - 1);
+      if (!diz) {
+        continue;
+      }
+      auto f = area->ReadFile(num);
+      if (!diz->description().empty()) {
+        f.set_description(diz->description());
+      }
+      if (!area->UpdateFile(f, num, diz->extended_description())) {
+        LOG(ERROR) << "Unable to update file: " << f.unaligned_filename();
+        continue;
+      }
+      VLOG(1) << "Updated: " << f.unaligned_filename() << ": " << f.description();
+      ++count;
+    }
+    if (!area->Save()) {
+      LOG(ERROR) << "Unable to save area: " << dir.filename;
+      return 1;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << fmt::format("Updated {} of {} files in {}ms", count, num_files, elapsed.count())
+              << std::endl;
+    return 0;
+  }
+
+  bool AddSubCommands() override {
+    add_argument(BooleanCommandLineArgument(
+        "desc", "Use the first line of the DIZ as the file description.", true));
+    add_argument({"threads", "Number of archives to read at once.",
+                  std::to_string(std::max(1u, std::thread::hardware_concurrency()))});
+    return true;
+  }
+};
+
 bool FilesCommand::AddSubCommands() {
   if (!add(std::make_unique<AllowCommand>())) {
     return false;
@@ -249,6 +364,9 @@ bool FilesCommand::AddSubCommands() {
   if (!add(std::make_unique<DeleteFileCommand>())) {
     return false;
   }
+  if (!add(std::make_unique<DizCommand>())) {
+    return false;
+  }
   return true;
 }
 
@@ -29,6 +29,7 @@
 #include "sdk/msgapi/message_api_wwiv.h"
 #include "sdk/msgapi/msgapi.h"
 #include "sdk/net/networks.h"
+#include "wwivutil/messages/qwk.h"
 #include "wwivutil/util.h"
 
 #include <ctime>
@@ -359,6 +360,9 @@ bool MessagesCommand::AddSubCommands() {
   if (!add(std::make_unique<PackMessageCommand>())) {
     return false;
   }
+  if (!add(std::make_unique<MessagesQwkCommand>())) {
+    return false;
+  }
   
   return true;
 }
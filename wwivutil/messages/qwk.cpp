@@ -0,0 +1,189 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2022, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "wwivutil/messages/qwk.h"
+
+#include "common/value/uservalueprovider.h"
+#include "core/command_line.h"
+#include "core/datetime.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "fmt/format.h"
+#include "sdk/config.h"
+#include "sdk/filenames.h"
+#include "sdk/qscan.h"
+#include "sdk/qwk_config.h"
+#include "sdk/subxtr.h"
+#include "sdk/user.h"
+#include "sdk/usermanager.h"
+#include "sdk/acs/eval.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/qwk/qwk_builder.h"
+#include "sdk/qwk/qwk_packet.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::sdk::qwk;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+
+namespace wwiv::wwivutil {
+
+static bool can_read_sub(const Config& config, const User& user, const subboard_t& sub) {
+  if (sub.read_acs.empty()) {
+    return true;
+  }
+  acs::Eval eval(sub.read_acs);
+  const auto sl = user.sl();
+  common::value::UserValueProvider u(config, user, sl, config.sl(sl));
+  eval.add(&u);
+  return eval.eval();
+}
+
+MessagesQwkCommand::MessagesQwkCommand()
+    : UtilCommand("qwk", "Builds the messages for a user's QWK packet.") {}
+
+std::string MessagesQwkCommand::GetUsage() const {
+  std::ostringstream ss;
+  ss << "Usage:   qwk --user=NN --out=<directory>" << std::endl;
+  ss << "Example: qwk --user=1 --out=/tmp/qwk" << std::endl;
+  ss << std::endl;
+  ss << "Writes MESSAGES.DAT, the .NDX files and CONTROL.DAT for all new messages in" << std::endl;
+  ss << "the subs the user scans.  Email is not included, the user's qscan pointers" << std::endl;
+  ss << "are not updated, and the packet is not archived." << std::endl;
+  return ss.str();
+}
+
+bool MessagesQwkCommand::AddSubCommands() {
+  add_argument({"user", "User number whose packet to build.", "1"});
+  add_argument({"out", "Directory in which to write the packet.", ""});
+  add_argument({"threads", "Number of subs to read at the same time.", "4"});
+  add_argument({"max_msgs", "Maximum number of messages, 0 for the user's QWK setting.", "0"});
+  return true;
+}
+
+int MessagesQwkCommand::Execute() {
+  const auto out = sarg("out");
+  if (out.empty()) {
+    std::clog << "Missing --out directory." << std::endl;
+    std::cout << GetUsage() << GetHelp() << std::endl;
+    return 2;
+  }
+  if (!File::Exists(out) && !File::mkdirs(out)) {
+    LOG(ERROR) << "Unable to create directory: " << out;
+    return 1;
+  }
+
+  const auto& cfg = *config()->config();
+  const auto user_number = iarg("user");
+  const UserManager um(cfg);
+  const auto user = um.readuser(user_number);
+  if (!user) {
+    LOG(ERROR) << "Failed to load user number " << user_number;
+    return 1;
+  }
+
+  Subs subs(cfg.datadir(), config()->networks().networks(), cfg.max_backups());
+  if (!subs.Load()) {
+    LOG(ERROR) << "Unable to open subs.";
+    return 1;
+  }
+
+  UserQScan qscan(FilePath(cfg.datadir(), USER_QSC).string(), user_number, cfg.qscn_len(),
+                  cfg.max_subs(), cfg.max_dirs());
+  std::vector<qwk_sub_t> packet_subs;
+  for (auto i = 0; i < size_int(subs.subs()); i++) {
+    const auto& sub = subs.sub(i);
+    if (i >= cfg.max_subs() || !qscan.subs().test(i) || !can_read_sub(cfg, *user, sub)) {
+      continue;
+    }
+    packet_subs.push_back(qwk_sub_t{sub, static_cast<uint16_t>(i + 1), qscan.lastread_pointer(i)});
+  }
+
+  const auto qwk_cfg = read_qwk_cfg(cfg);
+  qwk_builder_options_t options{};
+  options.text.remove_color = user->data.qwk_remove_color;
+  options.text.convert_color = user->data.qwk_convert_color;
+  options.text.keep_routing = user->data.qwk_keep_routing;
+  // Same limits as the BBS uses when building a packet online.
+  options.max_msgs = qwk_cfg.max_msgs;
+  if (user->data.qwk_max_msgs && user->data.qwk_max_msgs < options.max_msgs) {
+    options.max_msgs = user->data.qwk_max_msgs;
+  }
+  if (const auto max_msgs = iarg("max_msgs"); max_msgs > 0) {
+    options.max_msgs = max_msgs;
+  }
+  options.max_msgs_per_sub = user->data.qwk_max_msgs_per_sub;
+  options.num_threads = iarg("threads");
+
+  const MessageApiOptions api_options;
+  WWIVMessageApi api(api_options, cfg, config()->networks().networks(), new NullLastReadImpl());
+  QwkPacketWriter writer(FilePath(out, MESSAGES_DAT), out);
+  if (!writer.Open()) {
+    return 1;
+  }
+  QwkPacketBuilder builder(api, options);
+  const auto results = builder.Build(packet_subs, writer);
+  if (!writer.Close()) {
+    LOG(ERROR) << "Error writing: " << FilePath(out, MESSAGES_DAT);
+    return 1;
+  }
+
+  qwk_control_dat_t c{};
+  c.system_name = qwk_system_name(qwk_cfg, cfg.system_name());
+  c.system_phone = cfg.system_phone();
+  c.sysop_name = cfg.sysop_name();
+  c.date_time = DateTime::now().to_string("%m-%d-%Y,%H:%M:%S");
+  c.user_name = user->name();
+  // Matches what the BBS writes for the same packet.
+  c.num_messages = writer.next_logical_num();
+  for (const auto& s : packet_subs) {
+    c.subs.emplace_back(s.conf_num, stripcolors(s.sub.name));
+  }
+  c.hello = qwk_cfg.hello;
+  c.news = qwk_cfg.news;
+  c.bye = qwk_cfg.bye;
+  if (!write_control_dat(FilePath(out, "CONTROL.DAT"), c)) {
+    LOG(ERROR) << "Unable to write CONTROL.DAT";
+    return 1;
+  }
+
+  std::cout << fmt::format("{:<5} {:<40} {:>8} {:>8} {:>8}", "Conf", "Sub", "Total", "New",
+                           "Packed")
+            << std::endl;
+  std::cout << std::string(73, '=') << std::endl;
+  for (const auto& r : results) {
+    const auto& sub = subs.sub(r.conf_num - 1);
+    std::cout << fmt::format("{:<5} {:<40} {:>8} {:>8} {:>8}", r.conf_num,
+                             stripcolors(sub.name).substr(0, 40), r.total, r.num_new,
+                             r.num_written)
+              << std::endl;
+  }
+  std::cout << std::endl << "Wrote " << writer.num_messages() << " messages to " << out
+            << std::endl;
+  return 0;
+}
+
+}  // namespace
@@ -16,11 +16,22 @@
 /*    language governing permissions and limitations under the License.   */
 /*                                                                        */
 /**************************************************************************/
-#ifndef INCLUDED_BBS_QWK_QWK_UTIL_H
-#define INCLUDED_BBS_QWK_QWK_UTIL_H
+#ifndef INCLUDED_WWIVUTIL_MESSAGES_QWK_H
+#define INCLUDED_WWIVUTIL_MESSAGES_QWK_H
 
-namespace wwiv::bbs::qwk {
-  int _fieeetomsbin(float *src4, float *dest4);
-}
+#include "wwivutil/command.h"
 
-#endif
\ No newline at end of file
+namespace wwiv::wwivutil {
+
+class MessagesQwkCommand final : public UtilCommand {
+public:
+  MessagesQwkCommand();
+  ~MessagesQwkCommand() override = default;
+  [[nodiscard]] std::string GetUsage() const override;
+  int Execute() override;
+  bool AddSubCommands() override;
+};
+
+}  // namespace
+
+#endif